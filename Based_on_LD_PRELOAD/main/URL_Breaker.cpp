@@ -3,15 +3,28 @@
 #endif
 
 #include "ol_public.h"
+#include "ol_mplog.h"          // 引入OL多进程共享日志类
+#include "ol_evring.h"          // 引入OL跨进程事件环（向采集进程上报事件）
+#include "ol_verdict.h"         // 引入OL判定服务通信与共享内存缓存（向判定守护进程查询）
 #include "ol_net/ol_InetAddr.h" // 引入OL网络地址封装类
 #include "ol_string.h"          // 引入OL字符串处理工具类
+#include "ol_XmlScanner.h"      // 引入OL流式XML扫描器（一次遍历解析配置文件）
+#include "ol_DomainSet.h"       // 引入OL简洁域名集合（domainset_build编译的.dset文件，mmap共享）
+#include "policy/policy_set.h"      // 引入策略引擎libpolicy（条目解析、网段编译、列表加载、时间段、白名单，与iptables版本共用）
+#ifdef URL_BREAKER_SPECIALIZED
+#include "url_breaker_policy.h"     // 引入policy_codegen根据配置生成的编译期策略表（make specialized）
+#endif
+#include <algorithm>
 #include <atomic>
+#include <cctype>
 #include <cstdarg>
 #include <dlfcn.h>
 #include <fcntl.h>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 #include <vector>
 #include <sys/socket.h>
@@ -36,32 +49,36 @@ using namespace ol;
 using namespace std;
 
 // ===================== 全局配置 =====================
-// 黑名单条目结构（复用InetAddr简化IP/端口管理）
+// 黑名单条目结构（端口、网段和时间段由g_Policy匹配，这里只保留上报和日志所需的信息）
 typedef struct
 {
-    InetAddr addr;  // OL封装的IP+端口（核心）
     string url;     // 原始URL（可选，如www.xxx.com）
-    string mask;    // IP掩码（扩展预留）
     bool is_domain; // 是否是域名（非IP）
+    int rule_id;    // 规则编号（配置文件中第几个BlacklistEntry标签，从0开始；第n个BlacklistFeed标签为-2-n），采集进程据此还原规则
 } BlacklistEntry;
 
-// 拦截时间段（内部存储HHMM数值，外部交互用00:00格式）
-typedef struct
-{
-    int start_time; // 开始时间（如0900=09:00）
-    int end_time;   // 结束时间（如1800=18:00）
-} TimeRange;
-
 // 全局变量
-vector<BlacklistEntry> g_Blacklist;    // IP/URL黑名单
-vector<string> g_WhitelistProcs;       // 进程白名单
-TimeRange g_InterceptTime = {0, 2400}; // 默认全天拦截（00:00-24:00）
+vector<BlacklistEntry> g_Blacklist;    // IP/URL黑名单（下标即g_Policy中的规则编号）
+policy::PolicySet g_Policy;            // 拦截策略：IP/网段查找表、域名规则、进程白名单、拦截时间段（默认全天）
 atomic_bool g_bConfigLoaded(false);
-clogfile g_log;
+cmplogfile g_log;                      // 所有被注入的进程共用一个日志文件
+cevproducer g_evring;                  // 事件环生产者（采集进程运行时上报二进制事件，否则写日志文件）
 const string g_configPath = "/home/mysql/Projects/URL_Breaker/main/config.xml";
 const string g_logPath = "/home/mysql/Projects/URL_Breaker/main/url_breaker.log";
 const int MAX_BLACKLIST = 100;
 
+// 域名集合（BlacklistFeed配置的.dset文件）：非白名单进程解析其中的域名或其子域名（getaddrinfo）时拦截
+vector<pair<unique_ptr<DomainSet>, int>> g_DomainSets; // 域名集合及其规则编号（加载完成后只读）
+atomic_bool g_DomainSetsReady(false);                 // 域名集合是否已加载完成（完成前getaddrinfo不查集合）
+
+// 判定服务（配置了VerdictService时，黑名单、时间段由判定守护进程判定，本进程只查缓存和发查询）
+string g_VerdictSock;                  // 判定服务的套接字路径（为空时在本进程内判定）
+int g_VerdictDeadlineMs = 50;          // 缓存未命中时等待判定服务应答的最长时间（毫秒）
+bool g_VerdictFailClosed = false;      // 判定服务不可用或超时时是否拦截（默认放行）
+cvcache g_VerdictCache;                // 判定守护进程发布的结果缓存（只读挂接）
+mutex g_VerdictMutex;                  // 保护缓存的挂接
+atomic_bool g_VerdictDown(false);      // 判定服务当前是否不可用（状态变化时各记一次日志）
+
 // 原子初始化状态
 atomic<bool> g_InitState(false);
 
@@ -77,90 +94,28 @@ string get_current_proc_path()
 }
 
 /**
- * @brief 将HHMM格式数字转换为HH:MM字符串（如0900→09:00，2400→24:00）
- * @param hhmm 内部存储的HHMM数值
- * @return 格式化后的时间字符串
+ * @brief 调用原getaddrinfo函数（本库劫持了getaddrinfo，库内解析配置中的域名时不经过域名集合拦截）
+ * @return 同getaddrinfo；取不到原函数时返回EAI_SYSTEM（errno为EINVAL）
  */
-static string hhmm_to_str(int hhmm)
-{
-    // 严格限制小时/分钟范围，避免数值异常导致格式溢出
-    int hour = hhmm / 100;
-    int min = hhmm % 100;
-
-    // 强制约束合法范围（小时0-24，分钟0-59）
-    hour = (hour < 0) ? 0 : (hour > 24) ? 24
-                                        : hour;
-    min = (min < 0) ? 0 : (min > 59) ? 59
-                                     : min;
-
-    // 扩大缓冲区至16字节
-    char buf[16] = {0};
-    snprintf(buf, sizeof(buf), "%02d:%02d", hour, min);
-    return string(buf);
-}
+typedef int (*orig_getaddrinfo_t)(const char* node, const char* service, const struct addrinfo* hints, struct addrinfo** res);
+orig_getaddrinfo_t orig_getaddrinfo = nullptr;
 
-/**
- * @brief 解析HH:MM格式字符串为HHMM数值（结合OL库清理空白）
- * @param time_str 如"09:30"、"23:59"、"24:00"（允许包含首尾空白）
- * @param hhmm_out 输出解析后的HHMM数值
- * @return 成功返回true，失败返回false
- */
-static bool str_to_hhmm(const string& time_str, int& hhmm_out)
+static int real_getaddrinfo(const char* node, const char* service, const struct addrinfo* hints, struct addrinfo** res)
 {
-    // 使用OL库清理首尾空白
-    string clean_str = time_str;
-    deleteLRchr(clean_str);
-
-    // 校验格式（必须包含:，且长度符合）
-    size_t colon_pos = clean_str.find(':');
-    if (colon_pos == string::npos || colon_pos < 1 || colon_pos > 2 || clean_str.length() > 5)
+    if (!orig_getaddrinfo)
     {
-        return false;
+        orig_getaddrinfo = (orig_getaddrinfo_t)dlsym(RTLD_NEXT, "getaddrinfo");
+        if (!orig_getaddrinfo)
+        {
+            const char* error = dlerror();
+            write(STDERR_FILENO, "❌ 获取原getaddrinfo函数失败：", 39);
+            if (error) write(STDERR_FILENO, error, strlen(error));
+            write(STDERR_FILENO, "\n", 1);
+            errno = EINVAL;
+            return EAI_SYSTEM;
+        }
     }
-
-    // 拆分小时和分钟（使用OL库清理拆分后的字符串）
-    string hour_str = clean_str.substr(0, colon_pos);
-    string min_str = clean_str.substr(colon_pos + 1);
-    deleteLRchr(hour_str);
-    deleteLRchr(min_str);
-
-    // 转换为数字并校验范围
-    char* end_ptr = nullptr;
-    long hour = strtol(hour_str.c_str(), &end_ptr, 10);
-    if (*end_ptr != '\0' || hour < 0 || hour > 24) return false;
-
-    long min = strtol(min_str.c_str(), &end_ptr, 10);
-    if (*end_ptr != '\0' || min < 0 || min > 59) return false;
-
-    // 特殊处理24:00（转换为2400）
-    if (hour == 24 && min != 0) return false;
-
-    // 计算HHMM数值
-    hhmm_out = static_cast<int>(hour * 100 + min);
-    return true;
-}
-
-/**
- * @brief 解析当前时间为HHMM格式（如09:05→905）
- */
-static int get_current_hhmm()
-{
-    time_t now = time(NULL);
-    struct tm* t = localtime(&now);
-    return t->tm_hour * 100 + t->tm_min;
-}
-
-/**
- * @brief 判断当前时间是否在拦截时间段内
- */
-static bool is_in_intercept_time()
-{
-    int current = get_current_hhmm();
-    int start = g_InterceptTime.start_time;
-    int end = g_InterceptTime.end_time;
-
-    // 处理跨天场景（如23:00-02:00 → 2300-0200）
-    return (start > end) ? (current >= start || current <= end) : (current >= start && current <= end);
+    return orig_getaddrinfo(node, service, hints, res);
 }
 
 /**
@@ -177,7 +132,7 @@ static bool resolve_url_to_ip(const string& target, string& ip_out, sa_family_t&
     hints.ai_family = AF_UNSPEC; // 同时支持IPv4/IPv6
     hints.ai_socktype = SOCK_STREAM;
 
-    if (getaddrinfo(target.c_str(), NULL, &hints, &res) != 0)
+    if (real_getaddrinfo(target.c_str(), NULL, &hints, &res) != 0)
     {
         return false;
     }
@@ -212,152 +167,202 @@ static bool resolve_url_to_ip(const string& target, string& ip_out, sa_family_t&
 }
 
 /**
- * @brief 解析URL/域名为多个IP地址
+ * @brief 解析URL/域名为多个地址（二进制形式，不格式化）
  * @param target URL/域名
- * @param ips_out 输出解析后的IP列表
- * @return 成功解析出至少一个IP返回true
+ * @param addrs_out 输出解析后的地址列表
+ * @return 成功解析出至少一个地址返回true
  */
-static bool resolve_url_to_ips(const string& target, vector<string>& ips_out)
+static bool resolve_url_to_addrs(const string& target, vector<InetAddr>& addrs_out)
 {
     struct addrinfo hints, *res, *p;
     memset(&hints, 0, sizeof(hints));
     hints.ai_family = AF_UNSPEC;
     hints.ai_socktype = SOCK_STREAM;
 
-    if (getaddrinfo(target.c_str(), NULL, &hints, &res) != 0)
+    if (real_getaddrinfo(target.c_str(), NULL, &hints, &res) != 0)
     {
         return false;
     }
 
     for (p = res; p != NULL; p = p->ai_next)
     {
-        char ip[INET6_ADDRSTRLEN] = {0};
-        if (p->ai_family == AF_INET)
-        {
-            struct sockaddr_in* ipv4 = (struct sockaddr_in*)p->ai_addr;
-            inet_ntop(AF_INET, &ipv4->sin_addr, ip, sizeof(ip));
-            ips_out.push_back(ip);
-        }
-        else if (p->ai_family == AF_INET6)
-        {
-            struct sockaddr_in6* ipv6 = (struct sockaddr_in6*)p->ai_addr;
-            inet_ntop(AF_INET6, &ipv6->sin6_addr, ip, sizeof(ip));
-            ips_out.push_back(ip);
-        }
+        InetAddr addr;
+        if (addr.trySetAddr(p->ai_addr, p->ai_addrlen)) addrs_out.push_back(addr);
     }
 
     freeaddrinfo(res);
-    return !ips_out.empty();
+    return !addrs_out.empty();
 }
 
+#ifdef URL_BREAKER_SPECIALIZED
+// ================================== <编译期策略> ==================================
 /**
- * @brief 轻量版IP合法性判断（只判断是否是纯IP，不引入复杂逻辑）
- * @param str 待判断字符串
- * @return 是合法IP返回true，否则false
+ * @brief 判断某一时刻是否在拦截时间段内（查常量位图）
+ * @note 每个线程缓存当前整点的起始时刻和分钟数，同一小时内不再调用localtime_r（夏令时在整点切换）
  */
-static bool is_valid_ip(const string& str)
+static bool spec_active(time_t now)
 {
-    // IPv4判断（仅数字和.，且.的数量合法）
-    int dot_count = 0;
-    for (char c : str)
+    static thread_local time_t hour_start = 0;
+    static thread_local int hour_minute = -1;
+    if (hour_minute < 0 || now < hour_start || now >= hour_start + 3600)
     {
-        if (!isdigit(c) && c != '.') return false;
-        if (c == '.') dot_count++;
+        struct tm tmv;
+        if (localtime_r(&now, &tmv) == nullptr) return false;
+        hour_minute = tmv.tm_hour * 60;
+        hour_start = now - tmv.tm_min * 60 - tmv.tm_sec;
     }
-    if (dot_count == 3) return true;
+    int minute = hour_minute + static_cast<int>((now - hour_start) / 60);
+    return (spec::kSchedule[minute >> 6] >> (minute & 63)) & 1;
+}
 
-    // IPv6简单判断（包含:且有数字/字母）
-    bool has_colon = false;
-    for (char c : str)
-    {
-        if (!isdigit(c) && !isalpha(c) && c != ':' && c != '.') return false;
-        if (c == ':') has_colon = true;
-    }
-    return has_colon;
+// 端口是否在端口位图中（0表示所有端口）
+static inline bool spec_port(uint32_t set, uint16_t port)
+{
+    return set == 0 || spec::kPortSets[set - 1].contains(port);
 }
 
 /**
- * @brief 判断进程是否在白名单
+ * @brief 查找IP/网段黑名单（与PolicySet::matchNet的结果一致）
+ * @param family 地址族（FAMILY_V4/FAMILY_V6）
+ * @param addr 网络字节序地址（IPv4映射的IPv6地址按IPv4查找）
+ * @param port 目标端口
+ * @return 命中条目中最小的规则编号，未命中返回-1
  */
-static bool is_proc_whitelisted()
+static int spec_match_net(uint8_t family, const uint8_t* addr, uint16_t port)
 {
-    string proc_path = get_current_proc_path();
-    if (proc_path.empty()) return false;
-
-    // 兼容/usr/bin → /bin路径简化
-    string simplified_proc = proc_path;
-    if (simplified_proc.find("/usr/bin/") == 0)
+    static const uint8_t v4mapped[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+    if (family == policy::FAMILY_V6 && memcmp(addr, v4mapped, sizeof(v4mapped)) == 0)
     {
-        simplified_proc.replace(0, 4, "/bin");
+        family = policy::FAMILY_V4;
+        addr += 12;
     }
 
-    for (const auto& white_proc : g_WhitelistProcs)
+    int best = -1;
+    if (family == policy::FAMILY_V4)
     {
-        string simplified_white = white_proc;
-        if (simplified_white.find("/usr/bin/") == 0)
+        uint32_t key = (static_cast<uint32_t>(addr[0]) << 24) | (static_cast<uint32_t>(addr[1]) << 16) | (static_cast<uint32_t>(addr[2]) << 8) | addr[3];
+
+        // 单个地址：完美哈希，最多比较一个槽位
+        if constexpr (spec::kV4Ports.size() > 0)
         {
-            simplified_white.replace(0, 4, "/bin");
+            uint32_t disp = spec::kV4Disp[spec::spec_hash(key, 0) & (spec::kV4Buckets - 1)];
+            const spec::st_specslot& slot = spec::kV4Table[spec::spec_hash(key, disp) & (spec::kV4Size - 1)];
+            if (slot.m_count > 0 && slot.m_key == key)
+            {
+                for (uint32_t ii = slot.m_first; ii < slot.m_first + slot.m_count; ++ii)
+                {
+                    const spec::st_specport& p = spec::kV4Ports[ii];
+                    if (spec_port(p.m_set, port) && (best < 0 || p.m_ruleId < best)) best = p.m_ruleId;
+                }
+            }
         }
-        if (proc_path == white_proc || simplified_proc == simplified_white)
+
+        // 网段：每个端口匹配的分组一次二分查找
+        for (const spec::st_specgroup& g : spec::kV4Groups)
         {
-            return true;
+            if (!spec_port(g.m_set, port)) continue;
+            const spec::st_specrange4* first = spec::kV4Ranges.data() + g.m_first;
+            const spec::st_specrange4* last = first + g.m_count;
+            const spec::st_specrange4* it = upper_bound(first, last, key, [](uint32_t k, const spec::st_specrange4& r) { return k < r.m_lo; });
+            if (it != first && key <= (it - 1)->m_hi && (best < 0 || (it - 1)->m_ruleId < best)) best = (it - 1)->m_ruleId;
         }
+        return best;
     }
-    return false;
+
+    uint64_t hi = 0, lo = 0;
+    for (int ii = 0; ii < 8; ++ii)
+    {
+        hi = (hi << 8) | addr[ii];
+        lo = (lo << 8) | addr[ii + 8];
+    }
+    for (const spec::st_specgroup& g : spec::kV6Groups)
+    {
+        if (!spec_port(g.m_set, port)) continue;
+        const spec::st_specrange6* first = spec::kV6Ranges.data() + g.m_first;
+        const spec::st_specrange6* last = first + g.m_count;
+        const spec::st_specrange6* it = upper_bound(first, last, make_pair(hi, lo), [](const pair<uint64_t, uint64_t>& k, const spec::st_specrange6& r)
+                                                    { return k < make_pair(r.m_loHi, r.m_loLo); });
+        if (it == first) continue;
+        --it;
+        if (make_pair(hi, lo) <= make_pair(it->m_hiHi, it->m_hiLo) && (best < 0 || it->m_ruleId < best)) best = it->m_ruleId;
+    }
+    return best;
+}
+// ================================== </编译期策略> ==================================
+#endif // URL_BREAKER_SPECIALIZED
+
+/**
+ * @brief 判断进程是否在白名单
+ */
+static bool is_proc_whitelisted()
+{
+#ifdef URL_BREAKER_SPECIALIZED
+    // 编译期白名单：可执行文件在进程生命周期内不变（exec后重新加载本库），只判断一次
+    static const bool whitelisted = [] {
+        string exe = policy::PolicySet::normalizeExe(get_current_proc_path());
+        auto it = lower_bound(spec::kWhitelist.begin(), spec::kWhitelist.end(), exe,
+                              [](const char* w, const string& e) { return strcmp(w, e.c_str()) < 0; });
+        return it != spec::kWhitelist.end() && exe == *it;
+    }();
+    return whitelisted;
+#else
+    // 白名单已规整（/usr/bin → /bin）并排序，二分查找
+    return g_Policy.isWhitelisted(get_current_proc_path());
+#endif
 }
 
 /**
  * @brief 检查目标地址是否命中黑名单（支持域名动态匹配）
  * @param target_addr 目标地址
+ * @param matched 输出命中的黑名单条目（未命中时为nullptr）
  * @return 命中返回true，否则false
  */
-static bool is_blocked(const InetAddr& target_addr)
+static bool is_blocked(const InetAddr& target_addr, const BlacklistEntry*& matched)
 {
-    // 不在拦截时间段 → 直接放行
-    if (!is_in_intercept_time()) return false;
+    matched = nullptr;
 
-    string target_ip = target_addr.getIp();
-    uint16_t target_port = target_addr.getPort();
-
-    for (const auto& entry : g_Blacklist)
-    {
-        // 1. 先检查IP:端口直接匹配（包括通配符）
-        bool port_match = (entry.addr.getPort() == 0) ||
-                          (entry.addr.getPort() == target_port);
+    // 不在拦截时间段 → 直接放行（时间段已展开为分钟位图）
+#ifdef URL_BREAKER_SPECIALIZED
+    if (!spec_active(time(NULL))) return false;
+#else
+    if (!g_Policy.active(time(NULL))) return false;
+#endif
 
-        if (port_match)
-        {
-            const char* entry_ip = entry.addr.getIp();
+    // 全部按二进制比较（IPv4映射的IPv6目标按IPv4处理），不格式化IP字符串
+    uint16_t target_port = target_addr.getPortNoexcept();
 
-            // 通配符匹配
-            if (strcmp(entry_ip, "*") == 0)
-                return true;
+    // 1. 先查IP/网段黑名单（编译后的查找表，每个端口组一次二分查找）
+    uint8_t family = target_addr.getIpLen() == 16 ? policy::FAMILY_V6 : policy::FAMILY_V4;
+#ifdef URL_BREAKER_SPECIALIZED
+    int idx = spec_match_net(family, target_addr.getIpBytes(), target_port);
+#else
+    int idx = g_Policy.matchNet(family, target_addr.getIpBytes(), target_port, policy::PROTO_TCP | policy::PROTO_UDP);
+#endif
+    if (idx >= 0)
+    {
+        matched = &g_Blacklist[idx];
+        return true;
+    }
 
-            // IP完全匹配
-            if (strcmp(entry_ip, target_ip.c_str()) == 0)
-                return true;
-        }
+    // 2. 域名条目：实时解析匹配
+#ifdef URL_BREAKER_SPECIALIZED
+    for (const auto& rule : spec::kDomains)
+#else
+    for (const auto& rule : g_Policy.domains())
+#endif
+    {
+        // 端口不匹配的条目直接跳过
+        if (!rule.matchPort(target_port)) continue;
 
-        // 2. 如果是域名，尝试实时解析匹配
-        if (entry.is_domain && !entry.url.empty())
+        vector<InetAddr> resolved_addrs;
+        if (resolve_url_to_addrs(rule.m_host, resolved_addrs))
         {
-            // 检查端口是否匹配
-            bool port_match_domain = (entry.addr.getPort() == 0) ||
-                                     (entry.addr.getPort() == target_port);
-
-            if (port_match_domain)
+            for (const auto& resolved_addr : resolved_addrs)
             {
-                // 实时解析域名
-                vector<string> resolved_ips;
-                if (resolve_url_to_ips(entry.url, resolved_ips))
+                if (resolved_addr.contains(target_addr, 128))
                 {
-                    for (const auto& resolved_ip : resolved_ips)
-                    {
-                        if (resolved_ip == target_ip)
-                        {
-                            return true;
-                        }
-                    }
+                    matched = &g_Blacklist[rule.m_ruleId];
+                    return true;
                 }
             }
         }
@@ -367,24 +372,217 @@ static bool is_blocked(const InetAddr& target_addr)
 }
 
 /**
- * @brief 记录拦截/放行日志（参考示例风格，强化可读性）
+ * @brief 检查域名是否命中域名集合（域名本身或其任一上级域名在集合中）
+ * @param host 域名
+ * @param rule_id 输出命中的集合的规则编号
+ * @return 在拦截时间段内且命中返回true
  */
-static void log_operation(const InetAddr& target_addr, const string& target_url,
-                          const string& proc, const string& op_type, bool success)
+static bool is_domain_blocked(const char* host, int& rule_id)
 {
+    if (!g_DomainSetsReady.load(memory_order_acquire) || g_DomainSets.empty()) return false;
+    if (!g_Policy.active(time(NULL))) return false;
+
+    for (const auto& set : g_DomainSets)
+    {
+        if (set.first->hasSuffix(host))
+        {
+            rule_id = set.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 挂接判定守护进程的结果缓存（守护进程未运行时1秒内不再重试）
+ * @return 已挂接返回true
+ */
+static bool attach_verdict_cache()
+{
+    if (g_VerdictCache.isattached()) return true;
+
+    static atomic<int64_t> retry_at(0);
+    int64_t now = vnowms();
+    if (now < retry_at.load(memory_order_relaxed)) return false;
+
+    lock_guard<mutex> lock(g_VerdictMutex);
+    if (g_VerdictCache.attach()) return true;
+    retry_at.store(now + 1000, memory_order_relaxed);
+    return false;
+}
+
+/**
+ * @brief 向判定服务查询（先查共享内存缓存，未命中才发一次查询，最多等待g_VerdictDeadlineMs）
+ * @param target_addr 目标地址
+ * @param rule_id 输出：命中的规则编号（配置中的编号，-1表示未命中）
+ * @return 判定结果（VERDICT_*）；判定服务不可用或超时时按g_VerdictFailClosed放行或拦截
+ */
+static uint8_t query_verdict(const InetAddr& target_addr, int& rule_id)
+{
+    rule_id = -1;
+    attach_verdict_cache();
+
+    // 判定守护进程自身（解析域名等）的连接不能再向自己查询
+    if (g_VerdictCache.isowner()) return VERDICT_ALLOW;
+
+    // 可执行文件在进程生命周期内不变（exec后重新加载本库），哈希只算一次
+    static const uint64_t exe_hash = [] {
+        string exe = get_current_proc_path();
+        return vexehash(exe.data(), exe.size());
+    }();
+
+    st_vkey key;
+    memset(&key, 0, sizeof(key));
+    key.m_exeHash = exe_hash;
+    key.m_uid = static_cast<uint32_t>(getuid());
+    key.m_family = target_addr.getFamily();
+    key.m_port = target_addr.getPortNoexcept();
+    memcpy(key.m_addr, target_addr.getIpBytes(), target_addr.getIpLen());
+
+    st_vanswer ans;
+    if (g_VerdictCache.probe(key, ans))
+    {
+        rule_id = ans.m_ruleId;
+        return ans.m_verdict;
+    }
+
+    // 缓存未命中：每个线程各用一个连接，不加锁
+    static thread_local cvconn conn;
+    st_vquery query;
+    memset(&query, 0, sizeof(query));
+    query.m_family = key.m_family;
+    query.m_port = key.m_port;
+    memcpy(query.m_addr, key.m_addr, sizeof(query.m_addr));
+    if (conn.query(g_VerdictSock.c_str(), &query, &ans, 1, g_VerdictDeadlineMs) == 1)
+    {
+        if (g_VerdictDown.exchange(false)) g_log.write("✅ 判定服务已恢复\n");
+        rule_id = ans.m_ruleId;
+        return ans.m_verdict;
+    }
+
+    if (!g_VerdictDown.exchange(true))
+        g_log.write("⚠️ 判定服务不可用或超时（%s），按配置%s\n", g_VerdictSock.c_str(), g_VerdictFailClosed ? "拦截" : "放行");
+    return g_VerdictFailClosed ? VERDICT_BLOCK : VERDICT_ALLOW;
+}
+
+/**
+ * @brief 判定一次连接（启用判定服务时向判定服务查询，否则在本进程内匹配黑名单）
+ * @param target_addr 目标地址
+ * @param rule_id 输出：命中的规则编号（配置中的编号，-1表示未命中）
+ * @return 判定结果（VERDICT_*）
+ */
+static uint8_t judge_target(const InetAddr& target_addr, int& rule_id)
+{
+    if (!g_VerdictSock.empty()) return query_verdict(target_addr, rule_id);
+
+    rule_id = -1;
+    const BlacklistEntry* matched = nullptr;
+    if (!is_blocked(target_addr, matched)) return VERDICT_ALLOW;
+    rule_id = matched->rule_id;
+    return VERDICT_BLOCK;
+}
+
+/**
+ * @brief 向采集进程上报一条原始事件（只拷贝二进制字段，不格式化）
+ * @param target_addr 目标地址（白名单放行时可为nullptr）
+ * @param rule_id 命中的规则编号（-1表示未命中）
+ * @param verdict 处理结果（0-放行，1-拦截，2-白名单放行）
+ * @param op 被劫持的函数（0-connect，1-connectat）
+ * @return 成功返回true，未挂接采集进程或环已满返回false
+ */
+static bool push_event(const InetAddr* target_addr, int rule_id, uint8_t verdict, uint8_t op)
+{
+    if (!g_evring.isattached()) return false;
+
+    static thread_local int32_t tid = static_cast<int32_t>(syscall(SYS_gettid)); // 每个线程只取一次
+
+    st_hookevent ev;
+    memset(&ev, 0, sizeof(ev));
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ev.m_ts = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    ev.m_tid = tid;
+    ev.m_ruleId = rule_id;
+    ev.m_verdict = verdict;
+    ev.m_op = op;
+
+    if (target_addr != nullptr)
+    {
+        ev.m_family = target_addr->getFamily();
+        ev.m_port = target_addr->getPortNoexcept();
+        memcpy(ev.m_addr, target_addr->getIpBytes(), target_addr->getIpLen());
+    }
+
+    return g_evring.push(ev);
+}
+
+// 被劫持函数的名称（下标与st_hookevent::m_op一致）
+static const char* const g_opNames[] = {"connect", "connectat"};
+
+/**
+ * @brief 记录拦截/放行日志（采集进程运行时上报事件，否则直接写共享日志文件）
+ * @param target_addr 目标地址
+ * @param rule_id 命中的规则编号（配置中的编号，放行时为-1）
+ * @param op 被劫持的函数（0-connect，1-connectat）
+ * @param success 是否拦截
+ */
+static void log_operation(const InetAddr& target_addr, int rule_id, uint8_t op, bool success)
+{
+    if (push_event(&target_addr, rule_id, success ? 1 : 0, op)) return;
+
+    string proc = get_current_proc_path();
     if (success)
     {
+        // 按规则编号找回原始条目（只在未运行采集进程时写日志用）
+        const char* url = (rule_id == -1 && !g_VerdictSock.empty()) ? "判定服务不可用" : "无";
+        for (const auto& entry : g_Blacklist)
+        {
+            if (entry.rule_id == rule_id && !entry.url.empty())
+            {
+                url = entry.url.c_str();
+                break;
+            }
+        }
         g_log.write("✅ 拦截非白名单进程[%s]%s访问黑名单地址[%s]（原始URL：%s）\n",
-                    proc.c_str(), op_type.c_str(), target_addr.getAddrStr().c_str(),
-                    target_url.empty() ? "无" : target_url.c_str());
+                    proc.c_str(), g_opNames[op], target_addr.getAddrStr().c_str(), url);
     }
     else
     {
         g_log.write("ℹ️ 放行进程[%s]%s访问地址[%s]（原始URL：%s）\n",
-                    proc.c_str(), op_type.c_str(), target_addr.getAddrStr().c_str(),
-                    target_url.empty() ? "无" : target_url.c_str());
+                    proc.c_str(), g_opNames[op], target_addr.getAddrStr().c_str(), "无");
     }
 }
+
+/**
+ * @brief 记录白名单进程放行日志
+ * @param op 被劫持的函数（0-connect，1-connectat）
+ */
+static void log_whitelisted(uint8_t op)
+{
+    if (push_event(nullptr, -1, 2, op)) return;
+
+    g_log.write("ℹ️ 放行白名单进程[%s]访问\n", get_current_proc_path().c_str());
+}
+/**
+ * @brief 记录域名集合拦截日志（事件环只能上报地址，这类拦截直接写共享日志文件）
+ * @param host 被拦截的域名
+ * @param rule_id 命中的集合的规则编号
+ */
+static void log_domain_blocked(const char* host, int rule_id)
+{
+    const char* list = "无";
+    for (const auto& entry : g_Blacklist)
+    {
+        if (entry.rule_id == rule_id)
+        {
+            list = entry.url.c_str();
+            break;
+        }
+    }
+    g_log.write("✅ 拦截非白名单进程[%s]getaddrinfo解析黑名单域名[%s]（域名集合：%s）\n",
+                get_current_proc_path().c_str(), host, list);
+}
 // ================================== </工具函数> ==================================
 
 // ================================== <配置加载> ==================================
@@ -397,184 +595,273 @@ static void load_config()
         return;
     }
 
-    // 初始化日志
-    g_log.open(g_logPath, ios::app, false, true);
+    // 初始化日志（多进程共享，整条记录一次写入，通过共享内存协调切换）
+    g_log.open(g_logPath, true);
     g_log.write("========== 开始加载URL拦截配置 ==========\n");
     g_log.write("配置文件路径：%s\n", g_configPath.c_str());
 
-    // 读取XML配置
-    cifile ifile;
-    if (!ifile.open(g_configPath))
+    // 挂接采集进程的事件环（采集进程未运行时仍写日志文件）
+    if (g_evring.attach())
+        g_log.write("✅ 已连接事件采集进程，拦截/放行事件交由采集进程记录\n");
+
+#ifdef URL_BREAKER_SPECIALIZED
+    // 策略特化版本：策略已编译为常量表，不读取配置文件，只还原日志所需的黑名单条目
+    for (const auto& e : spec::kEntries) g_Blacklist.push_back({e.m_url, e.m_isDomain, e.m_ruleId});
+    g_log.write("✅ 使用编译期策略（生成自%s）：黑名单%zu条，域名%zu条，白名单进程%zu个，拦截时间段：%s\n",
+                spec::kSource, spec::kEntries.size(), spec::kDomains.size(), spec::kWhitelist.size(), spec::kSchedText);
+    return;
+#endif
+
+    // 映射XML配置（一次遍历，标签和内容都是映射内存中的视图，解析过程不复制）
+    cmmapfile mfile;
+    if (!mfile.open(g_configPath))
     {
-        g_log.write("❌ 配置文件不存在，使用默认配置（拦截时间段：%s-%s）\n",
-                    hhmm_to_str(g_InterceptTime.start_time).c_str(),
-                    hhmm_to_str(g_InterceptTime.end_time).c_str());
+        g_Policy.schedule().setAllDay();
+        g_log.write("❌ 配置文件不存在，使用默认配置（拦截时间段：%s）\n", g_Policy.schedule().toString().c_str());
         return;
     }
 
-    string buf;
-    int blacklist_count = 0, whitelist_count = 0;
-    while (ifile.readline(buf))
+    int blacklist_count = 0, whitelist_count = 0, feed_count = 0;
+    size_t feed_nets = 0; // 列表文件中的IP/网段条目数
+    int rule_ordinal = 0; // BlacklistEntry标签的序号（含被跳过的条目，与采集进程的编号保持一致）
+    int feed_ordinal = 0; // BlacklistFeed标签的序号（同上）
+    int pending_start = -1; // 尚未配对的拦截开始时间（分钟），与其后的第一个结束时间组成一个时间段
+    vector<pair<string, int>> feeds; // 黑名单列表文件及其规则编号
+    string verdict_sock;             // 判定服务的套接字路径（扫描完配置、确认服务可用后才生效）
+    XmlScanner scanner(mfile.view());
+    XmlToken tok;
+    while (scanner.next(tok))
     {
-        string load;
-        char* line = (char*)buf.c_str();
+        // 清理首尾空白（含跨行元素的换行和缩进）
+        string_view load = deleteLRspace(tok.m_value);
 
-        // 使用OL库清理首尾空白（替代原trim函数）
-        deleteLRchr(line);
-
-        // 跳过注释和空行
-        if (*line == '#' || *line == '\0') continue;
-
-        // 解析拦截开始时间（XML读入00:00格式字符串，自动清理空白）
-        if (getByXml(buf, "StartInterceptTime", load))
+        // 解析拦截开始/结束时间（XML读入00:00格式字符串）：每对Start/End组成一个时间段，可以配置多对；
+        // 只有开始时间时拦截到24:00，只有结束时间时从00:00开始拦截
+        if (tok.m_tag == "StartInterceptTime")
         {
             int parsed_time = 0;
-            if (str_to_hhmm(load, parsed_time))
+            if (policy::Schedule::parseTime(load.data(), load.size(), parsed_time))
             {
-                g_InterceptTime.start_time = parsed_time;
-                g_log.write("✅ 加载拦截开始时间：%s\n", hhmm_to_str(parsed_time).c_str());
+                if (pending_start >= 0) g_Policy.schedule().addRange(pending_start, policy::Schedule::MINUTES_PER_DAY);
+                pending_start = parsed_time;
+                g_log.write("✅ 加载拦截开始时间：%s\n", policy::Schedule::formatTime(parsed_time).c_str());
             }
             else
             {
-                g_log.write("❌ 无效的开始时间格式[%s]，使用默认值%s\n",
-                            load.c_str(), hhmm_to_str(g_InterceptTime.start_time).c_str());
+                g_log.write("❌ 无效的开始时间格式[%.*s]，忽略该时间\n", (int)load.size(), load.data());
             }
         }
-        // 解析拦截结束时间（XML读入00:00格式字符串，自动清理空白）
-        else if (getByXml(buf, "EndInterceptTime", load))
+        else if (tok.m_tag == "EndInterceptTime")
         {
             int parsed_time = 0;
-            if (str_to_hhmm(load, parsed_time))
+            if (policy::Schedule::parseTime(load.data(), load.size(), parsed_time))
             {
-                g_InterceptTime.end_time = parsed_time;
-                g_log.write("✅ 加载拦截结束时间：%s\n", hhmm_to_str(parsed_time).c_str());
+                g_Policy.schedule().addRange(pending_start >= 0 ? pending_start : 0, parsed_time);
+                pending_start = -1;
+                g_log.write("✅ 加载拦截结束时间：%s\n", policy::Schedule::formatTime(parsed_time).c_str());
             }
             else
             {
-                g_log.write("❌ 无效的结束时间格式[%s]，使用默认值%s\n",
-                            load.c_str(), hhmm_to_str(g_InterceptTime.end_time).c_str());
+                g_log.write("❌ 无效的结束时间格式[%.*s]，忽略该时间\n", (int)load.size(), load.data());
             }
         }
 
-        // 解析进程白名单（清理空白后存储）
-        else if (getByXml(buf, "WhitelistProc", load))
+        // 解析进程白名单
+        else if (tok.m_tag == "WhitelistProc")
         {
-            deleteLRchr(load); // 清理首尾空白
             if (!load.empty())
             {
-                g_WhitelistProcs.push_back(load);
-                g_log.write("✅ 加载白名单进程：%s\n", load.c_str());
+                g_Policy.addWhitelist(string(load));
+                g_log.write("✅ 加载白名单进程：%.*s\n", (int)load.size(), load.data());
                 whitelist_count++;
             }
         }
 
-        // 解析黑名单（IP:端口 / URL:端口，清理空白）
-        else if (getByXml(buf, "BlacklistEntry", load))
+        // 解析黑名单（IP:端口 / URL:端口）
+        else if (tok.m_tag == "BlacklistEntry")
         {
-            deleteLRchr(load); // 清理首尾空白
+            int rule_id = rule_ordinal++;
             if (load.empty() || blacklist_count >= MAX_BLACKLIST) continue;
 
-            // 分割目标（IP/URL）和端口
-            size_t colon_pos = load.find(':');
-            if (colon_pos == string::npos) continue;
-
-            string target_str = load.substr(0, colon_pos);
-            string port_str = load.substr(colon_pos + 1);
-
-            // 清理目标和端口字符串的空白
-            deleteLRchr(target_str);
-            deleteLRchr(port_str);
-
-            // 解析端口（支持*通配，记录显示用字符串）
-            uint16_t port = 0;
-            string port_display = "*"; // 日志显示用
-            if (port_str != "*")
+            // IP/网段条目：IP[/前缀长度]:端口，端口可为范围（8000-8100），IPv6写作[::1]:80，*表示所有IP
+            // 域名条目：域名:端口（端口写法相同），连接时实时解析匹配
+            policy::NetRule rule;
+            int index = static_cast<int>(g_Blacklist.size());
+            policy::TargetKind kind = g_Policy.addTarget(load.data(), load.size(), index, policy::PROTO_TCP | policy::PROTO_UDP, &rule);
+            if (kind == policy::TARGET_INVALID)
             {
-                long port_val = strtol(port_str.c_str(), nullptr, 10);
-                if (port_val < 1 || port_val > 65535)
-                {
-                    g_log.write("❌ 无效端口：%s，跳过该条目\n", port_str.c_str());
-                    continue;
-                }
-                port = static_cast<uint16_t>(port_val);
-                port_display = port_str; // 用原始端口字符串显示
+                g_log.write("❌ 无效的黑名单条目：%.*s，跳过该条目\n", (int)load.size(), load.data());
+                continue;
             }
 
-            // 构造黑名单条目
             BlacklistEntry entry;
-            entry.url = target_str;
-            entry.mask = "";
-
-            // 处理通配符*
-            if (target_str == "*")
+            entry.rule_id = rule_id;
+            if (kind == policy::TARGET_NET)
             {
-                // 通配所有IP，默认构造IPv4的0.0.0.0:端口
-                entry.addr = InetAddr("0.0.0.0", port);
+                entry.url = rule.m_family == policy::FAMILY_ANY ? "*" : policy::formatAddr(rule);
                 entry.is_domain = false;
-                g_log.write("✅ 加载黑名单：*:%s（通配所有IP）\n", port_display.c_str());
-                g_Blacklist.push_back(entry);
-                blacklist_count++;
-                continue;
+                g_log.write("✅ 加载黑名单：%s:%s%s\n", entry.url.c_str(),
+                            rule.allPorts() ? "*" : policy::formatPorts(rule).c_str(),
+                            rule.m_family == policy::FAMILY_ANY ? "（通配所有IP）" : "");
             }
-
-            // 处理合法IP地址（直接构造InetAddr）
-            if (is_valid_ip(target_str))
+            else
             {
-                try
-                {
-                    entry.addr = InetAddr(target_str, port);
-                    entry.is_domain = false;
-                    g_log.write("✅ 加载黑名单：%s:%s\n",
-                                target_str.c_str(), port_display.c_str());
-                    g_Blacklist.push_back(entry);
-                    blacklist_count++;
-                }
-                catch (const invalid_argument& e)
-                {
-                    g_log.write("❌ 无效IP地址：%s，跳过该条目\n", target_str.c_str());
-                    continue;
-                }
+                // 域名在扫描完配置后再处理（是否解析取决于判定服务是否可用）
+                entry.url = g_Policy.domains().back().m_host;
+                entry.is_domain = true;
             }
-            // 处理URL/域名（标记为域名，动态解析）
-            else
+            g_Blacklist.push_back(entry);
+            blacklist_count++;
+        }
+
+        // 黑名单列表文件：扫描完配置后再加载（启用判定服务时由判定守护进程加载，本进程不读取）
+        else if (tok.m_tag == "BlacklistFeed")
+        {
+            int rule_id = -2 - feed_ordinal++;
+            if (!load.empty()) feeds.emplace_back(string(load), rule_id);
+        }
+
+        // 判定服务：套接字路径、缓存未命中时的等待时间、不可用时放行（open）还是拦截（closed）
+        else if (tok.m_tag == "VerdictService")
+        {
+            verdict_sock.assign(load);
+        }
+        else if (tok.m_tag == "VerdictDeadlineMs")
+        {
+            int deadline = atoi(string(load).c_str());
+            if (deadline > 0) g_VerdictDeadlineMs = deadline;
+        }
+        else if (tok.m_tag == "VerdictFailMode")
+        {
+            g_VerdictFailClosed = (load == "closed");
+        }
+    }
+
+    // 配置格式错误时，出错位置之前的配置仍然有效
+    if (!scanner.ok())
+    {
+        g_log.write("❌ 配置文件格式错误（第%zu行：%s），其后的配置被忽略\n", scanner.errorLine(), scanner.error());
+    }
+
+    // 启用判定服务时，列表文件和域名解析都交给判定守护进程；守护进程连不上时退回本进程内判定
+    if (!verdict_sock.empty())
+    {
+        if (vreachable(verdict_sock.c_str()))
+            g_VerdictSock = verdict_sock;
+        else
+            g_log.write("⚠️ 判定服务不可用（%s），在本进程内加载黑名单列表并判定（WhitelistUser不生效）\n", verdict_sock.c_str());
+    }
+
+    // 域名条目：在本进程内判定时解析一次，获取主IP用于日志显示（解析失败不影响条目，连接时重新解析）
+    for (const auto& domain : g_Policy.domains())
+    {
+        string ports = domain.allPorts() ? "*" : to_string(domain.m_portLo);
+        if (!domain.allPorts() && domain.m_portHi != domain.m_portLo) ports += "-" + to_string(domain.m_portHi);
+        string resolved_ip;
+        sa_family_t family;
+        if (!g_VerdictSock.empty())
+            g_log.write("✅ 加载域名黑名单：%s:%s（由判定服务解析）\n", domain.m_host.c_str(), ports.c_str());
+        else if (resolve_url_to_ip(domain.m_host, resolved_ip, family))
+            g_log.write("✅ 加载域名黑名单：%s:%s（域名：%s）\n", resolved_ip.c_str(), ports.c_str(), domain.m_host.c_str());
+        else
+            g_log.write("⚠️ 加载域名黑名单：%s:%s（暂时无法解析，连接时重新解析）\n", domain.m_host.c_str(), ports.c_str());
+    }
+
+    // 解析黑名单列表文件（每行一个IP/网段、hosts格式或AdBlock格式，.gz自动解压）：
+    // IP/网段条目拦截所有端口，与BlacklistEntry一起编译；域名条目只计数（用domainset_build编译为.dset域名集合）
+    // .dset域名集合在本进程内mmap（与判定服务无关，所有进程共享物理页），解析其中的域名时拦截
+    for (const auto& feed : feeds)
+    {
+        const string& path = feed.first;
+        int rule_id = feed.second;
+        if (path.size() > 5 && path.compare(path.size() - 5, 5, ".dset") == 0)
+        {
+            unique_ptr<DomainSet> set(new DomainSet());
+            if (!set->open(path))
             {
-                // 对于域名，我们将其标记为域名类型，并记录端口
-                // 同时解析一次域名，获取主IP用于日志显示
-                string resolved_ip;
-                sa_family_t family;
-                if (resolve_url_to_ip(target_str, resolved_ip, family))
-                {
-                    try
-                    {
-                        entry.addr = InetAddr(resolved_ip, port);
-                        entry.is_domain = true;
-                        g_log.write("✅ 加载域名黑名单：%s:%s（域名：%s）\n",
-                                    resolved_ip.c_str(), port_display.c_str(), target_str.c_str());
-                        g_Blacklist.push_back(entry);
-                        blacklist_count++;
-                    }
-                    catch (const invalid_argument& e)
-                    {
-                        g_log.write("❌ 解析后的IP无效：%s，跳过该条目\n", resolved_ip.c_str());
-                        continue;
-                    }
-                }
-                else
-                {
-                    g_log.write("❌ 无法解析域名：%s，跳过该条目\n", target_str.c_str());
-                    continue;
-                }
+                g_log.write("❌ 打开域名集合失败：%s（文件不存在或已损坏）\n", path.c_str());
+                continue;
             }
+            g_log.write("✅ 加载域名集合：%s（%zu个域名，%zu字节），解析这些域名及其子域名时拦截\n",
+                        path.c_str(), set->size(), set->bytes());
+
+            BlacklistEntry entry;
+            entry.url = path;
+            entry.is_domain = true;
+            entry.rule_id = rule_id;
+            g_Blacklist.push_back(entry);
+            g_DomainSets.emplace_back(std::move(set), rule_id);
+            feed_count++;
+            continue;
+        }
+
+        if (!g_VerdictSock.empty())
+        {
+            // 只保留条目用于日志还原规则
+            BlacklistEntry entry;
+            entry.url = path;
+            entry.is_domain = false;
+            entry.rule_id = rule_id;
+            g_Blacklist.push_back(entry);
+            feed_count++;
+            continue;
+        }
+
+        string error;
+        policy::FeedStats st;
+        bool loaded = g_Policy.addFeed(path, static_cast<int>(g_Blacklist.size()), policy::PROTO_TCP | policy::PROTO_UDP, st, error);
+        if (!loaded)
+        {
+            g_log.write("❌ 读取黑名单列表失败：%s（%s）%s\n", path.c_str(), error.c_str(),
+                        st.m_nets > 0 ? "，已读出的条目仍然有效" : "");
+            if (st.m_nets == 0) continue;
+        }
+
+        if (st.m_nets > 0)
+        {
+            BlacklistEntry entry;
+            entry.url = path;
+            entry.is_domain = false;
+            entry.rule_id = rule_id;
+            g_Blacklist.push_back(entry);
         }
+        g_log.write("✅ 加载黑名单列表：%s（%s）\n", path.c_str(), st.toString().c_str());
+        if (st.m_domains > 0)
+            g_log.write("ℹ️ 列表中的%zu条域名被忽略（只拦截其中的IP/网段），要拦截域名请用domainset_build编译为.dset文件后配置\n", st.m_domains);
+        feed_nets += st.m_nets;
+        feed_count++;
+    }
+
+    // 没有配置拦截时间段时全天拦截
+    if (pending_start >= 0) g_Policy.schedule().addRange(pending_start, policy::Schedule::MINUTES_PER_DAY);
+    if (g_Policy.schedule().empty()) g_Policy.schedule().setAllDay();
+
+    // 时间段确定后域名集合才生效（getaddrinfo按时间段判断是否拦截）
+    g_DomainSetsReady.store(true, memory_order_release);
+
+    // 编译IP/网段黑名单，白名单排序
+    g_Policy.compile();
+    if (g_Policy.netInputs() > 0)
+    {
+        g_log.write("✅ IP/网段黑名单编译完成：%s，查找表%zu个端口组、%zu个地址段\n",
+                    g_Policy.report().toString().c_str(), g_Policy.table().groupNum(), g_Policy.table().size());
     }
 
     // 配置加载完成
     g_log.write("========== 配置加载完成 ==========\n");
     g_log.write("黑名单条目数：%d\n", blacklist_count);
+    if (feed_count > 0)
+    {
+        if (g_VerdictSock.empty())
+            g_log.write("黑名单列表数：%d（IP/网段%zu条）\n", feed_count, feed_nets);
+        else
+            g_log.write("黑名单列表数：%d（由判定服务加载）\n", feed_count);
+    }
     g_log.write("白名单进程数：%d\n", whitelist_count);
-    g_log.write("拦截时间段：%s - %s\n",
-                hhmm_to_str(g_InterceptTime.start_time).c_str(),
-                hhmm_to_str(g_InterceptTime.end_time).c_str());
+    g_log.write("拦截时间段：%s\n", g_Policy.schedule().toString().c_str());
+    if (!g_VerdictSock.empty())
+        g_log.write("判定服务：%s（等待应答最长%d毫秒，不可用时%s）\n", g_VerdictSock.c_str(), g_VerdictDeadlineMs,
+                    g_VerdictFailClosed ? "拦截" : "放行");
     g_log.write("==================================\n");
 }
 // ================================== </配置加载> ==================================
@@ -610,70 +897,34 @@ extern "C" int connect(int sockfd, const struct sockaddr* addr, socklen_t addrle
     // 白名单进程 → 直接放行
     if (is_proc_whitelisted())
     {
-        g_log.write("ℹ️ 放行白名单进程[%s]访问\n", get_current_proc_path());
+        log_whitelisted(0);
         return orig_connect(sockfd, addr, addrlen);
     }
 
-    // 非IP协议（如Unix域套接字）→ 放行
-    if (addr->sa_family != AF_INET && addr->sa_family != AF_INET6)
+    // 用InetAddr封装目标地址（简化IP/端口提取）；非IP协议（如Unix域套接字）、空指针或长度不足的地址
+    // 交给原函数处理（由内核返回相应错误），不能在这里抛出异常
+    InetAddr target_addr;
+    if (!target_addr.trySetAddr(addr, addrlen))
     {
         return orig_connect(sockfd, addr, addrlen);
     }
-
-    // 用InetAddr封装目标地址（简化IP/端口提取）
-    InetAddr target_addr(addr, addrlen);
-    string proc_path = get_current_proc_path();
-
-    // 检查是否命中黑名单（支持域名动态匹配）
-    bool blocked = is_blocked(target_addr);
-
-    // 找到匹配的黑名单条目（用于日志显示）
-    string matched_url = "";
-    if (blocked)
+    // 检查是否命中黑名单（支持域名动态匹配；启用判定服务时由判定服务判定），同时取回命中的规则编号用于日志
+    int rule_id = -1;
+    uint8_t verdict = judge_target(target_addr, rule_id);
+    if (verdict == VERDICT_WHITELIST)
     {
-        // 查找匹配的黑名单条目，获取原始URL用于日志
-        for (const auto& entry : g_Blacklist)
-        {
-            if (entry.is_domain)
-            {
-                vector<string> resolved_ips;
-                if (resolve_url_to_ips(entry.url, resolved_ips))
-                {
-                    for (const auto& ip : resolved_ips)
-                    {
-                        if (ip == target_addr.getIp() &&
-                            (entry.addr.getPort() == 0 || entry.addr.getPort() == target_addr.getPort()))
-                        {
-                            matched_url = entry.url;
-                            break;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                // 对于IP条目，检查是否匹配
-                bool ip_match = (strcmp(entry.addr.getIp(), "*") == 0) ||
-                                (strcmp(entry.addr.getIp(), target_addr.getIp()) == 0);
-                bool port_match = (entry.addr.getPort() == 0) ||
-                                  (entry.addr.getPort() == target_addr.getPort());
-
-                if (ip_match && port_match)
-                {
-                    matched_url = entry.url;
-                    break;
-                }
-            }
-            if (!matched_url.empty()) break;
-        }
-
-        log_operation(target_addr, matched_url, proc_path, "connect", true);
+        log_whitelisted(0);
+        return orig_connect(sockfd, addr, addrlen);
+    }
+    if (verdict == VERDICT_BLOCK)
+    {
+        log_operation(target_addr, rule_id, 0, true);
         errno = ECONNREFUSED;
         return -1;
     }
 
     // 放行并记录日志
-    log_operation(target_addr, "", proc_path, "connect", false);
+    log_operation(target_addr, -1, 0, false);
     return orig_connect(sockfd, addr, addrlen);
 }
 
@@ -703,64 +954,49 @@ extern "C" int connectat(int dirfd, int sockfd, const struct sockaddr* addr, soc
 
     if (is_proc_whitelisted())
     {
-        g_log.write("ℹ️ 放行白名单进程[%s]访问\n", get_current_proc_path());
+        log_whitelisted(1);
         return orig_connectat(dirfd, sockfd, addr, addrlen, flags);
     }
 
-    if (addr->sa_family != AF_INET && addr->sa_family != AF_INET6)
+    InetAddr target_addr;
+    if (!target_addr.trySetAddr(addr, addrlen))
     {
         return orig_connectat(dirfd, sockfd, addr, addrlen, flags);
     }
-
-    InetAddr target_addr(addr, addrlen);
-    string proc_path = get_current_proc_path();
-
-    bool blocked = is_blocked(target_addr);
-
-    // 查找匹配的黑名单条目
-    string matched_url = "";
-    if (blocked)
+    int rule_id = -1;
+    uint8_t verdict = judge_target(target_addr, rule_id);
+    if (verdict == VERDICT_WHITELIST)
     {
-        for (const auto& entry : g_Blacklist)
-        {
-            if (entry.is_domain)
-            {
-                vector<string> resolved_ips;
-                if (resolve_url_to_ips(entry.url, resolved_ips))
-                {
-                    for (const auto& ip : resolved_ips)
-                    {
-                        if (ip == target_addr.getIp() &&
-                            (entry.addr.getPort() == 0 || entry.addr.getPort() == target_addr.getPort()))
-                        {
-                            matched_url = entry.url;
-                            break;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                bool ip_match = (strcmp(entry.addr.getIp(), "*") == 0) ||
-                                (strcmp(entry.addr.getIp(), target_addr.getIp()) == 0);
-                bool port_match = (entry.addr.getPort() == 0) ||
-                                  (entry.addr.getPort() == target_addr.getPort());
-
-                if (ip_match && port_match)
-                {
-                    matched_url = entry.url;
-                    break;
-                }
-            }
-            if (!matched_url.empty()) break;
-        }
-
-        log_operation(target_addr, matched_url, proc_path, "connectat", true);
+        log_whitelisted(1);
+        return orig_connectat(dirfd, sockfd, addr, addrlen, flags);
+    }
+    if (verdict == VERDICT_BLOCK)
+    {
+        log_operation(target_addr, rule_id, 1, true);
         errno = ECONNREFUSED;
         return -1;
     }
 
-    log_operation(target_addr, "", proc_path, "connectat", false);
+    log_operation(target_addr, -1, 1, false);
     return orig_connectat(dirfd, sockfd, addr, addrlen, flags);
 }
+
+/**
+ * @brief 劫持getaddrinfo函数（域名集合拦截）
+ * @note 非白名单进程在拦截时间段内解析.dset域名集合中的域名或其子域名时返回EAI_NONAME，
+ *       其它域名、数字地址和白名单进程直接交给原函数
+ */
+extern "C" int getaddrinfo(const char* node, const char* service, const struct addrinfo* hints, struct addrinfo** res)
+{
+    load_config();
+
+    int rule_id = -1;
+    if (node != nullptr && is_domain_blocked(node, rule_id) && !is_proc_whitelisted())
+    {
+        log_domain_blocked(node, rule_id);
+        return EAI_NONAME;
+    }
+
+    return real_getaddrinfo(node, service, hints, res);
+}
 // ================================== </系统调用劫持> ==================================
\ No newline at end of file
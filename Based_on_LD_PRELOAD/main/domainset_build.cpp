@@ -0,0 +1,58 @@
+#include "ol_public.h"
+#include "ol_DomainSet.h"       // 引入OL简洁域名集合
+#include "policy/feed_loader.h" // 引入黑名单列表加载器（普通列表、hosts、AdBlock格式，gzip自动解压）
+#include <string>
+
+using namespace ol;
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        printf("用法：%s <输出文件> <主机名列表文件1> [主机名列表文件2 ...]\n", argv[0]);
+        printf("示例：%s /home/mysql/Projects/URL_Breaker/main/blocklist.dset hosts.txt adblock.txt.gz\n", argv[0]);
+        printf("说明：列表文件每行一个主机名，也支持hosts格式（0.0.0.0 www.xxx.com）和AdBlock域名规则（||www.xxx.com^），\n");
+        printf("      #和!开头为注释，.gz文件自动解压；列表中的IP/网段条目只计数，不写入集合。\n");
+        printf("      输出文件可被DomainSet::open()以mmap方式加载，所有进程共享同一份物理页。\n");
+        return -1;
+    }
+
+    DomainSetBuilder builder;
+    size_t invalid = 0;
+    string host;
+    auto addHost = [&](const char* p, size_t n)
+    {
+        host.assign(p, n);
+        if (!builder.add(host)) ++invalid;
+    };
+    policy::FeedLoader loader(nullptr, addHost);
+    for (int ii = 2; ii < argc; ++ii)
+    {
+        if (!loader.load(argv[ii]))
+        {
+            printf("❌ 读取列表文件失败：%s（%s）\n", argv[ii], loader.error().c_str());
+            return -1;
+        }
+    }
+
+    if (!builder.save(argv[1]))
+    {
+        printf("❌ 写入集合文件失败：%s\n", argv[1]);
+        return -1;
+    }
+
+    DomainSet set;
+    if (!set.open(argv[1]))
+    {
+        printf("❌ 校验集合文件失败：%s\n", argv[1]);
+        return -1;
+    }
+
+    const policy::FeedStats& st = loader.stats();
+    printf("✅ 构建完成：%s\n", argv[1]);
+    printf("列表统计：%s\n", st.toString().c_str());
+    printf("主机名条目数：%zu（非法：%zu），去重后：%zu\n", st.m_domains, invalid, set.size());
+    printf("文件大小：%zu字节（平均%.2f字节/主机名）\n", set.bytes(), set.size() ? (double)set.bytes() / set.size() : 0.0);
+    return 0;
+}
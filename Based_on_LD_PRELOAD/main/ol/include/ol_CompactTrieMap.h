@@ -0,0 +1,729 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_CompactTrieMap.h
+ * 功能描述：紧凑型Trie树（基数树）的键值对实现类，接口与TrieMap保持一致，支持以下特性：
+ *          - 所有节点存放在一个连续数组（arena）中，用32位下标代替shared_ptr，无引用计数、无逐节点堆分配
+ *          - 路径压缩：单分支路径合并为一条边，边上的字符串统一存放在一块字符arena中（节点只记录偏移和长度）
+ *          - 子节点按首字节有序排列（左孩子-右兄弟链表），查找时遇到更大的字节即可提前结束
+ *          - freeze()后转换为只读的双数组Trie（base/check），每层只需一次数组寻址，适合百万级域名集合的查询
+ * 作者：ol
+ * 适用标准：C++17及以上（需支持std::optional等特性）
+ */
+/****************************************************************************************/
+
+#ifndef OL_COMPACTTRIEMAP_H
+#define OL_COMPACTTRIEMAP_H 1
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ol
+{
+
+    /**
+     * @brief 紧凑型Trie树键值对映射类（CompactTrieMap）
+     * @tparam V 存储的值类型（需可默认构造）
+     * @note 1）可修改阶段：基数树，支持put/remove；
+     *       2）调用freeze()后：双数组Trie，只读，此时调用put/remove会抛出std::logic_error；
+     *       3）删除键后边上的旧字符串不会立即回收，freeze()时会重新整理字符arena。
+     */
+    template <typename V>
+    class CompactTrieMap
+    {
+    private:
+        static constexpr uint32_t NIL = 0xFFFFFFFF; // 空下标
+
+        // 基数树节点（20字节），冻结前后共用同一结构
+        struct Node
+        {
+            uint32_t labelOff = 0;  // 边上字符串在m_labels中的偏移
+            uint32_t labelLen = 0;  // 边上字符串的长度（根节点为0）
+            uint32_t child = NIL;   // 第一个子节点（子节点按首字节升序排列）
+            uint32_t sibling = NIL; // 下一个兄弟节点
+            uint32_t val = NIL;     // 值在m_vals中的下标，NIL表示该节点不是某个键的终点
+        };
+
+        std::vector<Node> m_nodes;         // 节点数组（冻结后下标即双数组的状态号）
+        std::vector<uint32_t> m_freeNodes; // 已删除节点的下标，供复用
+        std::string m_labels;              // 所有边上字符串的存储区
+        std::vector<V> m_vals;             // 值数组
+        std::vector<uint32_t> m_freeVals;  // 已删除值的下标，供复用
+        std::vector<uint32_t> m_base;      // 双数组的base（冻结后使用）
+        std::vector<uint32_t> m_check;     // 双数组的check（冻结后使用，NIL表示空闲）
+        uint32_t m_root = 0;               // 根节点下标
+        size_t m_count = 0;                // 当前存在的键值对总数
+        bool m_frozen = false;             // 是否已冻结
+
+        // 节点访问（冻结前后只有按字节找子节点的方式不同）
+        // ===========================================================================
+        /**
+         * @brief 查找首字节为c的子节点
+         * @param n 父节点
+         * @param c 子节点边上的首字节
+         * @return 子节点下标（不存在返回NIL）
+         */
+        uint32_t childOf(uint32_t n, unsigned char c) const
+        {
+            if (m_frozen)
+            {
+                size_t t = static_cast<size_t>(m_base[n]) + c;
+                return (t < m_check.size() && m_check[t] == n) ? static_cast<uint32_t>(t) : NIL;
+            }
+
+            for (uint32_t x = m_nodes[n].child; x != NIL; x = m_nodes[x].sibling)
+            {
+                unsigned char b = static_cast<unsigned char>(m_labels[m_nodes[x].labelOff]);
+                if (b == c) return x;
+                if (b > c) break; // 子节点有序，后面不会再匹配
+            }
+            return NIL;
+        }
+
+        // 边上字符串的首地址
+        const char* labelOf(uint32_t n) const
+        {
+            return m_labels.data() + m_nodes[n].labelOff;
+        }
+
+        /**
+         * @brief 沿key向下查找，定位key结束时所在的节点
+         * @param key 查找的键
+         * @param node 输出key结束时所在的节点（key的最后一个字符落在该节点的边上）
+         * @param rest 输出该节点的边上在key结束后还剩余的字符数（0表示key恰好在节点处结束）
+         * @return key能完整匹配到树中的某条路径返回true，否则返回false
+         */
+        bool locate(const std::string& key, uint32_t& node, size_t& rest) const
+        {
+            uint32_t n = m_root;
+            size_t i = 0;
+            rest = 0;
+
+            while (i < key.length())
+            {
+                uint32_t x = childOf(n, static_cast<unsigned char>(key[i]));
+                if (x == NIL) return false;
+
+                const char* label = labelOf(x);
+                size_t len = m_nodes[x].labelLen;
+                size_t k = 1; // 首字节已经匹配
+                while (k < len && i + k < key.length() && label[k] == key[i + k]) ++k;
+
+                if (k < len && i + k < key.length()) return false; // 边上出现不同字符
+
+                n = x;
+                i += k;
+                rest = len - k;
+            }
+
+            node = n;
+            return true;
+        }
+        // ===========================================================================
+
+        // 可修改阶段的内部操作
+        // ===========================================================================
+        // 分配一个新节点
+        uint32_t newNode(uint32_t off, uint32_t len)
+        {
+            uint32_t n;
+            if (!m_freeNodes.empty())
+            {
+                n = m_freeNodes.back();
+                m_freeNodes.pop_back();
+                m_nodes[n] = Node();
+            }
+            else
+            {
+                n = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
+            }
+            m_nodes[n].labelOff = off;
+            m_nodes[n].labelLen = len;
+            return n;
+        }
+
+        // 释放节点
+        void freeNode(uint32_t n)
+        {
+            m_nodes[n] = Node();
+            m_freeNodes.push_back(n);
+        }
+
+        // 把值写入节点（节点已有值时覆盖）
+        void setVal(uint32_t n, V&& val)
+        {
+            if (m_nodes[n].val != NIL)
+            {
+                m_vals[m_nodes[n].val] = std::move(val);
+                return;
+            }
+
+            uint32_t v;
+            if (!m_freeVals.empty())
+            {
+                v = m_freeVals.back();
+                m_freeVals.pop_back();
+                m_vals[v] = std::move(val);
+            }
+            else
+            {
+                v = static_cast<uint32_t>(m_vals.size());
+                m_vals.push_back(std::move(val));
+            }
+            m_nodes[n].val = v;
+            ++m_count;
+        }
+
+        /**
+         * @brief 把子节点按首字节有序插入父节点的子节点链表
+         * @param parent 父节点
+         * @param x 待插入的子节点
+         */
+        void linkChild(uint32_t parent, uint32_t x)
+        {
+            unsigned char c = static_cast<unsigned char>(m_labels[m_nodes[x].labelOff]);
+            uint32_t prev = NIL, cur = m_nodes[parent].child;
+            while (cur != NIL && static_cast<unsigned char>(m_labels[m_nodes[cur].labelOff]) < c)
+            {
+                prev = cur;
+                cur = m_nodes[cur].sibling;
+            }
+
+            m_nodes[x].sibling = cur;
+            if (prev == NIL)
+                m_nodes[parent].child = x;
+            else
+                m_nodes[prev].sibling = x;
+        }
+
+        // 把子节点从父节点的子节点链表中摘除
+        void unlinkChild(uint32_t parent, uint32_t x)
+        {
+            uint32_t prev = NIL, cur = m_nodes[parent].child;
+            while (cur != NIL && cur != x)
+            {
+                prev = cur;
+                cur = m_nodes[cur].sibling;
+            }
+            if (cur == NIL) return;
+
+            if (prev == NIL)
+                m_nodes[parent].child = m_nodes[x].sibling;
+            else
+                m_nodes[prev].sibling = m_nodes[x].sibling;
+        }
+
+        /**
+         * @brief 无值且只有一个子节点的节点与其子节点合并，恢复路径压缩
+         * @param n 待检查的节点（不能是根节点）
+         */
+        void mergeWithChild(uint32_t n)
+        {
+            uint32_t x = m_nodes[n].child;
+            if (m_nodes[n].val != NIL || x == NIL || m_nodes[x].sibling != NIL) return;
+
+            // 两段边上字符串在arena中不一定相邻，拼接后追加到末尾（旧字符串在freeze时回收）。
+            uint32_t off = static_cast<uint32_t>(m_labels.size());
+            m_labels.append(m_labels, m_nodes[n].labelOff, m_nodes[n].labelLen);
+            m_labels.append(m_labels, m_nodes[x].labelOff, m_nodes[x].labelLen);
+
+            m_nodes[n].labelOff = off;
+            m_nodes[n].labelLen += m_nodes[x].labelLen;
+            m_nodes[n].child = m_nodes[x].child;
+            m_nodes[n].val = m_nodes[x].val;
+            freeNode(x);
+        }
+
+        // 冻结前/冻结后禁止修改
+        void checkMutable() const
+        {
+            if (m_frozen) throw std::logic_error("CompactTrieMap is frozen");
+        }
+        // ===========================================================================
+
+        // 遍历
+        // ===========================================================================
+        /**
+         * @brief 遍历子树，收集所有有效键
+         * @param n 起始节点
+         * @param path 当前路径（已包含n边上的字符串）
+         * @param res 存储结果的列表
+         */
+        void traverse(uint32_t n, std::string& path, std::list<std::string>& res) const
+        {
+            if (m_nodes[n].val != NIL) res.push_back(path);
+
+            for (uint32_t x = m_nodes[n].child; x != NIL; x = m_nodes[x].sibling)
+            {
+                path.append(labelOf(x), m_nodes[x].labelLen);
+                traverse(x, path, res);
+                path.resize(path.size() - m_nodes[x].labelLen);
+            }
+        }
+
+        /**
+         * @brief 按模式匹配遍历（'.'匹配单个任意字符）
+         * @param n 当前节点
+         * @param path 当前匹配路径
+         * @param pattern 模式字符串
+         * @param i 当前匹配位置（n边上的字符串已匹配完）
+         * @param res 存储匹配结果的列表（为nullptr时只判断是否存在，找到一个即返回）
+         * @return 找到匹配的键返回true
+         */
+        bool traverseByPattern(uint32_t n, std::string& path, const std::string& pattern, size_t i,
+                               std::list<std::string>* res) const
+        {
+            if (i == pattern.length())
+            {
+                if (m_nodes[n].val == NIL) return false;
+                if (res != nullptr) res->push_back(path);
+                return true;
+            }
+
+            bool found = false;
+            for (uint32_t x = m_nodes[n].child; x != NIL; x = m_nodes[x].sibling)
+            {
+                const char* label = labelOf(x);
+                size_t len = m_nodes[x].labelLen;
+                if (i + len > pattern.length()) continue;
+
+                size_t k = 0;
+                while (k < len && (pattern[i + k] == '.' || pattern[i + k] == label[k])) ++k;
+                if (k < len) continue;
+
+                path.append(label, len);
+                found = traverseByPattern(x, path, pattern, i + len, res) || found;
+                path.resize(path.size() - len);
+
+                if (found && res == nullptr) return true;
+            }
+            return found;
+        }
+        // ===========================================================================
+
+    public:
+        // 构造函数，创建根节点
+        CompactTrieMap()
+        {
+            m_nodes.emplace_back();
+        }
+
+        /**
+         * @brief 插入或更新键值对
+         * @param key 键字符串
+         * @param val 对应的值
+         * @note 冻结后调用抛出std::logic_error
+         */
+        void put(const std::string& key, V val)
+        {
+            checkMutable();
+
+            uint32_t n = m_root;
+            size_t i = 0;
+            while (i < key.length())
+            {
+                uint32_t x = childOf(n, static_cast<unsigned char>(key[i]));
+                if (x == NIL)
+                {
+                    // 没有首字节相同的子节点，剩余部分整体作为一条新边。
+                    uint32_t off = static_cast<uint32_t>(m_labels.size());
+                    m_labels.append(key, i, std::string::npos);
+                    uint32_t leaf = newNode(off, static_cast<uint32_t>(key.length() - i));
+                    linkChild(n, leaf);
+                    n = leaf;
+                    break;
+                }
+
+                size_t len = m_nodes[x].labelLen;
+                size_t k = 1;
+                while (k < len && i + k < key.length() && m_labels[m_nodes[x].labelOff + k] == key[i + k]) ++k;
+
+                if (k < len)
+                {
+                    // 在边的第k个字符处分裂：x保留前半段，原有的子节点和值移到新节点。
+                    uint32_t low = newNode(m_nodes[x].labelOff + static_cast<uint32_t>(k), static_cast<uint32_t>(len - k));
+                    m_nodes[low].child = m_nodes[x].child;
+                    m_nodes[low].val = m_nodes[x].val;
+                    m_nodes[x].labelLen = static_cast<uint32_t>(k);
+                    m_nodes[x].child = low;
+                    m_nodes[x].val = NIL;
+                }
+
+                n = x;
+                i += k;
+            }
+
+            setVal(n, std::move(val));
+        }
+
+        /**
+         * @brief 删除键值对
+         * @param key 要删除的键
+         * @note 冻结后调用抛出std::logic_error
+         */
+        void remove(const std::string& key)
+        {
+            checkMutable();
+
+            // 记录路径上的节点，删除后自底向上整理。
+            std::vector<uint32_t> path{m_root};
+            size_t i = 0;
+            while (i < key.length())
+            {
+                uint32_t x = childOf(path.back(), static_cast<unsigned char>(key[i]));
+                if (x == NIL) return;
+
+                size_t len = m_nodes[x].labelLen;
+                if (key.compare(i, len, labelOf(x), len) != 0) return;
+
+                path.push_back(x);
+                i += len;
+            }
+
+            uint32_t n = path.back();
+            if (m_nodes[n].val == NIL) return;
+
+            m_vals[m_nodes[n].val] = V();
+            m_freeVals.push_back(m_nodes[n].val);
+            m_nodes[n].val = NIL;
+            --m_count;
+
+            if (n == m_root) return;
+
+            uint32_t parent = path[path.size() - 2];
+            if (m_nodes[n].child == NIL)
+            {
+                // 叶子节点直接摘除，父节点可能因此只剩一个子节点。
+                unlinkChild(parent, n);
+                freeNode(n);
+                if (parent != m_root) mergeWithChild(parent);
+            }
+            else
+            {
+                mergeWithChild(n);
+            }
+        }
+
+        /**
+         * @brief 获取键对应的值
+         * @param key 要查询的键
+         * @return 若键存在，返回包含对应值的std::optional<V>；若键不存在，返回std::nullopt
+         */
+        std::optional<V> get(const std::string& key) const
+        {
+            uint32_t n;
+            size_t rest;
+            if (locate(key, n, rest) && rest == 0 && m_nodes[n].val != NIL) return m_vals[m_nodes[n].val];
+            return std::nullopt;
+        }
+
+        /**
+         * @brief 检查键是否存在
+         * @param key 要检查的键
+         * @return 键存在返回true，否则返回false
+         */
+        bool has(const std::string& key) const
+        {
+            uint32_t n;
+            size_t rest;
+            return locate(key, n, rest) && rest == 0 && m_nodes[n].val != NIL;
+        }
+
+        /**
+         * @brief 检查是否存在以指定前缀开头的键
+         * @param prefix 前缀字符串
+         * @return 存在返回true，否则返回false
+         */
+        bool hasPrefix(const std::string& prefix) const
+        {
+            uint32_t n;
+            size_t rest;
+            return locate(prefix, n, rest);
+        }
+
+        /**
+         * @brief 查找查询字符串的最短前缀键
+         * @param query 查询字符串
+         * @return 最短前缀键（不存在返回空串）
+         */
+        std::string shortestPrefix(const std::string& query) const
+        {
+            uint32_t n = m_root;
+            size_t i = 0;
+            while (true)
+            {
+                if (m_nodes[n].val != NIL) return query.substr(0, i);
+                if (i == query.length()) break;
+
+                uint32_t x = childOf(n, static_cast<unsigned char>(query[i]));
+                if (x == NIL) break;
+
+                size_t len = m_nodes[x].labelLen;
+                if (query.compare(i, len, labelOf(x), len) != 0) break;
+
+                n = x;
+                i += len;
+            }
+            return "";
+        }
+
+        /**
+         * @brief 查找查询字符串的最长前缀键
+         * @param query 查询字符串
+         * @return 最长前缀键（不存在返回空串）
+         */
+        std::string longestPrefix(const std::string& query) const
+        {
+            uint32_t n = m_root;
+            size_t i = 0, maxLen = 0;
+            while (true)
+            {
+                if (m_nodes[n].val != NIL) maxLen = i;
+                if (i == query.length()) break;
+
+                uint32_t x = childOf(n, static_cast<unsigned char>(query[i]));
+                if (x == NIL) break;
+
+                size_t len = m_nodes[x].labelLen;
+                if (query.compare(i, len, labelOf(x), len) != 0) break;
+
+                n = x;
+                i += len;
+            }
+            return query.substr(0, maxLen);
+        }
+
+        /**
+         * @brief 获取所有以指定前缀开头的键
+         * @param prefix 前缀字符串
+         * @return 匹配的键列表（按字节序排列）
+         */
+        std::list<std::string> keysByPrefix(const std::string& prefix) const
+        {
+            std::list<std::string> res;
+            uint32_t n;
+            size_t rest;
+            if (!locate(prefix, n, rest)) return res;
+
+            // 前缀可能落在边的中间，补齐该边剩余的字符。
+            std::string path = prefix;
+            path.append(labelOf(n) + m_nodes[n].labelLen - rest, rest);
+            traverse(n, path, res);
+            return res;
+        }
+
+        /**
+         * @brief 获取所有匹配模式的键（支持'.'作为通配符，匹配单个任意字符）
+         * @param pattern 模式字符串
+         * @return 匹配的键列表
+         */
+        std::list<std::string> keysByPattern(const std::string& pattern) const
+        {
+            std::list<std::string> res;
+            std::string path;
+            traverseByPattern(m_root, path, pattern, 0, &res);
+            return res;
+        }
+
+        /**
+         * @brief 检查是否存在匹配模式的键（支持'.'作为通配符，匹配单个任意字符）
+         * @param pattern 模式字符串
+         * @return 存在返回true，否则返回false
+         */
+        bool hasPattern(const std::string& pattern) const
+        {
+            std::string path;
+            return traverseByPattern(m_root, path, pattern, 0, nullptr);
+        }
+
+        /**
+         * @brief 获取当前键值对的数量
+         * @return 键值对数量
+         */
+        size_t size() const
+        {
+            return m_count;
+        }
+
+        /**
+         * @brief 判断是否已冻结
+         * @return true-已冻结（只读），false-可修改
+         */
+        bool frozen() const
+        {
+            return m_frozen;
+        }
+
+        /**
+         * @brief 估算占用的内存（字节，不含V内部的堆内存）
+         * @return 内存字节数
+         */
+        size_t memoryUsage() const
+        {
+            return m_nodes.capacity() * sizeof(Node) + m_freeNodes.capacity() * sizeof(uint32_t) +
+                   m_labels.capacity() + m_vals.capacity() * sizeof(V) + m_freeVals.capacity() * sizeof(uint32_t) +
+                   (m_base.capacity() + m_check.capacity()) * sizeof(uint32_t);
+        }
+
+        /**
+         * @brief 冻结为只读的双数组Trie
+         * @note 1）按广度优先为每个节点分配base，使其所有子节点的状态号base+首字节互不冲突（check记录父状态）；
+         *       2）同时重新整理字符arena和值数组，去掉删除操作留下的空洞；
+         *       3）冻结后查询时每层只需一次数组寻址，不再遍历兄弟链表；重复调用无副作用。
+         */
+        void freeze()
+        {
+            if (m_frozen) return;
+
+            std::vector<Node> nodes(1);
+            std::vector<uint32_t> base(1, 0), check(1, NIL); // 状态0为根，check为NIL的其它状态为空闲
+            std::string labels;
+            std::vector<V> vals;
+            labels.reserve(m_labels.size());
+            vals.reserve(m_count);
+
+            if (m_nodes[m_root].val != NIL)
+            {
+                nodes[0].val = 0;
+                vals.push_back(std::move(m_vals[m_nodes[m_root].val]));
+            }
+
+            std::vector<std::pair<uint32_t, uint32_t>> queue{{m_root, 0}}; // （旧节点，新状态）
+            std::vector<unsigned char> bytes;
+
+            // 空闲状态按下标顺序串成双向链表，查找base时只尝试空闲位置，避免逐个扫描已占用的区域。
+            // 多次作为首字节位置都失败的空闲状态移出链表（仍可被其它字节占用），避免反复尝试难以填满的空洞。
+            std::vector<uint32_t> nextFree(1, NIL), prevFree(1, NIL);
+            std::vector<uint8_t> fails(1, 0xFF); // 失败次数，0xFF表示不在链表中
+            uint32_t freeHead = NIL, freeTail = NIL;
+
+            auto grow = [&](size_t need)
+            {
+                for (size_t t = check.size(); t < need; ++t)
+                {
+                    nextFree.push_back(NIL);
+                    prevFree.push_back(freeTail);
+                    fails.push_back(0);
+                    if (freeTail == NIL)
+                        freeHead = static_cast<uint32_t>(t);
+                    else
+                        nextFree[freeTail] = static_cast<uint32_t>(t);
+                    freeTail = static_cast<uint32_t>(t);
+                }
+                base.resize(need, 0);
+                check.resize(need, NIL);
+                nodes.resize(need);
+            };
+
+            auto take = [&](uint32_t t)
+            {
+                if (fails[t] == 0xFF) return;
+                fails[t] = 0xFF;
+
+                if (prevFree[t] == NIL)
+                    freeHead = nextFree[t];
+                else
+                    nextFree[prevFree[t]] = nextFree[t];
+                if (nextFree[t] == NIL)
+                    freeTail = prevFree[t];
+                else
+                    prevFree[nextFree[t]] = prevFree[t];
+            };
+
+            for (size_t qi = 0; qi < queue.size(); ++qi)
+            {
+                auto [old, s] = queue[qi];
+
+                bytes.clear();
+                for (uint32_t x = m_nodes[old].child; x != NIL; x = m_nodes[x].sibling)
+                    bytes.push_back(static_cast<unsigned char>(m_labels[m_nodes[x].labelOff]));
+                if (bytes.empty()) continue;
+
+                // 首次适配：让首字节落在某个空闲位置上，检查其余字节是否也空闲（base至少为1，子状态不会是根）。
+                // 尝试次数有上限，失败时直接放到数组末尾，保证冻结时间与节点数近似线性。
+                uint32_t b = NIL;
+                int tries = 0;
+                for (uint32_t f = freeHead, nf; f != NIL && tries < 256; f = nf)
+                {
+                    nf = nextFree[f];
+                    if (f <= bytes[0]) continue;
+                    ++tries;
+
+                    uint32_t cand = f - bytes[0];
+                    bool ok = true;
+                    for (size_t ii = 1; ii < bytes.size(); ++ii)
+                    {
+                        size_t t = static_cast<size_t>(cand) + bytes[ii];
+                        if (t < check.size() && (t == 0 || check[t] != NIL))
+                        {
+                            ok = false;
+                            break;
+                        }
+                    }
+                    if (ok)
+                    {
+                        b = cand;
+                        break;
+                    }
+                    if (++fails[f] >= 16) take(f);
+                }
+                if (b == NIL) b = static_cast<uint32_t>(std::max(check.size(), static_cast<size_t>(bytes[0]) + 1) - bytes[0]);
+
+                size_t need = static_cast<size_t>(b) + bytes.back() + 1;
+                if (need > check.size()) grow(need);
+                base[s] = b;
+
+                // 为子节点分配状态，并保持左孩子-右兄弟链表（供遍历使用）。
+                uint32_t prev = NIL;
+                for (uint32_t x = m_nodes[old].child; x != NIL; x = m_nodes[x].sibling)
+                {
+                    uint32_t t = b + static_cast<unsigned char>(m_labels[m_nodes[x].labelOff]);
+                    take(t);
+                    check[t] = s;
+
+                    Node& nd = nodes[t];
+                    nd.labelOff = static_cast<uint32_t>(labels.size());
+                    nd.labelLen = m_nodes[x].labelLen;
+                    labels.append(m_labels, m_nodes[x].labelOff, m_nodes[x].labelLen);
+                    if (m_nodes[x].val != NIL)
+                    {
+                        nd.val = static_cast<uint32_t>(vals.size());
+                        vals.push_back(std::move(m_vals[m_nodes[x].val]));
+                    }
+
+                    if (prev == NIL)
+                        nodes[s].child = t;
+                    else
+                        nodes[prev].sibling = t;
+                    prev = t;
+
+                    queue.emplace_back(x, t);
+                }
+            }
+
+            m_nodes.swap(nodes);
+            m_labels.swap(labels);
+            m_vals.swap(vals);
+            m_base.swap(base);
+            m_check.swap(check);
+            m_freeNodes = std::vector<uint32_t>();
+            m_freeVals = std::vector<uint32_t>();
+            m_nodes.shrink_to_fit();
+            m_labels.shrink_to_fit();
+            m_vals.shrink_to_fit();
+            m_base.shrink_to_fit();
+            m_check.shrink_to_fit();
+            m_root = 0;
+            m_frozen = true;
+        }
+    };
+
+} // namespace ol
+
+#endif // !OL_COMPACTTRIEMAP_H
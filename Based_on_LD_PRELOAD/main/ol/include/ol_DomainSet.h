@@ -0,0 +1,600 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_DomainSet.h
+ * 功能描述：只读的简洁（succinct）域名集合，面向数百万条目的主机名黑名单，支持以下特性：
+ *          - 离线构建：DomainSetBuilder把主机名按标签倒序（www.example.com → com.example.www）排序后，
+ *            按层序编码为LOUDS-Sparse字典树（每条边1字节标签+3个比特，外加约1/8的rank/select索引）
+ *          - 支持精确查询（has）和后缀查询（hasSuffix：主机名本身或其任一上级域名在集合中）
+ *          - 序列化格式自带全部索引，可直接mmap使用，所有被注入进程共享同一份物理页，无需各自重建
+ *          - 与TrieSet/CompactTrieSet互补：后两者可修改，本类只读但体积最小
+ * 作者：ol
+ * 适用标准：C++17及以上（save()依赖ol_fstream.h中的cofile，mmap仅支持Linux平台）
+ */
+/****************************************************************************************/
+
+#ifndef OL_DOMAINSET_H
+#define OL_DOMAINSET_H 1
+
+#include "ol_fstream.h"
+#include "ol_type_traits.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace ol
+{
+
+    namespace base
+    {
+        // 文件头（所有偏移相对文件起始位置，各段按8字节对齐）
+        struct st_dsethead
+        {
+            char m_magic[8];           // 魔数"OLDSET01"
+            uint64_t m_fileSize;       // 文件总大小（字节）
+            uint64_t m_keys;           // 主机名数量
+            uint64_t m_edges;          // 边数（每条边一个标签字节）
+            uint64_t m_nodes;          // 节点数（含根节点）
+            uint64_t m_labelsOff;      // 标签数组
+            uint64_t m_hasChildOff;    // hasChild位图（边指向内部节点）
+            uint64_t m_loudsOff;       // louds位图（边是所在节点的第一条边）
+            uint64_t m_isKeyOff;       // isKey位图（到该边为止是一个完整的键）
+            uint64_t m_hasChildRankOff; // hasChild的rank索引
+            uint64_t m_loudsRankOff;   // louds的rank索引
+            uint64_t m_loudsSelOff;    // louds的select采样
+            uint64_t m_loudsSelCnt;    // select采样个数
+        };
+
+        static constexpr char DSET_MAGIC[8] = {'O', 'L', 'D', 'S', 'E', 'T', '0', '1'};
+        static constexpr uint64_t DSET_RANK_BLOCK = 512; // rank索引的块大小（比特）
+        static constexpr uint64_t DSET_SEL_SAMPLE = 64; // select每隔多少个1采样一次（节点首边较稀疏，采样密一些以缩短扫描）
+
+        /**
+         * @brief 只读位图视图（指向序列化数据，不拥有内存）
+         * @note rank索引每512比特记录一次之前1的个数；select索引每64个1记录一次位置
+         */
+        struct bitsview
+        {
+            const uint64_t* m_words = nullptr; // 位图数据
+            const uint32_t* m_rank = nullptr;  // rank索引
+            const uint32_t* m_sel = nullptr;   // select采样（可为空）
+
+            // 第i位是否为1
+            bool get(uint64_t i) const
+            {
+                return (m_words[i >> 6] >> (i & 63)) & 1;
+            }
+
+            // [0, i)中1的个数
+            uint64_t rank1(uint64_t i) const
+            {
+                uint64_t block = i / DSET_RANK_BLOCK;
+                uint64_t r = m_rank[block];
+                for (uint64_t w = block * (DSET_RANK_BLOCK / 64); w < (i >> 6); ++w)
+                    r += static_cast<uint64_t>(__builtin_popcountll(m_words[w]));
+                if (i & 63) r += static_cast<uint64_t>(__builtin_popcountll(m_words[i >> 6] & ((1ULL << (i & 63)) - 1)));
+                return r;
+            }
+
+            // 第k个1（从0开始）的位置
+            uint64_t select1(uint64_t k) const
+            {
+                uint64_t wi = m_sel[k / DSET_SEL_SAMPLE] >> 6;
+                uint64_t r = rank1(wi << 6);
+                while (true)
+                {
+                    uint64_t c = static_cast<uint64_t>(__builtin_popcountll(m_words[wi]));
+                    if (r + c > k) break;
+                    r += c;
+                    ++wi;
+                }
+
+                uint64_t x = m_words[wi];
+                for (uint64_t j = r; j < k; ++j) x &= x - 1; // 去掉前面的1
+                return (wi << 6) + static_cast<uint64_t>(__builtin_ctzll(x));
+            }
+
+            // 从位置i（含）开始的下一个1的位置，不存在返回nbits
+            uint64_t next1(uint64_t i, uint64_t nbits) const
+            {
+                if (i >= nbits) return nbits;
+
+                uint64_t wi = i >> 6;
+                uint64_t x = m_words[wi] & (~0ULL << (i & 63));
+                uint64_t nwords = (nbits + 63) >> 6;
+                while (x == 0)
+                {
+                    if (++wi >= nwords) return nbits;
+                    x = m_words[wi];
+                }
+                uint64_t pos = (wi << 6) + static_cast<uint64_t>(__builtin_ctzll(x));
+                return pos < nbits ? pos : nbits;
+            }
+
+            /**
+             * @brief 校验rank索引（及select采样）与位图一致（加载文件时调用，O(位图字数)）
+             * @param nbits 位数
+             * @param selCnt select采样个数（m_sel为空时忽略）
+             * @param ones 输出：1的个数
+             * @return 一致返回true；末字中超出nbits的位必须为0
+             */
+            bool check(uint64_t nbits, uint64_t selCnt, uint64_t& ones) const
+            {
+                uint64_t nwords = (nbits + 63) >> 6;
+                if ((nbits & 63) && (m_words[nwords - 1] >> (nbits & 63)) != 0) return false;
+
+                ones = 0;
+                for (uint64_t w = 0; w < nwords; ++w)
+                {
+                    if (w % (DSET_RANK_BLOCK / 64) == 0 && m_rank[w / (DSET_RANK_BLOCK / 64)] != ones) return false;
+                    ones += static_cast<uint64_t>(__builtin_popcountll(m_words[w]));
+                }
+                if (nwords % (DSET_RANK_BLOCK / 64) == 0 && nwords / (DSET_RANK_BLOCK / 64) <= nbits / DSET_RANK_BLOCK &&
+                    m_rank[nwords / (DSET_RANK_BLOCK / 64)] != ones)
+                    return false; // 末块之后的rank项只在nbits正好是块大小的整数倍时存在
+
+                if (m_sel == nullptr) return true;
+                if (selCnt != (ones + DSET_SEL_SAMPLE - 1) / DSET_SEL_SAMPLE) return false;
+                for (uint64_t j = 0; j < selCnt; ++j)
+                {
+                    uint64_t pos = m_sel[j];
+                    if (pos >= nbits || !get(pos) || rank1(pos) != j * DSET_SEL_SAMPLE) return false;
+                }
+                return true;
+            }
+        };
+    } // namespace base
+
+    /**
+     * @brief 域名集合构建器（离线使用）
+     * @note 主机名规范化：转小写，去掉首尾空白、末尾的'.'和开头的"*."或'.'，再按标签倒序
+     */
+    class DomainSetBuilder
+    {
+    private:
+        std::vector<std::string> m_keys; // 已规范化（标签倒序）的主机名
+
+        // 把位图和rank/select索引追加到输出缓冲区
+        static void appendWords(std::string& out, const std::vector<uint64_t>& words)
+        {
+            out.append(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t));
+        }
+
+        static void appendRank(std::string& out, const std::vector<uint64_t>& words, uint64_t nbits)
+        {
+            uint64_t nblocks = nbits / base::DSET_RANK_BLOCK + 1;
+            std::vector<uint32_t> rank(nblocks + (nblocks & 1), 0); // 补齐到8字节
+            uint64_t r = 0;
+            for (uint64_t b = 0; b < nblocks; ++b)
+            {
+                rank[b] = static_cast<uint32_t>(r);
+                for (uint64_t w = b * (base::DSET_RANK_BLOCK / 64); w < (b + 1) * (base::DSET_RANK_BLOCK / 64) && w < words.size(); ++w)
+                    r += static_cast<uint64_t>(__builtin_popcountll(words[w]));
+            }
+            out.append(reinterpret_cast<const char*>(rank.data()), rank.size() * sizeof(uint32_t));
+        }
+
+        static uint64_t appendSelect(std::string& out, const std::vector<uint64_t>& words, uint64_t nbits)
+        {
+            std::vector<uint32_t> sel;
+            uint64_t ones = 0;
+            for (uint64_t i = 0; i < nbits; ++i)
+            {
+                if ((words[i >> 6] >> (i & 63)) & 1)
+                {
+                    if (ones % base::DSET_SEL_SAMPLE == 0) sel.push_back(static_cast<uint32_t>(i));
+                    ++ones;
+                }
+            }
+            uint64_t cnt = sel.size();
+            if (sel.size() & 1) sel.push_back(0); // 补齐到8字节
+            out.append(reinterpret_cast<const char*>(sel.data()), sel.size() * sizeof(uint32_t));
+            return cnt;
+        }
+
+    public:
+        /**
+         * @brief 规范化主机名并按标签倒序
+         * @param host 主机名（如www.Example.com.）
+         * @return 倒序后的键（如com.example.www），主机名非法时返回空串
+         */
+        static std::string normalize(const std::string& host)
+        {
+            size_t b = 0, e = host.length();
+            while (b < e && isspace(static_cast<unsigned char>(host[b]))) ++b;
+            while (e > b && isspace(static_cast<unsigned char>(host[e - 1]))) --e;
+            if (e - b >= 2 && host[b] == '*' && host[b + 1] == '.') b += 2;
+            while (b < e && host[b] == '.') ++b;
+            while (e > b && host[e - 1] == '.') --e;
+            if (b == e) return "";
+
+            std::string key;
+            key.reserve(e - b);
+            size_t end = e;
+            for (size_t i = e; i-- > b;)
+            {
+                if (host[i] != '.' && i != b) continue;
+
+                size_t start = (host[i] == '.') ? i + 1 : i;
+                if (start == end) return ""; // 空标签（如a..b）
+                if (!key.empty()) key += '.';
+                for (size_t j = start; j < end; ++j)
+                {
+                    unsigned char c = static_cast<unsigned char>(host[j]);
+                    if (c <= ' ' || c >= 0x7F) return ""; // 主机名只允许可见ASCII字符
+                    key += static_cast<char>((c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c);
+                }
+                end = i;
+            }
+            return key;
+        }
+
+        /**
+         * @brief 添加一个主机名
+         * @param host 主机名
+         * @return true-成功，false-主机名非法
+         */
+        bool add(const std::string& host)
+        {
+            std::string key = normalize(host);
+            if (key.empty()) return false;
+            m_keys.push_back(std::move(key));
+            return true;
+        }
+
+        // 已添加的主机名数量（含重复）
+        size_t size() const
+        {
+            return m_keys.size();
+        }
+
+        /**
+         * @brief 构建序列化数据（可直接交给DomainSet::load()或写入文件后mmap）
+         * @return 序列化数据
+         * @note 1）排序去重后按层序（广度优先）遍历字节级字典树，每个节点的边按标签升序输出；
+         *       2）第k个内部节点（根为0）的第一条边是louds中第k个1，边pos的子节点编号为hasChild在[0,pos]中1的个数。
+         */
+        std::string build()
+        {
+            std::sort(m_keys.begin(), m_keys.end());
+            m_keys.erase(std::unique(m_keys.begin(), m_keys.end()), m_keys.end());
+
+            std::string labels;
+            std::vector<uint64_t> hasChild, louds, isKey;
+            auto setbit = [](std::vector<uint64_t>& v, uint64_t i)
+            {
+                if ((i >> 6) >= v.size()) v.resize((i >> 6) + 1, 0);
+                v[i >> 6] |= 1ULL << (i & 63);
+            };
+
+            // 节点用（键区间，深度）表示：区间内的键前depth个字节相同，且都比depth长。
+            struct range
+            {
+                size_t lo, hi, depth;
+            };
+            std::vector<range> queue;
+            if (!m_keys.empty()) queue.push_back({0, m_keys.size(), 0});
+
+            uint64_t edges = 0;
+            for (size_t qi = 0; qi < queue.size(); ++qi)
+            {
+                range r = queue[qi];
+                bool first = true;
+                for (size_t i = r.lo; i < r.hi;)
+                {
+                    unsigned char c = static_cast<unsigned char>(m_keys[i][r.depth]);
+                    size_t j = i;
+                    while (j < r.hi && static_cast<unsigned char>(m_keys[j][r.depth]) == c) ++j;
+
+                    labels += static_cast<char>(c);
+                    if (first) setbit(louds, edges);
+                    first = false;
+
+                    // 有序，长度恰好为depth+1的键一定在组内第一个。
+                    size_t lo = i;
+                    if (m_keys[i].length() == r.depth + 1)
+                    {
+                        setbit(isKey, edges);
+                        ++lo;
+                    }
+                    if (lo < j)
+                    {
+                        setbit(hasChild, edges);
+                        queue.push_back({lo, j, r.depth + 1});
+                    }
+
+                    ++edges;
+                    i = j;
+                }
+            }
+
+            uint64_t nwords = (edges + 63) / 64;
+            hasChild.resize(nwords, 0);
+            louds.resize(nwords, 0);
+            isKey.resize(nwords, 0);
+
+            base::st_dsethead head;
+            memset(&head, 0, sizeof(head));
+            memcpy(head.m_magic, base::DSET_MAGIC, sizeof(head.m_magic));
+            head.m_keys = m_keys.size();
+            head.m_edges = edges;
+            head.m_nodes = queue.size();
+
+            std::string out(sizeof(head), '\0');
+            auto align8 = [&out]()
+            {
+                out.resize((out.size() + 7) & ~static_cast<size_t>(7), '\0');
+            };
+
+            head.m_labelsOff = out.size();
+            out += labels;
+            align8();
+            head.m_hasChildOff = out.size();
+            appendWords(out, hasChild);
+            head.m_loudsOff = out.size();
+            appendWords(out, louds);
+            head.m_isKeyOff = out.size();
+            appendWords(out, isKey);
+            head.m_hasChildRankOff = out.size();
+            appendRank(out, hasChild, edges);
+            head.m_loudsRankOff = out.size();
+            appendRank(out, louds, edges);
+            head.m_loudsSelOff = out.size();
+            head.m_loudsSelCnt = appendSelect(out, louds, edges);
+            head.m_fileSize = out.size();
+
+            memcpy(&out[0], &head, sizeof(head));
+            return out;
+        }
+
+        /**
+         * @brief 构建并写入文件（先写临时文件再改名，正在mmap旧文件的进程不受影响）
+         * @param filename 输出文件名
+         * @return true-成功，false-失败
+         */
+        bool save(const std::string& filename)
+        {
+            std::string data = build();
+
+            cofile ofile;
+            if (!ofile.open(filename, true, std::ios::out | std::ios::binary)) return false;
+            if (!ofile.write(&data[0], data.size())) return false;
+            return ofile.closeandrename();
+        }
+    };
+
+    /**
+     * @brief 只读的简洁域名集合
+     * @note 1）数据来源可以是DomainSetBuilder::build()的结果（拷贝一份），也可以是mmap的文件（多进程共享）；
+     *       2）查询只读，多线程并发查询安全。
+     */
+    class DomainSet : public TypeNonCopyableMovable
+    {
+    private:
+        std::string m_own;              // load()时持有的数据
+        const char* m_data = nullptr;   // 数据起始地址
+        size_t m_mapLen = 0;            // mmap的长度（0表示未mmap）
+        const base::st_dsethead* m_head = nullptr; // 文件头
+        const unsigned char* m_labels = nullptr;   // 标签数组
+        base::bitsview m_hasChild, m_louds, m_isKey; // 位图
+
+        /**
+         * @brief 校验并解析数据
+         * @param data 数据起始地址（8字节对齐）
+         * @param len 数据长度
+         * @return true-成功，false-数据非法
+         * @note 每一段都校验起点+长度不超出数据、按元素大小对齐，并核对rank/select索引，
+         *       截断或损坏的文件返回false，查询时不会越界读
+         */
+        bool parse(const char* data, size_t len)
+        {
+            if (len < sizeof(base::st_dsethead) || (reinterpret_cast<uintptr_t>(data) & 7) != 0) return false;
+
+            const base::st_dsethead* head = reinterpret_cast<const base::st_dsethead*>(data);
+            if (memcmp(head->m_magic, base::DSET_MAGIC, sizeof(head->m_magic)) != 0 || head->m_fileSize != len) return false;
+
+            // 各段长度由边数推出（与DomainSetBuilder::build()的写法一致），先限制边数和采样数以免相乘溢出
+            uint64_t edges = head->m_edges;
+            if (edges > len || head->m_loudsSelCnt > len / sizeof(uint32_t)) return false;
+            uint64_t wordsBytes = (edges + 63) / 64 * sizeof(uint64_t);
+            uint64_t rankBytes = (edges / base::DSET_RANK_BLOCK + 1) * sizeof(uint32_t);
+            uint64_t selBytes = head->m_loudsSelCnt * sizeof(uint32_t);
+
+            auto fits = [len](uint64_t off, uint64_t bytes, uint64_t align)
+            {
+                return off % align == 0 && off <= len && bytes <= len - off;
+            };
+            if (!fits(head->m_labelsOff, edges, 1) ||
+                !fits(head->m_hasChildOff, wordsBytes, sizeof(uint64_t)) ||
+                !fits(head->m_loudsOff, wordsBytes, sizeof(uint64_t)) ||
+                !fits(head->m_isKeyOff, wordsBytes, sizeof(uint64_t)) ||
+                !fits(head->m_hasChildRankOff, rankBytes, sizeof(uint32_t)) ||
+                !fits(head->m_loudsRankOff, rankBytes, sizeof(uint32_t)) ||
+                !fits(head->m_loudsSelOff, selBytes, sizeof(uint32_t)))
+                return false;
+
+            base::bitsview hasChild, louds, isKey;
+            hasChild.m_words = reinterpret_cast<const uint64_t*>(data + head->m_hasChildOff);
+            hasChild.m_rank = reinterpret_cast<const uint32_t*>(data + head->m_hasChildRankOff);
+            louds.m_words = reinterpret_cast<const uint64_t*>(data + head->m_loudsOff);
+            louds.m_rank = reinterpret_cast<const uint32_t*>(data + head->m_loudsRankOff);
+            louds.m_sel = reinterpret_cast<const uint32_t*>(data + head->m_loudsSelOff);
+            isKey.m_words = reinterpret_cast<const uint64_t*>(data + head->m_isKeyOff);
+
+            // 索引与位图一致；每个有边的节点（m_nodes个，含根节点）恰好对应louds中的一个1，
+            // 除根节点外都由一条hasChild边指向，第0条边是根节点的首边
+            uint64_t childOnes = 0, loudsOnes = 0;
+            if (!hasChild.check(edges, 0, childOnes) || !louds.check(edges, head->m_loudsSelCnt, loudsOnes)) return false;
+            if (loudsOnes != head->m_nodes || (edges > 0 && (loudsOnes != childOnes + 1 || !louds.get(0)))) return false;
+
+            m_data = data;
+            m_head = head;
+            m_labels = reinterpret_cast<const unsigned char*>(data + head->m_labelsOff);
+            m_hasChild = hasChild;
+            m_louds = louds;
+            m_isKey = isKey;
+            return true;
+        }
+
+        /**
+         * @brief 在节点中查找标签
+         * @param node 节点编号
+         * @param c 标签字节
+         * @return 边的位置，不存在返回m_edges
+         */
+        uint64_t findEdge(uint64_t node, unsigned char c) const
+        {
+            uint64_t edges = m_head->m_edges;
+            uint64_t start = (node == 0) ? 0 : m_louds.select1(node);
+            uint64_t end = m_louds.next1(start + 1, edges);
+
+            // 标签有序，二分查找（大多数节点只有几条边）。
+            const unsigned char* p = std::lower_bound(m_labels + start, m_labels + end, c);
+            if (p == m_labels + end || *p != c) return edges;
+            return static_cast<uint64_t>(p - m_labels);
+        }
+
+        /**
+         * @brief 沿倒序键向下查找
+         * @param key 倒序键
+         * @param suffix 是否后缀查询（途中在标签边界遇到完整的键即命中）
+         * @return 命中返回true
+         */
+        bool lookup(const std::string& key, bool suffix) const
+        {
+            if (m_head == nullptr || m_head->m_edges == 0 || key.empty()) return false;
+
+            uint64_t node = 0;
+            for (size_t i = 0; i < key.length(); ++i)
+            {
+                uint64_t pos = findEdge(node, static_cast<unsigned char>(key[i]));
+                if (pos == m_head->m_edges) return false;
+
+                bool last = (i + 1 == key.length());
+                if (m_isKey.get(pos) && (last || (suffix && key[i + 1] == '.'))) return true;
+                if (last || !m_hasChild.get(pos)) return false;
+
+                node = m_hasChild.rank1(pos + 1);
+            }
+            return false;
+        }
+
+    public:
+        DomainSet() = default;
+
+        // 持有mmap映射或数据副本，复制会导致重复munmap
+        DomainSet(const DomainSet&) = delete;
+        DomainSet& operator=(const DomainSet&) = delete;
+
+        /**
+         * @brief 加载序列化数据（拷贝一份，适合刚构建完直接使用）
+         * @param data DomainSetBuilder::build()的结果
+         * @return true-成功，false-数据非法
+         */
+        bool load(std::string data)
+        {
+            close();
+            m_own = std::move(data);
+            if (parse(m_own.data(), m_own.size())) return true;
+            close();
+            return false;
+        }
+
+#ifdef __linux__
+        /**
+         * @brief 以只读方式mmap集合文件（多个进程映射同一文件时共享物理页）
+         * @param filename 文件名
+         * @return true-成功，false-失败
+         */
+        bool open(const std::string& filename)
+        {
+            close();
+
+            int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return false;
+
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size <= 0)
+            {
+                ::close(fd);
+                return false;
+            }
+
+            void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (addr == MAP_FAILED) return false;
+
+            size_t len = static_cast<size_t>(st.st_size);
+            if (!parse(static_cast<const char*>(addr), len))
+            {
+                munmap(addr, len); // parse失败时m_data仍为空，close()解除不了这段映射
+                return false;
+            }
+            m_mapLen = len;
+            return true;
+        }
+#endif // __linux__
+
+        /**
+         * @brief 判断主机名是否在集合中（精确匹配，忽略大小写）
+         * @param host 主机名
+         * @return 存在返回true
+         */
+        bool has(const std::string& host) const
+        {
+            return lookup(DomainSetBuilder::normalize(host), false);
+        }
+
+        /**
+         * @brief 判断主机名本身或其任一上级域名是否在集合中（如集合含example.com时，a.b.example.com命中）
+         * @param host 主机名
+         * @return 命中返回true
+         */
+        bool hasSuffix(const std::string& host) const
+        {
+            return lookup(DomainSetBuilder::normalize(host), true);
+        }
+
+        // 主机名数量
+        size_t size() const
+        {
+            return m_head ? static_cast<size_t>(m_head->m_keys) : 0;
+        }
+
+        // 数据大小（字节）
+        size_t bytes() const
+        {
+            return m_head ? static_cast<size_t>(m_head->m_fileSize) : 0;
+        }
+
+        // 释放数据（解除mmap）
+        void close()
+        {
+#ifdef __linux__
+            if (m_mapLen > 0) munmap(const_cast<char*>(m_data), m_mapLen);
+#endif // __linux__
+            m_mapLen = 0;
+            m_own.clear();
+            m_data = nullptr;
+            m_head = nullptr;
+            m_labels = nullptr;
+            m_hasChild = m_louds = m_isKey = base::bitsview();
+        }
+
+        ~DomainSet()
+        {
+            close();
+        }
+    };
+
+} // namespace ol
+
+#endif // !OL_DOMAINSET_H
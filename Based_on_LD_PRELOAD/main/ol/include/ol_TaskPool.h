@@ -0,0 +1,1660 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_TaskPool.h
+ * 功能描述：扩展线程池模板类的实现（接口与ThreadPool兼容），支持以下特性：
+ *          - 双模式支持：固定线程数模式（默认）和动态扩缩容模式（通过模板参数控制）
+ *          - 任务管理：支持无返回值任务（addTask）和带返回值任务（submitTask）
+ *          - 批量提交：addTasks/submitBatch在一次加锁、一次通知内入队多个任务，配合TaskGroup等待完成
+ *          - 任务类型：只可移动、小对象内联存储（base::Task），不要求可调用对象可复制
+ *          - 队列策略：任务队列满时可选择拒绝、阻塞等待或超时等待策略
+ *          - 优先级车道（setLanes）：多条独立队列，严格优先或平滑加权轮转调度，可为车道保留最少工作线程，
+ *            每条车道有自己的容量和队列满策略
+ *          - 线程安全：通过互斥锁和条件变量保证多线程环境下的操作安全性
+ *          - 动态特性（当模板参数IsDynamic=true时）：
+ *              - 自动根据任务负载扩缩容线程数量（在minThreads和maxThreads范围内）
+ *              - 事件驱动：入队时积压任务多于空闲线程即唤醒管理者扩容；多余线程空闲超过keepAlive后自行退出
+ *          - 运行统计：排队等待时间、工作线程利用率、扩缩容次数（getStats）
+ *          - 工作窃取模式（构造时开启）：每个工作线程一个Chase-Lev本地队列，工作线程内提交的任务后进先出地
+ *            压入本地队列，空闲线程随机窃取其它线程的任务；外部线程提交的任务仍进入全局队列
+ *          注意：ThreadPool<false>内嵌在libol.a编译好的TcpServer中，其布局和成员函数必须与libol.a保持一致，
+ *          因此以上扩展放在独立的TaskPool模板中，ThreadPool<false>保持原样；ThreadPool<true>直接继承TaskPool<true>
+ * 作者：ol
+ * 适用标准：C++17及以上（需支持constexpr if、模板条件类型等特性）
+ */
+/****************************************************************************************/
+
+#ifndef OL_TASKPOOL_H
+#define OL_TASKPOOL_H 1
+
+#include "ol_base/ol_TaskPool_base.h"
+#include "ol_type_traits.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <utility>
+
+// #define DEBUG
+
+namespace ol
+{
+    /**
+     * @brief 一组无返回值任务的完成计数（调用者持有，不做堆分配）
+     * @note 1）用于addTask(task, group)/submitBatch()，作为无返回值任务的轻量future：每个任务只多一次原子减；
+     *       2）wait()等待计数归零，若有任务抛出异常则重新抛出第一个异常（抛出后清除）；
+     *       3）wait()返回前不能销毁TaskGroup，组内任务全部完成后才能复用。
+     */
+    class TaskGroup : public TypeNonCopyableMovable
+    {
+    private:
+        std::atomic_size_t m_count{0};  ///< 未完成的任务数
+        std::atomic_bool m_failed{false}; ///< 是否已记录异常
+        std::exception_ptr m_error;       ///< 第一个任务异常
+        std::mutex m_mutex;               ///< 等待用互斥锁
+        std::condition_variable m_cv;     ///< 计数归零条件变量
+
+    public:
+        TaskGroup() = default;
+
+        /**
+         * @brief 增加未完成的任务数（提交任务前调用）
+         * @param n 增加的数量
+         */
+        void add(size_t n = 1)
+        {
+            m_count.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 一个任务完成（计数归零时唤醒等待者）
+         * @note 非最后一个任务只做一次CAS；最后一次减计数在锁内进行，保证wait()返回后不再访问本对象
+         */
+        void done()
+        {
+            size_t c = m_count.load(std::memory_order_relaxed);
+            while (c > 1)
+            {
+                if (m_count.compare_exchange_weak(c, c - 1, std::memory_order_release, std::memory_order_relaxed))
+                    return;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                m_cv.notify_all();
+        }
+
+        /**
+         * @brief 执行组内的一个任务：捕获异常并记录第一个，最后调用done()
+         * @param f 可调用对象
+         */
+        template <typename F>
+        void run(F& f) noexcept
+        {
+            try
+            {
+                f();
+            }
+            catch (...)
+            {
+                bool expected = false;
+                if (m_failed.compare_exchange_strong(expected, true, std::memory_order_relaxed))
+                    m_error = std::current_exception();
+            }
+            done();
+        }
+
+        /**
+         * @brief 等待组内所有任务完成
+         * @throw 组内任务抛出的第一个异常
+         */
+        void wait()
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this]()
+                          { return m_count.load(std::memory_order_acquire) == 0; });
+            }
+            if (m_failed.load(std::memory_order_acquire))
+            {
+                // 取走异常，TaskGroup可以复用
+                std::exception_ptr error;
+                error.swap(m_error);
+                m_failed.store(false, std::memory_order_relaxed);
+                std::rethrow_exception(error);
+            }
+        }
+
+        /**
+         * @brief 限时等待组内所有任务完成
+         * @param timeout 超时时间
+         * @return 全部完成返回true，超时返回false
+         * @note 不抛出任务异常，可在返回true后调用wait()取得异常
+         */
+        template <typename Rep, typename Period>
+        bool waitFor(const std::chrono::duration<Rep, Period>& timeout)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            return m_cv.wait_for(lock, timeout, [this]()
+                                 { return m_count.load(std::memory_order_acquire) == 0; });
+        }
+
+        // 未完成的任务数
+        size_t pending() const
+        {
+            return m_count.load(std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief 线程池运行统计快照（TaskPool::getStats()）
+     */
+    struct TaskPoolStats
+    {
+        uint64_t completed = 0;   ///< 已执行完的任务数
+        uint64_t waitSamples = 0; ///< 统计了排队时间的任务数（每16个任务抽样1个）
+        uint64_t waitNsTotal = 0; ///< 抽样任务的排队等待时间总和（纳秒，从入队到开始执行）
+        uint64_t waitNsMax = 0;   ///< 抽样任务的最长排队等待时间（纳秒）
+        uint64_t busyNs = 0;      ///< 工作线程非空闲的时间总和（纳秒）
+        uint64_t idleNs = 0;      ///< 工作线程休眠等待任务的时间总和（纳秒）
+        uint64_t scaleUps = 0;    ///< 动态模式：扩容创建的线程数
+        uint64_t scaleDowns = 0;  ///< 动态模式：空闲超时退出的线程数
+        size_t peakThreads = 0;   ///< 线程数峰值
+        size_t threads = 0;       ///< 当前工作线程数
+        size_t idleThreads = 0;   ///< 动态模式：当前空闲线程数（固定模式为0）
+        size_t queued = 0;        ///< 当前等待执行的任务数
+
+        // 平均排队等待时间（微秒）
+        double avgWaitUs() const
+        {
+            return waitSamples ? static_cast<double>(waitNsTotal) / 1000.0 / waitSamples : 0.0;
+        }
+
+        // 工作线程利用率（非空闲时间 / 总时间，0~1）
+        double utilization() const
+        {
+            uint64_t total = busyNs + idleNs;
+            return total ? static_cast<double>(busyNs) / total : 0.0;
+        }
+    };
+
+    /**
+     * @brief 扩展线程池模板类，支持动态/固定两种工作模式，以及工作窃取、优先级车道和运行统计
+     * @tparam IsDynamic 是否启用动态模式：true为动态扩缩容模式，false为固定线程数模式（默认）
+     * @note 动态模式下会根据任务负载自动调整线程数量，固定模式使用初始化时指定的线程数
+     * @note 线程安全设计，支持多线程并发添加任务
+     * @note 所有线程均通过join模式退出
+     * @note addTask/submitTask等接口与ThreadPool相同，可直接替换ThreadPool使用（TcpServer内部的线程池除外）
+     */
+    template <bool IsDynamic = false>
+    class TaskPool : public TypeNonCopyableMovable
+    {
+    public:
+        using QueueFullPolicy = base::QueueFullPolicy; ///< 队列满处理策略
+
+        /**
+         * @brief 优先级车道配置（setLanes）
+         */
+        struct LaneOptions
+        {
+            unsigned weight = 1;                               ///< 加权轮转的权重（必须大于0，严格优先模式下忽略）
+            size_t reservedWorkers = 0;                        ///< 保留给本车道的最少工作线程数（其它车道的任务不会占用这些线程）
+            size_t maxQueueSize = 0;                           ///< 最大队列容量（0表示无限制）
+            QueueFullPolicy policy = QueueFullPolicy::kReject; ///< 队列满策略
+            std::chrono::milliseconds timeout{500};            ///< 超时策略的等待时间
+        };
+
+    private:
+        // 通用成员
+        mutable std::mutex m_workersMutex;                                                                                            ///< 保护工作线程集合的互斥锁
+        typename std::conditional_t<IsDynamic, std::unordered_map<std::thread::id, std::thread>, std::vector<std::thread>> m_workers; ///< 工作线程集合
+        mutable std::mutex m_taskQueueMutex;                                                                                          ///< 保护任务队列的互斥锁
+        std::condition_variable m_taskQueueNotEmpty_condVar;                                                                          ///< 任务队列非空条件变量
+        std::atomic_bool m_stop;                                                                                                      ///< 停止标志
+        std::atomic_size_t m_activeWorkers;                                                                                           ///< 追踪活跃工作线程数
+        base::PoolCounters m_counters;                                                                                                ///< 运行统计
+
+        // 优先级车道（均由m_taskQueueMutex保护）
+        std::vector<std::unique_ptr<base::Lane>> m_lanes; ///< 车道（至少1条，车道0为默认车道）
+        size_t m_queuedTotal = 0;                         ///< 各车道排队任务总数
+        bool m_laneStrict = false;                        ///< true为严格优先（车道号小的优先），false为平滑加权轮转
+        bool m_laneReserve = false;                       ///< 是否有车道保留了工作线程（有时任务完成需要记账）
+        size_t m_reservedTotal = 0;                       ///< 各车道保留线程数之和
+        size_t m_sharedUsed = 0;                          ///< 占用非保留线程的任务数
+        uint64_t m_laneGen = 0;                           ///< 车道配置的版本（重新配置后，旧任务完成时不再记账）
+        std::vector<std::unique_ptr<base::Lane>> m_retiredLanes; ///< 被setLanes替换的旧车道（可能仍有生产者在其条件变量上等待，保留到析构）
+
+        // 动态模式特有成员
+        struct DynamicMembers
+        {
+            size_t minThreads;                              ///< 最小线程数
+            size_t maxThreads;                              ///< 最大线程数
+            std::atomic_size_t idleThreads;                 ///< 空闲线程数
+            std::atomic_size_t liveThreads;                 ///< 存活的工作线程数（不含已决定退出的线程）
+            std::atomic_bool growRequested;                 ///< 已请求管理者扩容（避免每次入队都唤醒管理者）
+            std::chrono::milliseconds keepAlive;            ///< 多余线程的最长空闲时间，超过后自行退出
+            mutable std::mutex managerMutex;                ///< 管理者线程锁（同时保护工作线程退出ID队列）
+            std::condition_variable manager_condVar;        ///< 管理者事件条件变量（扩容请求、线程退出、停止）
+            std::thread managerThread;                      ///< 管理者线程
+            std::deque<std::thread::id> workerExitId_deque; ///< 已退出待join的工作线程ID队列
+        };
+        typename std::conditional_t<IsDynamic, DynamicMembers, TypeEmpty> m_dynamic; ///< 动态模式成员
+
+        // 工作窃取模式成员（未开启时为空，车道0兼作外部提交任务的注入队列）
+        std::unique_ptr<base::WSState> m_ws; ///< 工作窃取状态
+
+    public:
+        /**
+         * @brief 固定模式构造函数（仅IsDynamic=false时可用）
+         * @param threadNum 固定线程数量（必须大于0，否则线程池初始化为停止状态）
+         * @param maxQueueSize 任务队列最大容量（0表示无限制，默认0）
+         * @param workStealing 是否开启工作窃取模式（默认false）
+         * @note 线程池初始化时会创建指定数量的工作线程
+         * @note 工作窃取模式下maxQueueSize只限制全局队列，工作线程内提交的任务优先进入本地队列
+         * @throw 无异常抛出（线程数为0时仅初始化停止状态）
+         */
+        template <bool D = IsDynamic, typename = std::enable_if_t<!D>>
+        TaskPool(size_t threadNum, size_t maxQueueSize = 0, bool workStealing = false)
+            : m_stop(false), m_activeWorkers(0)
+        {
+            m_lanes.emplace_back(new base::Lane());
+            m_lanes[0]->maxQueueSize = maxQueueSize;
+
+            if (threadNum == 0)
+            {
+                m_stop = true;
+                return;
+            }
+
+            if (workStealing) m_ws = std::make_unique<base::WSState>(threadNum);
+
+            // 启动固定数量的工作线程
+            m_counters.peakThreads = threadNum;
+            m_workers.reserve(threadNum);
+            while (threadNum > 0)
+            {
+                m_activeWorkers.fetch_add(1, std::memory_order_release);
+                m_workers.emplace_back(&TaskPool<IsDynamic>::worker, this);
+                --threadNum;
+            }
+        }
+
+        /**
+         * @brief 动态模式构造函数（仅IsDynamic=true时可用）
+         * @param minThreadNum 最小线程数（默认0，实际会至少创建1个线程）
+         * @param maxThreadNum 最大线程数（默认CPU核心数）
+         * @param maxQueueSize 任务队列最大容量（0表示无限制，默认0）
+         * @param keepAlive 多余线程（超过minThreadNum的部分）的最长空闲时间，超过后自行退出（默认1秒）
+         * @param workStealing 是否开启工作窃取模式（默认false，本地队列按maxThreadNum个槽位预先分配）
+         * @note 初始化时会创建minThreadNum个线程（若minThreadNum=0则创建1个;若minThreadNum=maxThreadNum=0则线程池初始化为停止状态）
+         * @note 扩容由入队触发（积压任务数多于空闲线程数时立即唤醒管理者），缩容由线程自身的空闲超时触发，
+         *       快扩慢缩形成迟滞，负载小幅波动时线程数不会来回振荡
+         * @throw std::invalid_argument 当 minThreadNum > maxThreadNum 时抛出
+         */
+        template <bool D = IsDynamic, typename = std::enable_if_t<D>>
+        TaskPool(size_t minThreadNum = 0,
+                   size_t maxThreadNum = std::thread::hardware_concurrency(),
+                   size_t maxQueueSize = 0,
+                   std::chrono::milliseconds keepAlive = std::chrono::seconds(1),
+                   bool workStealing = false)
+            : m_stop(false), m_activeWorkers(0)
+        {
+            m_lanes.emplace_back(new base::Lane());
+            m_lanes[0]->maxQueueSize = maxQueueSize;
+
+            if (minThreadNum > maxThreadNum)
+                throw std::invalid_argument("Invalid thread number range");
+
+            if (minThreadNum == maxThreadNum && minThreadNum == 0)
+            {
+                m_stop = true;
+                return;
+            }
+
+            // 初始化动态模式成员
+            m_dynamic.minThreads = minThreadNum;
+            m_dynamic.maxThreads = maxThreadNum;
+            m_dynamic.idleThreads = 0;
+            m_dynamic.growRequested = false;
+            m_dynamic.keepAlive = keepAlive;
+
+            if (workStealing) m_ws = std::make_unique<base::WSState>(maxThreadNum);
+
+            // 启动最小数量（至少为1）的工作线程
+            size_t needThreads = minThreadNum == 0 ? 1 : minThreadNum;
+            m_dynamic.liveThreads = needThreads;
+            m_counters.peakThreads = needThreads;
+
+            while (needThreads > 0)
+            {
+                m_activeWorkers.fetch_add(1, std::memory_order_release);
+                std::thread th(&TaskPool<IsDynamic>::worker, this);
+#ifdef DEBUG
+                printf("构造函数：新工作线程ID：%zu\n", th.get_id());
+#endif
+                m_workers.emplace(th.get_id(), std::move(th)); // 移动到哈希表
+                --needThreads;
+            }
+
+            // 启动管理者线程
+            m_dynamic.managerThread = std::thread(&TaskPool<IsDynamic>::manager<IsDynamic>, this);
+#ifdef DEBUG
+            printf("构造函数：新管理者线程ID：%zu\n", m_dynamic.managerThread.get_id());
+#endif
+        }
+
+        /**
+         * @brief 析构函数
+         * @note 自动调用stop()，等待所有任务完成并清理资源
+         */
+        ~TaskPool()
+        {
+            if (m_stop) return;
+            stop(); // 强制join，确保所有线程退出
+        }
+
+        /**
+         * @brief 停止线程池并清理资源
+         * @note 多次调用安全，已停止状态下调用无效果
+         * @note 仅支持join模式，等待所有任务完成、所有线程安全退出后返回
+         * @warning 确保任务无外部临时资源依赖，避免join等待时出现资源释放竞态
+         */
+        void stop()
+        {
+#ifdef DEBUG
+            printf("线程池开始stop()\n");
+#endif
+
+            // 原子交换，确保仅执行一次stop逻辑 + 内存可见性
+            bool expected = false;
+            if (!m_stop.compare_exchange_strong(expected, true))
+            {
+#ifdef DEBUG
+                printf("线程池已停止，无需重复操作\n");
+#endif
+                return;
+            }
+
+            // 动态模式：先停止管理者线程（确保其不再修改m_workers）
+            if constexpr (IsDynamic)
+            {
+                // 唤醒管理者线程，使其退出循环（先加锁再通知，避免管理者检查完条件、尚未等待时丢失通知）
+                {
+                    std::lock_guard<std::mutex> lock_manager(m_dynamic.managerMutex);
+                }
+                m_dynamic.manager_condVar.notify_one();
+                joinThread(m_dynamic.managerThread);
+
+                // 清空工作线程退出队列（其中的线程仍在m_workers中，下面统一join）
+                std::lock_guard<std::mutex> lock_exit_deque(m_dynamic.managerMutex);
+                m_dynamic.workerExitId_deque.clear();
+#ifdef DEBUG
+                printf("动态模式：清空工作线程退出队列\n");
+#endif
+            }
+
+            // 唤醒所有等待的工作线程（先加锁再通知，保证每个线程要么已看到停止标志，要么已在等待中）
+            {
+                std::lock_guard<std::mutex> lock_taskQueue(m_taskQueueMutex);
+            }
+            m_taskQueueNotEmpty_condVar.notify_all();
+            for (auto& lane : m_lanes) lane->notFull.notify_all();
+
+            // 处理工作线程（直接join，正在执行的任务完成后线程即退出）
+            std::lock_guard<std::mutex> lock(m_workersMutex);
+            if constexpr (IsDynamic)
+            {
+                for (auto& worker : m_workers) joinThread(worker.second); // 动态模式：哈希表遍历
+            }
+            else
+            {
+                for (auto& th : m_workers) joinThread(th); // 固定模式：向量遍历
+            }
+
+            // 清理线程容器
+            m_workers.clear();
+#ifdef DEBUG
+            printf("线程池finish stop()\n");
+#endif
+        }
+
+        /**
+         * @brief 获取当前等待执行的任务数量
+         * @return 任务队列中的任务数（多车道时为各车道之和；工作窃取模式下为全局队列与各本地队列之和）
+         * @note 线程安全，通过互斥锁保护队列访问
+         */
+        inline size_t getTaskNum() const
+        {
+            if (m_ws) return m_ws->pending.load(std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            return m_queuedTotal;
+        }
+
+        /**
+         * @brief 获取某条车道等待执行的任务数量
+         * @param lane 车道号
+         * @return 车道中的任务数（车道号越界返回0）
+         */
+        inline size_t getTaskNum(size_t lane) const
+        {
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            return lane < m_lanes.size() ? m_lanes[lane]->queue.size() : 0;
+        }
+
+        /**
+         * @brief 获取车道数
+         * @return 车道数（未调用setLanes时为1）
+         */
+        inline size_t getLaneNum() const
+        {
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            return m_lanes.size();
+        }
+
+        /**
+         * @brief 获取当前工作线程数量
+         * @return 工作线程的实时数量
+         * @note 线程安全，通过互斥锁保护线程集合访问
+         */
+        inline size_t getWorkerNum() const
+        {
+            std::lock_guard<std::mutex> lock(m_workersMutex);
+            return m_workers.size();
+        }
+
+        /**
+         * @brief 动态模式特有：获取当前空闲线程数量
+         * @return 空闲线程数
+         * @note 仅IsDynamic=true时可用，原子操作确保线程安全
+         */
+        template <bool D = IsDynamic, typename = std::enable_if_t<D>>
+        inline size_t getIdleThreadNum() const
+        {
+            return m_dynamic.idleThreads;
+        }
+
+        /**
+         * @brief 设置任务队列满时的拒绝策略（新任务直接被拒绝）
+         * @note 线程安全，通过互斥锁保护策略修改；对所有车道生效
+         */
+        void setRejectPolicy()
+        {
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            for (auto& lane : m_lanes) lane->policy = QueueFullPolicy::kReject;
+        }
+
+        /**
+         * @brief 设置任务队列满时的阻塞策略（等待直到队列有空闲位置）
+         * @note 线程安全，通过互斥锁保护策略修改；对所有车道生效
+         */
+        void setBlockPolicy()
+        {
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            for (auto& lane : m_lanes) lane->policy = QueueFullPolicy::kBlock;
+        }
+
+        /**
+         * @brief 设置任务队列满时的超时等待策略
+         * @param timeoutMS 超时时间（毫秒，必须大于0）
+         * @throw std::invalid_argument 当timeoutMS <= 0时抛出
+         * @note 线程安全，通过互斥锁保护策略和超时时间修改；对所有车道生效
+         */
+        void setTimeoutPolicy(std::chrono::milliseconds timeoutMS)
+        {
+            if (timeoutMS.count() <= 0)
+                throw std::invalid_argument("Timeout must be greater than 0");
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            for (auto& lane : m_lanes)
+            {
+                lane->policy = QueueFullPolicy::kTimeout;
+                lane->timeout = timeoutMS;
+            }
+        }
+
+        /**
+         * @brief 配置优先级车道（替换现有的全部车道，车道号即下标）
+         * @param lanes 各车道的配置（至少1条）
+         * @param strict true为严格优先：总是先取车道号最小的非空车道；false（默认）为平滑加权轮转：
+         *               按权重比例交替取各非空车道的任务，低优先级车道不会饿死
+         * @throw std::invalid_argument 车道为空、权重为0、超时策略的超时时间不大于0、
+         *        或保留线程数之和不小于线程数（固定模式）/最大线程数（动态模式）时抛出
+         * @throw std::logic_error 工作窃取模式下调用，或仍有任务在排队时抛出
+         * @note 1）保留线程：车道i最多使用自己的reservedWorkers个线程加上共享线程（总线程数 - 各车道保留数之和），
+         *          所以即使其它车道的长任务占满共享线程，车道i仍有reservedWorkers个线程随时可用；
+         *       2）有保留时每个任务完成后要加锁记账，没有保留时调度开销只在取任务时；
+         *       3）动态模式按当前线程数计算共享线程，且至少留1个共享线程，保留车道的任务到达时若没有可用线程会立即触发扩容；
+         *          要求严格保证时把minThreadNum设为保留数之和加1；
+         *       4）建议在提交任务前调用。
+         */
+        void setLanes(const std::vector<LaneOptions>& lanes, bool strict = false)
+        {
+            if (lanes.empty()) throw std::invalid_argument("At least one lane is required");
+            if (m_ws) throw std::logic_error("Priority lanes are not supported in work-stealing mode");
+
+            size_t reservedTotal = 0;
+            for (const auto& opt : lanes)
+            {
+                if (opt.weight == 0) throw std::invalid_argument("Lane weight must be greater than 0");
+                if (opt.policy == QueueFullPolicy::kTimeout && opt.timeout.count() <= 0)
+                    throw std::invalid_argument("Timeout must be greater than 0");
+                reservedTotal += opt.reservedWorkers;
+            }
+
+            size_t maxThreads;
+            if constexpr (IsDynamic)
+                maxThreads = m_dynamic.maxThreads;
+            else
+                maxThreads = m_activeWorkers.load(std::memory_order_relaxed);
+            if (reservedTotal > 0 && reservedTotal >= maxThreads)
+                throw std::invalid_argument("Reserved workers must be fewer than the thread number");
+
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            if (m_queuedTotal > 0) throw std::logic_error("Cannot reconfigure lanes while tasks are queued");
+
+            std::vector<std::unique_ptr<base::Lane>> newLanes;
+            newLanes.reserve(lanes.size());
+            for (const auto& opt : lanes)
+            {
+                auto lane = std::make_unique<base::Lane>();
+                lane->weight = opt.weight;
+                lane->reserved = opt.reservedWorkers;
+                lane->maxQueueSize = opt.maxQueueSize;
+                lane->policy = opt.policy;
+                lane->timeout = opt.timeout;
+                newLanes.emplace_back(std::move(lane));
+            }
+
+            // 唤醒在旧车道上等待空位的生产者（醒来后按车道号改到新车道）
+            for (auto& lane : m_lanes) lane->notFull.notify_all();
+
+            m_lanes.swap(newLanes);
+            for (auto& lane : newLanes) m_retiredLanes.emplace_back(std::move(lane));
+            m_laneStrict = strict;
+            m_reservedTotal = reservedTotal;
+            m_laneReserve = reservedTotal > 0;
+            m_sharedUsed = 0;
+            ++m_laneGen;
+        }
+
+        /**
+         * @brief 动态模式特有：设置多余线程的最长空闲时间
+         * @param keepAlive 空闲时间（超过minThreadNum的线程空闲这么久后自行退出）
+         * @note 仅IsDynamic=true时可用，用于调整缩容的迟滞；对已在等待中的线程从下一次等待开始生效
+         */
+        template <bool D = IsDynamic, typename = std::enable_if_t<D>>
+        void setKeepAlive(std::chrono::milliseconds keepAlive)
+        {
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            m_dynamic.keepAlive = keepAlive;
+        }
+
+        /**
+         * @brief 动态模式特有：旧接口，等同于setKeepAlive()
+         * @param interval 空闲时间
+         */
+        template <bool D = IsDynamic, typename = std::enable_if_t<D>>
+        void setCheckInterval(std::chrono::milliseconds interval)
+        {
+            setKeepAlive(interval);
+        }
+
+        /**
+         * @brief 获取运行统计
+         * @return 统计快照
+         * @note 工作线程每执行64个任务、进入休眠前和退出时才合并统计，快照可能略落后于实际；
+         *       正在休眠的线程的空闲时间在醒来后才计入
+         */
+        TaskPoolStats getStats() const
+        {
+            TaskPoolStats stats;
+            stats.completed = m_counters.completed.load(std::memory_order_relaxed);
+            stats.waitSamples = m_counters.waitSamples.load(std::memory_order_relaxed);
+            stats.waitNsTotal = m_counters.waitNs.load(std::memory_order_relaxed);
+            stats.waitNsMax = m_counters.waitMaxNs.load(std::memory_order_relaxed);
+            stats.busyNs = m_counters.busyNs.load(std::memory_order_relaxed);
+            stats.idleNs = m_counters.idleNs.load(std::memory_order_relaxed);
+            stats.scaleUps = m_counters.scaleUps.load(std::memory_order_relaxed);
+            stats.scaleDowns = m_counters.scaleDowns.load(std::memory_order_relaxed);
+            stats.peakThreads = m_counters.peakThreads.load(std::memory_order_relaxed);
+            stats.queued = getTaskNum();
+            if constexpr (IsDynamic)
+            {
+                stats.threads = m_dynamic.liveThreads.load(std::memory_order_relaxed);
+                stats.idleThreads = m_dynamic.idleThreads.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                stats.threads = getWorkerNum();
+            }
+            return stats;
+        }
+
+        /**
+         * @brief 添加无返回值任务到线程池
+         * @param task 待执行的任务（任意无参可调用对象，可以只可移动；返回值被丢弃）
+         * @return 任务添加成功返回true，失败返回false（线程池已停止或队列满且策略为拒绝/超时）
+         * @note 线程安全，根据当前队列策略处理满队列情况
+         * @note 不超过40字节的可调用对象内联保存在任务中，入队不做额外的堆分配
+         * @warning 如果任务有异常虽然会将异常输出到错误流，但推荐自己包装一下函数，设置异常处理函数
+         */
+        template <typename F>
+        bool addTask(F&& task)
+        {
+            if (m_stop) return false;
+            return pushTask(base::Task(std::forward<F>(task)));
+        }
+
+        /**
+         * @brief 添加无返回值任务到指定车道
+         * @param lane 车道号（见setLanes，默认车道为0）
+         * @param task 待执行的任务
+         * @return 任务添加成功返回true，失败返回false（线程池已停止、车道号越界或车道满且策略为拒绝/超时）
+         * @note 按该车道的容量和队列满策略处理
+         */
+        template <typename F>
+        bool addLaneTask(size_t lane, F&& task)
+        {
+            if (m_stop) return false;
+            return pushTask(base::Task(std::forward<F>(task)), lane);
+        }
+
+        /**
+         * @brief 添加属于某个任务组的无返回值任务到指定车道
+         * @param lane 车道号
+         * @param task 待执行的任务
+         * @param group 任务组
+         * @return 任务添加成功返回true，失败返回false（此时任务组计数不变）
+         */
+        template <typename F>
+        bool addLaneTask(size_t lane, F&& task, TaskGroup& group)
+        {
+            if (m_stop) return false;
+            group.add();
+            if (pushTask(base::Task([&group, f = std::forward<F>(task)]() mutable
+                                    { group.run(f); }),
+                         lane))
+                return true;
+            group.done();
+            return false;
+        }
+
+        /**
+         * @brief 添加属于某个任务组的无返回值任务
+         * @param task 待执行的任务
+         * @param group 任务组（添加成功时计数加1，任务执行完（包括抛出异常）后减1）
+         * @return 任务添加成功返回true，失败返回false（此时任务组计数不变）
+         * @note 相当于不做堆分配的void future：用group.wait()等待完成并取得任务异常
+         */
+        template <typename F>
+        bool addTask(F&& task, TaskGroup& group)
+        {
+            return addLaneTask(0, std::forward<F>(task), group);
+        }
+
+        /**
+         * @brief 批量添加无返回值任务（一次加锁、一次通知）
+         * @tparam InputIt 输入迭代器类型，元素为可调用对象（会被移走）
+         * @param first 起始迭代器
+         * @param last 结束迭代器
+         * @return 成功添加的任务数（从first开始的前若干个；队列满且策略为拒绝/超时或线程池停止时少于总数）
+         * @note 阻塞策略下队列满时先唤醒工作线程再等待空位，等待期间会释放锁
+         */
+        template <typename InputIt>
+        size_t addTasks(InputIt first, InputIt last)
+        {
+            return pushBatch(first, last, [](auto&& f)
+                             { return base::Task(std::move(f)); });
+        }
+
+        /**
+         * @brief 批量添加无返回值任务（容器版本）
+         * @param tasks 任务容器（元素会被移走）
+         * @return 成功添加的任务数
+         */
+        template <typename Range>
+        size_t addTasks(Range& tasks)
+        {
+            return addTasks(std::begin(tasks), std::end(tasks));
+        }
+
+        /**
+         * @brief 批量添加无返回值任务到指定车道（一次加锁、一次通知）
+         * @param lane 车道号
+         * @param first 起始迭代器（元素为可调用对象，会被移走）
+         * @param last 结束迭代器
+         * @return 成功添加的任务数
+         */
+        template <typename InputIt>
+        size_t addLaneTasks(size_t lane, InputIt first, InputIt last)
+        {
+            return pushBatch(first, last, [](auto&& f)
+                             { return base::Task(std::move(f)); }, lane);
+        }
+
+        /**
+         * @brief 批量添加属于某个任务组的无返回值任务（一次加锁、一次通知）
+         * @param first 起始迭代器（元素为可调用对象，会被移走）
+         * @param last 结束迭代器
+         * @param group 任务组（按实际添加的任务数增加计数）
+         * @return 成功添加的任务数
+         */
+        template <typename InputIt>
+        size_t submitBatch(InputIt first, InputIt last, TaskGroup& group)
+        {
+            return pushBatch(first, last, [&group](auto&& f)
+                             {
+                                 group.add();
+                                 return base::Task([&group, f = std::move(f)]() mutable
+                                                   { group.run(f); }); });
+        }
+
+        /**
+         * @brief 批量添加属于某个任务组的无返回值任务（容器版本）
+         * @param tasks 任务容器（元素会被移走）
+         * @param group 任务组
+         * @return 成功添加的任务数
+         */
+        template <typename Range>
+        size_t submitBatch(Range& tasks, TaskGroup& group)
+        {
+            return submitBatch(std::begin(tasks), std::end(tasks), group);
+        }
+
+        /**
+         * @brief 提交带返回值的任务到线程池
+         * @tparam F 任务函数类型
+         * @tparam Args 任务函数参数类型
+         * @param f 任务函数
+         * @param args 任务函数参数
+         * @return pair<是否成功添加任务的bool值, 包含任务返回值的std::future对象>
+         * @note 若任务添加失败（bool为false），调用future.get()会抛出对应异常（线程池停止/队列满）；
+         *       若任务添加成功（bool为true），future.get()会返回任务结果或抛出任务自身的异常。
+         * @note 线程安全，内部调用addTask实现任务添加；packaged_task直接移入任务，只有共享状态一次堆分配
+         * @note 无返回值且不需要future时，用addTask(task, group)更省
+         */
+        template <typename F, typename... Args>
+        auto submitTask(F&& f, Args&&... args) -> std::pair<bool, std::future<typename std::invoke_result_t<F, Args...>>>
+        {
+            return submitLaneTask(0, std::forward<F>(f), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief 提交带返回值的任务到指定车道
+         * @param lane 车道号
+         * @param f 任务函数
+         * @param args 任务函数参数
+         * @return pair<是否成功添加任务的bool值, 包含任务返回值的std::future对象>（失败时的异常同submitTask）
+         */
+        template <typename F, typename... Args>
+        auto submitLaneTask(size_t lane, F&& f, Args&&... args) -> std::pair<bool, std::future<typename std::invoke_result_t<F, Args...>>>
+        {
+            using ReturnType = typename std::invoke_result_t<F, Args...>;
+
+            std::packaged_task<ReturnType()> task(
+                [f = std::forward<F>(f), args = std::make_tuple(std::forward<Args>(args)...)]() mutable
+                {
+                    return std::apply(std::move(f), std::move(args));
+                });
+
+            std::future<ReturnType> result = task.get_future();
+
+            if (!addLaneTask(lane, std::move(task)))
+            {
+                std::promise<ReturnType> promise;
+                if (m_stop)
+                {
+                    promise.set_exception(std::make_exception_ptr(std::runtime_error("TaskPool has been stopped")));
+                    return {false, promise.get_future()};
+                }
+                if (lane >= getLaneNum())
+                {
+                    promise.set_exception(std::make_exception_ptr(std::out_of_range("Task lane index out of range")));
+                    return {false, promise.get_future()};
+                }
+
+                switch (getLanePolicy(lane))
+                {
+                case QueueFullPolicy::kReject:
+                    promise.set_exception(std::make_exception_ptr(std::runtime_error("Task queue full (Reject policy)")));
+                    return {false, promise.get_future()};
+                case QueueFullPolicy::kBlock:
+                    // 此时失败一定是因为线程池已停止（否则wait会一直等）
+                    promise.set_exception(std::make_exception_ptr(std::runtime_error("Task submission failed in block policy (TaskPool stopped)")));
+                    return {false, promise.get_future()};
+                case QueueFullPolicy::kTimeout:
+                    promise.set_exception(std::make_exception_ptr(std::runtime_error("Task queue full (Timeout policy)")));
+                    return {false, promise.get_future()};
+                default:
+                    promise.set_exception(std::make_exception_ptr(std::runtime_error("Task submission failed")));
+                    return {false, promise.get_future()};
+                }
+            }
+
+            return {true, std::move(result)};
+        }
+
+        /**
+         * @brief 获取车道的队列满策略
+         * @param lane 车道号
+         * @return 队列满策略（车道号越界时返回kReject）
+         */
+        QueueFullPolicy getLanePolicy(size_t lane) const
+        {
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            return lane < m_lanes.size() ? m_lanes[lane]->policy : QueueFullPolicy::kReject;
+        }
+
+        /**
+         * @brief 检查是否开启了工作窃取模式
+         * @return 开启返回true
+         */
+        bool isWorkStealing() const
+        {
+            return m_ws != nullptr;
+        }
+
+        /**
+         * @brief 检查线程池是否处于运行状态
+         * @return 运行中返回true，已停止返回false
+         * @note 基于原子变量m_stop的状态判断，线程安全
+         */
+        bool isRunning() const
+        {
+            return !m_stop;
+        }
+
+    private:
+        /**
+         * @brief 任务入队（addTask的实现）
+         * @param task 待执行的任务
+         * @param lane 车道号
+         * @return 成功返回true，失败返回false（车道号越界时也返回false）
+         */
+        bool pushTask(base::Task&& task, size_t lane = 0)
+        {
+            // 工作窃取模式：本池工作线程提交的任务进入自己的本地队列
+            if (m_ws && base::t_wsCtx.pool == this) return addLocalTask(std::move(task));
+
+            int64_t enqueueNs = base::sampleEnqueueNs();
+            size_t backlog = 0;
+            {
+                std::unique_lock<std::mutex> lock(m_taskQueueMutex);
+
+                // 处理队列大小限制
+                base::Lane* target = waitNotFull(lock, lane);
+                if (target == nullptr || m_stop) return false;
+
+                enqueueLocked(*target, base::QueuedTask{std::move(task), enqueueNs});
+                backlog = m_queuedTotal;
+                if (m_ws)
+                {
+                    m_ws->injected.fetch_add(1, std::memory_order_relaxed);
+                    backlog = m_ws->pending.fetch_add(1, std::memory_order_seq_cst) + 1;
+                }
+            }
+
+            m_taskQueueNotEmpty_condVar.notify_one();
+            requestGrow(backlog);
+            return true;
+        }
+
+        /**
+         * @brief 动态模式：入队后检查积压，积压任务多于空闲线程且未达最大线程数时唤醒管理者扩容
+         * @param backlog 入队后的积压任务数
+         * @note 已有扩容请求未处理时直接返回，突发负载下只唤醒管理者一次
+         */
+        void requestGrow(size_t backlog)
+        {
+            if constexpr (IsDynamic)
+            {
+                if (backlog <= m_dynamic.idleThreads.load(std::memory_order_relaxed)) return;
+                if (m_dynamic.liveThreads.load(std::memory_order_relaxed) >= m_dynamic.maxThreads) return;
+                if (m_dynamic.growRequested.load(std::memory_order_relaxed) ||
+                    m_dynamic.growRequested.exchange(true, std::memory_order_acq_rel))
+                    return;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_dynamic.managerMutex);
+                }
+                m_dynamic.manager_condVar.notify_one();
+            }
+        }
+
+        /**
+         * @brief 车道满时按该车道的策略等待空位（调用前已持有任务队列锁）
+         * @param lock 任务队列锁
+         * @param lane 车道号
+         * @return 有空位（或线程池已停止）时返回车道，车道号越界、拒绝策略或等待超时返回nullptr
+         * @note 每次醒来都按车道号重新取车道（等待期间车道可能被setLanes替换）
+         */
+        base::Lane* waitNotFull(std::unique_lock<std::mutex>& lock, size_t lane)
+        {
+            std::chrono::steady_clock::time_point deadline{};
+            while (true)
+            {
+                if (lane >= m_lanes.size()) return nullptr;
+                base::Lane* target = m_lanes[lane].get();
+                if (!target->full() || m_stop) return target;
+
+                switch (target->policy)
+                {
+                case QueueFullPolicy::kReject:
+                    return nullptr;
+                case QueueFullPolicy::kBlock:
+                    target->notFull.wait(lock);
+                    break;
+                case QueueFullPolicy::kTimeout:
+                    if (deadline == std::chrono::steady_clock::time_point{})
+                        deadline = std::chrono::steady_clock::now() + target->timeout;
+                    if (target->notFull.wait_until(lock, deadline) == std::cv_status::timeout)
+                    {
+                        if (lane < m_lanes.size() && (!m_lanes[lane]->full() || m_stop)) return m_lanes[lane].get();
+                        return nullptr;
+                    }
+                    break;
+                }
+            }
+        }
+
+        /**
+         * @brief 批量入队（addTasks/submitBatch的实现）
+         * @param first 起始迭代器
+         * @param last 结束迭代器
+         * @param wrap 把元素转换为base::Task的函数（元素确定入队时才调用）
+         * @param lane 车道号
+         * @return 成功添加的任务数
+         * @note 整批只加一次锁、只通知一次；等待空位前先发布并通知已入队的任务，避免工作线程休眠导致死锁
+         */
+        template <typename InputIt, typename Wrap>
+        size_t pushBatch(InputIt first, InputIt last, Wrap&& wrap, size_t lane = 0)
+        {
+            if (m_stop) return 0;
+
+            size_t added = 0;
+
+            // 工作窃取模式：本池工作线程逐个压入本地队列（无锁）
+            if (m_ws && base::t_wsCtx.pool == this)
+            {
+                for (; first != last; ++first)
+                {
+                    if (!addLocalTask(wrap(std::move(*first)))) break;
+                    ++added;
+                }
+                return added;
+            }
+
+            int64_t enqueueNs = base::nowNs(); // 整批共用一个入队时间（按WAIT_SAMPLE_MASK抽样）
+            size_t unpublished = 0;            // 已入队但尚未通知的任务数
+            size_t backlog = 0;                // 最近一次发布时的积压任务数
+            auto publish = [&]()
+            {
+                if (unpublished == 0) return;
+                backlog = m_queuedTotal;
+                if (m_ws)
+                {
+                    m_ws->injected.fetch_add(unpublished, std::memory_order_relaxed);
+                    backlog = m_ws->pending.fetch_add(unpublished, std::memory_order_seq_cst) + unpublished;
+                }
+                if (unpublished == 1)
+                    m_taskQueueNotEmpty_condVar.notify_one();
+                else
+                    m_taskQueueNotEmpty_condVar.notify_all();
+                unpublished = 0;
+            };
+
+            {
+                std::unique_lock<std::mutex> lock(m_taskQueueMutex);
+                for (; first != last && !m_stop; ++first)
+                {
+                    if (lane >= m_lanes.size()) break;
+                    base::Lane* target = m_lanes[lane].get();
+                    if (target->full())
+                    {
+                        publish();
+                        requestGrow(backlog); // 持锁调用安全：管理者从不在持有managerMutex时申请队列锁
+                        target = waitNotFull(lock, lane);
+                        if (target == nullptr || m_stop) break;
+                    }
+
+                    enqueueLocked(*target, base::QueuedTask{wrap(std::move(*first)), (added & base::WAIT_SAMPLE_MASK) == 0 ? enqueueNs : 0});
+                    ++added;
+                    ++unpublished;
+                }
+                publish(); // 在锁内发布（读取队列长度、工作窃取模式的计数都需要持锁）
+            }
+
+            requestGrow(backlog);
+            return added;
+        }
+
+        // 车道调度（以下函数均在持有任务队列锁时调用）
+        // ===========================================================================
+        // 任务进入车道
+        void enqueueLocked(base::Lane& lane, base::QueuedTask&& item)
+        {
+            lane.queue.push(std::move(item));
+            ++m_queuedTotal;
+        }
+
+        // 从车道取出队首任务，并通知在该车道上等待空位的生产者
+        base::QueuedTask dequeueLocked(base::Lane& lane)
+        {
+            base::QueuedTask item = std::move(lane.queue.front());
+            lane.queue.pop();
+            --m_queuedTotal;
+            if (lane.maxQueueSize > 0 && lane.policy != QueueFullPolicy::kReject)
+                lane.notFull.notify_one();
+            return item;
+        }
+
+        /**
+         * @brief 车道现在能否再开始一个任务（保留线程约束）
+         * @param lane 车道
+         * @return 未占满自己的保留线程，或共享线程还有空闲时返回true
+         */
+        bool laneEligible(const base::Lane& lane) const
+        {
+            if (!m_laneReserve) return true;
+            if (lane.running < lane.reserved) return true;
+
+            size_t threads = m_activeWorkers.load(std::memory_order_relaxed);
+            if constexpr (IsDynamic)
+                threads = std::max(threads, m_reservedTotal + 1); // 动态模式至少留1个共享线程，保留车道靠扩容保证
+            size_t shared = threads > m_reservedTotal ? threads - m_reservedTotal : 0;
+            return m_sharedUsed < shared;
+        }
+
+        // 是否有可以开始执行的任务（工作线程的等待条件）
+        bool hasRunnable() const
+        {
+            if (m_queuedTotal == 0) return false;
+            if (!m_laneReserve) return true;
+            for (const auto& lane : m_lanes)
+                if (!lane->queue.empty() && laneEligible(*lane)) return true;
+            return false;
+        }
+
+        /**
+         * @brief 选择下一个要取任务的车道
+         * @return 车道号，没有可执行的任务时返回SIZE_MAX
+         * @note 严格优先：车道号最小的可执行车道；加权：平滑加权轮转（每次给各可执行车道加上权重，选当前值最大的，
+         *       再减去本轮权重之和），n个车道时开销O(n)
+         */
+        size_t pickLane()
+        {
+            size_t n = m_lanes.size();
+            if (n == 1) return (!m_lanes[0]->queue.empty() && laneEligible(*m_lanes[0])) ? 0 : SIZE_MAX;
+
+            if (m_laneStrict)
+            {
+                for (size_t ii = 0; ii < n; ++ii)
+                    if (!m_lanes[ii]->queue.empty() && laneEligible(*m_lanes[ii])) return ii;
+                return SIZE_MAX;
+            }
+
+            size_t best = SIZE_MAX;
+            int64_t total = 0;
+            for (size_t ii = 0; ii < n; ++ii)
+            {
+                base::Lane& lane = *m_lanes[ii];
+                if (lane.queue.empty() || !laneEligible(lane)) continue;
+                lane.current += lane.weight;
+                total += lane.weight;
+                if (best == SIZE_MAX || lane.current > m_lanes[best]->current) best = ii;
+            }
+            if (best != SIZE_MAX) m_lanes[best]->current -= total;
+            return best;
+        }
+
+        // 开始执行车道任务：有保留时记账
+        void laneStartLocked(base::Lane& lane)
+        {
+            if (!m_laneReserve) return;
+            if (lane.running >= lane.reserved) ++m_sharedUsed;
+            ++lane.running;
+        }
+
+        /**
+         * @brief 车道任务执行完：记账并唤醒一个工作线程（可能有任务因保留约束在等待）
+         * @param lane 车道号
+         * @param gen 取任务时的车道配置版本（配置已更换时不再记账）
+         * @note 只在有保留时调用，需要加锁
+         */
+        void laneFinish(size_t lane, uint64_t gen)
+        {
+            bool wake = false;
+            {
+                std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+                if (gen != m_laneGen || lane >= m_lanes.size()) return;
+                base::Lane& l = *m_lanes[lane];
+                --l.running;
+                if (l.running >= l.reserved) --m_sharedUsed;
+                wake = m_queuedTotal > 0;
+            }
+            if (wake) m_taskQueueNotEmpty_condVar.notify_one();
+        }
+        // ===========================================================================
+
+        /**
+         * @brief 工作线程主函数
+         * @note 循环从任务队列获取并执行任务，直到线程池停止或（动态模式下）空闲超时退出
+         * @note 动态模式下会维护空闲线程计数，任务执行前后更新状态
+         */
+        void worker()
+        {
+            // 动态模式：初始化线程状态
+            if constexpr (IsDynamic)
+            {
+                ++m_dynamic.idleThreads;
+            }
+
+            base::WorkerStats stats;
+            bool retired = false; // 动态模式：是否因空闲超时退出
+
+            try
+            {
+                if (m_ws) retired = stealingLoop(stats);
+
+                while (!m_ws && !m_stop)
+                {
+                    base::QueuedTask item;
+                    size_t lane = 0;      // 任务所属车道
+                    uint64_t laneGen = 0; // 取任务时的车道配置版本
+                    bool accounted = false; // 是否需要在任务完成后记账（有车道保留线程时）
+
+                    {
+                        std::unique_lock<std::mutex> lock(m_taskQueueMutex);
+
+                        // 等待可执行的任务或停止信号
+                        auto waitCond = [this]()
+                        { return hasRunnable() || m_stop; };
+                        if (!waitCond())
+                        {
+                            int64_t sleepNs = stats.sleepBegin(m_counters); // 休眠前合并统计
+
+                            if constexpr (IsDynamic)
+                            {
+                                // 空闲超过keepAlive且线程数多于下限时退出
+                                bool woken = m_taskQueueNotEmpty_condVar.wait_for(lock, m_dynamic.keepAlive, waitCond);
+                                stats.sleepEnd(sleepNs);
+                                if (!woken && tryRetire())
+                                {
+                                    retired = true;
+                                    break;
+                                }
+                            }
+                            else
+                            {
+                                m_taskQueueNotEmpty_condVar.wait(lock, waitCond);
+                                stats.sleepEnd(sleepNs);
+                            }
+                        }
+
+                        if (m_stop) break; // 优先检查停止信号，避免无效操作
+
+                        lane = pickLane();
+                        if (lane == SIZE_MAX)
+                        {
+                            lock.unlock();
+                            continue;
+                        }
+
+                        // 取出任务（同时通知可能等待该车道空位的生产者）
+                        base::Lane& l = *m_lanes[lane];
+                        item = dequeueLocked(l);
+                        laneStartLocked(l);
+                        accounted = m_laneReserve;
+                        laneGen = m_laneGen;
+
+                        // 动态模式：更新空闲线程数
+                        if constexpr (IsDynamic)
+                            --m_dynamic.idleThreads;
+                    }
+
+                    // 执行任务
+                    runQueued(item, stats);
+                    if (accounted) laneFinish(lane, laneGen);
+
+                    // 动态模式：任务完成，恢复空闲状态
+                    if constexpr (IsDynamic)
+                    {
+                        ++m_dynamic.idleThreads;
+                    }
+                }
+            }
+            catch (...)
+            {
+                fprintf(stderr, "Worker thread(ID:%zu) unexpected exception\n", std::this_thread::get_id());
+            }
+
+            stats.flush(m_counters);
+
+            // 减少活跃数
+            m_activeWorkers.fetch_sub(1, std::memory_order_release);
+
+            // 动态模式：空闲超时退出的线程把ID交给管理者join（线程池停止时由stop()统一join）
+            if constexpr (IsDynamic)
+            {
+                --m_dynamic.idleThreads;
+                if (!retired) m_dynamic.liveThreads.fetch_sub(1, std::memory_order_relaxed);
+
+                if (retired && !m_stop.load(std::memory_order_acquire))
+                {
+                    {
+                        std::lock_guard<std::mutex> lock_manager(m_dynamic.managerMutex);
+#ifdef DEBUG
+                        printf("线程(ID:%zu)加入退出容器\n", std::this_thread::get_id());
+#endif
+                        m_dynamic.workerExitId_deque.emplace_back(std::this_thread::get_id());
+                    }
+                    m_dynamic.manager_condVar.notify_one();
+                }
+            }
+
+#ifdef DEBUG
+            printf("线程已销毁（主动移除，ID:%zu）\n", std::this_thread::get_id());
+#endif
+        }
+
+        /**
+         * @brief 动态模式：空闲超时的线程尝试退出
+         * @return 线程数多于下限（max(minThreads,1)）时占用一个退出名额并返回true，否则返回false
+         * @note 在任务队列锁内调用，与入队时的扩容判断（读取空闲线程数）互斥
+         */
+        bool tryRetire()
+        {
+            if constexpr (IsDynamic)
+            {
+                size_t minKeep = std::max(m_dynamic.minThreads, static_cast<size_t>(1));
+                size_t live = m_dynamic.liveThreads.load(std::memory_order_relaxed);
+                while (live > minKeep)
+                {
+                    if (m_dynamic.liveThreads.compare_exchange_weak(live, live - 1, std::memory_order_acq_rel))
+                    {
+                        m_counters.scaleDowns.fetch_add(1, std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief 执行队列中取出的任务并累加统计
+         * @param item 任务
+         * @param stats 工作线程本地统计
+         */
+        void runQueued(base::QueuedTask& item, base::WorkerStats& stats)
+        {
+            stats.taken(item.enqueueNs);
+            runTask(item.task);
+            stats.done(m_counters);
+        }
+
+        // 工作窃取模式
+        // ===========================================================================
+        /**
+         * @brief 唤醒一个休眠的工作线程（无锁入队之后调用）
+         * @note 入队方先增加pending再读取sleepers，休眠方在锁内先增加sleepers再检查pending（均为seq_cst），
+         *       两者至少有一方能看到对方的修改，不会丢失唤醒
+         */
+        void wakeOne()
+        {
+            if (m_ws->sleepers.load(std::memory_order_seq_cst) == 0) return;
+
+            {
+                std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            }
+            m_taskQueueNotEmpty_condVar.notify_one();
+        }
+
+        /**
+         * @brief 工作线程内提交任务：压入本地队列，本地队列满时改投全局队列
+         * @param task 待执行的任务
+         * @return 成功返回true，失败返回false（拒绝策略下全局队列也满）
+         * @note 阻塞/超时策略下全局队列也满时由提交任务的工作线程直接执行（caller-runs），
+         *       避免所有工作线程都在等待队列空位而死锁
+         */
+        bool addLocalTask(base::Task&& task)
+        {
+            int64_t enqueueNs = base::sampleEnqueueNs();
+            size_t slot = base::t_wsCtx.slot;
+            if (slot != SIZE_MAX)
+            {
+                // 先增加pending再压入：窃取者取到任务后立即减pending，顺序反过来计数会下溢
+                auto* p = new base::WSTask{std::move(task), enqueueNs};
+                size_t backlog = m_ws->pending.fetch_add(1, std::memory_order_seq_cst) + 1;
+                if (m_ws->deques[slot]->push(p))
+                {
+                    wakeOne();
+                    requestGrow(backlog);
+                    return true;
+                }
+                m_ws->pending.fetch_sub(1, std::memory_order_relaxed);
+                task = std::move(p->task);
+                delete p;
+            }
+
+            size_t backlog = 0;
+            {
+                std::unique_lock<std::mutex> lock(m_taskQueueMutex);
+                if (m_stop) return false;
+
+                base::Lane& lane = *m_lanes[0]; // 工作窃取模式只有默认车道
+                if (lane.full())
+                {
+                    if (lane.policy == QueueFullPolicy::kReject) return false;
+
+                    lock.unlock();
+                    runTask(task);
+                    return true;
+                }
+
+                enqueueLocked(lane, base::QueuedTask{std::move(task), enqueueNs});
+                m_ws->injected.fetch_add(1, std::memory_order_relaxed);
+                backlog = m_ws->pending.fetch_add(1, std::memory_order_seq_cst) + 1;
+            }
+
+            m_taskQueueNotEmpty_condVar.notify_one();
+            requestGrow(backlog);
+            return true;
+        }
+
+        /**
+         * @brief join线程，失败时输出到错误流（stop()和管理者清理退出线程共用）
+         * @param th 线程对象（不可join时直接返回）
+         */
+        static void joinThread(std::thread& th)
+        {
+            if (!th.joinable()) return;
+            try
+            {
+                th.join();
+            }
+            catch (const std::system_error& e)
+            {
+                fprintf(stderr, "TaskPool thread join failure: %s\n", e.what());
+            }
+        }
+
+        /**
+         * @brief 执行任务并捕获异常（与普通模式的异常处理一致）
+         * @param task 待执行的任务
+         */
+        static void runTask(base::Task& task)
+        {
+            try
+            {
+                if (task) task(); // 空任务保护
+            }
+            catch (const std::exception& e)
+            {
+                fprintf(stderr, "Task error: %s\n", e.what());
+            }
+            catch (...)
+            {
+                fprintf(stderr, "Unknown task error\n");
+            }
+        }
+
+        /**
+         * @brief 按顺序查找任务：本地队列（后进先出）→ 全局队列 → 随机选择起点依次窃取其它槽位
+         * @param item 输出取到的任务
+         * @return 取到任务返回true
+         */
+        bool findTask(base::QueuedTask& item)
+        {
+            base::WSWorkerCtx& ctx = base::t_wsCtx;
+            auto& deques = m_ws->deques;
+
+            base::WSTask* p = (ctx.slot != SIZE_MAX) ? deques[ctx.slot]->pop() : nullptr;
+
+            if (p == nullptr && m_ws->injected.load(std::memory_order_relaxed) > 0)
+            {
+                std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+                base::Lane& lane = *m_lanes[0]; // 工作窃取模式只有默认车道
+                if (!lane.queue.empty())
+                {
+                    item = dequeueLocked(lane); // 同时通知可能等待的生产者
+                    m_ws->injected.fetch_sub(1, std::memory_order_relaxed);
+                    m_ws->pending.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            if (p == nullptr)
+            {
+                // xorshift随机选择起点，遍历一轮所有槽位
+                ctx.rng ^= ctx.rng << 13;
+                ctx.rng ^= ctx.rng >> 7;
+                ctx.rng ^= ctx.rng << 17;
+                size_t n = deques.size();
+                size_t start = static_cast<size_t>(ctx.rng % n);
+                for (size_t ii = 0; ii < n && p == nullptr; ++ii)
+                {
+                    size_t victim = (start + ii) % n;
+                    if (victim != ctx.slot) p = deques[victim]->steal();
+                }
+            }
+
+            if (p == nullptr) return false;
+
+            m_ws->pending.fetch_sub(1, std::memory_order_relaxed);
+            item = std::move(*p);
+            delete p;
+            return true;
+        }
+
+        /**
+         * @brief 工作窃取模式的工作线程主循环
+         * @param stats 工作线程本地统计
+         * @return 动态模式下因空闲超时退出返回true
+         * @note 退出（缩容）时把本地队列中剩余的任务转入全局队列，再释放槽位
+         */
+        bool stealingLoop(base::WorkerStats& stats)
+        {
+            base::WSWorkerCtx& ctx = base::t_wsCtx;
+            ctx.pool = this;
+            ctx.slot = SIZE_MAX;
+            for (size_t ii = 0; ii < m_ws->deques.size(); ++ii)
+            {
+                bool expected = false;
+                if (m_ws->claimed[ii].compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                {
+                    ctx.slot = ii;
+                    break;
+                }
+            }
+            ctx.rng = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+
+            bool retired = false;
+            while (!m_stop)
+            {
+                base::QueuedTask item;
+                if (!findTask(item))
+                {
+                    int64_t sleepNs = stats.sleepBegin(m_counters); // 休眠前合并统计
+
+                    // 没有取到任务：登记为休眠线程后在锁内复查pending，仍为0才等待
+                    std::unique_lock<std::mutex> lock(m_taskQueueMutex);
+                    m_ws->sleepers.fetch_add(1, std::memory_order_seq_cst);
+                    auto waitCond = [this]()
+                    { return m_ws->pending.load(std::memory_order_seq_cst) > 0 || m_stop; };
+                    if constexpr (IsDynamic)
+                    {
+                        // 空闲超过keepAlive且线程数多于下限时退出
+                        if (!m_taskQueueNotEmpty_condVar.wait_for(lock, m_dynamic.keepAlive, waitCond) && tryRetire())
+                            retired = true;
+                    }
+                    else
+                    {
+                        m_taskQueueNotEmpty_condVar.wait(lock, waitCond);
+                    }
+                    m_ws->sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    stats.sleepEnd(sleepNs);
+                    if (retired) break;
+                    continue;
+                }
+
+                // 动态模式：更新空闲线程数
+                if constexpr (IsDynamic)
+                    --m_dynamic.idleThreads;
+
+                runQueued(item, stats);
+
+                // 动态模式：任务完成，恢复空闲状态
+                if constexpr (IsDynamic)
+                    ++m_dynamic.idleThreads;
+            }
+
+            if (ctx.slot != SIZE_MAX)
+            {
+                // 本地剩余任务转入全局队列（线程池停止时直接丢弃，由WSState析构释放）
+                if (!m_stop)
+                {
+                    std::vector<base::WSTask*> left;
+                    while (base::WSTask* p = m_ws->deques[ctx.slot]->pop()) left.push_back(p);
+                    if (!left.empty())
+                    {
+                        {
+                            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+                            for (auto it = left.rbegin(); it != left.rend(); ++it) enqueueLocked(*m_lanes[0], std::move(**it));
+                            m_ws->injected.fetch_add(left.size(), std::memory_order_relaxed);
+                        }
+                        for (base::WSTask* p : left) delete p;
+                        m_taskQueueNotEmpty_condVar.notify_all();
+                    }
+                }
+                m_ws->claimed[ctx.slot].store(false, std::memory_order_release);
+            }
+            ctx = base::WSWorkerCtx();
+            return retired;
+        }
+        // ===========================================================================
+
+        /**
+         * @brief 管理者线程主函数（仅动态模式可用）
+         * @note 平时阻塞在条件变量上，不做周期性检查，只在以下事件时被唤醒：
+         *       1. 入队时积压任务多于空闲线程（requestGrow）：按积压量一次创建所需线程（不超过maxThreads）
+         *       2. 工作线程空闲超时退出：join并从容器中移除
+         *       3. 线程池停止
+         */
+        template <bool D = IsDynamic, typename = std::enable_if_t<D>>
+        void manager()
+        {
+#ifdef DEBUG
+            printf("管理者线程(ID:%zu)启动\n", std::this_thread::get_id());
+#endif
+
+            try
+            {
+                std::unique_lock<std::mutex> lock_manager(m_dynamic.managerMutex);
+                while (true)
+                {
+                    m_dynamic.manager_condVar.wait(lock_manager, [this]()
+                                                   { return m_stop.load(std::memory_order_acquire) ||
+                                                            m_dynamic.growRequested.load(std::memory_order_acquire) ||
+                                                            !m_dynamic.workerExitId_deque.empty(); });
+                    if (m_stop) return;
+
+                    // 取走退出ID队列，之后在不持有managerMutex的情况下处理（工作线程退出时需要该锁）
+                    std::deque<std::thread::id> exitIds;
+                    exitIds.swap(m_dynamic.workerExitId_deque);
+                    lock_manager.unlock();
+
+                    // 1. 清理已退出的线程对象
+                    if (!exitIds.empty()) reapWorkers(exitIds);
+
+                    // 2. 扩容（先清除请求标志，处理期间的新入队可以再次请求）
+                    if (m_dynamic.growRequested.exchange(false, std::memory_order_acq_rel)) grow();
+
+                    lock_manager.lock();
+                }
+            }
+            catch (...)
+            {
+                fprintf(stderr, "Manager thread(ID:%zu) unexpected exception\n", std::this_thread::get_id());
+            }
+        }
+
+        /**
+         * @brief 管理者：join已退出的工作线程并从容器中移除
+         * @param exitIds 已退出的线程ID
+         */
+        void reapWorkers(const std::deque<std::thread::id>& exitIds)
+        {
+            std::lock_guard<std::mutex> lock_workers(m_workersMutex);
+            for (const auto& exitId : exitIds)
+            {
+#ifdef DEBUG
+                printf("待清理线程ID：%zu\n", exitId);
+#endif
+                auto it = m_workers.find(exitId);
+                if (it == m_workers.end()) continue;
+
+                // 先join线程（线程已在退出路径末尾，join很快返回），再从容器中移除
+                joinThread(it->second);
+                m_workers.erase(it);
+            }
+        }
+
+        /**
+         * @brief 管理者：按积压任务数扩容
+         * @note 需要的线程数 = 积压任务数 - 空闲线程数（不超过maxThreads - 存活线程数），一次创建完
+         */
+        void grow()
+        {
+            size_t backlog = 0;
+            if (m_ws)
+            {
+                backlog = m_ws->pending.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock_taskQueue(m_taskQueueMutex);
+                backlog = m_queuedTotal;
+            }
+
+            size_t idle = m_dynamic.idleThreads.load(std::memory_order_relaxed);
+            size_t live = m_dynamic.liveThreads.load(std::memory_order_relaxed);
+            if (backlog <= idle || live >= m_dynamic.maxThreads) return;
+
+            size_t needThreads = std::min(m_dynamic.maxThreads - live, backlog - idle);
+
+            std::lock_guard<std::mutex> lock_workers(m_workersMutex);
+            if (m_stop) return;
+            for (size_t ii = 0; ii < needThreads; ++ii)
+            {
+                m_dynamic.liveThreads.fetch_add(1, std::memory_order_relaxed);
+                m_activeWorkers.fetch_add(1, std::memory_order_release);
+                std::thread th(&TaskPool<IsDynamic>::worker, this);
+#ifdef DEBUG
+                printf("新线程（ID: %zu）\n", th.get_id());
+#endif
+                m_workers.emplace(th.get_id(), std::move(th)); // 哈希表插入新线程
+            }
+            m_counters.scaleUps.fetch_add(needThreads, std::memory_order_relaxed);
+
+            size_t now = m_dynamic.liveThreads.load(std::memory_order_relaxed);
+            size_t peak = m_counters.peakThreads.load(std::memory_order_relaxed);
+            while (now > peak && !m_counters.peakThreads.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+                ;
+#ifdef DEBUG
+            printf("扩容：线程数从 %zu 增加到 %zu（积压任务数: %zu）\n", live, now, backlog);
+#endif
+        }
+    };
+} // namespace ol
+
+#endif // !OL_TASKPOOL_H
\ No newline at end of file
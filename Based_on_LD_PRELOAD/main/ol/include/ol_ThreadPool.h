@@ -8,7 +8,8 @@
  *          - 线程安全：通过互斥锁和条件变量保证多线程环境下的操作安全性
  *          - 动态特性（当模板参数IsDynamic=true时）：
  *              - 自动根据任务负载扩缩容线程数量（在minThreads和maxThreads范围内）
- *              - 可配置管理者线程检查间隔，平衡响应速度和资源消耗
+ *              - ThreadPool<true>即TaskPool<true>（见ol_TaskPool.h）：事件驱动扩缩容，无周期性检查
+ *          注意：ThreadPool<false>内嵌在libol.a编译好的TcpServer中，主模板保持libol.a编译时的定义不变
  * 作者：ol
  * 适用标准：C++17及以上（需支持constexpr if、模板条件类型等特性）
  */
@@ -17,6 +18,7 @@
 #ifndef OL_THREADPOOL_H
 #define OL_THREADPOOL_H 1
 
+#include "ol_TaskPool.h"
 #include "ol_type_traits.h"
 #include <algorithm>
 #include <atomic>
@@ -801,6 +803,20 @@ namespace ol
 #endif
         }
     };
+
+    /**
+     * @brief 动态模式线程池：直接使用TaskPool<true>
+     * @note 主模板的动态模式由管理者线程周期性检查扩缩容，且与TaskPool是两份实现；
+     *       libol.a只实例化了ThreadPool<false>，动态模式没有布局约束，所以统一到TaskPool<true>
+     * @note 构造参数为(minThreadNum, maxThreadNum, maxQueueSize, keepAlive, workStealing)，
+     *       原来的checkInterval参数（秒）即keepAlive，setCheckInterval()等同于setKeepAlive()
+     */
+    template <>
+    class ThreadPool<true> : public TaskPool<true>
+    {
+    public:
+        using TaskPool<true>::TaskPool;
+    };
 } // namespace ol
 
 #endif // !OL_THREADPOOL_H
\ No newline at end of file
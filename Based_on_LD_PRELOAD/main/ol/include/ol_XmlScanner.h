@@ -0,0 +1,345 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_XmlScanner.h
+ * 功能描述：流式零拷贝XML扫描器，面向OL使用的简单XML子集（配置文件等），支持以下特性：
+ *          - 一次遍历整个缓冲区（通常是cmmapfile映射的文件），依次产出叶子元素的(标签, 内容)事件，
+ *            标签和内容都是缓冲区内部的string_view，解析过程不分配内存，开销与文件大小成线性关系
+ *          - 跳过注释（<!-- -->）、处理指令（<?xml ?>）、DOCTYPE，支持跨行元素、自闭合元素（<a/>）、
+ *            CDATA内容（<a><![CDATA[...]]></a>，产出CDATA内部的原始内容）
+ *          - 开始标签中的属性被忽略，容器元素（含子元素）不产出事件，其标签名记在固定大小的栈中
+ *            （最多MAX_DEPTH层，不分配内存），结束标签必须与最近未闭合的开始标签同名
+ *          - 内容原样产出（不修整空白、不解码实体），用ol_string.h中的deleteLRspace()修整
+ *          - 格式错误（注释、标签或元素未闭合，结束标签不匹配或多余，嵌套过深）时停止并记录出错位置和行号
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_XMLSCANNER_H
+#define OL_XMLSCANNER_H 1
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+namespace ol
+{
+
+    // ===========================================================================
+    /**
+     * @brief 叶子元素事件
+     */
+    struct XmlToken
+    {
+        std::string_view m_tag;   ///< 标签名
+        std::string_view m_value; ///< 元素内容（原样，未修整空白）
+        size_t m_depth = 0;       ///< 元素深度（根元素为0）
+        size_t m_offset = 0;      ///< 开始标签在缓冲区中的偏移
+    };
+
+    /**
+     * @brief 流式零拷贝XML扫描器
+     * @note 用法：
+     *       cmmapfile file; file.open(path);
+     *       XmlScanner scanner(file.view());
+     *       XmlToken tok;
+     *       while (scanner.next(tok)) { if (tok.m_tag == "Item") use(deleteLRspace(tok.m_value)); }
+     *       if (!scanner.ok()) 报错：scanner.error()、scanner.errorLine()
+     *       缓冲区必须在使用事件期间保持有效。
+     */
+    class XmlScanner
+    {
+    public:
+        static constexpr size_t MAX_DEPTH = 64; ///< 容器元素的最大嵌套深度
+
+    private:
+        std::string_view m_buf;                 ///< 缓冲区
+        size_t m_pos = 0;                       ///< 当前扫描位置
+        size_t m_depth = 0;                     ///< 当前深度（已进入的容器元素数）
+        std::string_view m_open[MAX_DEPTH];     ///< 已进入的容器元素的标签名（指向缓冲区）
+        const char* m_error = nullptr;          ///< 错误描述（nullptr表示无错误）
+        size_t m_errorPos = 0;                  ///< 出错位置
+
+        // 记录错误并停止扫描。
+        bool fail(const char* what, size_t pos)
+        {
+            m_error = what;
+            m_errorPos = pos;
+            m_pos = m_buf.size();
+            return false;
+        }
+
+        static bool isSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        // buf[pos]起是否为前缀s。
+        bool startsWith(size_t pos, std::string_view s) const
+        {
+            return m_buf.size() - pos >= s.size() && std::memcmp(m_buf.data() + pos, s.data(), s.size()) == 0;
+        }
+
+        // 从pos起查找终止串，返回终止串之后的位置，找不到返回npos。
+        size_t skipPast(size_t pos, std::string_view term) const
+        {
+            size_t end = m_buf.find(term, pos);
+            return end == std::string_view::npos ? end : end + term.size();
+        }
+
+        // 跳过标签剩余部分（属性，引号内的'>'不算），返回'>'的位置，找不到返回npos。
+        size_t findTagEnd(size_t pos) const
+        {
+            char quote = 0;
+            for (; pos < m_buf.size(); ++pos)
+            {
+                char c = m_buf[pos];
+                if (quote)
+                {
+                    if (c == quote) quote = 0;
+                }
+                else if (c == '"' || c == '\'')
+                    quote = c;
+                else if (c == '>')
+                    return pos;
+            }
+            return std::string_view::npos;
+        }
+
+        /**
+         * @brief 跳过pos处的注释、处理指令、DOCTYPE（pos指向'<'）
+         * @return 跳过后的位置；不是这几种标记返回pos；未闭合返回npos
+         */
+        size_t skipMarkup(size_t pos) const
+        {
+            if (startsWith(pos, "<!--")) return skipPast(pos + 4, "-->");
+            if (startsWith(pos, "<?")) return skipPast(pos + 2, "?>");
+            if (startsWith(pos, "<!") && !startsWith(pos, "<![CDATA[")) return skipPast(pos + 2, ">");
+            return pos;
+        }
+
+        /**
+         * @brief 扫描元素内容，判断是否为叶子元素
+         * @param tag 标签名
+         * @param pos 内容起始位置（开始标签的'>'之后）
+         * @param tok 输出：叶子元素的内容
+         * @return 1-叶子元素（m_pos移到结束标签之后），0-容器元素（遇到子元素），-1-格式错误
+         * @note 内容中夹有注释时，内容视图从第一段非空白文本开始，到最后一段非空白文本结束（包含中间的注释）
+         */
+        int scanContent(std::string_view tag, size_t pos, XmlToken& tok)
+        {
+            size_t first = std::string_view::npos, last = pos; // 非空白文本的范围
+            size_t cur = pos;
+            while (true)
+            {
+                const char* lt = static_cast<const char*>(std::memchr(m_buf.data() + cur, '<', m_buf.size() - cur));
+                if (lt == nullptr)
+                {
+                    fail("element not closed", pos);
+                    return -1;
+                }
+                size_t ltPos = static_cast<size_t>(lt - m_buf.data());
+
+                // 记录这段文本中的非空白范围
+                for (size_t ii = cur; ii < ltPos; ++ii)
+                {
+                    if (isSpace(m_buf[ii])) continue;
+                    if (first == std::string_view::npos) first = ii;
+                    size_t jj = ltPos;
+                    while (jj > ii && isSpace(m_buf[jj - 1])) --jj;
+                    last = jj;
+                    break;
+                }
+
+                if (startsWith(ltPos, "</"))
+                {
+                    // 结束标签：必须与开始标签同名
+                    size_t nameEnd = ltPos + 2 + tag.size();
+                    if (nameEnd > m_buf.size() || m_buf.compare(ltPos + 2, tag.size(), tag) != 0 ||
+                        (nameEnd < m_buf.size() && m_buf[nameEnd] != '>' && !isSpace(m_buf[nameEnd])))
+                    {
+                        fail("mismatched closing tag", ltPos);
+                        return -1;
+                    }
+                    size_t gt = m_buf.find('>', nameEnd);
+                    if (gt == std::string_view::npos)
+                    {
+                        fail("tag not closed", ltPos);
+                        return -1;
+                    }
+
+                    tok.m_value = first == std::string_view::npos ? m_buf.substr(pos, ltPos - pos) : m_buf.substr(first, last - first);
+                    m_pos = gt + 1;
+                    return 1;
+                }
+
+                if (startsWith(ltPos, "<![CDATA["))
+                {
+                    size_t end = m_buf.find("]]>", ltPos + 9);
+                    if (end == std::string_view::npos)
+                    {
+                        fail("CDATA not closed", ltPos);
+                        return -1;
+                    }
+                    if (first == std::string_view::npos) first = ltPos + 9; // 内容以CDATA开头时只取其内部文本
+                    last = end;
+                    cur = end + 3;
+                    continue;
+                }
+
+                size_t next = skipMarkup(ltPos);
+                if (next == std::string_view::npos)
+                {
+                    fail("comment or declaration not closed", ltPos);
+                    return -1;
+                }
+                if (next != ltPos)
+                {
+                    cur = next;
+                    continue;
+                }
+
+                return 0; // 子元素：本元素是容器
+            }
+        }
+
+    public:
+        XmlScanner() = default;
+
+        /**
+         * @brief 构造函数
+         * @param buf 待扫描的缓冲区（使用期间必须保持有效）
+         */
+        explicit XmlScanner(std::string_view buf) : m_buf(buf)
+        {
+        }
+
+        /**
+         * @brief 重新开始扫描新的缓冲区
+         * @param buf 缓冲区
+         */
+        void reset(std::string_view buf)
+        {
+            m_buf = buf;
+            m_pos = 0;
+            m_depth = 0;
+            m_error = nullptr;
+            m_errorPos = 0;
+        }
+
+        /**
+         * @brief 取下一个叶子元素
+         * @param tok 输出事件
+         * @return true-取到，false-扫描结束或出错（用ok()区分）
+         */
+        bool next(XmlToken& tok)
+        {
+            while (m_pos < m_buf.size())
+            {
+                const char* lt = static_cast<const char*>(std::memchr(m_buf.data() + m_pos, '<', m_buf.size() - m_pos));
+                if (lt == nullptr)
+                {
+                    m_pos = m_buf.size();
+                    break;
+                }
+                size_t pos = static_cast<size_t>(lt - m_buf.data());
+
+                // 注释、处理指令、DOCTYPE
+                size_t next = skipMarkup(pos);
+                if (next == std::string_view::npos) return fail("comment or declaration not closed", pos);
+                if (next != pos)
+                {
+                    m_pos = next;
+                    continue;
+                }
+
+                // 容器元素的结束标签：必须与最近未闭合的容器元素同名
+                if (startsWith(pos, "</"))
+                {
+                    size_t nameEnd = pos + 2;
+                    while (nameEnd < m_buf.size() && !isSpace(m_buf[nameEnd]) && m_buf[nameEnd] != '>') ++nameEnd;
+                    if (m_depth == 0) return fail("unexpected closing tag", pos);
+                    if (m_buf.substr(pos + 2, nameEnd - pos - 2) != m_open[m_depth - 1]) return fail("mismatched closing tag", pos);
+                    size_t gt = m_buf.find('>', nameEnd);
+                    if (gt == std::string_view::npos) return fail("tag not closed", pos);
+                    --m_depth;
+                    m_pos = gt + 1;
+                    continue;
+                }
+
+                // 容器之间的CDATA（没有所属的叶子元素）直接跳过
+                if (startsWith(pos, "<![CDATA["))
+                {
+                    size_t end = skipPast(pos + 9, "]]>");
+                    if (end == std::string_view::npos) return fail("CDATA not closed", pos);
+                    m_pos = end;
+                    continue;
+                }
+
+                // 开始标签
+                size_t nameBegin = pos + 1, nameEnd = nameBegin;
+                while (nameEnd < m_buf.size() && !isSpace(m_buf[nameEnd]) && m_buf[nameEnd] != '>' && m_buf[nameEnd] != '/') ++nameEnd;
+                if (nameEnd == nameBegin) return fail("empty tag name", pos);
+                size_t gt = findTagEnd(nameEnd);
+                if (gt == std::string_view::npos) return fail("tag not closed", pos);
+
+                tok.m_tag = m_buf.substr(nameBegin, nameEnd - nameBegin);
+                tok.m_depth = m_depth;
+                tok.m_offset = pos;
+
+                // 自闭合元素：内容为空
+                if (m_buf[gt - 1] == '/')
+                {
+                    tok.m_value = std::string_view();
+                    m_pos = gt + 1;
+                    return true;
+                }
+
+                int r = scanContent(tok.m_tag, gt + 1, tok);
+                if (r < 0) return false;
+                if (r > 0) return true;
+
+                // 容器元素：进入下一层
+                if (m_depth == MAX_DEPTH) return fail("element nested too deep", pos);
+                m_open[m_depth++] = tok.m_tag;
+                m_pos = gt + 1;
+            }
+
+            // 到达末尾时仍有未闭合的容器元素（如文件被截断），出错位置为最内层的开始标签
+            if (m_depth > 0 && m_error == nullptr)
+                return fail("element not closed", static_cast<size_t>(m_open[m_depth - 1].data() - m_buf.data()) - 1);
+            return false;
+        }
+
+        // 是否没有出错（扫描结束后用来区分正常结束和格式错误）。
+        bool ok() const
+        {
+            return m_error == nullptr;
+        }
+
+        // 错误描述（没有错误时返回nullptr）。
+        const char* error() const
+        {
+            return m_error;
+        }
+
+        // 出错位置。
+        size_t errorPos() const
+        {
+            return m_errorPos;
+        }
+
+        // 出错位置所在的行号（从1开始，只在出错时计算）。
+        size_t errorLine() const
+        {
+            size_t line = 1;
+            for (size_t ii = 0; ii < m_errorPos && ii < m_buf.size(); ++ii)
+                if (m_buf[ii] == '\n') ++line;
+            return line;
+        }
+    };
+    // ===========================================================================
+
+} // namespace ol
+
+#endif // !OL_XMLSCANNER_H
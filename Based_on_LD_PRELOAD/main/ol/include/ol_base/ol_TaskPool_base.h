@@ -0,0 +1,459 @@
+#ifndef OL_TASKPOOL_BASE_H
+#define OL_TASKPOOL_BASE_H 1
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <queue>
+#include <type_traits>
+#include <vector>
+
+namespace ol
+{
+
+    // 线程池内部实现
+    // ===========================================================================
+    namespace base
+    {
+        // 任务类型
+        // -----------------------------------------------------------------------
+        template <typename T>
+        struct is_std_function : std::false_type
+        {
+        };
+        template <typename R, typename... Args>
+        struct is_std_function<std::function<R(Args...)>> : std::true_type
+        {
+        };
+
+        /**
+         * @brief 只可移动的无参任务包装（小对象内联存储）
+         * @note 1）不超过TASK_INLINE_SIZE（40）字节、可无异常移动的可调用对象直接存放在对象内部（整个对象48字节），否则在堆上分配；
+         *       2）与std::function不同，可以保存只可移动的可调用对象（如std::packaged_task、捕获unique_ptr的lambda）；
+         *       3）可调用对象的返回值被丢弃；空函数指针、空std::function构造出的是空任务。
+         */
+        class Task
+        {
+        public:
+            static constexpr size_t TASK_INLINE_SIZE = 40; ///< 内联存储大小（整个对象48字节，加上入队时间的QueuedTask正好64字节）
+
+        private:
+            // 按存储方式生成的操作表
+            struct Ops
+            {
+                void (*invoke)(void* buf);
+                void (*move)(void* dst, void* src); // 移动构造到dst并析构src
+                void (*destroy)(void* buf);
+            };
+
+            template <typename F>
+            static constexpr bool fitsInline = sizeof(F) <= TASK_INLINE_SIZE &&
+                                               alignof(F) <= alignof(std::max_align_t) &&
+                                               std::is_nothrow_move_constructible_v<F>;
+
+            template <typename F>
+            struct InlineOps
+            {
+                static void invoke(void* buf) { (*static_cast<F*>(buf))(); }
+                static void move(void* dst, void* src)
+                {
+                    ::new (dst) F(std::move(*static_cast<F*>(src)));
+                    static_cast<F*>(src)->~F();
+                }
+                static void destroy(void* buf) { static_cast<F*>(buf)->~F(); }
+                static constexpr Ops ops{invoke, move, destroy};
+            };
+
+            template <typename F>
+            struct HeapOps
+            {
+                static void invoke(void* buf) { (**static_cast<F**>(buf))(); }
+                static void move(void* dst, void* src) { *static_cast<F**>(dst) = *static_cast<F**>(src); }
+                static void destroy(void* buf) { delete *static_cast<F**>(buf); }
+                static constexpr Ops ops{invoke, move, destroy};
+            };
+
+            alignas(std::max_align_t) unsigned char m_buf[TASK_INLINE_SIZE]; ///< 内联存储区（堆存储时存放指针）
+            const Ops* m_ops = nullptr;                                      ///< 操作表（为空表示空任务）
+
+        public:
+            Task() noexcept = default;
+            Task(std::nullptr_t) noexcept {}
+
+            /**
+             * @brief 用任意无参可调用对象构造任务
+             * @param f 可调用对象（按值移动或复制进任务）
+             */
+            template <typename F, typename D = std::decay_t<F>,
+                      typename = std::enable_if_t<!std::is_same_v<D, Task> && std::is_invocable_v<D&>>>
+            Task(F&& f)
+            {
+                if constexpr (std::is_pointer_v<D> || is_std_function<D>::value)
+                {
+                    if (!f) return;
+                }
+
+                if constexpr (fitsInline<D>)
+                {
+                    ::new (static_cast<void*>(m_buf)) D(std::forward<F>(f));
+                    m_ops = &InlineOps<D>::ops;
+                }
+                else
+                {
+                    *reinterpret_cast<D**>(m_buf) = new D(std::forward<F>(f));
+                    m_ops = &HeapOps<D>::ops;
+                }
+            }
+
+            Task(Task&& other) noexcept : m_ops(other.m_ops)
+            {
+                if (m_ops)
+                {
+                    m_ops->move(m_buf, other.m_buf);
+                    other.m_ops = nullptr;
+                }
+            }
+
+            Task& operator=(Task&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    if (other.m_ops)
+                    {
+                        other.m_ops->move(m_buf, other.m_buf);
+                        m_ops = other.m_ops;
+                        other.m_ops = nullptr;
+                    }
+                }
+                return *this;
+            }
+
+            Task(const Task&) = delete;
+            Task& operator=(const Task&) = delete;
+
+            ~Task() { reset(); }
+
+            // 释放保存的可调用对象，变为空任务
+            void reset() noexcept
+            {
+                if (m_ops)
+                {
+                    m_ops->destroy(m_buf);
+                    m_ops = nullptr;
+                }
+            }
+
+            explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+            // 执行任务（调用前需保证非空）
+            void operator()() { m_ops->invoke(m_buf); }
+        };
+
+        // 单调时钟（纳秒）
+        inline int64_t nowNs()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static constexpr uint32_t WAIT_SAMPLE_MASK = 15; ///< 每16个任务抽样1个统计排队时间
+
+        /**
+         * @brief 单个提交任务的入队时间戳（抽样）
+         * @return 抽中时返回当前时间，否则返回0（不统计该任务的排队时间）
+         * @note 读时钟约30纳秒，逐个打时间戳会让入队开销翻倍，所以只抽样
+         */
+        inline int64_t sampleEnqueueNs()
+        {
+            thread_local uint32_t t_count = 0;
+            return ((++t_count & WAIT_SAMPLE_MASK) == 0) ? nowNs() : 0;
+        }
+
+        /**
+         * @brief 队列中的任务（附带入队时间，用于统计排队等待时间）
+         */
+        struct QueuedTask
+        {
+            Task task;             ///< 任务
+            int64_t enqueueNs = 0; ///< 入队时间（nowNs()，0表示未抽样）
+        };
+        static_assert(sizeof(Task) == 48, "Task should be TASK_INLINE_SIZE bytes plus the ops pointer");
+        static_assert(sizeof(QueuedTask) == 64, "QueuedTask should fill exactly one cache line");
+        // -----------------------------------------------------------------------
+
+        // 优先级车道
+        // -----------------------------------------------------------------------
+        // 队列满处理策略
+        enum class QueueFullPolicy : char
+        {
+            kReject, ///< 拒绝新任务
+            kBlock,  ///< 阻塞等待
+            kTimeout ///< 超时等待
+        };
+
+        /**
+         * @brief 一条优先级车道：独立的任务队列、容量、队列满策略、调度权重和保留线程数
+         * @note 所有字段都由线程池的任务队列锁保护
+         */
+        struct Lane
+        {
+            std::queue<QueuedTask> queue;                    ///< 任务队列
+            std::condition_variable notFull;                 ///< 队列非满条件变量
+            size_t maxQueueSize = 0;                         ///< 最大队列容量（0表示无限制）
+            QueueFullPolicy policy = QueueFullPolicy::kReject; ///< 队列满策略
+            std::chrono::milliseconds timeout{500};          ///< 超时策略的等待时间
+            unsigned weight = 1;                             ///< 加权轮转的权重
+            size_t reserved = 0;                             ///< 保留给本车道的最少工作线程数
+            size_t running = 0;                              ///< 正在执行的本车道任务数（仅有保留时记账）
+            int64_t current = 0;                             ///< 平滑加权轮转的当前值
+
+            // 队列是否已满
+            bool full() const
+            {
+                return maxQueueSize > 0 && queue.size() >= maxQueueSize;
+            }
+        };
+        // -----------------------------------------------------------------------
+
+        // 运行统计
+        // -----------------------------------------------------------------------
+        /**
+         * @brief 线程池共享的统计计数（工作线程批量累加，避免每个任务都写共享缓存行）
+         */
+        struct PoolCounters
+        {
+            alignas(64) std::atomic_uint64_t completed{0}; ///< 已执行完的任务数
+            std::atomic_uint64_t waitNs{0};                ///< 抽样任务的排队等待时间总和
+            std::atomic_uint64_t waitSamples{0};           ///< 抽样任务数
+            std::atomic_uint64_t waitMaxNs{0};             ///< 抽样任务的最长排队等待时间
+            std::atomic_uint64_t busyNs{0};                ///< 非空闲时间总和
+            std::atomic_uint64_t idleNs{0};                ///< 空闲（休眠等待任务）时间总和
+            alignas(64) std::atomic_uint64_t scaleUps{0};  ///< 扩容创建的线程数
+            std::atomic_uint64_t scaleDowns{0};            ///< 缩容退出的线程数
+            std::atomic_size_t peakThreads{0};             ///< 线程数峰值
+        };
+
+        /**
+         * @brief 工作线程本地的统计累加器
+         * @note 1）空闲时间只在休眠前后读时钟，非空闲时间 = 两次合并之间的时长 - 其间的空闲时间，执行任务本身不读时钟；
+         *       2）每执行FLUSH_EVERY个任务、休眠前（距上次合并超过1毫秒）和退出时合并到PoolCounters。
+         */
+        struct WorkerStats
+        {
+            static constexpr uint64_t FLUSH_EVERY = 64;        ///< 每执行多少个任务合并一次
+            static constexpr int64_t FLUSH_SLEEP_NS = 1000000; ///< 休眠前距上次合并超过1毫秒才合并
+
+            uint64_t completed = 0;
+            uint64_t waitNs = 0;
+            uint64_t waitSamples = 0;
+            uint64_t waitMaxNs = 0;
+            uint64_t idleNs = 0;
+            int64_t lastFlushNs = nowNs(); ///< 上一次合并的时间
+
+            // 取到任务：抽样任务累加排队时间
+            void taken(int64_t enqueueNs)
+            {
+                if (enqueueNs == 0) return;
+                int64_t t = nowNs();
+                uint64_t wait = t > enqueueNs ? static_cast<uint64_t>(t - enqueueNs) : 0;
+                waitNs += wait;
+                ++waitSamples;
+                if (wait > waitMaxNs) waitMaxNs = wait;
+            }
+
+            // 任务完成：必要时合并
+            void done(PoolCounters& counters)
+            {
+                if (++completed >= FLUSH_EVERY) flush(counters);
+            }
+
+            // 开始休眠：距上次合并超过FLUSH_SLEEP_NS时先合并（频繁短暂休眠时不必每次都写共享计数），返回休眠开始时间
+            int64_t sleepBegin(PoolCounters& counters)
+            {
+                int64_t t = nowNs();
+                return (t - lastFlushNs > FLUSH_SLEEP_NS) ? flush(counters) : t;
+            }
+
+            // 结束休眠：累加空闲时间
+            void sleepEnd(int64_t beginNs)
+            {
+                idleNs += static_cast<uint64_t>(nowNs() - beginNs);
+            }
+
+            // 合并到共享计数并清零，返回当前时间
+            int64_t flush(PoolCounters& counters)
+            {
+                int64_t t = nowNs();
+                uint64_t span = static_cast<uint64_t>(t - lastFlushNs);
+                lastFlushNs = t;
+
+                counters.completed.fetch_add(completed, std::memory_order_relaxed);
+                counters.busyNs.fetch_add(span > idleNs ? span - idleNs : 0, std::memory_order_relaxed);
+                counters.idleNs.fetch_add(idleNs, std::memory_order_relaxed);
+                if (waitSamples > 0)
+                {
+                    counters.waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+                    counters.waitSamples.fetch_add(waitSamples, std::memory_order_relaxed);
+                    uint64_t cur = counters.waitMaxNs.load(std::memory_order_relaxed);
+                    while (waitMaxNs > cur && !counters.waitMaxNs.compare_exchange_weak(cur, waitMaxNs, std::memory_order_relaxed))
+                        ;
+                }
+                completed = waitNs = waitSamples = waitMaxNs = idleNs = 0;
+                return t;
+            }
+        };
+        // -----------------------------------------------------------------------
+
+        // 工作窃取相关实现
+        // -----------------------------------------------------------------------
+        static constexpr size_t WSDEQUE_CAPACITY = 4096; ///< 每个工作线程本地双端队列的容量（2的幂）
+
+        /**
+         * @brief Chase-Lev工作窃取双端队列（定长）
+         * @tparam T 元素类型（指针，空指针表示取不到元素）
+         * @tparam CAP 容量（必须是2的幂）
+         * @note 1）只有所属工作线程调用push()/pop()（在bottom端后进先出），其它线程调用steal()（在top端先进先出）；
+         *       2）定长不扩容，push()返回false时由调用者改投全局队列；
+         *       3）内存序参照Lê等人的C11版本实现。
+         */
+        template <typename T, size_t CAP = WSDEQUE_CAPACITY>
+        class WSDeque
+        {
+            static_assert(CAP > 0 && (CAP & (CAP - 1)) == 0, "CAP must be a power of 2");
+            static_assert(std::is_pointer_v<T>, "T must be a pointer type");
+
+        private:
+            alignas(64) std::atomic<int64_t> m_top{0};    ///< 窃取端位置
+            alignas(64) std::atomic<int64_t> m_bottom{0}; ///< 所属线程端位置
+            alignas(64) std::atomic<T> m_buf[CAP];        ///< 环形缓冲区
+
+        public:
+            WSDeque()
+            {
+                for (auto& slot : m_buf) slot.store(nullptr, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief 所属线程压入元素
+             * @param x 元素
+             * @return 成功返回true，队列已满返回false
+             */
+            bool push(T x)
+            {
+                int64_t b = m_bottom.load(std::memory_order_relaxed);
+                int64_t t = m_top.load(std::memory_order_acquire);
+                if (b - t >= static_cast<int64_t>(CAP)) return false;
+
+                m_buf[b & (CAP - 1)].store(x, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return true;
+            }
+
+            /**
+             * @brief 所属线程弹出最近压入的元素
+             * @return 元素，队列为空（或最后一个元素被窃取）时返回nullptr
+             */
+            T pop()
+            {
+                int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+                m_bottom.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t t = m_top.load(std::memory_order_relaxed);
+
+                if (t > b)
+                {
+                    m_bottom.store(b + 1, std::memory_order_relaxed); // 队列为空
+                    return nullptr;
+                }
+
+                T x = m_buf[b & (CAP - 1)].load(std::memory_order_relaxed);
+                if (t == b)
+                {
+                    // 只剩最后一个元素，与窃取者竞争
+                    if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        x = nullptr;
+                    m_bottom.store(b + 1, std::memory_order_relaxed);
+                }
+                return x;
+            }
+
+            /**
+             * @brief 其它线程窃取最早压入的元素
+             * @return 元素，队列为空或竞争失败时返回nullptr
+             */
+            T steal()
+            {
+                int64_t t = m_top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t b = m_bottom.load(std::memory_order_acquire);
+                if (t >= b) return nullptr;
+
+                T x = m_buf[t & (CAP - 1)].load(std::memory_order_relaxed);
+                if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    return nullptr;
+                return x;
+            }
+
+            // 近似元素个数（仅用于统计）
+            size_t size() const
+            {
+                int64_t n = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+                return n > 0 ? static_cast<size_t>(n) : 0;
+            }
+        };
+
+        using WSTask = QueuedTask; ///< 本地队列中的任务（堆上分配，队列中存指针）
+
+        /**
+         * @brief 工作窃取模式的共享状态
+         * @note 槽位数等于最大线程数，工作线程启动时占用一个空闲槽位，退出时把本地剩余任务转入全局队列后释放
+         */
+        struct WSState
+        {
+            std::vector<std::unique_ptr<WSDeque<WSTask*>>> deques; ///< 各槽位的本地队列
+            std::unique_ptr<std::atomic_bool[]> claimed;           ///< 槽位是否已被占用
+            alignas(64) std::atomic_size_t pending{0};             ///< 尚未被取走的任务总数（本地队列+全局队列）
+            alignas(64) std::atomic_size_t injected{0};            ///< 全局队列中的任务数（为0时工作线程不必加锁查看全局队列）
+            alignas(64) std::atomic_size_t sleepers{0};            ///< 正在休眠等待任务的工作线程数
+
+            explicit WSState(size_t slots) : claimed(new std::atomic_bool[slots])
+            {
+                deques.reserve(slots);
+                for (size_t ii = 0; ii < slots; ++ii)
+                {
+                    deques.emplace_back(new WSDeque<WSTask*>());
+                    claimed[ii].store(false, std::memory_order_relaxed);
+                }
+            }
+
+            ~WSState()
+            {
+                // 线程池停止后仍留在本地队列中的任务直接丢弃（与全局队列的行为一致）
+                for (auto& dq : deques)
+                    while (WSTask* task = dq->pop()) delete task;
+            }
+        };
+
+        /**
+         * @brief 当前线程所属的线程池及槽位（非工作线程为空）
+         */
+        struct WSWorkerCtx
+        {
+            const void* pool = nullptr; ///< 所属线程池
+            size_t slot = 0;            ///< 占用的槽位（SIZE_MAX表示没有槽位）
+            uint64_t rng = 0;           ///< 随机选择窃取对象用的xorshift状态
+        };
+        inline thread_local WSWorkerCtx t_wsCtx;
+        // -----------------------------------------------------------------------
+    } // namespace base
+    // ===========================================================================
+
+} // namespace ol
+
+#endif // !OL_TASKPOOL_BASE_H
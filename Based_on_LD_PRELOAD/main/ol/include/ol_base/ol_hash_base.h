@@ -0,0 +1,79 @@
+#ifndef OL_HASH_BASE_H
+#define OL_HASH_BASE_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ol
+{
+
+    // 哈希公共组件 (内部实现)
+    // ===========================================================================
+    namespace base
+    {
+        // wyhash的常数（奇数，每个字节恰有4个1，乘法后各位充分混合）
+        constexpr uint64_t HASH_SECRET0 = 0x2d358dccaa6c78a5ULL;
+        constexpr uint64_t HASH_SECRET1 = 0x8bb84b93962eacc9ULL;
+        constexpr uint64_t HASH_SECRET2 = 0x4b33a62ed433d4a3ULL;
+        constexpr uint64_t HASH_SECRET3 = 0x4d5a2da51de1aa47ULL;
+
+        // 乘法与折叠
+        // -----------------------------------------------------------------------
+        /**
+         * @brief 64x64→128位乘法，低64位写回a，高64位写回b
+         */
+        inline void hash_mum(uint64_t& a, uint64_t& b) noexcept
+        {
+#ifdef __SIZEOF_INT128__
+            __uint128_t r = static_cast<__uint128_t>(a) * b;
+            a = static_cast<uint64_t>(r);
+            b = static_cast<uint64_t>(r >> 64);
+#else
+            uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+            uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            uint64_t t = rl + (rm0 << 32);
+            uint64_t c = t < rl;
+            uint64_t lo = t + (rm1 << 32);
+            c += lo < t;
+            a = lo;
+            b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+        }
+
+        /**
+         * @brief 128位乘积的高低两半异或（一次宽乘法完成全部混合）
+         */
+        inline uint64_t hash_mix(uint64_t a, uint64_t b) noexcept
+        {
+            hash_mum(a, b);
+            return a ^ b;
+        }
+
+        // 非对齐读取（小端序，与平台无关的结果只在小端机上保证）
+        // -----------------------------------------------------------------------
+        inline uint64_t hash_r8(const uint8_t* p) noexcept
+        {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            return v;
+        }
+
+        inline uint64_t hash_r4(const uint8_t* p) noexcept
+        {
+            uint32_t v;
+            std::memcpy(&v, p, 4);
+            return v;
+        }
+
+        // 1~3字节：首、中、尾三个字节拼成一个值
+        inline uint64_t hash_r3(const uint8_t* p, size_t k) noexcept
+        {
+            return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+        }
+    } // namespace base
+    // ===========================================================================
+
+} // namespace ol
+
+#endif // !OL_HASH_BASE_H
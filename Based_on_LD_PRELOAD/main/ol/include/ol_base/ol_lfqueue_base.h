@@ -0,0 +1,215 @@
+#ifndef OL_LFQUEUE_BASE_H
+#define OL_LFQUEUE_BASE_H 1
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace ol
+{
+
+    // 无锁队列公共组件 (内部实现)
+    // ===========================================================================
+    namespace base
+    {
+        constexpr size_t LFQ_CACHELINE = 64; ///< 缓存行大小，头尾计数器各占一行避免伪共享
+
+        // futex封装
+        // -----------------------------------------------------------------------
+        /**
+         * @brief 当*addr仍等于expected时睡眠，直到被唤醒或超时
+         * @param addr 等待的32位原子变量
+         * @param expected 期望值（不相等时立即返回）
+         * @param shared true-跨进程（共享内存中的变量），false-进程内（使用FUTEX_PRIVATE_FLAG，更快）
+         * @param timeoutNs 超时时间（纳秒，小于0表示无限等待）
+         * @note 非Linux平台退化为短暂休眠，调用方总是在循环中重新检查条件
+         */
+        inline void futexWait(std::atomic<uint32_t>* addr, uint32_t expected, bool shared, int64_t timeoutNs)
+        {
+#ifdef __linux__
+            static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+            struct timespec ts;
+            struct timespec* pts = nullptr;
+            if (timeoutNs >= 0)
+            {
+                ts.tv_sec = timeoutNs / 1000000000;
+                ts.tv_nsec = timeoutNs % 1000000000;
+                pts = &ts;
+            }
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr),
+                    shared ? FUTEX_WAIT : (FUTEX_WAIT | FUTEX_PRIVATE_FLAG),
+                    expected, pts, nullptr, 0);
+#else
+            (void)shared;
+            if (addr->load(std::memory_order_acquire) != expected) return;
+            int64_t ns = (timeoutNs >= 0 && timeoutNs < 50000) ? timeoutNs : 50000;
+            std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+#endif // __linux__
+        }
+
+        /**
+         * @brief 唤醒在addr上等待的线程
+         * @param addr 等待的32位原子变量
+         * @param shared 是否跨进程（必须与futexWait一致）
+         * @param count 最多唤醒的线程数
+         */
+        inline void futexWake(std::atomic<uint32_t>* addr, bool shared, int count)
+        {
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr),
+                    shared ? FUTEX_WAKE : (FUTEX_WAKE | FUTEX_PRIVATE_FLAG),
+                    count, nullptr, nullptr, 0);
+#else
+            (void)addr, (void)shared, (void)count;
+#endif // __linux__
+        }
+
+        // 事件计数器（阻塞等待"非空"/"非满"）
+        // -----------------------------------------------------------------------
+        /**
+         * @brief 基于futex的事件计数器，不含指针，可放在共享内存中（全0即为初始状态）
+         * @note 等待方：key = prepareWait(); 重新检查条件; 条件仍不满足时 wait(key)，否则 cancelWait()；
+         *       通知方：改变条件后调用notify()，没有等待者时只有一次fence和一次load，不做系统调用。
+         */
+        struct EventCount
+        {
+            std::atomic<uint32_t> m_seq;     ///< 事件序号（futex字）
+            std::atomic<uint32_t> m_waiters; ///< 正在等待的线程数
+
+            // 登记为等待者并取得当前序号
+            uint32_t prepareWait()
+            {
+                m_waiters.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return m_seq.load(std::memory_order_seq_cst);
+            }
+
+            // 条件已满足，取消等待登记
+            void cancelWait()
+            {
+                m_waiters.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief 睡眠直到序号变化（prepareWait之后有通知则立即返回）
+             * @param key prepareWait返回的序号
+             * @param shared 是否跨进程
+             * @param timeoutNs 超时时间（纳秒，小于0表示无限等待）
+             */
+            void wait(uint32_t key, bool shared, int64_t timeoutNs)
+            {
+                futexWait(&m_seq, key, shared, timeoutNs);
+                m_waiters.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief 通知等待者（条件改变之后调用）
+             * @param shared 是否跨进程
+             * @param all true-唤醒全部等待者（批量操作后），false-唤醒一个
+             */
+            void notify(bool shared, bool all)
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_waiters.load(std::memory_order_relaxed) == 0) return;
+                m_seq.fetch_add(1, std::memory_order_seq_cst);
+                futexWake(&m_seq, shared, all ? INT_MAX : 1);
+            }
+        };
+
+        /**
+         * @brief 按条件阻塞等待的通用循环
+         * @param ev 事件计数器
+         * @param shared 是否跨进程
+         * @param timeout 超时时间（小于0表示无限等待）
+         * @param attempt 尝试操作的函数（成功返回true）
+         * @return attempt成功返回true，超时返回false
+         * @note 先自旋少量次数，仍失败再用futex睡眠，避免短暂空/满时的系统调用
+         */
+        template <typename Attempt>
+        bool blockingRetry(EventCount& ev, bool shared, std::chrono::nanoseconds timeout, Attempt&& attempt)
+        {
+            for (int spin = 0; spin < 64; ++spin)
+            {
+                if (attempt()) return true;
+            }
+
+            const bool infinite = timeout.count() < 0;
+            const auto deadline = std::chrono::steady_clock::now() + (infinite ? std::chrono::nanoseconds(0) : timeout);
+            while (true)
+            {
+                uint32_t key = ev.prepareWait();
+                if (attempt())
+                {
+                    ev.cancelWait();
+                    return true;
+                }
+
+                int64_t remain = -1;
+                if (!infinite)
+                {
+                    remain = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+                    if (remain <= 0)
+                    {
+                        ev.cancelWait();
+                        return attempt();
+                    }
+                }
+                ev.wait(key, shared, remain);
+                if (attempt()) return true;
+            }
+        }
+
+        // 元素存储
+        // -----------------------------------------------------------------------
+        /**
+         * @brief 未初始化的元素存储（由队列决定何时构造和析构）
+         * @tparam T 元素类型
+         */
+        template <typename T>
+        struct SlotStorage
+        {
+            alignas(T) unsigned char m_buf[sizeof(T)];
+
+            T* ptr() { return std::launder(reinterpret_cast<T*>(m_buf)); }
+
+            template <typename... Args>
+            void construct(Args&&... args) { ::new (static_cast<void*>(m_buf)) T(std::forward<Args>(args)...); }
+
+            // 移出元素并析构存储中的对象
+            void moveOut(T& out)
+            {
+                T* p = ptr();
+                out = std::move(*p);
+                p->~T();
+            }
+
+            void destroy() { ptr()->~T(); }
+        };
+
+        // Vyukov有界队列的槽位：序号 + 元素
+        template <typename T>
+        struct SeqSlot
+        {
+            std::atomic<size_t> m_seq; ///< 槽位序号（等于位置时可写，等于位置+1时可读）
+            SlotStorage<T> m_data;     ///< 元素
+        };
+    } // namespace base
+    // ===========================================================================
+
+} // namespace ol
+
+#endif // !OL_LFQUEUE_BASE_H
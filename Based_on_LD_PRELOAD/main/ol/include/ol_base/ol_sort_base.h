@@ -1,6 +1,7 @@
 #ifndef OL_SORT_BASE_H
 #define OL_SORT_BASE_H 1
 
+#include "ol_TaskPool.h"
 #include "ol_type_traits.h"
 #include <algorithm>
 #include <array>
@@ -877,6 +878,364 @@ namespace ol
         }
         // -----------------------------------------------------------------------
 
+        // 按字节的基数排序（定宽无符号键）相关实现
+        // -----------------------------------------------------------------------
+        /**
+         * @brief 基数排序的键类型萃取：整数映射为同宽度的无符号数，保持大小顺序
+         * @note 有符号数翻转最高位（负数排在非负数之前）；支持__int128（编译器提供时）
+         */
+        template <typename K, typename = void>
+        struct radix_key_traits
+        {
+            static constexpr bool value = false;
+        };
+
+        template <typename K>
+        struct radix_key_traits<K, typename std::enable_if<std::is_integral<K>::value && !std::is_same<K, bool>::value>::type>
+        {
+            static constexpr bool value = true;
+            using ukey_type = typename std::make_unsigned<K>::type;
+
+            static ukey_type to_unsigned(K k) noexcept
+            {
+                return std::is_signed<K>::value
+                           ? static_cast<ukey_type>(static_cast<ukey_type>(k) ^ (ukey_type(1) << (sizeof(K) * 8 - 1)))
+                           : static_cast<ukey_type>(k);
+            }
+        };
+
+#ifdef __SIZEOF_INT128__
+        template <>
+        struct radix_key_traits<unsigned __int128, void>
+        {
+            static constexpr bool value = true;
+            using ukey_type = unsigned __int128;
+
+            static ukey_type to_unsigned(ukey_type k) noexcept { return k; }
+        };
+
+        template <>
+        struct radix_key_traits<__int128, void>
+        {
+            static constexpr bool value = true;
+            using ukey_type = unsigned __int128;
+
+            static ukey_type to_unsigned(__int128 k) noexcept
+            {
+                return static_cast<ukey_type>(k) ^ (ukey_type(1) << 127);
+            }
+        };
+#endif
+
+        // 迭代器是否指向连续内存（指针、vector/string的迭代器），是则直接在原数组上排序，省去两次整体复制
+        template <typename It>
+        struct is_contiguous_iter
+            : std::integral_constant<bool,
+                                     std::is_pointer<It>::value ||
+                                         std::is_same<It, typename std::vector<typename std::iterator_traits<It>::value_type>::iterator>::value ||
+                                         (std::is_same<typename std::iterator_traits<It>::value_type, char>::value &&
+                                          std::is_same<It, std::string::iterator>::value)>
+        {
+        };
+
+        constexpr size_t RADIX_SMALL = 64;          ///< 元素数不超过该值时改用插入排序
+        constexpr size_t RADIX_MSD_MIN = 1 << 17;   ///< 元素数不少于该值时先按最高字节分桶（MSD）再对各桶做LSD
+
+        /**
+         * @brief LSD字节基数排序的核心：一次遍历统计全部字节的直方图，再逐字节分配
+         * @tparam T 元素类型
+         * @tparam KeyFn 取键函数，返回无符号整数（键宽度决定排序轮数）
+         * @param a 数据
+         * @param b 与a等长的临时空间
+         * @param n 元素数
+         * @param key 取键函数
+         * @param nbytes 参与排序的低位字节数（高位字节已相同时可减少，例如MSD分桶后）
+         * @return 排序结果所在的数组（a或b）
+         * @note 稳定排序；所有元素在某个字节上都相同时跳过该轮（地址、端口等键的高位常常相同）
+         */
+        template <typename T, typename KeyFn>
+        T* radix_lsd_bytes_base(T* a, T* b, size_t n, const KeyFn& key, size_t nbytes)
+        {
+            using U = decltype(key(*a));
+            if (n <= 1 || nbytes == 0) return a;
+
+            std::unique_ptr<size_t[]> hist(new size_t[nbytes * 256]());
+            for (size_t ii = 0; ii < n; ++ii)
+            {
+                U k = key(a[ii]);
+                for (size_t bb = 0; bb < nbytes; ++bb)
+                    ++hist[bb * 256 + static_cast<size_t>((k >> (bb * 8)) & 0xFF)];
+            }
+
+            T* src = a;
+            T* dst = b;
+            const U first = key(a[0]);
+            for (size_t bb = 0; bb < nbytes; ++bb)
+            {
+                size_t* count = &hist[bb * 256];
+                if (count[static_cast<size_t>((first >> (bb * 8)) & 0xFF)] == n) continue; // 该字节全部相同
+
+                size_t sum = 0;
+                for (size_t dd = 0; dd < 256; ++dd)
+                {
+                    size_t c = count[dd];
+                    count[dd] = sum;
+                    sum += c;
+                }
+                for (size_t ii = 0; ii < n; ++ii)
+                {
+                    size_t digit = static_cast<size_t>((key(src[ii]) >> (bb * 8)) & 0xFF);
+                    dst[count[digit]++] = std::move(src[ii]);
+                }
+                std::swap(src, dst);
+            }
+            return src;
+        }
+
+        /**
+         * @brief 按键的LSD字节基数排序（在连续数组上，结果写回data）
+         * @param data 数据
+         * @param n 元素数
+         * @param key 取键函数（返回无符号整数）
+         */
+        template <typename T, typename KeyFn>
+        void radix_sort_bytes_base(T* data, size_t n, const KeyFn& key)
+        {
+            using U = decltype(key(*data));
+            if (n <= RADIX_SMALL)
+            {
+                insertion_sort_base(data, data + n, [&key](const T& x, const T& y)
+                                    { return key(x) < key(y); });
+                return;
+            }
+            std::vector<T> buf(n);
+            if (n < RADIX_MSD_MIN || sizeof(U) == 1)
+            {
+                T* res = radix_lsd_bytes_base(data, buf.data(), n, key, sizeof(U));
+                if (res != data) std::move(res, res + n, data);
+                return;
+            }
+
+            // 数据量大时先按最高的非常量字节分桶（MSD），每个桶再做LSD：桶能放进缓存，逐轮分配时不再跨整个数组随机写
+            size_t hist[sizeof(U)][256] = {};
+            for (size_t ii = 0; ii < n; ++ii)
+            {
+                U k = key(data[ii]);
+                for (size_t bb = 0; bb < sizeof(U); ++bb)
+                    ++hist[bb][static_cast<size_t>((k >> (bb * 8)) & 0xFF)];
+            }
+            const U first = key(data[0]);
+            size_t top = sizeof(U);
+            while (top > 0 && hist[top - 1][static_cast<size_t>((first >> ((top - 1) * 8)) & 0xFF)] == n) --top;
+            if (top == 0) return; // 全部键相同
+            --top;
+
+            size_t bucket[257];
+            size_t sum = 0;
+            for (size_t dd = 0; dd < 256; ++dd)
+            {
+                bucket[dd] = sum;
+                sum += hist[top][dd];
+            }
+            bucket[256] = n;
+            size_t pos[256];
+            std::copy(bucket, bucket + 256, pos);
+            T* out = buf.data();
+            for (size_t ii = 0; ii < n; ++ii)
+                out[pos[static_cast<size_t>((key(data[ii]) >> (top * 8)) & 0xFF)]++] = std::move(data[ii]);
+
+            for (size_t dd = 0; dd < 256; ++dd)
+            {
+                size_t lo = bucket[dd], cnt = bucket[dd + 1] - bucket[dd];
+                if (cnt == 0) continue;
+                T* res = out + lo;
+                if (cnt <= RADIX_SMALL)
+                    insertion_sort_base(res, res + cnt, [&key](const T& x, const T& y)
+                                        { return key(x) < key(y); });
+                else
+                    res = radix_lsd_bytes_base(out + lo, data + lo, cnt, key, top);
+                if (res != data + lo) std::move(res, res + cnt, data + lo);
+            }
+        }
+
+        /**
+         * @brief 按键的LSD字节基数排序（迭代器版本，非连续迭代器先复制到临时数组）
+         */
+        template <typename RandomIt, typename KeyFn>
+        void radix_sort_by_key_base(RandomIt first, RandomIt last, const KeyFn& key)
+        {
+            using T = typename std::iterator_traits<RandomIt>::value_type;
+            const size_t n = static_cast<size_t>(std::distance(first, last));
+            if (n <= 1) return;
+            if constexpr (is_contiguous_iter<RandomIt>::value)
+            {
+                radix_sort_bytes_base(&*first, n, key);
+            }
+            else
+            {
+                std::vector<T> tmp(std::make_move_iterator(first), std::make_move_iterator(last));
+                radix_sort_bytes_base(tmp.data(), n, key);
+                std::move(tmp.begin(), tmp.end(), first);
+            }
+        }
+        // -----------------------------------------------------------------------
+
+        // 并行排序相关实现
+        // -----------------------------------------------------------------------
+        constexpr size_t PARALLEL_SORT_MIN = 1 << 15; ///< 元素数少于该值时不并行（任务调度开销大于收益）
+
+        /**
+         * @brief 并行比较排序：分块排序后两两归并
+         * @tparam Pool 线程池类型（TaskPool<false>或TaskPool<true>）
+         * @param data 数据（连续数组）
+         * @param n 元素数
+         * @param comp 比较函数对象
+         * @param pool 线程池
+         * @param chunks 分块数（一般为线程数）
+         * @note 各块用std::sort排序（不稳定）；归并轮次中各对块的归并互相独立，并行执行
+         */
+        template <typename T, typename Compare, typename Pool>
+        void parallel_sort_base(T* data, size_t n, const Compare& comp, Pool& pool, size_t chunks)
+        {
+            if (chunks <= 1 || n < PARALLEL_SORT_MIN)
+            {
+                std::sort(data, data + n, comp);
+                return;
+            }
+
+            // 分块边界
+            std::vector<size_t> bounds(chunks + 1);
+            for (size_t ii = 0; ii <= chunks; ++ii) bounds[ii] = n * ii / chunks;
+
+            TaskGroup group;
+            for (size_t ii = 0; ii < chunks; ++ii)
+            {
+                T* lo = data + bounds[ii];
+                T* hi = data + bounds[ii + 1];
+                if (!pool.addTask([lo, hi, &comp]()
+                                  { std::sort(lo, hi, comp); },
+                                  group))
+                    std::sort(lo, hi, comp); // 线程池拒绝时在当前线程执行
+            }
+            group.wait();
+
+            // 两两归并，src与dst交替
+            std::vector<T> buf(n);
+            T* src = data;
+            T* dst = buf.data();
+            while (bounds.size() > 2)
+            {
+                std::vector<size_t> next;
+                for (size_t ii = 0; ii + 1 < bounds.size(); ii += 2)
+                {
+                    next.push_back(bounds[ii]);
+                    size_t lo = bounds[ii], mid = bounds[ii + 1];
+                    size_t hi = ii + 2 < bounds.size() ? bounds[ii + 2] : mid;
+                    auto task = [src, dst, lo, mid, hi, &comp]()
+                    {
+                        std::merge(std::make_move_iterator(src + lo), std::make_move_iterator(src + mid),
+                                   std::make_move_iterator(src + mid), std::make_move_iterator(src + hi), dst + lo, comp);
+                    };
+                    if (!pool.addTask(task, group)) task();
+                    if (ii + 2 >= bounds.size()) break;
+                }
+                next.push_back(n);
+                group.wait();
+                bounds.swap(next);
+                std::swap(src, dst);
+            }
+            if (src != data) std::move(src, src + n, data);
+        }
+
+        /**
+         * @brief 并行基数排序：先按最高字节（MSD）把数据并行分配到256个桶，再对各桶并行做LSD排序
+         * @param data 数据（连续数组）
+         * @param n 元素数
+         * @param key 取键函数（返回无符号整数）
+         * @param pool 线程池
+         * @param chunks 分块数（一般为线程数）
+         * @note 稳定排序。第一步各块分别统计直方图、按"桶优先、块其次"的顺序计算写入位置，各块写入互不重叠，
+         *       无需加锁；第二步每个桶的数据连续，单独排序时缓存友好
+         */
+        template <typename T, typename KeyFn, typename Pool>
+        void parallel_radix_sort_base(T* data, size_t n, const KeyFn& key, Pool& pool, size_t chunks)
+        {
+            using U = decltype(key(*data));
+            if (chunks <= 1 || n < PARALLEL_SORT_MIN)
+            {
+                radix_sort_bytes_base(data, n, key);
+                return;
+            }
+
+            constexpr size_t shift = (sizeof(U) - 1) * 8;
+            std::vector<size_t> bounds(chunks + 1);
+            for (size_t ii = 0; ii <= chunks; ++ii) bounds[ii] = n * ii / chunks;
+            std::vector<std::array<size_t, 256>> hist(chunks);
+
+            // 1. 各块统计最高字节的直方图
+            TaskGroup group;
+            for (size_t cc = 0; cc < chunks; ++cc)
+            {
+                auto task = [&, cc]()
+                {
+                    hist[cc].fill(0);
+                    for (size_t ii = bounds[cc]; ii < bounds[cc + 1]; ++ii)
+                        ++hist[cc][static_cast<size_t>((key(data[ii]) >> shift) & 0xFF)];
+                };
+                if (!pool.addTask(task, group)) task();
+            }
+            group.wait();
+
+            // 2. 计算每块每个桶的写入位置
+            std::array<size_t, 257> bucket{};
+            size_t sum = 0;
+            for (size_t dd = 0; dd < 256; ++dd)
+            {
+                bucket[dd] = sum;
+                for (size_t cc = 0; cc < chunks; ++cc)
+                {
+                    size_t c = hist[cc][dd];
+                    hist[cc][dd] = sum;
+                    sum += c;
+                }
+            }
+            bucket[256] = n;
+
+            // 3. 各块并行分配到桶中
+            std::vector<T> buf(n);
+            T* out = buf.data();
+            for (size_t cc = 0; cc < chunks; ++cc)
+            {
+                auto task = [&, cc, out]()
+                {
+                    std::array<size_t, 256>& pos = hist[cc];
+                    for (size_t ii = bounds[cc]; ii < bounds[cc + 1]; ++ii)
+                        out[pos[static_cast<size_t>((key(data[ii]) >> shift) & 0xFF)]++] = std::move(data[ii]);
+                };
+                if (!pool.addTask(task, group)) task();
+            }
+            group.wait();
+
+            // 4. 各桶并行排序剩余的低位字节，结果写回data
+            for (size_t dd = 0; dd < 256; ++dd)
+            {
+                size_t lo = bucket[dd], hi = bucket[dd + 1];
+                if (lo == hi) continue;
+                auto task = [data, out, lo, hi, &key]()
+                {
+                    T* res = hi - lo <= RADIX_SMALL ? out + lo
+                                                    : radix_lsd_bytes_base(out + lo, data + lo, hi - lo, key, sizeof(U) - 1);
+                    if (hi - lo <= RADIX_SMALL)
+                        insertion_sort_base(res, res + (hi - lo), [&key](const T& x, const T& y)
+                                            { return key(x) < key(y); });
+                    if (res != data + lo) std::move(res, res + (hi - lo), data + lo);
+                };
+                if (!pool.addTask(task, group)) task();
+            }
+            group.wait();
+        }
+        // -----------------------------------------------------------------------
+
     } // namespace base
     // ===========================================================================
 
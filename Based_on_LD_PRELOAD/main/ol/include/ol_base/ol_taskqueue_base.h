@@ -0,0 +1,168 @@
+#ifndef OL_TASKQUEUE_BASE_H
+#define OL_TASKQUEUE_BASE_H 1
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ol
+{
+
+    // 任务队列公共组件 (内部实现)
+    // ===========================================================================
+    namespace base
+    {
+        constexpr size_t TQ_INLINE_SIZE = 48; ///< 任务节点内联存放可调用对象的大小（节点共64字节，一个缓存行）
+
+        // 任务节点
+        // -----------------------------------------------------------------------
+        /**
+         * @brief 侵入式任务节点：链表指针 + 操作函数 + 内联存储
+         * @note 可调用对象不超过TQ_INLINE_SIZE字节时直接构造在节点中（不分配内存），否则节点中只保存堆上对象的指针
+         */
+        struct TaskNode
+        {
+            TaskNode* m_next;                   ///< 链表中的下一个节点
+            void (*m_op)(TaskNode*, bool run);  ///< run=true：执行并析构可调用对象；run=false：只析构
+            alignas(16) unsigned char m_storage[TQ_INLINE_SIZE]; ///< 可调用对象（或其指针）
+
+            template <typename F>
+            void set(F&& f)
+            {
+                using Fn = typename std::decay<F>::type;
+                constexpr bool fits = sizeof(Fn) <= TQ_INLINE_SIZE && alignof(Fn) <= 16 &&
+                                      std::is_nothrow_move_constructible<Fn>::value;
+                if constexpr (fits)
+                {
+                    ::new (static_cast<void*>(m_storage)) Fn(std::forward<F>(f));
+                    m_op = [](TaskNode* node, bool run)
+                    {
+                        Fn* fn = std::launder(reinterpret_cast<Fn*>(node->m_storage));
+                        if (run)
+                        {
+                            struct Guard // 任务抛出异常时也析构
+                            {
+                                Fn* p;
+                                ~Guard() { p->~Fn(); }
+                            } guard{fn};
+                            (*fn)();
+                        }
+                        else
+                            fn->~Fn();
+                    };
+                }
+                else
+                {
+                    Fn* heap = new Fn(std::forward<F>(f));
+                    ::new (static_cast<void*>(m_storage)) Fn*(heap);
+                    m_op = [](TaskNode* node, bool run)
+                    {
+                        Fn* fn = *std::launder(reinterpret_cast<Fn**>(node->m_storage));
+                        struct Guard
+                        {
+                            Fn* p;
+                            ~Guard() { delete p; }
+                        } guard{fn};
+                        if (run) (*fn)();
+                    };
+                }
+            }
+        };
+        static_assert(sizeof(TaskNode) == 64, "TaskNode should fill one cache line");
+
+        // 节点池
+        // -----------------------------------------------------------------------
+        /**
+         * @brief 全局任务节点池：消费者把执行完的节点整批归还到共享栈，生产者从线程本地缓存取节点，
+         *        缓存为空时一次取走共享栈上的全部节点
+         * @note 共享栈只有"压入"（CAS）和"整体取走"（exchange）两种操作，不存在ABA问题；
+         *       节点只在线程本地缓存中释放（线程退出时），稳定状态下不做内存分配
+         */
+        class TaskNodePool
+        {
+        private:
+            std::atomic<TaskNode*> m_returned{nullptr}; ///< 消费者归还的节点
+
+            // 线程本地缓存
+            struct Local
+            {
+                TaskNode* m_head = nullptr;
+
+                ~Local()
+                {
+                    while (m_head)
+                    {
+                        TaskNode* next = m_head->m_next;
+                        ::operator delete(m_head);
+                        m_head = next;
+                    }
+                }
+            };
+
+            static Local& local()
+            {
+                static thread_local Local tl;
+                return tl;
+            }
+
+            TaskNodePool() = default;
+
+        public:
+            ~TaskNodePool()
+            {
+                TaskNode* node = m_returned.exchange(nullptr, std::memory_order_acquire);
+                while (node)
+                {
+                    TaskNode* next = node->m_next;
+                    ::operator delete(node);
+                    node = next;
+                }
+            }
+
+            static TaskNodePool& instance()
+            {
+                static TaskNodePool pool;
+                return pool;
+            }
+
+            // 取一个未初始化的节点。
+            TaskNode* acquire()
+            {
+                Local& tl = local();
+                if (!tl.m_head) tl.m_head = m_returned.exchange(nullptr, std::memory_order_acquire);
+                if (TaskNode* node = tl.m_head)
+                {
+                    tl.m_head = node->m_next;
+                    return node;
+                }
+                return static_cast<TaskNode*>(::operator new(sizeof(TaskNode)));
+            }
+
+            // 把节点直接放回本线程缓存（节点未入队，例如构造可调用对象时抛出异常）。
+            void releaseLocal(TaskNode* node)
+            {
+                Local& tl = local();
+                node->m_next = tl.m_head;
+                tl.m_head = node;
+            }
+
+            /**
+             * @brief 归还一批节点（first到last已用m_next串好）
+             */
+            void release(TaskNode* first, TaskNode* last)
+            {
+                TaskNode* head = m_returned.load(std::memory_order_relaxed);
+                do
+                {
+                    last->m_next = head;
+                } while (!m_returned.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+            }
+        };
+    } // namespace base
+    // ===========================================================================
+
+} // namespace ol
+
+#endif // !OL_TASKQUEUE_BASE_H
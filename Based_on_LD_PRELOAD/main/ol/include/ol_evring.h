@@ -0,0 +1,396 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_evring.h
+ * 功能描述：跨进程共享内存事件环，用于被注入进程向采集守护进程上报原始二进制事件，支持以下特性：
+ *          - 共享内存中划分MAXNUMEVR个槽位，每个进程占用一个槽位（登记方式与cpactive类似）
+ *          - 每个槽位是一个无锁SPSC环（生产者为被注入进程，消费者为采集进程），容量为2的幂，用掩码取下标
+ *          - 生产端只做一次memcpy，不格式化、不做系统调用；环满时丢弃并计数，绝不阻塞业务线程
+ *          - 采集端（cevcollector）轮询全部槽位批量取事件，并回收已退出进程的槽位
+ *          - 仅支持Linux平台（依赖System V共享内存）
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_EVRING_H
+#define OL_EVRING_H 1
+
+#include "ol_mutex.h"
+#include "ol_type_traits.h"
+#include <atomic>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <limits.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace ol
+{
+
+#ifdef __linux__
+    // ===========================================================================
+    // 事件环相关宏定义
+#define SHMKEYEVR 0x5097   // 事件环共享内存的key。
+#define MAXNUMEVR 128      // 最大的进程（槽位）数量。
+#define EVRINGCAP 512      // 每个槽位的事件容量，必须是2的幂。
+#define EVRINGMAGIC 0x4F4C4556 // 共享内存已初始化的标志（"OLEV"）。
+
+    // 被注入进程上报的原始事件（64字节，一个缓存行）
+    struct st_hookevent
+    {
+        uint64_t m_ts;       // 事件时间（CLOCK_REALTIME，纳秒）
+        int32_t m_tid;       // 发起线程ID
+        int32_t m_ruleId;    // 命中的规则编号（-1表示未命中任何规则）
+        uint16_t m_family;   // 目标地址族（AF_INET/AF_INET6）
+        uint16_t m_port;     // 目标端口（主机字节序）
+        uint8_t m_verdict;   // 处理结果（0-放行，1-拦截，2-白名单放行）
+        uint8_t m_op;        // 被劫持的函数（0-connect，1-connectat）
+        uint8_t m_pad[2];    // 填充
+        uint8_t m_addr[16];  // 目标IP（网络字节序，IPv4只用前4字节）
+        uint8_t m_resv[24];  // 保留
+    };
+    static_assert(sizeof(st_hookevent) == 64, "st_hookevent must be 64 bytes");
+
+    /**
+     * @brief 定长无锁SPSC环，可直接放在共享内存中（不含指针，全0即为空环）
+     * @tparam T 元素类型（必须可平凡复制）
+     * @tparam CAP 容量（必须是2的幂）
+     * @note 头尾计数器单调递增，用掩码取下标，分别占用独立的缓存行避免伪共享
+     */
+    template <typename T, size_t CAP>
+    struct spscring
+    {
+        static_assert(CAP > 0 && (CAP & (CAP - 1)) == 0, "CAP must be a power of 2");
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+        alignas(64) std::atomic<uint64_t> m_head; // 消费者位置（只由消费者修改）
+        alignas(64) std::atomic<uint64_t> m_tail; // 生产者位置（只由生产者修改）
+        alignas(64) T m_data[CAP];                // 元素数组
+
+        // 重置为空环（仅在没有生产者和消费者时调用）
+        void reset()
+        {
+            m_head.store(0, std::memory_order_relaxed);
+            m_tail.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 生产者写入一个元素
+         * @param e 待写入的元素
+         * @return true-成功，false-环已满
+         */
+        bool push(const T& e)
+        {
+            uint64_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) >= CAP) return false;
+
+            memcpy(&m_data[tail & (CAP - 1)], &e, sizeof(T));
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 消费者批量取出元素
+         * @param out 存放元素的数组
+         * @param maxn 最多取出的数量
+         * @return 实际取出的数量
+         */
+        size_t pop(T* out, size_t maxn)
+        {
+            uint64_t head = m_head.load(std::memory_order_relaxed);
+            uint64_t avail = m_tail.load(std::memory_order_acquire) - head;
+            size_t n = avail < maxn ? static_cast<size_t>(avail) : maxn;
+
+            for (size_t ii = 0; ii < n; ++ii)
+                memcpy(&out[ii], &m_data[(head + ii) & (CAP - 1)], sizeof(T));
+
+            if (n > 0) m_head.store(head + n, std::memory_order_release);
+            return n;
+        }
+
+        // 判断环是否为空（消费者调用）
+        bool empty() const
+        {
+            return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+        }
+    };
+
+    // 共享内存中的一个槽位，对应一个被注入进程
+    struct st_evslot
+    {
+        std::atomic<int32_t> m_pid;                 // 占用槽位的进程ID，0表示空闲
+        std::atomic<uint64_t> m_dropped;            // 环满被丢弃的事件数
+        char m_exe[256];                            // 进程的可执行文件路径（登记时写入一次）
+        spscring<st_hookevent, EVRINGCAP> m_ring;   // 事件环
+    };
+
+    // 事件环共享内存的整体布局
+    struct st_evrings
+    {
+        std::atomic<uint32_t> m_magic;  // 初始化标志（EVRINGMAGIC）
+        std::atomic<int32_t> m_ownerPid; // 采集进程的pid
+        st_evslot m_slot[MAXNUMEVR];    // 槽位数组
+    };
+
+    /**
+     * @brief 事件生产者（被注入进程使用）
+     * @note 1）只挂接已存在的共享内存（由采集进程创建），采集进程未运行或已退出时attach()/push()返回false，调用者应回退到写日志文件；
+     *       2）同一进程内的多个线程通过自旋锁串行写入，环本身是单生产者；
+     *       3）fork出的子进程第一次push时会自动重新登记槽位。
+     */
+    class cevproducer : public TypeNonCopyableMovable
+    {
+    private:
+        st_evrings* m_shm = nullptr; // 指向共享内存的指针
+        st_evslot* m_slot = nullptr; // 当前进程占用的槽位
+        int32_t m_pid = 0;           // 登记槽位时的进程ID
+        spin_mutex m_splock;         // 进程内多线程写入的互斥锁
+
+    public:
+        cevproducer() = default;
+
+        /**
+         * @brief 挂接采集进程创建的事件环共享内存并登记槽位
+         * @param shmkey 共享内存的key（默认SHMKEYEVR）
+         * @return true-成功，false-失败（采集进程未运行或槽位已满）
+         */
+        bool attach(key_t shmkey = SHMKEYEVR)
+        {
+            if (m_shm != nullptr) return m_slot != nullptr;
+
+            int shmid = shmget(shmkey, 0, 0666);
+            if (shmid == -1) return false;
+
+            void* addr = shmat(shmid, nullptr, 0);
+            if (addr == (void*)-1) return false;
+
+            m_shm = static_cast<st_evrings*>(addr);
+            if (m_shm->m_magic.load(std::memory_order_acquire) != EVRINGMAGIC || m_shm->m_ownerPid.load(std::memory_order_acquire) == 0)
+            {
+                detach();
+                return false;
+            }
+
+            return claim();
+        }
+
+        /**
+         * @brief 判断是否已挂接到事件环
+         * @return true-已挂接，false-未挂接
+         */
+        bool isattached() const
+        {
+            return m_slot != nullptr;
+        }
+
+        /**
+         * @brief 写入一个事件（热路径，只做一次memcpy）
+         * @param ev 待写入的事件
+         * @return true-成功，false-未挂接或环已满（已计入丢弃数）
+         */
+        bool push(const st_hookevent& ev)
+        {
+            if (m_slot == nullptr) return false;
+
+            // 采集进程已正常退出，没有人再取事件，由调用者回退到写日志文件。
+            if (m_shm->m_ownerPid.load(std::memory_order_relaxed) == 0) return false;
+
+            m_splock.lock();
+            if (m_pid != static_cast<int32_t>(getpid()) && !claim()) // fork出的子进程重新登记
+            {
+                m_splock.unlock();
+                return false;
+            }
+
+            bool ret = m_slot->m_ring.push(ev);
+            if (!ret) m_slot->m_dropped.fetch_add(1, std::memory_order_relaxed);
+            m_splock.unlock();
+
+            return ret;
+        }
+
+        // 分离共享内存（槽位由采集进程在本进程退出后回收）
+        void detach()
+        {
+            if (m_shm != nullptr) shmdt(m_shm);
+            m_shm = nullptr;
+            m_slot = nullptr;
+            m_pid = 0;
+        }
+
+        ~cevproducer()
+        {
+            detach();
+        }
+
+    private:
+        /**
+         * @brief 为当前进程登记一个空闲槽位
+         * @return true-成功，false-槽位已满
+         */
+        bool claim()
+        {
+            int32_t pid = static_cast<int32_t>(getpid());
+            for (size_t ii = 0; ii < MAXNUMEVR; ++ii)
+            {
+                st_evslot& slot = m_shm->m_slot[ii];
+                int32_t expected = 0;
+                if (!slot.m_pid.compare_exchange_strong(expected, -pid, std::memory_order_acq_rel)) continue;
+
+                // 先用负的pid占住槽位，写完进程路径后再公开，采集进程只处理正的pid。
+                ssize_t len = readlink("/proc/self/exe", slot.m_exe, sizeof(slot.m_exe) - 1);
+                slot.m_exe[len > 0 ? len : 0] = '\0';
+                slot.m_dropped.store(0, std::memory_order_relaxed);
+                slot.m_pid.store(pid, std::memory_order_release);
+
+                m_slot = &slot;
+                m_pid = pid;
+                return true;
+            }
+
+            m_slot = nullptr;
+            return false;
+        }
+    };
+
+    /**
+     * @brief 事件采集者（采集守护进程使用）
+     * @note 负责创建/初始化共享内存、批量取出全部槽位的事件、回收已退出进程的槽位
+     */
+    class cevcollector : public TypeNonCopyableMovable
+    {
+    private:
+        int m_shmid = -1;            // 共享内存ID
+        st_evrings* m_shm = nullptr; // 指向共享内存的指针
+
+    public:
+        cevcollector() = default;
+
+        /**
+         * @brief 创建（或接管）事件环共享内存
+         * @param shmkey 共享内存的key（默认SHMKEYEVR）
+         * @return true-成功，false-失败
+         * @note 同一时刻只允许一个采集进程，上一个采集进程仍存活时返回false
+         */
+        bool create(key_t shmkey = SHMKEYEVR)
+        {
+            m_shmid = shmget(shmkey, sizeof(st_evrings), 0666 | IPC_CREAT);
+            if (m_shmid == -1) return false;
+
+            void* addr = shmat(m_shmid, nullptr, 0);
+            if (addr == (void*)-1)
+            {
+                m_shmid = -1;
+                return false;
+            }
+            m_shm = static_cast<st_evrings*>(addr);
+
+            int32_t owner = m_shm->m_ownerPid.load(std::memory_order_acquire);
+            if (owner != 0 && owner != static_cast<int32_t>(getpid()) && (kill(owner, 0) == 0 || errno != ESRCH))
+            {
+                close();
+                return false;
+            }
+            m_shm->m_ownerPid.store(static_cast<int32_t>(getpid()), std::memory_order_release);
+
+            // 已初始化的共享内存保留现有槽位（采集进程重启时不丢已登记进程的事件）。
+            if (m_shm->m_magic.load(std::memory_order_acquire) != EVRINGMAGIC)
+            {
+                for (size_t ii = 0; ii < MAXNUMEVR; ++ii)
+                {
+                    m_shm->m_slot[ii].m_pid.store(0, std::memory_order_relaxed);
+                    m_shm->m_slot[ii].m_dropped.store(0, std::memory_order_relaxed);
+                    m_shm->m_slot[ii].m_ring.reset();
+                }
+                m_shm->m_magic.store(EVRINGMAGIC, std::memory_order_release);
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief 取出全部槽位中的事件，逐个回调处理函数
+         * @tparam Func 处理函数类型，签名为void(const st_evslot&, const st_hookevent&)
+         * @param func 处理函数
+         * @param maxPerSlot 每个槽位每轮最多取出的事件数（保证各进程之间公平）
+         * @return 本轮取出的事件总数
+         */
+        template <typename Func>
+        size_t drain(Func&& func, size_t maxPerSlot = 64)
+        {
+            if (m_shm == nullptr) return 0;
+
+            st_hookevent evs[64];
+            if (maxPerSlot > 64) maxPerSlot = 64;
+
+            size_t total = 0;
+            for (size_t ii = 0; ii < MAXNUMEVR; ++ii)
+            {
+                st_evslot& slot = m_shm->m_slot[ii];
+                if (slot.m_pid.load(std::memory_order_acquire) <= 0) continue;
+
+                size_t n = slot.m_ring.pop(evs, maxPerSlot);
+                for (size_t jj = 0; jj < n; ++jj) func(slot, evs[jj]);
+                total += n;
+            }
+            return total;
+        }
+
+        /**
+         * @brief 回收已退出进程的槽位（环中剩余事件已取完时才回收）
+         * @return 回收的槽位数
+         */
+        size_t reclaim()
+        {
+            if (m_shm == nullptr) return 0;
+
+            size_t n = 0;
+            for (size_t ii = 0; ii < MAXNUMEVR; ++ii)
+            {
+                st_evslot& slot = m_shm->m_slot[ii];
+                int32_t pid = slot.m_pid.load(std::memory_order_acquire);
+                if (pid == 0) continue;
+
+                int32_t realpid = pid > 0 ? pid : -pid;
+                if (kill(realpid, 0) == 0 || errno != ESRCH) continue; // 进程还活着
+                if (pid > 0 && !slot.m_ring.empty()) continue;          // 先把事件取完
+
+                slot.m_ring.reset();
+                slot.m_pid.store(0, std::memory_order_release);
+                ++n;
+            }
+            return n;
+        }
+
+        // 分离共享内存（不删除，被注入进程可能仍在挂接）
+        void close()
+        {
+            if (m_shm != nullptr)
+            {
+                if (m_shm->m_ownerPid.load(std::memory_order_relaxed) == static_cast<int32_t>(getpid()))
+                    m_shm->m_ownerPid.store(0, std::memory_order_release);
+                shmdt(m_shm);
+            }
+            m_shm = nullptr;
+            m_shmid = -1;
+        }
+
+        ~cevcollector()
+        {
+            close();
+        }
+    };
+    // ===========================================================================
+#endif // __linux__
+
+} // namespace ol
+
+#endif // !OL_EVRING_H
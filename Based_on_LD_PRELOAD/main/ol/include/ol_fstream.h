@@ -5,6 +5,7 @@
  *          - 目录创建、文件重命名、复制、大小/时间获取等基础文件操作
  *          - 目录遍历类（cdir），支持递归获取文件列表及属性
  *          - 文件读写类（cofile/cifile），支持文本/二进制操作及临时文件机制
+ *          - 只读内存映射文件类（cmmapfile，仅Linux），整个文件零拷贝读取
  *          - 日志文件类（clogfile），支持自动切换、多线程安全
  *          - 辅助工具：自旋锁、自定义输出操作符等
  * 作者：ol
@@ -36,6 +37,8 @@
 
 #ifdef __linux__
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <utime.h>
 #elif defined(_WIN32)  // Windows 平台头文件
@@ -345,6 +348,109 @@ namespace ol
     };
     // ===========================================================================
 
+#ifdef __linux__
+    // ===========================================================================
+    // 只读内存映射文件类，整个文件映射为一段连续内存（配合string_view零拷贝解析）
+    class cmmapfile // class mmap file
+    {
+    private:
+        const char* m_data = nullptr; // 映射的起始地址（空文件时为nullptr）。
+        size_t m_size = 0;            // 文件大小。
+        bool m_open = false;          // 是否已打开。
+
+        cmmapfile(const cmmapfile&) = delete;            // 禁用拷贝构造函数
+        cmmapfile& operator=(const cmmapfile&) = delete; // 禁用赋值函数
+    public:
+        // 构造函数
+        cmmapfile()
+        {
+        }
+
+        /**
+         * @brief 以只读方式映射文件（顺序读取提示MADV_SEQUENTIAL）
+         * @param filename 文件名
+         * @return true-成功（空文件也算成功，size()为0），false-失败
+         * @note 映射期间文件被截断时，访问截断部分会收到SIGBUS；配置文件等小文件请用"写临时文件再改名"的方式更新
+         */
+        bool open(const std::string& filename)
+        {
+            close();
+
+            int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return false;
+
+            struct stat st;
+            if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+            {
+                ::close(fd);
+                return false;
+            }
+
+            if (st.st_size > 0)
+            {
+                void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED)
+                {
+                    ::close(fd);
+                    return false;
+                }
+                madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                m_data = static_cast<const char*>(addr);
+                m_size = static_cast<size_t>(st.st_size);
+            }
+            ::close(fd); // 映射建立后即可关闭文件描述符
+
+            m_open = true;
+            return true;
+        }
+
+        /**
+         * @brief 判断文件是否已打开
+         * @return true-已打开，false-未打开
+         */
+        bool isopen() const
+        {
+            return m_open;
+        }
+
+        // 文件内容的起始地址（空文件时为nullptr）。
+        const char* data() const
+        {
+            return m_data;
+        }
+
+        // 文件大小。
+        size_t size() const
+        {
+            return m_size;
+        }
+
+#if __cplusplus >= 201703L
+        // 文件内容的视图。
+        std::string_view view() const
+        {
+            return std::string_view(m_data, m_size);
+        }
+#endif
+
+        // 解除映射。
+        void close()
+        {
+            if (m_data != nullptr) munmap(const_cast<char*>(m_data), m_size);
+            m_data = nullptr;
+            m_size = 0;
+            m_open = false;
+        }
+
+        // 析构函数，自动解除映射
+        ~cmmapfile()
+        {
+            close();
+        }
+    };
+    // ===========================================================================
+#endif // __linux__
+
     // ===========================================================================
     // 日志文件类，支持自动切换和多线程安全
     class clogfile
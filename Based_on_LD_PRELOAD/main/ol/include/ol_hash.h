@@ -5,12 +5,26 @@
  *          - 哈希组合函数（hash_combine）：将单个值的哈希合并到种子中
  *          - 可变参数哈希计算（hash_val）：支持任意类型和数量的参数组合计算哈希值
  *          - 适用于自定义类型的哈希计算场景（如作为unordered_map的哈希函数）
+ *          - 高速非加密哈希（wyhash风格，128位乘法折叠）：任意字节串（hash_bytes，长串三路并行）、
+ *            整数（hash_u64）以及IPv4+端口、16字节IPv6、IPv6+端口地址键的快速路径
+ *          - 带种子的变体与进程随机种子（hash_random_seed），防止构造冲突键的HashDoS攻击
+ *          - 哈希函数对象Hash<T>/SeededHash<T>，可直接作为unordered_map/unordered_set的哈希参数
  * 作者：ol
  * 适用标准：C++11及以上（需支持变参模板、std::hash等特性）
  */
 /****************************************************************************************/
 
+#include "ol_base/ol_hash_base.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <random>
+#include <string>
+#include <type_traits>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 #ifndef OL_HASH_H
 #define OL_HASH_H 1
@@ -23,12 +37,13 @@ namespace ol
      * @tparam T 待哈希的值类型
      * @param seed 哈希种子（会被修改）
      * @param val 待合并的数值
-     * @note 采用boost库的哈希组合算法，具有良好的雪崩效应
+     * @note 用128位乘法折叠混合（std::hash对整数是恒等映射，加法移位组合在打包的IP/端口键上分布很差）
      */
     template <typename T>
     inline void hash_combine(std::size_t& seed, const T& val)
     {
-        seed ^= std::hash<T>()(val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed = static_cast<std::size_t>(base::hash_mix(seed ^ base::HASH_SECRET0,
+                                                       static_cast<uint64_t>(std::hash<T>()(val)) ^ base::HASH_SECRET1));
     }
 
     /**
@@ -73,6 +88,233 @@ namespace ol
         return seed;
     }
 
+    // ===========================================================================
+    // 高速非加密哈希
+    // ===========================================================================
+
+    /**
+     * @brief 任意字节串的哈希（wyhash风格）
+     * @param data 数据
+     * @param len 数据长度
+     * @param seed 种子（默认0；对外部可控的键使用hash_random_seed()防止HashDoS）
+     * @return 64位哈希值
+     * @note 不超过16字节时只做一次读取拼接；超过48字节时每轮处理48字节，三路相互独立的乘法链并行执行
+     */
+    inline uint64_t hash_bytes(const void* data, size_t len, uint64_t seed = 0) noexcept
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        seed ^= base::hash_mix(seed ^ base::HASH_SECRET0, base::HASH_SECRET1);
+        uint64_t a, b;
+        if (len <= 16)
+        {
+            if (len >= 4)
+            {
+                size_t mid = (len >> 3) << 2; // 4~7字节时为0，8~16字节时为4
+                a = (base::hash_r4(p) << 32) | base::hash_r4(p + mid);
+                b = (base::hash_r4(p + len - 4) << 32) | base::hash_r4(p + len - 4 - mid);
+            }
+            else if (len > 0)
+            {
+                a = base::hash_r3(p, len);
+                b = 0;
+            }
+            else
+                a = b = 0;
+        }
+        else
+        {
+            size_t ii = len;
+            if (ii > 48)
+            {
+                uint64_t see1 = seed, see2 = seed;
+                do
+                {
+                    seed = base::hash_mix(base::hash_r8(p) ^ base::HASH_SECRET1, base::hash_r8(p + 8) ^ seed);
+                    see1 = base::hash_mix(base::hash_r8(p + 16) ^ base::HASH_SECRET2, base::hash_r8(p + 24) ^ see1);
+                    see2 = base::hash_mix(base::hash_r8(p + 32) ^ base::HASH_SECRET3, base::hash_r8(p + 40) ^ see2);
+                    p += 48;
+                    ii -= 48;
+                } while (ii > 48);
+                seed ^= see1 ^ see2;
+            }
+            while (ii > 16)
+            {
+                seed = base::hash_mix(base::hash_r8(p) ^ base::HASH_SECRET1, base::hash_r8(p + 8) ^ seed);
+                p += 16;
+                ii -= 16;
+            }
+            a = base::hash_r8(p + ii - 16); // 最后16字节（可能与已处理的部分重叠）
+            b = base::hash_r8(p + ii - 8);
+        }
+        a ^= base::HASH_SECRET1;
+        b ^= seed;
+        base::hash_mum(a, b);
+        return base::hash_mix(a ^ base::HASH_SECRET0 ^ len, b ^ base::HASH_SECRET1);
+    }
+
+    /**
+     * @brief 字符串的哈希
+     * @param str 字符串
+     * @param seed 种子
+     * @return 64位哈希值
+     */
+    inline uint64_t hash_string(const std::string& str, uint64_t seed = 0) noexcept
+    {
+        return hash_bytes(str.data(), str.size(), seed);
+    }
+
+    /**
+     * @brief 64位整数的哈希（一次宽乘法）
+     * @param val 整数
+     * @param seed 种子
+     * @return 64位哈希值
+     */
+    inline uint64_t hash_u64(uint64_t val, uint64_t seed = 0) noexcept
+    {
+        return base::hash_mix(val ^ base::HASH_SECRET0, seed ^ base::HASH_SECRET1);
+    }
+
+    /**
+     * @brief IPv4地址+端口的哈希（6字节拼成一个整数，一次宽乘法）
+     * @param ip IPv4地址（4字节，字节序不限，同一张表中保持一致即可）
+     * @param port 端口
+     * @param seed 种子
+     * @return 64位哈希值
+     */
+    inline uint64_t hash_addr4(uint32_t ip, uint16_t port, uint64_t seed = 0) noexcept
+    {
+        return hash_u64((static_cast<uint64_t>(ip) << 16) | port, seed);
+    }
+
+    /**
+     * @brief 16字节地址（IPv6）的哈希（两个64位字各异或种子和常数后相乘，再与种子做一次收尾混合）
+     * @param addr16 16字节地址
+     * @param seed 种子
+     * @return 64位哈希值
+     * @note 种子同时进入两个乘数；收尾混合保证某一半恰好被异或成0时结果仍随种子变化
+     */
+    inline uint64_t hash_addr16(const void* addr16, uint64_t seed = 0) noexcept
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(addr16);
+        uint64_t h = base::hash_mix(base::hash_r8(p) ^ seed ^ base::HASH_SECRET0, base::hash_r8(p + 8) ^ seed ^ base::HASH_SECRET1);
+        return base::hash_mix(h ^ base::HASH_SECRET2, seed ^ base::HASH_SECRET3);
+    }
+
+    /**
+     * @brief 18字节地址键（IPv6+端口）的哈希
+     * @param addr16 16字节地址
+     * @param port 端口
+     * @param seed 种子
+     * @return 64位哈希值
+     * @note 端口先乘奇数常数（64位乘法，可逆）散布到整个字再并入，避免与地址低位形成有规律的冲突，
+     *       不额外增加128位乘法
+     */
+    inline uint64_t hash_addr18(const void* addr16, uint16_t port, uint64_t seed = 0) noexcept
+    {
+        return hash_addr16(addr16, seed ^ (static_cast<uint64_t>(port) * base::HASH_SECRET2));
+    }
+
+    /**
+     * @brief 进程随机种子（首次调用时生成，之后不变）
+     * @return 64位随机种子
+     * @note 键来自外部（主机名、对端地址等）的哈希表使用该种子，攻击者无法离线构造大量冲突的键
+     */
+    inline uint64_t hash_random_seed() noexcept
+    {
+        static const uint64_t seed = []() noexcept
+        {
+            uint64_t s = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            s ^= reinterpret_cast<uintptr_t>(&s); // 地址空间随机化带来的熵
+            try
+            {
+                std::random_device rd;
+                s ^= (static_cast<uint64_t>(rd()) << 32) | rd();
+            }
+            catch (...)
+            {
+            }
+            return hash_u64(s, base::HASH_SECRET3);
+        }();
+        return seed;
+    }
+
+    // 哈希函数对象
+    // -----------------------------------------------------------------------
+    namespace base
+    {
+        // 按类型选择哈希路径：整数/枚举走hash_u64，字符串走hash_bytes，其它类型先取std::hash再混合
+        template <typename T, typename = void>
+        struct HashImpl
+        {
+            static uint64_t apply(const T& val, uint64_t seed) noexcept
+            {
+                return hash_u64(static_cast<uint64_t>(std::hash<T>()(val)), seed);
+            }
+        };
+
+        template <typename T>
+        struct HashImpl<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+        {
+            static uint64_t apply(const T& val, uint64_t seed) noexcept
+            {
+                return hash_u64(static_cast<uint64_t>(val), seed);
+            }
+        };
+
+        template <>
+        struct HashImpl<std::string>
+        {
+            static uint64_t apply(const std::string& val, uint64_t seed) noexcept
+            {
+                return hash_bytes(val.data(), val.size(), seed);
+            }
+        };
+
+#if __cplusplus >= 201703L
+        template <>
+        struct HashImpl<std::string_view>
+        {
+            static uint64_t apply(std::string_view val, uint64_t seed) noexcept
+            {
+                return hash_bytes(val.data(), val.size(), seed);
+            }
+        };
+#endif
+    } // namespace base
+
+    /**
+     * @brief 哈希函数对象（固定种子0，结果在进程间一致）
+     * @tparam T 键类型（整数、枚举、std::string、std::string_view，或有std::hash特化的类型）
+     * @note 用法：std::unordered_map<std::string, int, ol::Hash<std::string>> map;
+     */
+    template <typename T>
+    struct Hash
+    {
+        size_t operator()(const T& val) const noexcept
+        {
+            return static_cast<size_t>(base::HashImpl<T>::apply(val, 0));
+        }
+    };
+
+    /**
+     * @brief 带种子的哈希函数对象（默认使用进程随机种子，抵抗HashDoS）
+     * @tparam T 键类型，同Hash<T>
+     * @note 用法：std::unordered_set<std::string, ol::SeededHash<std::string>> hosts;
+     */
+    template <typename T>
+    struct SeededHash
+    {
+        uint64_t m_seed; ///< 种子
+
+        SeededHash() noexcept : m_seed(hash_random_seed()) {}
+        explicit SeededHash(uint64_t seed) noexcept : m_seed(seed) {}
+
+        size_t operator()(const T& val) const noexcept
+        {
+            return static_cast<size_t>(base::HashImpl<T>::apply(val, m_seed));
+        }
+    };
+
 } // namespace ol
 
 #endif // !OL_HASH_H
\ No newline at end of file
@@ -0,0 +1,522 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_lfqueue.h
+ * 功能描述：有界无锁队列模板类族（cqueue的并发版本），支持以下特性：
+ *          - spsc_queue：单生产者单消费者环，入队出队均为wait-free，双方各自缓存对方的位置减少缓存行迁移
+ *          - mpsc_queue：多生产者单消费者队列，消费端不做CAS
+ *          - mpmc_queue：多生产者多消费者队列（Vyukov有界队列，每个槽位带序号）
+ *          - 容量为2的幂，用掩码取下标；头尾计数器分别占用独立的缓存行避免伪共享
+ *          - 批量操作：push_n/pop_n一次CAS（或一次发布）处理多个元素
+ *          - 可选阻塞（模板参数BLOCKING=true）：push_wait/pop_wait先自旋、再用futex睡眠，
+ *            没有等待者时通知只有一次fence，不做系统调用
+ *          - 不含指针，可直接放在共享内存中跨进程使用（构造时传入processShared=true）
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_LFQUEUE_H
+#define OL_LFQUEUE_H 1
+
+#include "ol_base/ol_lfqueue_base.h"
+#include "ol_type_traits.h"
+#include <iterator>
+
+namespace ol
+{
+
+    // ===========================================================================
+    /**
+     * @brief 单生产者单消费者有界无锁队列
+     * @tparam T 元素类型（跨进程使用时必须可平凡复制）
+     * @tparam CAP 容量（必须是2的幂）
+     * @tparam BLOCKING 是否支持push_wait/pop_wait（为false时入队出队不做任何额外的同步）
+     * @note 1）同一时刻只能有一个线程入队、一个线程出队；
+     *       2）跨进程使用：在共享内存上用placement new构造（new (addr) spsc_queue<...>(true)），
+     *          其它进程直接把共享内存地址转换为队列指针使用；
+     *       3）对象较大（CAP * sizeof(T)），不要放在栈上。
+     */
+    template <class T, size_t CAP, bool BLOCKING = false>
+    class spsc_queue : public TypeNonCopyableMovable
+    {
+        static_assert(CAP > 0 && (CAP & (CAP - 1)) == 0, "CAP must be a power of 2");
+        static constexpr size_t MASK = CAP - 1;
+
+    private:
+        bool m_shared; ///< 是否跨进程（决定futex是否带PRIVATE标志）
+
+        alignas(base::LFQ_CACHELINE) std::atomic<size_t> m_tail; ///< 生产者位置（只由生产者修改）
+        size_t m_headCache;                                        ///< 生产者缓存的消费者位置
+
+        alignas(base::LFQ_CACHELINE) std::atomic<size_t> m_head; ///< 消费者位置（只由消费者修改）
+        size_t m_tailCache;                                        ///< 消费者缓存的生产者位置
+
+        alignas(base::LFQ_CACHELINE) base::EventCount m_notEmpty; ///< 非空事件（消费者等待）
+        alignas(base::LFQ_CACHELINE) base::EventCount m_notFull;  ///< 非满事件（生产者等待）
+
+        alignas(base::LFQ_CACHELINE) base::SlotStorage<T> m_data[CAP]; ///< 元素数组
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param processShared 是否放在共享内存中跨进程使用
+         */
+        explicit spsc_queue(bool processShared = false)
+            : m_shared(processShared), m_tail(0), m_headCache(0), m_head(0), m_tailCache(0),
+              m_notEmpty{{0}, {0}}, m_notFull{{0}, {0}}
+        {
+        }
+
+        // 析构函数，析构队列中剩余的元素
+        ~spsc_queue()
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                size_t tail = m_tail.load(std::memory_order_relaxed);
+                for (size_t pos = m_head.load(std::memory_order_relaxed); pos != tail; ++pos)
+                    m_data[pos & MASK].destroy();
+            }
+        }
+
+        /**
+         * @brief 原地构造一个元素入队（生产者调用）
+         * @param args 元素构造参数
+         * @return true-成功，false-队列已满
+         */
+        template <typename... Args>
+        bool emplace(Args&&... args)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_headCache >= CAP)
+            {
+                m_headCache = m_head.load(std::memory_order_acquire);
+                if (tail - m_headCache >= CAP) return false;
+            }
+
+            m_data[tail & MASK].construct(std::forward<Args>(args)...);
+            m_tail.store(tail + 1, std::memory_order_release);
+            if constexpr (BLOCKING) m_notEmpty.notify(m_shared, false);
+            return true;
+        }
+
+        // 入队（生产者调用），队列已满返回false
+        bool push(const T& e) { return emplace(e); }
+
+        // 入队（生产者调用），队列已满返回false
+        bool push(T&& e) { return emplace(std::move(e)); }
+
+        /**
+         * @brief 批量入队（生产者调用，只发布一次）
+         * @param first 输入迭代器（元素被复制，需要移动时传std::make_move_iterator）
+         * @param n 元素个数
+         * @return 实际入队的元素个数（队列空位不足时小于n）
+         */
+        template <typename InputIt>
+        size_t push_n(InputIt first, size_t n)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (CAP - (tail - m_headCache) < n) m_headCache = m_head.load(std::memory_order_acquire);
+            size_t room = CAP - (tail - m_headCache);
+            if (n > room) n = room;
+            if (n == 0) return 0;
+
+            for (size_t ii = 0; ii < n; ++ii, ++first)
+                m_data[(tail + ii) & MASK].construct(*first);
+            m_tail.store(tail + n, std::memory_order_release);
+            if constexpr (BLOCKING) m_notEmpty.notify(m_shared, false);
+            return n;
+        }
+
+        /**
+         * @brief 出队（消费者调用）
+         * @param out 存放出队元素
+         * @return true-成功，false-队列为空
+         */
+        bool pop(T& out)
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tailCache)
+            {
+                m_tailCache = m_tail.load(std::memory_order_acquire);
+                if (head == m_tailCache) return false;
+            }
+
+            m_data[head & MASK].moveOut(out);
+            m_head.store(head + 1, std::memory_order_release);
+            if constexpr (BLOCKING) m_notFull.notify(m_shared, false);
+            return true;
+        }
+
+        /**
+         * @brief 批量出队（消费者调用，只发布一次）
+         * @param out 输出迭代器
+         * @param maxn 最多出队的元素个数
+         * @return 实际出队的元素个数
+         */
+        template <typename OutputIt>
+        size_t pop_n(OutputIt out, size_t maxn)
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (m_tailCache - head < maxn) m_tailCache = m_tail.load(std::memory_order_acquire);
+            size_t n = m_tailCache - head;
+            if (n > maxn) n = maxn;
+            if (n == 0) return 0;
+
+            for (size_t ii = 0; ii < n; ++ii, ++out)
+            {
+                T* p = m_data[(head + ii) & MASK].ptr();
+                *out = std::move(*p);
+                p->~T();
+            }
+            m_head.store(head + n, std::memory_order_release);
+            if constexpr (BLOCKING) m_notFull.notify(m_shared, false);
+            return n;
+        }
+
+        /**
+         * @brief 阻塞入队（生产者调用），队列满时等待
+         * @param e 待入队的元素
+         * @param timeout 超时时间（默认无限等待）
+         * @return true-成功，false-超时
+         */
+        template <typename U>
+        bool push_wait(U&& e, std::chrono::milliseconds timeout = std::chrono::milliseconds(-1))
+        {
+            static_assert(BLOCKING, "push_wait requires BLOCKING=true");
+            return base::blockingRetry(m_notFull, m_shared, timeout, [&]
+                                       { return emplace(std::forward<U>(e)); });
+        }
+
+        /**
+         * @brief 阻塞出队（消费者调用），队列空时等待
+         * @param out 存放出队元素
+         * @param timeout 超时时间（默认无限等待）
+         * @return true-成功，false-超时
+         */
+        bool pop_wait(T& out, std::chrono::milliseconds timeout = std::chrono::milliseconds(-1))
+        {
+            static_assert(BLOCKING, "pop_wait requires BLOCKING=true");
+            return base::blockingRetry(m_notEmpty, m_shared, timeout, [&]
+                                       { return pop(out); });
+        }
+
+        /**
+         * @brief 阻塞批量出队（消费者调用），队列空时等待，有元素后尽量多取
+         * @param out 输出迭代器
+         * @param maxn 最多出队的元素个数
+         * @param timeout 超时时间（默认无限等待）
+         * @return 实际出队的元素个数（超时返回0）
+         */
+        template <typename OutputIt>
+        size_t pop_wait_n(OutputIt out, size_t maxn, std::chrono::milliseconds timeout = std::chrono::milliseconds(-1))
+        {
+            static_assert(BLOCKING, "pop_wait_n requires BLOCKING=true");
+            size_t n = 0;
+            base::blockingRetry(m_notEmpty, m_shared, timeout, [&]
+                                { return (n = pop_n(out, maxn)) > 0; });
+            return n;
+        }
+
+        // 元素个数（并发修改时为近似值）
+        size_t size() const
+        {
+            size_t head = m_head.load(std::memory_order_acquire);
+            size_t tail = m_tail.load(std::memory_order_acquire);
+            return tail >= head ? tail - head : 0;
+        }
+
+        // 判断队列是否为空（并发修改时为近似值）
+        bool empty() const { return size() == 0; }
+
+        // 队列容量
+        static constexpr size_t capacity() { return CAP; }
+    };
+    // ===========================================================================
+
+    namespace base
+    {
+        /**
+         * @brief 基于槽位序号的有界队列（Vyukov），mpsc_queue和mpmc_queue的共同实现
+         * @tparam T 元素类型
+         * @tparam CAP 容量（必须是2的幂）
+         * @tparam BLOCKING 是否支持阻塞操作
+         * @tparam MULTI_CONSUMER 是否允许多个消费者（为false时消费端不做CAS）
+         */
+        template <class T, size_t CAP, bool BLOCKING, bool MULTI_CONSUMER>
+        class SeqQueue : public TypeNonCopyableMovable
+        {
+            static_assert(CAP >= 2 && (CAP & (CAP - 1)) == 0, "CAP must be a power of 2 (at least 2)");
+            static constexpr size_t MASK = CAP - 1;
+
+        private:
+            bool m_shared; ///< 是否跨进程
+
+            alignas(LFQ_CACHELINE) std::atomic<size_t> m_tail; ///< 下一个入队位置
+            alignas(LFQ_CACHELINE) std::atomic<size_t> m_head; ///< 下一个出队位置
+
+            alignas(LFQ_CACHELINE) EventCount m_notEmpty; ///< 非空事件
+            alignas(LFQ_CACHELINE) EventCount m_notFull;  ///< 非满事件
+
+            alignas(LFQ_CACHELINE) SeqSlot<T> m_slots[CAP]; ///< 槽位数组
+
+            /**
+             * @brief 领取从pos开始最多n个连续的可写位置
+             * @return 领取的个数（0表示队列已满），pos为起始位置
+             */
+            size_t claimPush(size_t& pos, size_t n)
+            {
+                pos = m_tail.load(std::memory_order_relaxed);
+                while (true)
+                {
+                    size_t k = 0;
+                    while (k < n && m_slots[(pos + k) & MASK].m_seq.load(std::memory_order_acquire) == pos + k) ++k;
+
+                    if (k == 0)
+                    {
+                        // 槽位序号落后于位置说明已满；超前说明其它生产者已领取，重读tail重试。
+                        size_t seq = m_slots[pos & MASK].m_seq.load(std::memory_order_acquire);
+                        if (static_cast<intptr_t>(seq - pos) < 0) return 0;
+                        pos = m_tail.load(std::memory_order_relaxed);
+                        continue;
+                    }
+                    if (m_tail.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) return k;
+                }
+            }
+
+            /**
+             * @brief 领取从pos开始最多n个连续的可读位置
+             * @return 领取的个数（0表示队列为空），pos为起始位置
+             */
+            size_t claimPop(size_t& pos, size_t n)
+            {
+                pos = m_head.load(std::memory_order_relaxed);
+                while (true)
+                {
+                    size_t k = 0;
+                    while (k < n && m_slots[(pos + k) & MASK].m_seq.load(std::memory_order_acquire) == pos + k + 1) ++k;
+
+                    if constexpr (!MULTI_CONSUMER)
+                    {
+                        if (k > 0) m_head.store(pos + k, std::memory_order_relaxed);
+                        return k;
+                    }
+                    else
+                    {
+                        if (k == 0)
+                        {
+                            size_t seq = m_slots[pos & MASK].m_seq.load(std::memory_order_acquire);
+                            if (static_cast<intptr_t>(seq - (pos + 1)) < 0) return 0;
+                            pos = m_head.load(std::memory_order_relaxed);
+                            continue;
+                        }
+                        if (m_head.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) return k;
+                    }
+                }
+            }
+
+            // 取出位置pos的元素并把槽位交还给下一圈的生产者
+            template <typename OutputIt>
+            void take(size_t pos, OutputIt& out)
+            {
+                SeqSlot<T>& slot = m_slots[pos & MASK];
+                T* p = slot.m_data.ptr();
+                *out = std::move(*p);
+                ++out;
+                p->~T();
+                slot.m_seq.store(pos + CAP, std::memory_order_release);
+            }
+
+        public:
+            /**
+             * @brief 构造函数
+             * @param processShared 是否放在共享内存中跨进程使用
+             */
+            explicit SeqQueue(bool processShared = false)
+                : m_shared(processShared), m_tail(0), m_head(0), m_notEmpty{{0}, {0}}, m_notFull{{0}, {0}}
+            {
+                for (size_t ii = 0; ii < CAP; ++ii)
+                    m_slots[ii].m_seq.store(ii, std::memory_order_relaxed);
+            }
+
+            // 析构函数，析构队列中剩余的元素
+            ~SeqQueue()
+            {
+                if constexpr (!std::is_trivially_destructible_v<T>)
+                {
+                    size_t tail = m_tail.load(std::memory_order_relaxed);
+                    for (size_t pos = m_head.load(std::memory_order_relaxed); pos != tail; ++pos)
+                    {
+                        if (m_slots[pos & MASK].m_seq.load(std::memory_order_relaxed) == pos + 1)
+                            m_slots[pos & MASK].m_data.destroy();
+                    }
+                }
+            }
+
+            /**
+             * @brief 原地构造一个元素入队
+             * @param args 元素构造参数
+             * @return true-成功，false-队列已满
+             */
+            template <typename... Args>
+            bool emplace(Args&&... args)
+            {
+                size_t pos;
+                if (claimPush(pos, 1) == 0) return false;
+
+                SeqSlot<T>& slot = m_slots[pos & MASK];
+                slot.m_data.construct(std::forward<Args>(args)...);
+                slot.m_seq.store(pos + 1, std::memory_order_release);
+                if constexpr (BLOCKING) m_notEmpty.notify(m_shared, false);
+                return true;
+            }
+
+            // 入队，队列已满返回false
+            bool push(const T& e) { return emplace(e); }
+
+            // 入队，队列已满返回false
+            bool push(T&& e) { return emplace(std::move(e)); }
+
+            /**
+             * @brief 批量入队（一次CAS领取连续的位置）
+             * @param first 输入迭代器（元素被复制，需要移动时传std::make_move_iterator）
+             * @param n 元素个数
+             * @return 实际入队的元素个数（队列空位不足时小于n）
+             */
+            template <typename InputIt>
+            size_t push_n(InputIt first, size_t n)
+            {
+                size_t pos;
+                size_t k = n ? claimPush(pos, n) : 0;
+                for (size_t ii = 0; ii < k; ++ii, ++first)
+                {
+                    SeqSlot<T>& slot = m_slots[(pos + ii) & MASK];
+                    slot.m_data.construct(*first);
+                    slot.m_seq.store(pos + ii + 1, std::memory_order_release);
+                }
+                if constexpr (BLOCKING)
+                {
+                    if (k > 0) m_notEmpty.notify(m_shared, MULTI_CONSUMER && k > 1);
+                }
+                return k;
+            }
+
+            /**
+             * @brief 出队
+             * @param out 存放出队元素
+             * @return true-成功，false-队列为空
+             */
+            bool pop(T& out)
+            {
+                size_t pos;
+                if (claimPop(pos, 1) == 0) return false;
+
+                T* it = &out;
+                take(pos, it);
+                if constexpr (BLOCKING) m_notFull.notify(m_shared, false);
+                return true;
+            }
+
+            /**
+             * @brief 批量出队（一次CAS领取连续的位置，单消费者时不做CAS）
+             * @param out 输出迭代器
+             * @param maxn 最多出队的元素个数
+             * @return 实际出队的元素个数
+             */
+            template <typename OutputIt>
+            size_t pop_n(OutputIt out, size_t maxn)
+            {
+                size_t pos;
+                size_t k = maxn ? claimPop(pos, maxn) : 0;
+                for (size_t ii = 0; ii < k; ++ii) take(pos + ii, out);
+                if constexpr (BLOCKING)
+                {
+                    if (k > 0) m_notFull.notify(m_shared, k > 1);
+                }
+                return k;
+            }
+
+            /**
+             * @brief 阻塞入队，队列满时等待
+             * @param e 待入队的元素
+             * @param timeout 超时时间（默认无限等待）
+             * @return true-成功，false-超时
+             */
+            template <typename U>
+            bool push_wait(U&& e, std::chrono::milliseconds timeout = std::chrono::milliseconds(-1))
+            {
+                static_assert(BLOCKING, "push_wait requires BLOCKING=true");
+                return blockingRetry(m_notFull, m_shared, timeout, [&]
+                                     { return emplace(std::forward<U>(e)); });
+            }
+
+            /**
+             * @brief 阻塞出队，队列空时等待
+             * @param out 存放出队元素
+             * @param timeout 超时时间（默认无限等待）
+             * @return true-成功，false-超时
+             */
+            bool pop_wait(T& out, std::chrono::milliseconds timeout = std::chrono::milliseconds(-1))
+            {
+                static_assert(BLOCKING, "pop_wait requires BLOCKING=true");
+                return blockingRetry(m_notEmpty, m_shared, timeout, [&]
+                                     { return pop(out); });
+            }
+
+            /**
+             * @brief 阻塞批量出队，队列空时等待，有元素后尽量多取
+             * @param out 输出迭代器
+             * @param maxn 最多出队的元素个数
+             * @param timeout 超时时间（默认无限等待）
+             * @return 实际出队的元素个数（超时返回0）
+             */
+            template <typename OutputIt>
+            size_t pop_wait_n(OutputIt out, size_t maxn, std::chrono::milliseconds timeout = std::chrono::milliseconds(-1))
+            {
+                static_assert(BLOCKING, "pop_wait_n requires BLOCKING=true");
+                size_t n = 0;
+                blockingRetry(m_notEmpty, m_shared, timeout, [&]
+                              { return (n = pop_n(out, maxn)) > 0; });
+                return n;
+            }
+
+            // 元素个数（包括已领取但尚未发布的位置，并发修改时为近似值）
+            size_t size() const
+            {
+                size_t head = m_head.load(std::memory_order_acquire);
+                size_t tail = m_tail.load(std::memory_order_acquire);
+                return tail >= head ? tail - head : 0;
+            }
+
+            // 判断队列是否为空（并发修改时为近似值）
+            bool empty() const { return size() == 0; }
+
+            // 队列容量
+            static constexpr size_t capacity() { return CAP; }
+        };
+    } // namespace base
+
+    // ===========================================================================
+    /**
+     * @brief 多生产者单消费者有界无锁队列
+     * @tparam T 元素类型（跨进程使用时必须可平凡复制）
+     * @tparam CAP 容量（必须是2的幂，至少为2）
+     * @tparam BLOCKING 是否支持push_wait/pop_wait
+     * @note 同一时刻只能有一个线程出队；生产者之间用CAS领取位置，push_n一次CAS领取多个位置
+     */
+    template <class T, size_t CAP, bool BLOCKING = false>
+    using mpsc_queue = base::SeqQueue<T, CAP, BLOCKING, false>;
+
+    /**
+     * @brief 多生产者多消费者有界无锁队列（Vyukov有界队列）
+     * @tparam T 元素类型（跨进程使用时必须可平凡复制）
+     * @tparam CAP 容量（必须是2的幂，至少为2）
+     * @tparam BLOCKING 是否支持push_wait/pop_wait
+     * @note 每个槽位带序号，生产者和消费者只在领取位置时CAS，不会互相阻塞
+     */
+    template <class T, size_t CAP, bool BLOCKING = false>
+    using mpmc_queue = base::SeqQueue<T, CAP, BLOCKING, true>;
+    // ===========================================================================
+
+} // namespace ol
+
+#endif // !OL_LFQUEUE_H
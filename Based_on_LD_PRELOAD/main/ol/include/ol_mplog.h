@@ -0,0 +1,329 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_mplog.h
+ * 功能描述：多进程安全的共享日志文件类（cmplogfile），支持以下特性：
+ *          - 每条日志先在内存中拼装完整（时间前缀+内容），再用一次write()写入O_APPEND打开的fd，
+ *            多个进程同时写同一个日志文件时记录不会交错
+ *          - 通过一小块System V共享内存头（代数+文件大小计数）在进程间协调日志切换：
+ *            只有一个进程执行rename，其它进程发现代数变化后重新打开新文件
+ *          - 切换锁记录持有者的pid，持有者异常退出后可被其它进程接管，不会永久卡死
+ *          - 接口与clogfile保持一致（open/write/close），可直接替换
+ * 作者：ol
+ * 适用标准：C++17及以上（依赖ol_fstream.h、ol_mutex.h，仅支持Linux平台）
+ */
+/****************************************************************************************/
+
+#ifndef OL_MPLOG_H
+#define OL_MPLOG_H 1
+
+#include "ol_chrono.h"
+#include "ol_fstream.h"
+#include "ol_mutex.h"
+#include "ol_string.h"
+#include "ol_type_traits.h"
+#include <atomic>
+#include <errno.h>
+#include <functional>
+#include <signal.h>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace ol
+{
+
+#ifdef __linux__
+    // ===========================================================================
+    // 共享日志头的初始化状态
+#define MPLOG_SHM_UNINIT 0  // 未初始化（新建的共享内存全为0）
+#define MPLOG_SHM_INITING 1 // 某个进程正在初始化
+#define MPLOG_SHM_READY 2   // 已初始化，可以使用
+
+    // 共享日志头，存放在共享内存中，同一日志文件的所有进程共用一份
+    struct st_mplogshm
+    {
+        std::atomic<uint32_t> m_state;    // 初始化状态（MPLOG_SHM_UNINIT/INITING/READY）
+        std::atomic<int32_t> m_rotatePid; // 正在执行日志切换的进程pid，0表示无人切换
+        std::atomic<uint64_t> m_gen;      // 日志代数，每切换一次加1，进程据此判断是否需要重新打开文件
+        std::atomic<uint64_t> m_size;     // 当前日志文件的大小（字节），由各进程写入后累加
+        std::atomic<uint64_t> m_pathhash; // 日志文件名的64位哈希，挂接时核对，防止key冲突时共用了别的日志的头
+    };
+
+    /**
+     * @brief 多进程安全的日志文件类
+     * @note 1）每条记录一次write()写入O_APPEND文件，内核保证追加写的原子性，进程间不会交错；
+     *       2）同一进程内的多线程用自旋锁互斥（与clogfile一致）；
+     *       3）共享内存头不会自动删除（与cpactive一致），可用ipcrm -m shmid手工删除；
+     *       4）共享内存头的权限为0600（与日志文件一样只允许属主写），其它用户的进程挂接失败时不切换日志。
+     */
+    class cmplogfile : public TypeNonCopyableMovable
+    {
+    private:
+        int m_fd = -1;                // 日志文件的fd（O_WRONLY|O_APPEND）
+        std::string m_filename;       // 日志文件名，建议采用绝对路径
+        bool m_backup = true;         // 是否自动切换日志
+        size_t m_maxsize;             // 当日志文件的大小超过本参数（MB）时，自动切换日志
+        int m_shmid = -1;             // 共享内存ID
+        st_mplogshm* m_shm = nullptr; // 指向共享日志头的指针
+        uint64_t m_gen = 0;           // 本进程打开的日志文件对应的代数
+        spin_mutex m_splock;          // 自旋锁，用于多线程程序中给写日志的操作加锁
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param maxsize 日志最大大小（MB，默认100）
+         */
+        explicit cmplogfile(size_t maxsize = 100) : m_maxsize(maxsize)
+        {
+        }
+
+        /**
+         * @brief 打开日志文件并挂接共享日志头
+         * @param filename 日志文件名（建议采用绝对路径，目录不存在会自动创建）
+         * @param bbackup 是否自动切换（默认true，多进程下也可以开启）
+         * @param shmkey 共享日志头的key（默认0，表示根据文件名自动生成，同一文件名的进程得到同一个key；
+         *               挂接时核对文件名哈希，与已有的头不符时不切换日志）
+         * @return true-成功，false-失败
+         * @note 共享内存挂接失败时仍可写日志，只是不再切换（退化为bbackup=false）
+         */
+        bool open(const std::string& filename, const bool bbackup = true, key_t shmkey = 0)
+        {
+            close();
+
+            m_filename = filename;
+            m_backup = bbackup;
+
+            newdir(m_filename, true); // 自动创建日志目录
+
+            m_fd = ::open(m_filename.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+            if (m_fd < 0) return false;
+
+            const uint64_t pathhash = std::hash<std::string>()(m_filename);
+            if (shmkey == 0) shmkey = makekey(pathhash);
+
+            if (attachshm(shmkey, pathhash) == false)
+            {
+                m_backup = false; // 没有共享头就无法协调切换
+                return true;
+            }
+
+            m_gen = m_shm->m_gen.load(std::memory_order_acquire);
+            return true;
+        }
+
+        /**
+         * @brief 判断日志文件是否已打开
+         * @return true-已打开，false-未打开
+         */
+        bool isopen() const
+        {
+            return m_fd >= 0;
+        }
+
+        /**
+         * @brief 格式化写入日志（带时间前缀），整条记录一次write()写入
+         * @tparam Types 可变参数类型
+         * @param fmt 格式字符串
+         * @param args 待格式化的参数
+         * @return true-成功，false-失败
+         */
+        template <typename... Types>
+        bool write(const char* fmt, Types... args)
+        {
+            if (m_fd < 0) return false;
+
+            std::string record = ltime1();
+            record += ' ';
+            record += sformat(fmt, args...);
+
+            return writeraw(record.data(), record.size());
+        }
+
+        /**
+         * @brief 写入一条已拼装好的日志记录（无时间前缀）
+         * @param data 记录内容
+         * @param size 记录长度（字节）
+         * @return true-成功，false-失败
+         */
+        bool writeraw(const char* data, size_t size)
+        {
+            if (m_fd < 0) return false;
+
+            backup(); // 判断是否需要切换日志文件。
+
+            m_splock.lock();
+
+            // 其它进程已经切换了日志，重新打开当前日志文件。
+            if (m_shm != nullptr && m_shm->m_gen.load(std::memory_order_acquire) != m_gen) reopen();
+
+            ssize_t n;
+            do
+            {
+                n = ::write(m_fd, data, size);
+            } while (n < 0 && errno == EINTR);
+
+            m_splock.unlock();
+
+            if (n < 0) return false;
+
+            if (m_shm != nullptr) m_shm->m_size.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+
+            return static_cast<size_t>(n) == size;
+        }
+
+        // 关闭日志文件并分离共享日志头
+        void close()
+        {
+            if (m_fd >= 0)
+            {
+                ::close(m_fd);
+                m_fd = -1;
+            }
+
+            if (m_shm != nullptr)
+            {
+                shmdt(m_shm);
+                m_shm = nullptr;
+            }
+            m_shmid = -1;
+        }
+
+        // 析构函数，自动关闭文件
+        ~cmplogfile()
+        {
+            close();
+        }
+
+    private:
+        /**
+         * @brief 根据日志文件名的哈希生成共享内存的key
+         * @param pathhash 日志文件名的64位哈希
+         * @return 共享内存的key（32位全部取自哈希，不会是IPC_PRIVATE）
+         * @note 不用ftok：切换日志时文件被改名，新文件的inode不同，ftok得到的key会随之变化
+         */
+        static key_t makekey(uint64_t pathhash)
+        {
+            uint32_t k = static_cast<uint32_t>(pathhash ^ (pathhash >> 32));
+            return static_cast<key_t>(k == IPC_PRIVATE ? 0x4F4C0000 : k);
+        }
+
+        /**
+         * @brief 创建或挂接共享日志头，第一个挂接的进程负责初始化
+         * @param shmkey 共享内存的key
+         * @param pathhash 日志文件名的64位哈希
+         * @return true-成功，false-失败（包括key已被其它日志文件占用）
+         */
+        bool attachshm(key_t shmkey, uint64_t pathhash)
+        {
+            m_shmid = shmget(shmkey, sizeof(st_mplogshm), 0600 | IPC_CREAT);
+            if (m_shmid == -1) return false;
+
+            void* addr = shmat(m_shmid, nullptr, 0);
+            if (addr == (void*)-1)
+            {
+                m_shmid = -1;
+                return false;
+            }
+            m_shm = static_cast<st_mplogshm*>(addr);
+
+            // 新建的共享内存全为0，抢到初始化权的进程用当前文件大小初始化计数。
+            uint32_t expected = MPLOG_SHM_UNINIT;
+            if (m_shm->m_state.compare_exchange_strong(expected, MPLOG_SHM_INITING, std::memory_order_acq_rel))
+            {
+                m_shm->m_pathhash.store(pathhash, std::memory_order_relaxed);
+                struct stat st;
+                m_shm->m_size.store((fstat(m_fd, &st) == 0) ? static_cast<uint64_t>(st.st_size) : 0, std::memory_order_relaxed);
+                m_shm->m_gen.store(0, std::memory_order_relaxed);
+                m_shm->m_rotatePid.store(0, std::memory_order_relaxed);
+                m_shm->m_state.store(MPLOG_SHM_READY, std::memory_order_release);
+                return true;
+            }
+
+            // 等待其它进程完成初始化（最多等待约1秒，初始化者异常退出时放弃等待）。
+            for (int ii = 0; ii < 1000 && m_shm->m_state.load(std::memory_order_acquire) != MPLOG_SHM_READY; ++ii)
+                usleep(1000);
+
+            // key相同但文件名不同（哈希冲突或手工指定了别的日志的key），不能共用切换状态。
+            if (m_shm->m_pathhash.load(std::memory_order_relaxed) != pathhash)
+            {
+                shmdt(m_shm);
+                m_shm = nullptr;
+                m_shmid = -1;
+                return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief 重新打开当前日志文件（其它进程已完成切换时调用，调用者需持有m_splock）
+         * @return true-成功，false-失败
+         */
+        bool reopen()
+        {
+            uint64_t gen = m_shm->m_gen.load(std::memory_order_acquire);
+
+            int fd = ::open(m_filename.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+            if (fd < 0) return false; // 打开失败继续写旧文件，下次再试
+
+            ::close(m_fd);
+            m_fd = fd;
+            m_gen = gen;
+            return true;
+        }
+
+        /**
+         * @brief 自动切换日志（文件大小超过m_maxsize时，抢到切换锁的进程把当前日志改名为历史日志）
+         * @return true-成功，false-失败
+         * @note 备份文件名为原文件名+时间戳（如/tmp/log/url_breaker.log.20200101123025），与clogfile一致
+         */
+        bool backup()
+        {
+            if (m_backup == false || m_shm == nullptr || m_maxsize == 0) return true;
+
+            const uint64_t limit = static_cast<uint64_t>(m_maxsize) * 1024 * 1024;
+            if (m_shm->m_size.load(std::memory_order_relaxed) < limit) return true;
+
+            // 抢切换锁；持锁进程已不存在时接管。
+            int32_t self = static_cast<int32_t>(getpid());
+            int32_t owner = 0;
+            if (!m_shm->m_rotatePid.compare_exchange_strong(owner, self, std::memory_order_acq_rel))
+            {
+                if (owner == self || kill(owner, 0) == 0 || errno != ESRCH) return true; // 别的进程正在切换
+                if (!m_shm->m_rotatePid.compare_exchange_strong(owner, self, std::memory_order_acq_rel)) return true;
+            }
+
+            bool ret = true;
+
+            // 抢到锁后再判断一次，避免刚切换完又切换。
+            if (m_shm->m_size.load(std::memory_order_acquire) >= limit)
+            {
+                std::string bak = m_filename + "." + ltime1("yyyymmddhh24miss");
+                for (int ii = 1; access(bak.c_str(), F_OK) == 0; ++ii)
+                    bak = m_filename + "." + ltime1("yyyymmddhh24miss") + "." + std::to_string(ii);
+
+                if (rename(m_filename.c_str(), bak.c_str()) == 0)
+                {
+                    m_shm->m_size.store(0, std::memory_order_relaxed);
+                    m_shm->m_gen.fetch_add(1, std::memory_order_acq_rel);
+                }
+                else
+                    ret = false;
+            }
+
+            m_shm->m_rotatePid.store(0, std::memory_order_release);
+            return ret;
+        }
+    };
+    // ===========================================================================
+#endif // __linux__
+
+} // namespace ol
+
+#endif // !OL_MPLOG_H
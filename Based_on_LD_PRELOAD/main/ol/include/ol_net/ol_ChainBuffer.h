@@ -0,0 +1,444 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_ChainBuffer.h
+ * 功能描述：链式定长块缓冲区（Buffer的高吞吐版本），支持以下特性：
+ *          - 数据存放在定长块组成的链表中，每块带读写偏移：从头部消费只移动偏移，不做memmove
+ *          - 读socket：readv同时填充尾块剩余空间和栈上的溢出区，一次系统调用读尽可能多的数据
+ *          - 写socket：writev直接从各块发送，发送多少消费多少；缓冲区为空时sendOrAppend先直接写，剩余部分才复制
+ *          - 拆包：pickMessage返回std::string_view帧视图，帧位于单个块内时零拷贝，跨块时拼接到内部暂存区
+ *          - 分隔符模式与Buffer一致：0-无分隔符、1-四字节报头（主机字节序）、2-"\r\n\r\n"
+ *          - 空闲块复用，稳定状态下不做内存分配
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_CHAINBUFFER_H
+#define OL_CHAINBUFFER_H 1
+
+#include "ol_type_traits.h"
+#include <errno.h>
+#include <initializer_list>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+
+#ifdef __linux__
+#include <sys/uio.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace ol
+{
+
+#ifdef __linux__
+    class ChainBuffer : public TypeNonCopyableMovable
+    {
+    private:
+        // 数据块：块头之后紧跟m_blockSize字节的数据区
+        struct Block
+        {
+            Block* next; ///< 下一个块
+            size_t rd;   ///< 读偏移（已消费的字节数）
+            size_t wr;   ///< 写偏移（已写入的字节数）
+
+            char* data() { return reinterpret_cast<char*>(this + 1); }
+        };
+
+        static constexpr size_t MAX_FREE_BLOCKS = 4; ///< 最多缓存的空闲块数
+        static constexpr size_t MAX_IOV = 64;        ///< writev一次最多使用的块数
+        static constexpr size_t SPILL_SIZE = 65536;  ///< readv栈上溢出区大小
+
+        const uint16_t m_sep;     ///< 报文的分隔符：0-无分隔符，1-四字节的报头，2-"\r\n\r\n"分隔符（http协议）。
+        const size_t m_blockSize; ///< 每块的数据区大小
+        Block* m_head = nullptr;  ///< 第一个块（读端）
+        Block* m_tail = nullptr;  ///< 最后一个块（写端）
+        Block* m_free = nullptr;  ///< 空闲块链表
+        size_t m_freeNum = 0;     ///< 空闲块个数
+        size_t m_size = 0;        ///< 可读字节数
+        size_t m_pending = 0;     ///< 上一个帧视图占用、尚未消费的字节数
+        size_t m_scanned = 0;     ///< 分隔符模式2下已确认不含分隔符的前缀长度
+        std::string m_scratch;    ///< 跨块帧的拼接区
+
+        Block* allocBlock()
+        {
+            Block* b = m_free;
+            if (b != nullptr)
+            {
+                m_free = b->next;
+                --m_freeNum;
+            }
+            else
+            {
+                b = static_cast<Block*>(::operator new(sizeof(Block) + m_blockSize));
+            }
+            b->next = nullptr;
+            b->rd = b->wr = 0;
+            return b;
+        }
+
+        void freeBlock(Block* b)
+        {
+            if (m_freeNum < MAX_FREE_BLOCKS)
+            {
+                b->next = m_free;
+                m_free = b;
+                ++m_freeNum;
+            }
+            else
+            {
+                ::operator delete(b);
+            }
+        }
+
+        // 释放上一个帧视图占用的数据
+        void releasePending()
+        {
+            if (m_pending == 0) return;
+            size_t n = m_pending;
+            m_pending = 0;
+            consume(n);
+        }
+
+        // 从可读数据的off处复制len字节到dst（调用方保证off+len不超过size()）
+        void copyOut(size_t off, char* dst, size_t len) const
+        {
+            const Block* b = m_head;
+            while (off >= b->wr - b->rd)
+            {
+                off -= b->wr - b->rd;
+                b = b->next;
+            }
+            while (len > 0)
+            {
+                size_t n = b->wr - b->rd - off;
+                if (n > len) n = len;
+                memcpy(dst, const_cast<Block*>(b)->data() + b->rd + off, n);
+                dst += n;
+                len -= n;
+                off = 0;
+                b = b->next;
+            }
+        }
+
+        /**
+         * @brief 取可读数据前len字节的连续视图
+         * @note 位于第一个块内时直接指向块，否则拼接到m_scratch
+         */
+        std::string_view frontView(size_t len)
+        {
+            if (len <= m_head->wr - m_head->rd)
+                return std::string_view(m_head->data() + m_head->rd, len);
+
+            m_scratch.resize(len);
+            copyOut(0, &m_scratch[0], len);
+            return std::string_view(m_scratch.data(), len);
+        }
+
+        // 查找"\r\n\r\n"，返回其后一个字节的偏移，没找到返回0
+        size_t findHttpEnd()
+        {
+            static const char pat[] = "\r\n\r\n";
+            size_t off = m_scanned >= 3 ? m_scanned - 3 : 0; // 分隔符可能跨越上次扫描的末尾
+            size_t base = 0;
+            for (Block* b = m_head; b != nullptr; b = b->next)
+            {
+                size_t len = b->wr - b->rd;
+                if (off < base + len)
+                {
+                    const char* p = b->data() + b->rd;
+                    for (size_t ii = off - base; ii < len; ++ii)
+                    {
+                        if (p[ii] != '\r') continue;
+                        size_t pos = base + ii;
+                        if (pos + 4 > m_size) break;
+                        char tmp[4];
+                        if (ii + 4 <= len)
+                            memcpy(tmp, p + ii, 4);
+                        else
+                            copyOut(pos, tmp, 4);
+                        if (memcmp(tmp, pat, 4) == 0) return pos + 4;
+                    }
+                    off = base + len;
+                }
+                base += len;
+            }
+            m_scanned = m_size;
+            return 0;
+        }
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param sep 报文分隔符模式（同Buffer）
+         * @param blockSize 每块的数据区大小（默认16KB）
+         */
+        explicit ChainBuffer(uint16_t sep = 1, size_t blockSize = 16384)
+            : m_sep(sep), m_blockSize(blockSize < 64 ? 64 : blockSize)
+        {
+        }
+
+        ~ChainBuffer()
+        {
+            for (Block* b : {m_head, m_free})
+            {
+                while (b != nullptr)
+                {
+                    Block* next = b->next;
+                    ::operator delete(b);
+                    b = next;
+                }
+            }
+        }
+
+        // 返回可读字节数（不包括最近一次pickMessage返回的帧）
+        inline size_t size() const { return m_size - m_pending; }
+
+        inline bool empty() const { return size() == 0; }
+
+        // 清空缓冲区（保留空闲块）
+        void clear()
+        {
+            m_pending = 0;
+            consume(m_size);
+        }
+
+        /**
+         * @brief 把数据追加到缓冲区尾部
+         * @param data 数据
+         * @param size 数据长度
+         */
+        void append(const char* data, size_t size)
+        {
+            while (size > 0)
+            {
+                if (m_tail == nullptr || m_tail->wr == m_blockSize)
+                {
+                    Block* b = allocBlock();
+                    if (m_tail != nullptr)
+                        m_tail->next = b;
+                    else
+                        m_head = b;
+                    m_tail = b;
+                }
+                size_t n = m_blockSize - m_tail->wr;
+                if (n > size) n = size;
+                memcpy(m_tail->data() + m_tail->wr, data, n);
+                m_tail->wr += n;
+                m_size += n;
+                data += n;
+                size -= n;
+            }
+        }
+
+        inline void append(std::string_view sv) { append(sv.data(), sv.size()); }
+
+        // 把数据追加到缓冲区尾部，附加报文头部4字节（报文长度，主机字节序）
+        void appendWithSep(const char* data, size_t size)
+        {
+            if (m_sep == 1)
+            {
+                uint32_t len = static_cast<uint32_t>(size);
+                append(reinterpret_cast<const char*>(&len), 4);
+            }
+            append(data, size);
+        }
+
+        /**
+         * @brief 从头部消费n个字节（只移动偏移，用完的块回收复用）
+         * @param n 字节数（超过可读字节数时清空）
+         */
+        void consume(size_t n)
+        {
+            if (n > m_size) n = m_size;
+            m_size -= n;
+            m_scanned = (m_scanned > n) ? m_scanned - n : 0;
+            while (n > 0)
+            {
+                size_t len = m_head->wr - m_head->rd;
+                if (n < len)
+                {
+                    m_head->rd += n;
+                    return;
+                }
+                n -= len;
+                Block* b = m_head;
+                m_head = b->next;
+                if (m_head == nullptr) m_tail = nullptr;
+                freeBlock(b);
+            }
+        }
+
+        /**
+         * @brief 从缓冲区拆分出一个报文（零拷贝视图）
+         * @param frame 报文视图，在下一次调用本对象的非const成员函数之前有效
+         * @return true-拆出一个报文，false-没有完整报文
+         * @note 上一次返回的帧在本次调用时才真正消费；帧位于单个块内时直接指向块，跨块时拼接到内部暂存区
+         */
+        bool pickMessage(std::string_view& frame)
+        {
+            releasePending();
+            if (m_size == 0) return false;
+
+            size_t len = 0;
+            if (m_sep == 0)
+            {
+                len = m_size;
+            }
+            else if (m_sep == 1)
+            {
+                if (m_size < 4) return false;
+                uint32_t hdr;
+                copyOut(0, reinterpret_cast<char*>(&hdr), 4);
+                if (m_size < 4 + static_cast<size_t>(hdr)) return false;
+                consume(4);
+                len = hdr;
+            }
+            else if (m_sep == 2)
+            {
+                len = findHttpEnd();
+                if (len == 0) return false;
+                m_scanned = 0;
+            }
+            else
+            {
+                return false;
+            }
+
+            frame = len ? frontView(len) : std::string_view();
+            m_pending = len;
+            return true;
+        }
+
+        // 从缓冲区拆分出一个报文，复制到s中（兼容Buffer::pickMessage）
+        bool pickMessage(std::string& s)
+        {
+            std::string_view frame;
+            if (!pickMessage(frame)) return false;
+            s.assign(frame.data(), frame.size());
+            return true;
+        }
+
+        /**
+         * @brief 从fd读取数据到缓冲区（非阻塞模式，读到EAGAIN、对端关闭或读不满为止）
+         * @param fd 文件描述符
+         * @return 读取的字节数；0-对端已关闭且没有读到数据；-1-出错（errno为错误码，EAGAIN时返回已读字节数）
+         * @note 每次readv填充尾块剩余空间和64KB栈上溢出区，溢出部分再按块追加
+         */
+        ssize_t recvFd(int fd)
+        {
+            releasePending();
+            char spill[SPILL_SIZE];
+            ssize_t total = 0;
+            while (true)
+            {
+                struct iovec iov[2];
+                int iovcnt = 0;
+                size_t room = (m_tail != nullptr) ? m_blockSize - m_tail->wr : 0;
+                if (room > 0)
+                {
+                    iov[iovcnt].iov_base = m_tail->data() + m_tail->wr;
+                    iov[iovcnt].iov_len = room;
+                    ++iovcnt;
+                }
+                iov[iovcnt].iov_base = spill;
+                iov[iovcnt].iov_len = sizeof(spill);
+                ++iovcnt;
+
+                ssize_t n = ::readv(fd, iov, iovcnt);
+                if (n < 0)
+                {
+                    if (errno == EINTR) continue;
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return total;
+                    return total > 0 ? total : -1;
+                }
+                if (n == 0) return total;
+
+                total += n;
+                size_t inTail = static_cast<size_t>(n) < room ? static_cast<size_t>(n) : room;
+                if (inTail > 0)
+                {
+                    m_tail->wr += inTail;
+                    m_size += inTail;
+                }
+                if (static_cast<size_t>(n) > room) append(spill, n - room);
+
+                // 没有读满说明内核缓冲区已读空，省掉一次返回EAGAIN的系统调用
+                if (static_cast<size_t>(n) < room + sizeof(spill)) return total;
+            }
+        }
+
+        /**
+         * @brief 把缓冲区的数据写到fd（非阻塞模式，writev直接从各块发送）
+         * @param fd 文件描述符
+         * @return 写出的字节数；-1-出错（errno为错误码，EAGAIN时返回已写字节数）
+         */
+        ssize_t sendFd(int fd)
+        {
+            ssize_t total = 0;
+            while (size() > 0)
+            {
+                struct iovec iov[MAX_IOV];
+                int iovcnt = 0;
+                size_t skip = m_pending;
+                for (Block* b = m_head; b != nullptr && iovcnt < static_cast<int>(MAX_IOV); b = b->next)
+                {
+                    size_t len = b->wr - b->rd;
+                    if (skip >= len)
+                    {
+                        skip -= len;
+                        continue;
+                    }
+                    iov[iovcnt].iov_base = b->data() + b->rd + skip;
+                    iov[iovcnt].iov_len = len - skip;
+                    skip = 0;
+                    ++iovcnt;
+                }
+
+                ssize_t n = ::writev(fd, iov, iovcnt);
+                if (n < 0)
+                {
+                    if (errno == EINTR) continue;
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return total;
+                    return total > 0 ? total : -1;
+                }
+                releasePending();
+                consume(static_cast<size_t>(n));
+                total += n;
+            }
+            return total;
+        }
+
+        /**
+         * @brief 发送数据：缓冲区为空时先直接write，写不完的部分才复制到缓冲区
+         * @param fd 文件描述符
+         * @param data 数据
+         * @param size 数据长度
+         * @return 直接写出的字节数；-1-出错（errno为错误码，此时数据没有进入缓冲区）
+         * @note 缓冲区非空时为保证顺序只做追加，由调用方在可写事件中调用sendFd
+         */
+        ssize_t sendOrAppend(int fd, const char* data, size_t size)
+        {
+            ssize_t written = 0;
+            if (empty())
+            {
+                do
+                {
+                    written = ::write(fd, data, size);
+                } while (written < 0 && errno == EINTR);
+                if (written < 0)
+                {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+                    written = 0;
+                }
+            }
+            if (static_cast<size_t>(written) < size) append(data + written, size - written);
+            return written;
+        }
+    };
+#endif // __linux__
+
+} // namespace ol
+
+#endif // !OL_CHAINBUFFER_H
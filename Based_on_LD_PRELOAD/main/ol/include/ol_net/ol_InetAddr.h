@@ -6,6 +6,8 @@
  *          - 线程安全的IP地址与端口转换（避免静态缓冲区竞争）
  *          - 提供原生套接字地址访问接口，便于系统调用（bind/connect等）
  *          - 支持地址类型判断（IPv4/IPv6）和格式化输出（IP:端口）
+ *          - 二进制操作（不格式化、不抛异常）：==/<比较、哈希（std::hash特化）、前缀掩码与包含判断、
+ *            IPv4映射地址（::ffff:a.b.c.d）规范化、不分配内存的tryParse
  * 作者：ol
  * 适用标准：C++11及以上（需支持异常处理等特性）
  */
@@ -14,7 +16,11 @@
 #ifndef OL_INETADDR_H
 #define OL_INETADDR_H 1
 
+#include "ol_hash.h"
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <stdexcept>
 #include <string>
 
@@ -191,9 +197,282 @@ namespace ol
          * @throw std::invalid_argument 地址长度超限时抛出
          */
         void setAddr(const sockaddr* addr, socklen_t addrLen);
+
+        // 二进制操作（内联，不访问IP字符串缓存，不抛异常）
+        // -----------------------------------------------------------------------
+        // 注：m_ipBuf由库中已编译的getIp()使用，对象布局必须与libol.a保持一致，
+        //     去掉文本缓存（缩小到32字节）需要与库源码一起重新编译。
+    private:
+        // 规范化后的IP字节和地址族（IPv4映射地址取后4字节，按IPv4处理），不复制对象。
+        const uint8_t* effectiveIp(sa_family_t& family) const noexcept
+        {
+            if (isV4Mapped())
+            {
+                family = AF_INET;
+                return reinterpret_cast<const uint8_t*>(&m_addr.ipv6.sin6_addr) + 12;
+            }
+            family = m_family;
+            return getIpBytes();
+        }
+
+    public:
+
+        /**
+         * @brief 获取IP地址的二进制形式（网络字节序）
+         * @return 指向4字节（IPv4）或16字节（IPv6）地址的指针
+         */
+        const uint8_t* getIpBytes() const noexcept
+        {
+            return m_family == AF_INET6 ? reinterpret_cast<const uint8_t*>(&m_addr.ipv6.sin6_addr)
+                                        : reinterpret_cast<const uint8_t*>(&m_addr.ipv4.sin_addr);
+        }
+
+        /**
+         * @brief 获取IP地址的字节数
+         * @return IPv4返回4，IPv6返回16
+         */
+        size_t getIpLen() const noexcept
+        {
+            return m_family == AF_INET6 ? 16 : 4;
+        }
+
+        /**
+         * @brief 获取端口号（主机字节序，不抛异常）
+         * @return 端口号，地址族不支持时返回0
+         */
+        uint16_t getPortNoexcept() const noexcept
+        {
+            if (m_family == AF_INET) return ntohs(m_addr.ipv4.sin_port);
+            if (m_family == AF_INET6) return ntohs(m_addr.ipv6.sin6_port);
+            return 0;
+        }
+
+        /**
+         * @brief 把IP地址格式化到调用方的缓冲区（不使用内部缓存，可在多线程中共享同一对象）
+         * @param buf 输出缓冲区
+         * @param len 缓冲区大小（INET6_ADDRSTRLEN足够）
+         * @return 成功返回buf，失败返回nullptr
+         */
+        const char* formatIp(char* buf, size_t len) const noexcept
+        {
+            return inet_ntop(m_family, getIpBytes(), buf, static_cast<socklen_t>(len));
+        }
+
+        /**
+         * @brief 判断是否为IPv4映射的IPv6地址（::ffff:a.b.c.d）
+         */
+        bool isV4Mapped() const noexcept
+        {
+            return m_family == AF_INET6 && IN6_IS_ADDR_V4MAPPED(&m_addr.ipv6.sin6_addr);
+        }
+
+        /**
+         * @brief 判断IP是否为全0（0.0.0.0或::）
+         */
+        bool isAny() const noexcept
+        {
+            const uint8_t* p = getIpBytes();
+            for (size_t ii = 0; ii < getIpLen(); ++ii)
+            {
+                if (p[ii] != 0) return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 规范化：IPv4映射的IPv6地址转换为IPv4地址（端口不变），其它地址原样返回
+         * @return 规范化后的地址
+         * @note 双栈套接字上connect的IPv4目标以::ffff:a.b.c.d出现，比较前先规范化即可与IPv4规则匹配
+         */
+        InetAddr normalized() const noexcept
+        {
+            InetAddr addr(*this);
+            if (!isV4Mapped()) return addr;
+
+            sockaddr_in sin;
+            std::memset(&sin, 0, sizeof(sin));
+            sin.sin_family = AF_INET;
+            sin.sin_port = m_addr.ipv6.sin6_port;
+            std::memcpy(&sin.sin_addr, reinterpret_cast<const uint8_t*>(&m_addr.ipv6.sin6_addr) + 12, 4);
+            addr.trySetAddr(reinterpret_cast<const sockaddr*>(&sin), sizeof(sin));
+            return addr;
+        }
+
+        /**
+         * @brief 判断两个地址的IP是否相同（忽略端口，不做IPv4映射规范化）
+         */
+        bool sameIp(const InetAddr& other) const noexcept
+        {
+            return m_family == other.m_family && std::memcmp(getIpBytes(), other.getIpBytes(), getIpLen()) == 0;
+        }
+
+        /**
+         * @brief 保留IP的前prefixLen位，其余位清零（端口不变）
+         * @param prefixLen 前缀长度（超过地址位数时按地址位数处理）
+         * @return 掩码后的地址（如192.168.1.77掩码24位得到192.168.1.0）
+         */
+        InetAddr masked(unsigned prefixLen) const noexcept
+        {
+            InetAddr addr(*this);
+            uint8_t* p = const_cast<uint8_t*>(addr.getIpBytes());
+            size_t bits = getIpLen() * 8;
+            if (prefixLen >= bits) return addr;
+            size_t full = prefixLen / 8;
+            p[full] &= static_cast<uint8_t>(0xFF00u >> (prefixLen % 8));
+            std::memset(p + full + 1, 0, getIpLen() - full - 1);
+            std::memset(addr.m_ipBuf, 0, sizeof(addr.m_ipBuf)); // IP变了，缓存失效
+            return addr;
+        }
+
+        /**
+         * @brief 判断addr是否落在以本地址为网络号、前缀长度为prefixLen的网段内（忽略端口）
+         * @param addr 待判断的地址（IPv4映射地址按IPv4处理）
+         * @param prefixLen 前缀长度，0表示匹配任意地址（不区分地址族）
+         * @return 在网段内返回true，否则返回false
+         */
+        bool contains(const InetAddr& addr, unsigned prefixLen) const noexcept
+        {
+            if (prefixLen == 0) return true;
+            sa_family_t fa, fb;
+            const uint8_t* a = effectiveIp(fa);
+            const uint8_t* b = addr.effectiveIp(fb);
+            if (fa != fb) return false;
+
+            size_t bits = fa == AF_INET6 ? 128 : 32;
+            if (prefixLen > bits) prefixLen = static_cast<unsigned>(bits);
+            size_t full = prefixLen / 8;
+            if (std::memcmp(a, b, full) != 0) return false;
+            unsigned rest = prefixLen % 8;
+            if (rest == 0) return true;
+            uint8_t mask = static_cast<uint8_t>(0xFF00u >> rest);
+            return (a[full] & mask) == (b[full] & mask);
+        }
+
+        /**
+         * @brief 哈希值（与operator==一致：地址族、IP、端口、IPv6的scope id）
+         */
+        size_t hash() const noexcept
+        {
+            uint64_t seed = static_cast<uint64_t>(m_family) << 32;
+            if (m_family == AF_INET6)
+                return static_cast<size_t>(hash_addr18(&m_addr.ipv6.sin6_addr, getPortNoexcept(), seed ^ m_addr.ipv6.sin6_scope_id));
+            uint32_t v4;
+            std::memcpy(&v4, &m_addr.ipv4.sin_addr, 4);
+            return static_cast<size_t>(hash_addr4(v4, getPortNoexcept(), seed));
+        }
+
+        /**
+         * @brief 相等比较：地址族、IP、端口（IPv6还比较scope id）都相同
+         * @note 不做IPv4映射规范化，::ffff:1.2.3.4与1.2.3.4不相等，需要时先调用normalized()
+         */
+        bool operator==(const InetAddr& other) const noexcept
+        {
+            if (!sameIp(other) || getPortNoexcept() != other.getPortNoexcept()) return false;
+            return m_family != AF_INET6 || m_addr.ipv6.sin6_scope_id == other.m_addr.ipv6.sin6_scope_id;
+        }
+
+        bool operator!=(const InetAddr& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+        /**
+         * @brief 严格弱序：依次比较地址族、IP（网络字节序即数值顺序）、端口、scope id
+         */
+        bool operator<(const InetAddr& other) const noexcept
+        {
+            if (m_family != other.m_family) return m_family < other.m_family;
+            int cmp = std::memcmp(getIpBytes(), other.getIpBytes(), getIpLen());
+            if (cmp != 0) return cmp < 0;
+            uint16_t p1 = getPortNoexcept(), p2 = other.getPortNoexcept();
+            if (p1 != p2) return p1 < p2;
+            return m_family == AF_INET6 && m_addr.ipv6.sin6_scope_id < other.m_addr.ipv6.sin6_scope_id;
+        }
+
+        /**
+         * @brief 从原生sockaddr修改地址（不抛异常）
+         * @param addr 原生套接字地址指针（AF_INET或AF_INET6）
+         * @param addrLen 地址长度
+         * @return 成功返回true；地址族不支持或长度不足时返回false，本对象不变
+         */
+        bool trySetAddr(const sockaddr* addr, socklen_t addrLen) noexcept
+        {
+            if (addr == nullptr) return false;
+            if (addr->sa_family == AF_INET && addrLen >= static_cast<socklen_t>(sizeof(sockaddr_in)))
+                addrLen = sizeof(sockaddr_in);
+            else if (addr->sa_family == AF_INET6 && addrLen >= static_cast<socklen_t>(sizeof(sockaddr_in6)))
+                addrLen = sizeof(sockaddr_in6);
+            else
+                return false;
+
+            std::memset(&m_addr, 0, sizeof(m_addr));
+            std::memcpy(&m_addr, addr, addrLen);
+            m_family = addr->sa_family;
+            m_addrLen = addrLen;
+            std::memset(m_ipBuf, 0, sizeof(m_ipBuf)); // 缓存失效
+            return true;
+        }
+
+        /**
+         * @brief 解析IP字符串（自动识别IPv4/IPv6，不抛异常，不分配内存）
+         * @param ip IP字符串（不要求以'\0'结尾）
+         * @param len 字符串长度
+         * @param port 端口号（主机字节序）
+         * @param out 输出地址（解析失败时不变）
+         * @return 解析成功返回true，否则返回false
+         */
+        static bool tryParse(const char* ip, size_t len, uint16_t port, InetAddr& out) noexcept
+        {
+            char buf[INET6_ADDRSTRLEN];
+            if (ip == nullptr || len == 0 || len >= sizeof(buf)) return false;
+            std::memcpy(buf, ip, len);
+            buf[len] = '\0';
+
+            sockaddr_in6 sin6;
+            std::memset(&sin6, 0, sizeof(sin6));
+            if (std::memchr(buf, ':', len) == nullptr)
+            {
+                sockaddr_in* sin = reinterpret_cast<sockaddr_in*>(&sin6);
+                if (inet_pton(AF_INET, buf, &sin->sin_addr) != 1) return false;
+                sin->sin_family = AF_INET;
+                sin->sin_port = htons(port);
+                return out.trySetAddr(reinterpret_cast<const sockaddr*>(sin), sizeof(sockaddr_in));
+            }
+            if (inet_pton(AF_INET6, buf, &sin6.sin6_addr) != 1) return false;
+            sin6.sin6_family = AF_INET6;
+            sin6.sin6_port = htons(port);
+            return out.trySetAddr(reinterpret_cast<const sockaddr*>(&sin6), sizeof(sin6));
+        }
+
+        // 同上，ip为以'\0'结尾的字符串。
+        static bool tryParse(const char* ip, uint16_t port, InetAddr& out) noexcept
+        {
+            return ip != nullptr && tryParse(ip, std::strlen(ip), port, out);
+        }
+
+        // 同上，ip为std::string。
+        static bool tryParse(const std::string& ip, uint16_t port, InetAddr& out) noexcept
+        {
+            return tryParse(ip.data(), ip.size(), port, out);
+        }
     };
 #endif // __linux__
 
 } // namespace ol
 
+#ifdef __linux__
+// InetAddr作为unordered_map/unordered_set的键
+namespace std
+{
+    template <>
+    struct hash<ol::InetAddr>
+    {
+        size_t operator()(const ol::InetAddr& addr) const noexcept
+        {
+            return addr.hash();
+        }
+    };
+} // namespace std
+#endif // __linux__
+
 #endif // !OL_INETADDR_H
\ No newline at end of file
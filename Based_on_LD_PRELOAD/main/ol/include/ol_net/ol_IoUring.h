@@ -0,0 +1,519 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_IoUring.h
+ * 功能描述：io_uring的轻量封装（直接使用系统调用，不依赖liburing），支持以下特性：
+ *          - 创建环并映射SQ/CQ，优先使用SINGLE_ISSUER + DEFER_TASKRUN，内核不支持时逐级回退
+ *          - SQE在用户态累积，submitAndWait()一次系统调用完成提交和等待（带超时）
+ *          - 常用操作的填充函数：多发accept、多发recv（提供缓冲区环）、send（可链接成发送链）、
+ *            read、取消
+ *          - IoUringBufRing：注册提供缓冲区环（IORING_REGISTER_PBUF_RING），内核收包时自行挑选缓冲区，
+ *            用户处理完后归还
+ *          - 需要Linux 6.0及以上内核（多发recv），isSupported()在运行时探测
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_IOURING_H
+#define OL_IOURING_H 1
+
+#include "ol_type_traits.h"
+#include <atomic>
+#include <errno.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#ifdef __linux__
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#define OL_HAS_IO_URING 1
+#endif
+#endif // __linux__
+
+namespace ol
+{
+
+#ifdef OL_HAS_IO_URING
+    // io_uring环
+    // ===========================================================================
+    class IoUring : public TypeNonCopyableMovable
+    {
+    private:
+        int m_ringFd = -1;               ///< io_uring的fd。
+        unsigned m_features = 0;         ///< 内核支持的特性（IORING_FEAT_*）。
+        unsigned m_setupFlags = 0;       ///< 实际使用的创建标志（IORING_SETUP_*）。
+        void* m_sqMem = nullptr;         ///< SQ环的映射区。
+        size_t m_sqMemSize = 0;          ///< SQ环映射区的大小。
+        void* m_cqMem = nullptr;         ///< CQ环的映射区（SINGLE_MMAP时与m_sqMem相同）。
+        size_t m_cqMemSize = 0;          ///< CQ环映射区的大小。
+        io_uring_sqe* m_sqes = nullptr;  ///< SQE数组。
+        size_t m_sqesSize = 0;           ///< SQE数组映射区的大小。
+        unsigned* m_sqHead = nullptr;    ///< SQ头（内核更新）。
+        unsigned* m_sqTail = nullptr;    ///< SQ尾（用户更新）。
+        unsigned m_sqMask = 0;           ///< SQ掩码。
+        unsigned m_sqEntries = 0;        ///< SQ大小。
+        unsigned m_sqLocalTail = 0;      ///< 本地SQ尾，提交时才发布给内核。
+        unsigned* m_cqHead = nullptr;    ///< CQ头（用户更新）。
+        unsigned* m_cqTail = nullptr;    ///< CQ尾（内核更新）。
+        unsigned m_cqMask = 0;           ///< CQ掩码。
+        io_uring_cqe* m_cqes = nullptr;  ///< CQE数组。
+        size_t m_enterCalls = 0;         ///< 累计io_uring_enter系统调用次数（用于统计每个请求的系统调用数）。
+
+        static inline unsigned loadAcquire(const unsigned* p)
+        {
+            return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+        }
+
+        static inline void storeRelease(unsigned* p, unsigned v)
+        {
+            __atomic_store_n(p, v, __ATOMIC_RELEASE);
+        }
+
+        static inline int sysSetup(unsigned entries, io_uring_params* p)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+        }
+
+        inline int sysEnter(unsigned toSubmit, unsigned minComplete, unsigned flags, void* arg, size_t argSize)
+        {
+            ++m_enterCalls;
+            return static_cast<int>(syscall(__NR_io_uring_enter, m_ringFd, toSubmit, minComplete, flags, arg, argSize));
+        }
+
+        // 把本地SQ尾发布给内核，返回待内核取走的SQE数。
+        inline unsigned flushSq()
+        {
+            storeRelease(m_sqTail, m_sqLocalTail);
+            return m_sqLocalTail - loadAcquire(m_sqHead);
+        }
+
+        void release()
+        {
+            if (m_sqes) munmap(m_sqes, m_sqesSize);
+            if (m_cqMem && m_cqMem != m_sqMem) munmap(m_cqMem, m_cqMemSize);
+            if (m_sqMem) munmap(m_sqMem, m_sqMemSize);
+            if (m_ringFd >= 0) ::close(m_ringFd);
+            m_sqes = nullptr;
+            m_cqMem = m_sqMem = nullptr;
+            m_ringFd = -1;
+        }
+
+    public:
+        /**
+         * @brief 创建io_uring环
+         * @param entries SQ大小（内核向上取2的幂），CQ大小为其4倍
+         * @throw std::runtime_error 创建或映射失败时抛出
+         * @note 优先使用SINGLE_ISSUER + DEFER_TASKRUN（完成事件只在本线程等待时处理，减少中断和上下文切换），
+         *       这要求环只在一个线程中提交，所以应在事件循环线程中创建；内核不支持时回退到COOP_TASKRUN或默认模式
+         */
+        explicit IoUring(unsigned entries = 256)
+        {
+            const unsigned base = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL;
+            const unsigned tries[] = {base | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN,
+                                      base | IORING_SETUP_COOP_TASKRUN,
+                                      base,
+                                      0};
+            io_uring_params p;
+            for (unsigned flags : tries)
+            {
+                memset(&p, 0, sizeof(p));
+                p.flags = flags;
+                p.cq_entries = entries * 4;
+                m_ringFd = sysSetup(entries, &p);
+                if (m_ringFd >= 0)
+                {
+                    m_setupFlags = flags;
+                    break;
+                }
+                if (errno != EINVAL) break;
+            }
+            if (m_ringFd < 0)
+                throw std::runtime_error(std::string("io_uring_setup failed: ") + strerror(errno));
+            m_features = p.features;
+
+            m_sqMemSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+            m_cqMemSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+            if (m_features & IORING_FEAT_SINGLE_MMAP)
+            {
+                if (m_cqMemSize > m_sqMemSize) m_sqMemSize = m_cqMemSize;
+                m_cqMemSize = m_sqMemSize;
+            }
+
+            m_sqMem = mmap(nullptr, m_sqMemSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+            if (m_sqMem == MAP_FAILED)
+            {
+                m_sqMem = nullptr;
+                release();
+                throw std::runtime_error("io_uring mmap sq ring failed");
+            }
+            if (m_features & IORING_FEAT_SINGLE_MMAP)
+                m_cqMem = m_sqMem;
+            else
+            {
+                m_cqMem = mmap(nullptr, m_cqMemSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_CQ_RING);
+                if (m_cqMem == MAP_FAILED)
+                {
+                    m_cqMem = nullptr;
+                    release();
+                    throw std::runtime_error("io_uring mmap cq ring failed");
+                }
+            }
+            m_sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED)
+            {
+                release();
+                throw std::runtime_error("io_uring mmap sqes failed");
+            }
+            m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+            char* sq = static_cast<char*>(m_sqMem);
+            char* cq = static_cast<char*>(m_cqMem);
+            m_sqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+            m_sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+            m_sqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+            m_sqEntries = p.sq_entries;
+            m_sqLocalTail = *m_sqTail;
+            m_cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+            m_cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+            m_cqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+            // SQ索引数组固定为恒等映射，之后只需移动尾指针。
+            unsigned* array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+            for (unsigned ii = 0; ii < m_sqEntries; ++ii) array[ii] = ii;
+        }
+
+        ~IoUring()
+        {
+            release();
+        }
+
+        // io_uring的fd。
+        inline int getFd() const { return m_ringFd; }
+
+        // 内核支持的特性（IORING_FEAT_*）。
+        inline unsigned getFeatures() const { return m_features; }
+
+        // 实际使用的创建标志（IORING_SETUP_*）。
+        inline unsigned getSetupFlags() const { return m_setupFlags; }
+
+        // 累计io_uring_enter系统调用次数。
+        inline size_t getEnterCalls() const { return m_enterCalls; }
+
+        /**
+         * @brief 取一个空闲SQE（已清零），SQ满时先提交已有的SQE
+         * @return SQE指针，填充后在下次submit()/submitAndWait()时提交
+         */
+        io_uring_sqe* getSqe()
+        {
+            if (m_sqLocalTail - loadAcquire(m_sqHead) >= m_sqEntries) submit();
+            io_uring_sqe* sqe = &m_sqes[m_sqLocalTail & m_sqMask];
+            ++m_sqLocalTail;
+            memset(sqe, 0, sizeof(*sqe));
+            return sqe;
+        }
+
+        /**
+         * @brief 提交累积的SQE，不等待完成
+         * @return 内核取走的SQE数，失败返回-errno
+         */
+        int submit()
+        {
+            unsigned n = flushSq();
+            if (n == 0) return 0;
+            int ret = sysEnter(n, 0, 0, nullptr, 0);
+            return ret < 0 ? -errno : ret;
+        }
+
+        /**
+         * @brief 提交累积的SQE并等待至少一个完成事件（一次系统调用）
+         * @param timeoutMs 等待的超时时间（毫秒，小于0表示无限等待）
+         * @return 成功返回0，超时返回-ETIME，被信号打断返回-EINTR，其它错误返回-errno
+         */
+        int submitAndWait(int timeoutMs)
+        {
+            unsigned n = flushSq();
+            if (cqReady() > 0) // 已有完成事件：只提交不等待
+            {
+                if (n == 0) return 0;
+                int ret = sysEnter(n, 0, 0, nullptr, 0);
+                return ret < 0 ? -errno : 0;
+            }
+
+            int ret;
+            if (timeoutMs >= 0 && (m_features & IORING_FEAT_EXT_ARG))
+            {
+                struct __kernel_timespec ts;
+                ts.tv_sec = timeoutMs / 1000;
+                ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+                io_uring_getevents_arg arg;
+                memset(&arg, 0, sizeof(arg));
+                arg.ts = reinterpret_cast<uint64_t>(&ts);
+                ret = sysEnter(n, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+            }
+            else
+                ret = sysEnter(n, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (ret < 0) return -errno;
+            return 0;
+        }
+
+        // 已完成但未处理的CQE数。
+        inline unsigned cqReady() const
+        {
+            return loadAcquire(m_cqTail) - *m_cqHead;
+        }
+
+        /**
+         * @brief 处理全部已完成的CQE
+         * @param func 回调函数，签名为void(const io_uring_cqe&)，可在其中继续getSqe()
+         * @return 处理的CQE数
+         */
+        template <typename Func>
+        unsigned forEachCqe(Func&& func)
+        {
+            unsigned count = 0;
+            while (true)
+            {
+                unsigned head = *m_cqHead;
+                unsigned tail = loadAcquire(m_cqTail);
+                if (head == tail) break;
+                for (; head != tail; ++head, ++count)
+                {
+                    io_uring_cqe cqe = m_cqes[head & m_cqMask];
+                    storeRelease(m_cqHead, head + 1); // 先归还槽位，回调中产生的新完成事件不会被挤掉
+                    func(cqe);
+                }
+            }
+            return count;
+        }
+
+        // 操作填充函数
+        // -----------------------------------------------------------------------
+        /**
+         * @brief 多发accept：一次提交持续产生新连接，每个连接一个CQE（res为新fd）
+         * @note CQE不带IORING_CQE_F_MORE时多发已结束，需要重新提交
+         */
+        static void prepAcceptMultishot(io_uring_sqe* sqe, int listenFd, uint64_t userData, int flags = SOCK_CLOEXEC)
+        {
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->fd = listenFd;
+            sqe->accept_flags = static_cast<uint32_t>(flags);
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe->user_data = userData;
+        }
+
+        /**
+         * @brief 多发recv：从提供缓冲区组bgid中取缓冲区，每次收到数据一个CQE
+         * @note CQE带IORING_CQE_F_BUFFER时高16位是缓冲区id，处理完必须归还；res为-ENOBUFS表示缓冲区耗尽
+         */
+        static void prepRecvMultishot(io_uring_sqe* sqe, int fd, uint16_t bgid, uint64_t userData)
+        {
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = fd;
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = bgid;
+            sqe->user_data = userData;
+        }
+
+        /**
+         * @brief send：使用MSG_WAITALL，短写由内核继续发送完，因此可以用IOSQE_IO_LINK串成有序的发送链
+         * @param link true-与下一个SQE链接（前一个完成后才开始下一个，失败时后续以-ECANCELED结束）
+         */
+        static void prepSend(io_uring_sqe* sqe, int fd, const void* buf, size_t len, uint64_t userData, bool link)
+        {
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(buf);
+            sqe->len = static_cast<uint32_t>(len);
+            sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+            sqe->user_data = userData;
+            if (link) sqe->flags |= IOSQE_IO_LINK;
+        }
+
+        // read（用于eventfd等）。
+        static void prepRead(io_uring_sqe* sqe, int fd, void* buf, size_t len, uint64_t userData)
+        {
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(buf);
+            sqe->len = static_cast<uint32_t>(len);
+            sqe->off = static_cast<uint64_t>(-1);
+            sqe->user_data = userData;
+        }
+
+        // 取消user_data等于target的请求。
+        static void prepCancel(io_uring_sqe* sqe, uint64_t target, uint64_t userData)
+        {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = target;
+            sqe->user_data = userData;
+        }
+
+        // 取消fd上的全部请求。
+        static void prepCancelFd(io_uring_sqe* sqe, int fd, uint64_t userData)
+        {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = fd;
+            sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+            sqe->user_data = userData;
+        }
+
+        // 注册提供缓冲区环（供IoUringBufRing使用）。
+        int registerBufRing(io_uring_buf_reg* reg)
+        {
+            int ret = static_cast<int>(syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_PBUF_RING, reg, 1));
+            return ret < 0 ? -errno : ret;
+        }
+
+        // 注销提供缓冲区环。
+        int unregisterBufRing(uint16_t bgid)
+        {
+            io_uring_buf_reg reg;
+            memset(&reg, 0, sizeof(reg));
+            reg.bgid = bgid;
+            int ret = static_cast<int>(syscall(__NR_io_uring_register, m_ringFd, IORING_UNREGISTER_PBUF_RING, &reg, 1));
+            return ret < 0 ? -errno : ret;
+        }
+
+        /**
+         * @brief 运行时探测：内核是否支持本封装用到的全部特性（多发accept/recv、提供缓冲区环、EXT_ARG）
+         * @return true-支持，false-不支持（被sysctl kernel.io_uring_disabled禁用、内核低于6.0等）
+         */
+        static bool isSupported()
+        {
+            static const bool supported = []()
+            {
+                struct utsname u;
+                if (uname(&u) != 0) return false;
+                int major = 0, minor = 0;
+                if (sscanf(u.release, "%d.%d", &major, &minor) != 2) return false;
+                if (major < 6) return false; // 多发recv从6.0开始支持
+
+                io_uring_params p;
+                memset(&p, 0, sizeof(p));
+                int fd = sysSetup(4, &p);
+                if (fd < 0) return false;
+                ::close(fd);
+                return (p.features & IORING_FEAT_EXT_ARG) && (p.features & IORING_FEAT_NODROP);
+            }();
+            return supported;
+        }
+    };
+
+    // 提供缓冲区环
+    // ===========================================================================
+    class IoUringBufRing : public TypeNonCopyableMovable
+    {
+    private:
+        IoUring* m_ring;             ///< 注册到的io_uring。
+        uint16_t m_bgid;             ///< 缓冲区组id。
+        unsigned m_entries;          ///< 缓冲区个数（2的幂）。
+        unsigned m_mask;             ///< 环掩码。
+        size_t m_bufSize;            ///< 每个缓冲区的大小。
+        io_uring_buf_ring* m_br;     ///< 与内核共享的缓冲区描述环。
+        size_t m_brSize;             ///< 描述环的映射大小。
+        char* m_bufs;                ///< 全部缓冲区（连续内存）。
+        unsigned short m_tail = 0;   ///< 本地环尾，归还缓冲区后发布。
+        unsigned short m_pending = 0;///< 已填充但未发布的描述个数。
+
+    public:
+        /**
+         * @brief 分配缓冲区并注册到io_uring
+         * @param ring 注册到的io_uring
+         * @param bgid 缓冲区组id（recv时用prepRecvMultishot的bgid指定）
+         * @param entries 缓冲区个数（向上取2的幂，最大32768）
+         * @param bufSize 每个缓冲区的大小
+         * @throw std::runtime_error 分配或注册失败时抛出
+         */
+        IoUringBufRing(IoUring& ring, uint16_t bgid, unsigned entries = 1024, size_t bufSize = 4096)
+            : m_ring(&ring), m_bgid(bgid), m_bufSize(bufSize)
+        {
+            m_entries = 1;
+            while (m_entries < entries && m_entries < 32768) m_entries <<= 1;
+            m_mask = m_entries - 1;
+
+            m_brSize = m_entries * sizeof(io_uring_buf);
+            void* br = mmap(nullptr, m_brSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (br == MAP_FAILED) throw std::runtime_error("io_uring buf ring mmap failed");
+            m_br = static_cast<io_uring_buf_ring*>(br);
+
+            void* bufs = mmap(nullptr, m_entries * m_bufSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (bufs == MAP_FAILED)
+            {
+                munmap(m_br, m_brSize);
+                throw std::runtime_error("io_uring buffers mmap failed");
+            }
+            m_bufs = static_cast<char*>(bufs);
+
+            io_uring_buf_reg reg;
+            memset(&reg, 0, sizeof(reg));
+            reg.ring_addr = reinterpret_cast<uint64_t>(m_br);
+            reg.ring_entries = m_entries;
+            reg.bgid = m_bgid;
+            int ret = m_ring->registerBufRing(&reg);
+            if (ret < 0)
+            {
+                munmap(m_bufs, m_entries * m_bufSize);
+                munmap(m_br, m_brSize);
+                throw std::runtime_error(std::string("io_uring register buf ring failed: ") + strerror(-ret));
+            }
+
+            for (unsigned ii = 0; ii < m_entries; ++ii) add(static_cast<uint16_t>(ii));
+            commit();
+        }
+
+        ~IoUringBufRing()
+        {
+            m_ring->unregisterBufRing(m_bgid);
+            munmap(m_bufs, m_entries * m_bufSize);
+            munmap(m_br, m_brSize);
+        }
+
+        // 缓冲区组id。
+        inline uint16_t getBgid() const { return m_bgid; }
+
+        // 每个缓冲区的大小。
+        inline size_t getBufSize() const { return m_bufSize; }
+
+        // 缓冲区bid的地址。
+        inline char* getBuf(uint16_t bid) const { return m_bufs + static_cast<size_t>(bid) * m_bufSize; }
+
+        /**
+         * @brief 归还缓冲区（先填充描述，commit()时一次发布给内核）
+         * @param bid 缓冲区id（CQE的flags >> IORING_CQE_BUFFER_SHIFT）
+         */
+        inline void add(uint16_t bid)
+        {
+            // 不用m_br->bufs：内核头文件的柔性数组在C++中前面多了一个空结构体成员，偏移是8而不是0。
+            io_uring_buf* buf = reinterpret_cast<io_uring_buf*>(m_br) + ((m_tail + m_pending) & m_mask);
+            buf->addr = reinterpret_cast<uint64_t>(getBuf(bid));
+            buf->len = static_cast<uint32_t>(m_bufSize);
+            buf->bid = bid;
+            ++m_pending;
+        }
+
+        // 发布已归还的缓冲区。
+        inline void commit()
+        {
+            if (m_pending == 0) return;
+            m_tail = static_cast<unsigned short>(m_tail + m_pending);
+            m_pending = 0;
+            __atomic_store_n(&m_br->tail, m_tail, __ATOMIC_RELEASE);
+        }
+    };
+#endif // OL_HAS_IO_URING
+
+} // namespace ol
+
+#endif // !OL_IOURING_H
@@ -0,0 +1,299 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_OrderedOffload.h
+ * 功能描述：按连接保序的工作线程分流器（把报文处理从IO线程转交给工作线程），支持以下特性：
+ *          - 每个连接按fd哈希固定到一个工作线程（分片），同一连接的报文在该分片上按到达顺序处理，
+ *            不同连接在各分片上并行；慢处理（例如重新编译策略）只阻塞同一分片，不阻塞IO线程
+ *          - 每个分片一个无锁任务队列（TaskQueue），队列由空变非空时才用futex唤醒工作线程
+ *          - 回复批量送回IO线程：处理一批报文期间产生的回复按所属事件循环分组，每个事件循环只投递一次任务
+ *            （连接类型提供getLoop()时，例如UringConnection；否则逐条调用conn->send()）
+ *          - 可选CPU亲和：工作线程i绑定到cpus[i % cpus.size()]，连接的数据始终在同一个核上处理，缓存保持热
+ *          - 适用于TcpServer、ShardedTcpServer、UringTcpServer（模板参数为Server::ConnPtr）
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_ORDEREDOFFLOAD_H
+#define OL_ORDEREDOFFLOAD_H 1
+
+#include "ol_base/ol_lfqueue_base.h"
+#include "ol_taskqueue.h"
+#include "ol_type_traits.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif // __linux__
+
+namespace ol
+{
+
+    namespace base
+    {
+        // 连接类型是否提供getLoop()->pushToQueue()（可以把回复按事件循环分组投递）
+        template <class ConnPtr, class = void>
+        struct HasLoopAccess : std::false_type
+        {
+        };
+
+        template <class ConnPtr>
+        struct HasLoopAccess<ConnPtr, std::void_t<decltype(std::declval<ConnPtr&>()->getLoop()->pushToQueue(std::function<void()>()))>>
+            : std::true_type
+        {
+        };
+    } // namespace base
+
+#ifdef __linux__
+    // ===========================================================================
+    /**
+     * @brief 按连接保序的工作线程分流器
+     * @tparam ConnPtr 连接指针类型（ConnectionPtr、UringConnectionPtr等，需要getFd()和send(data, size)）
+     * @note 用法：
+     *       OrderedOffload<TcpServer::ConnPtr> offload(handler, 4);
+     *       server.setOnMessageCb([&](ConnectionPtr conn, std::string& message)
+     *                             { offload.offload(conn, std::move(message)); });
+     *       handler在工作线程中执行，用offload.reply(conn, data, size)回复（批量送回IO线程）
+     */
+    template <class ConnPtr>
+    class OrderedOffload : public TypeNonCopyableMovable
+    {
+    public:
+        using Handler = std::function<void(ConnPtr, std::string&)>; ///< 报文处理函数（在工作线程中执行）
+
+    private:
+        static constexpr size_t MAX_BATCH_REPLIES = 256; ///< 一批处理中累积的回复达到该数量时提前送回
+
+        // 待送回IO线程的回复
+        struct Reply
+        {
+            ConnPtr m_conn;
+            std::string m_data;
+        };
+
+        // 工作线程（分片）
+        struct Worker
+        {
+            OrderedOffload* m_owner;             ///< 所属分流器。
+            TaskQueue m_queue;                   ///< 本分片的任务队列。
+            base::EventCount m_ev{};             ///< 队列非空事件（工作线程空闲时在上面睡眠）。
+            std::vector<Reply> m_replies;        ///< 本批处理产生的回复。
+            std::atomic<size_t> m_processed{0};  ///< 累计处理的任务数。
+            std::thread m_thread;                ///< 工作线程。
+        };
+
+        Handler m_handler;                              ///< 报文处理函数。
+        std::vector<std::unique_ptr<Worker>> m_workers; ///< 全部分片。
+        std::atomic_bool m_stop{false};                 ///< 是否停止。
+
+        // 当前线程所在的分片（不是工作线程时为nullptr）。
+        static Worker*& current()
+        {
+            static thread_local Worker* worker = nullptr;
+            return worker;
+        }
+
+        // 连接到分片的映射（fd哈希，连接的生命期内固定不变）。
+        inline size_t shardIndex(const ConnPtr& conn) const
+        {
+            uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(conn->getFd())) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>(h >> 32) % m_workers.size();
+        }
+
+        inline Worker* shardOf(const ConnPtr& conn) const
+        {
+            return m_workers[shardIndex(conn)].get();
+        }
+
+        // 把任务放入分片的队列，队列由空变非空时唤醒工作线程。
+        template <typename F>
+        void pushTo(Worker* w, F&& task)
+        {
+            if (w->m_queue.push(std::forward<F>(task))) w->m_ev.notify(false, false);
+        }
+
+        // 把本批回复送回IO线程。
+        void flushReplies(Worker* w)
+        {
+            if (w->m_replies.empty()) return;
+            if constexpr (base::HasLoopAccess<ConnPtr>::value)
+            {
+                // 按事件循环分组（IO线程通常只有几个，线性查找即可），组内保持回复顺序
+                using LoopPtr = decltype(std::declval<ConnPtr&>()->getLoop());
+                std::vector<std::pair<LoopPtr, std::vector<Reply>>> groups;
+                for (auto& reply : w->m_replies)
+                {
+                    LoopPtr loop = reply.m_conn->getLoop();
+                    size_t ii = 0;
+                    while (ii < groups.size() && groups[ii].first != loop) ++ii;
+                    if (ii == groups.size()) groups.emplace_back(loop, std::vector<Reply>());
+                    groups[ii].second.push_back(std::move(reply));
+                }
+                for (auto& group : groups)
+                {
+                    group.first->pushToQueue([batch = std::move(group.second)]()
+                                             {
+                                                 for (auto& reply : batch)
+                                                     reply.m_conn->send(reply.m_data.data(), reply.m_data.size()); });
+                }
+            }
+            else
+            {
+                for (auto& reply : w->m_replies)
+                    reply.m_conn->send(reply.m_data.data(), reply.m_data.size());
+            }
+            w->m_replies.clear();
+        }
+
+        void workerLoop(Worker* w, int cpu)
+        {
+            if (cpu >= 0) pinToCpu(static_cast<size_t>(cpu));
+            current() = w;
+            while (true)
+            {
+                size_t n = w->m_queue.drain();
+                if (n > 0)
+                {
+                    flushReplies(w);
+                    w->m_processed.fetch_add(n, std::memory_order_relaxed);
+                    continue;
+                }
+                if (m_stop.load(std::memory_order_acquire)) break; // 队列已取空才退出，已提交的任务都会执行
+
+                uint32_t key = w->m_ev.prepareWait();
+                if (!w->m_queue.empty() || m_stop.load(std::memory_order_acquire))
+                {
+                    w->m_ev.cancelWait();
+                    continue;
+                }
+                w->m_ev.wait(key, false, -1);
+            }
+            current() = nullptr;
+        }
+
+    public:
+        /**
+         * @brief 构造函数：创建并启动工作线程
+         * @param handler 报文处理函数（在工作线程中执行，同一连接的报文按顺序调用）
+         * @param workerNum 工作线程（分片）数，0表示CPU核数
+         * @param cpus 工作线程绑定的CPU列表（为空表示不绑定），线程i绑定到cpus[i % cpus.size()]
+         */
+        explicit OrderedOffload(Handler handler, size_t workerNum = 0, std::vector<int> cpus = {})
+            : m_handler(std::move(handler))
+        {
+            if (workerNum == 0) workerNum = std::thread::hardware_concurrency();
+            if (workerNum == 0) workerNum = 1;
+
+            for (size_t ii = 0; ii < workerNum; ++ii)
+            {
+                std::unique_ptr<Worker> w(new Worker);
+                w->m_owner = this;
+                m_workers.emplace_back(std::move(w));
+            }
+            for (size_t ii = 0; ii < workerNum; ++ii)
+            {
+                Worker* w = m_workers[ii].get();
+                int cpu = cpus.empty() ? -1 : cpus[ii % cpus.size()];
+                w->m_thread = std::thread([this, w, cpu]()
+                                          { workerLoop(w, cpu); });
+            }
+        }
+
+        ~OrderedOffload()
+        {
+            stop();
+        }
+
+        /**
+         * @brief 把报文转交给连接所属的分片处理（通常在IO线程的报文回调中调用）
+         * @param conn 连接
+         * @param message 报文（被移走）
+         */
+        void offload(const ConnPtr& conn, std::string&& message)
+        {
+            pushTo(shardOf(conn), [this, conn, message = std::move(message)]() mutable
+                   { m_handler(conn, message); });
+        }
+
+        // 同上，移走message的内容（可直接传入报文回调的std::string&参数）。
+        void offload(const ConnPtr& conn, std::string& message)
+        {
+            offload(conn, std::move(message));
+        }
+
+        /**
+         * @brief 在连接所属的分片上执行任意任务（与该连接的报文处理保持先后顺序）
+         * @param conn 连接
+         * @param task 任务，签名为void()
+         */
+        template <typename F>
+        void post(const ConnPtr& conn, F&& task)
+        {
+            pushTo(shardOf(conn), std::forward<F>(task));
+        }
+
+        /**
+         * @brief 回复连接（在处理函数中调用）：回复先缓存在分片中，本批处理结束后批量送回IO线程
+         * @param conn 连接
+         * @param data 数据
+         * @param size 数据大小
+         * @note 不在本分流器的工作线程中调用时，直接调用conn->send()
+         */
+        void reply(const ConnPtr& conn, const char* data, size_t size)
+        {
+            Worker* w = current();
+            if (!w || w->m_owner != this)
+            {
+                conn->send(data, size);
+                return;
+            }
+            w->m_replies.push_back(Reply{conn, std::string(data, size)});
+            if (w->m_replies.size() >= MAX_BATCH_REPLIES) flushReplies(w);
+        }
+
+        // 停止：执行完已提交的任务后退出工作线程。
+        void stop()
+        {
+            m_stop.store(true, std::memory_order_release);
+            for (auto& w : m_workers) w->m_ev.notify(false, true);
+            for (auto& w : m_workers)
+            {
+                if (w->m_thread.joinable() && w->m_thread.get_id() != std::this_thread::get_id()) w->m_thread.join();
+            }
+        }
+
+        // 工作线程（分片）数。
+        inline size_t getWorkerNum() const { return m_workers.size(); }
+
+        // 连接所属的分片编号。
+        inline size_t getShard(const ConnPtr& conn) const { return shardIndex(conn); }
+
+        // 分片累计处理的任务数。
+        inline size_t getProcessedNum(size_t shard) const
+        {
+            return shard < m_workers.size() ? m_workers[shard]->m_processed.load(std::memory_order_relaxed) : 0;
+        }
+
+        // 把当前线程绑定到CPU。
+        static void pinToCpu(size_t cpu)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu % CPU_SETSIZE, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+    };
+    // ===========================================================================
+#endif // __linux__
+
+} // namespace ol
+
+#endif // !OL_ORDEREDOFFLOAD_H
@@ -0,0 +1,288 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_ShardedTcpServer.h
+ * 功能描述：SO_REUSEPORT多监听分片的TCP服务器，与TcpServer接口一致，支持以下特性：
+ *          - 每个IO线程（分片）拥有自己的事件循环和监听socket（同一ip:port，SO_REUSEPORT），
+ *            由内核在各监听socket之间分配新连接；连接在哪个线程accept就在哪个线程处理，
+ *            不经过主事件循环，也没有pushToQueue + eventfd的跨线程转交
+ *          - 每次可读事件循环accept到EAGAIN，一次唤醒处理一批连接
+ *          - 每个分片有自己的连接表和互斥锁（只有本分片线程和少量查询会访问，基本无竞争）
+ *          - 可选CPU亲和分流：把IO线程i绑定到CPU i，并给监听组挂载BPF程序（SO_ATTACH_REUSEPORT_CBPF），
+ *            按处理SYN的CPU选择分片，连接的软中断、accept和业务处理都在同一个CPU上
+ *          - 报文回调在IO线程中直接执行（耗时的业务请自行转交线程池）
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_SHARDEDTCPSERVER_H
+#define OL_SHARDEDTCPSERVER_H 1
+
+#include "ol_net/ol_Channel.h"
+#include "ol_net/ol_Connection.h"
+#include "ol_net/ol_EventLoop.h"
+#include "ol_net/ol_InetAddr.h"
+#include "ol_net/ol_SocketFd.h"
+#include "ol_net/ol_net_fwd_decls.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/filter.h>
+#include <pthread.h>
+#include <sched.h>
+#endif // __linux__
+
+namespace ol
+{
+
+#ifdef __linux__
+    class ShardedTcpServer
+    {
+    public:
+        using ConnPtr = ConnectionPtr; ///< 连接类型（与UringTcpServer::ConnPtr对应，便于业务类按服务器类型写成模板）。
+        using LoopType = EventLoop;    ///< 事件循环类型。
+
+    private:
+        // 分片：一个IO线程、一个事件循环、一个监听socket
+        struct Shard
+        {
+            EventLoopPtr m_loop;                            ///< 分片的事件循环。
+            SocketFdPtr m_listenFd;                         ///< 分片的监听socket（SO_REUSEPORT）。
+            ChannelPtr m_acceptChnl;                        ///< 监听socket的Channel。
+            std::mutex m_connsMutex;                        ///< 保护m_conns的互斥锁。
+            std::unordered_map<int, ConnectionPtr> m_conns; ///< 本分片的Connection对象。
+            std::atomic<size_t> m_accepted{0};              ///< 本分片累计accept的连接数。
+            std::thread m_thread;                           ///< 分片的IO线程（分片0在调用start()的线程中运行）。
+        };
+
+        std::vector<std::unique_ptr<Shard>> m_shards; ///< 全部分片。
+        int m_epWaitTimeout;                          ///< epoll_wait()的超时时间（毫秒）。
+        bool m_cpuSteering;                           ///< 是否开启CPU亲和分流。
+
+        std::function<void(ConnectionPtr)> m_newConnCb;                         ///< 回调上层业务类的handleNewConn()。
+        std::function<void(ConnectionPtr)> m_closeCb;                           ///< 回调上层业务类的handleClose()。
+        std::function<void(ConnectionPtr)> m_errorCb;                           ///< 回调上层业务类的handleError()。
+        std::function<void(ConnectionPtr, std::string& message)> m_onMessageCb; ///< 回调上层业务类的handleMessage()。
+        std::function<void(ConnectionPtr)> m_sendCompleteCb;                    ///< 回调上层业务类的handleSendComplete()。
+        std::function<void(EventLoop*)> m_timeoutCb;                            ///< 回调上层业务类的handleTimeOut()。
+        std::function<void(int)> m_timerTimeoutCb;                              ///< 回调上层业务类的handleTimerTimeOut()。
+
+        /**
+         * @brief 给REUSEPORT监听组挂载按CPU选择分片的BPF程序
+         * @return true-成功，false-失败（内核不支持时连接仍按哈希分配）
+         */
+        bool attachCpuSteering()
+        {
+            struct sock_filter code[] = {
+                {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<__u32>(SKF_AD_OFF + SKF_AD_CPU)}, // A = 当前CPU
+                {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<__u32>(m_shards.size())},      // A %= 分片数
+                {BPF_RET | BPF_A, 0, 0, 0},                                                   // 返回组内第A个socket
+            };
+            struct sock_fprog prog = {static_cast<unsigned short>(sizeof(code) / sizeof(code[0])), code};
+            return setsockopt(m_shards[0]->m_listenFd->getFd(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == 0;
+        }
+
+        /**
+         * @brief 处理监听socket的可读事件：accept到EAGAIN为止
+         * @note 直接调用accept4而不是SocketFd::accept()：后者失败时也会用未填充的地址调用InetAddr::setAddr()并抛出异常，
+         *       只适合Acceptor每次事件accept一个连接的用法
+         */
+        void acceptAll(Shard* shard)
+        {
+            while (true)
+            {
+                sockaddr_storage ss;
+                socklen_t len = sizeof(ss);
+                int fd = ::accept4(shard->m_listenFd->getFd(), reinterpret_cast<sockaddr*>(&ss), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                {
+                    if (errno == EINTR || errno == ECONNABORTED) continue;
+                    break; // EAGAIN：已取完；EMFILE等：等下次可读事件再试
+                }
+
+                SocketFdPtr cliFd(new SocketFd(fd));
+                cliFd->setAddr(InetAddr(reinterpret_cast<sockaddr*>(&ss), len));
+                newConn(shard, std::move(cliFd));
+            }
+        }
+
+        // 处理新客户端连接：在accept它的分片上创建Connection。
+        void newConn(Shard* shard, SocketFdPtr cliFd)
+        {
+            ConnectionPtr conn(new Connection(shard->m_loop.get(), std::move(cliFd)));
+            conn->setCloseCb([this, shard](ConnectionPtr c)
+                             { closeConn(shard, c, m_closeCb); });
+            conn->setErrorCb([this, shard](ConnectionPtr c)
+                             { closeConn(shard, c, m_errorCb); });
+            conn->setOnMessageCb([this](ConnectionPtr c, std::string& message)
+                                 { if (m_onMessageCb) m_onMessageCb(c, message); });
+            conn->setSendCompleteCb([this](ConnectionPtr c)
+                                    { if (m_sendCompleteCb) m_sendCompleteCb(c); });
+
+            {
+                std::lock_guard<std::mutex> lock(shard->m_connsMutex);
+                shard->m_conns[conn->getFd()] = conn;
+            }
+            shard->m_loop->newConn(conn);
+            shard->m_accepted.fetch_add(1, std::memory_order_relaxed);
+
+            if (m_newConnCb) m_newConnCb(conn);
+        }
+
+        // 关闭或出错的连接：回调上层后从事件循环和分片连接表中删除。
+        void closeConn(Shard* shard, ConnectionPtr conn, const std::function<void(ConnectionPtr)>& cb)
+        {
+            if (cb) cb(conn);
+            shard->m_loop->closeConn(conn);
+            std::lock_guard<std::mutex> lock(shard->m_connsMutex);
+            shard->m_conns.erase(conn->getFd());
+        }
+
+        // 空闲超时的连接，由分片事件循环的定时器回调。
+        void removeConn(Shard* shard, int fd)
+        {
+            {
+                std::lock_guard<std::mutex> lock(shard->m_connsMutex);
+                shard->m_conns.erase(fd);
+            }
+            if (m_timerTimeoutCb) m_timerTimeoutCb(fd);
+        }
+
+        // 把当前线程绑定到CPU。
+        static void pinToCpu(size_t cpu)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu % CPU_SETSIZE, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+
+    public:
+        /**
+         * @brief 构造函数：创建分片、事件循环和监听socket
+         * @param ip 监听的IP地址
+         * @param port 监听的端口
+         * @param threadNum IO线程（分片）数，0表示CPU核数
+         * @param maxEvents 每个事件循环epoll_wait()一次最多返回的事件数
+         * @param epWaitTimeout epoll_wait()的超时时间（毫秒）
+         * @param timerTimetvl 空闲连接检查的闹钟间隔（秒）
+         * @param timerTimeout 连接空闲超时时间（秒）
+         * @param cpuSteering 是否开启CPU亲和分流（IO线程i绑定到CPU i，BPF按处理SYN的CPU选择分片）
+         * @note 地址无效、绑定或监听失败时与Acceptor一致（SocketFd中输出错误并退出）
+         */
+        ShardedTcpServer(const std::string& ip, const uint16_t port, size_t threadNum = 0, size_t maxEvents = 100,
+                         int epWaitTimeout = 10000, int timerTimetvl = 30, int timerTimeout = 80, bool cpuSteering = false)
+            : m_epWaitTimeout(epWaitTimeout), m_cpuSteering(cpuSteering)
+        {
+            if (threadNum == 0) threadNum = std::thread::hardware_concurrency();
+            if (threadNum == 0) threadNum = 1;
+
+            InetAddr servAddr(ip, port);
+            for (size_t ii = 0; ii < threadNum; ++ii)
+            {
+                std::unique_ptr<Shard> shard(new Shard);
+                Shard* sp = shard.get();
+                shard->m_loop.reset(new EventLoop(false, maxEvents, timerTimetvl, timerTimeout));
+                shard->m_loop->setEpollTimeoutCb([this](EventLoop* loop)
+                                                 { if (m_timeoutCb) m_timeoutCb(loop); });
+                shard->m_loop->setRemoveTimeoutConnCb([this, sp](int fd)
+                                                      { removeConn(sp, fd); });
+
+                // 同一组内的socket按绑定顺序编号，BPF返回的下标即分片号。
+                shard->m_listenFd.reset(new SocketFd(createFdNonblocking()));
+                shard->m_listenFd->setKeepalive(true);
+                shard->m_listenFd->setReuseaddr(true);
+                shard->m_listenFd->setReuseport(true);
+                shard->m_listenFd->setTcpnodelay(true);
+                shard->m_listenFd->bind(servAddr);
+                shard->m_listenFd->listen(1024);
+
+                shard->m_acceptChnl.reset(new Channel(shard->m_loop.get(), shard->m_listenFd->getFd()));
+                shard->m_acceptChnl->setReadCb([this, sp]()
+                                               { acceptAll(sp); });
+                shard->m_acceptChnl->enableReading();
+
+                m_shards.emplace_back(std::move(shard));
+            }
+
+            if (m_cpuSteering && m_shards.size() > 1 && !attachCpuSteering())
+                m_cpuSteering = false;
+        }
+
+        ~ShardedTcpServer()
+        {
+            stop();
+        }
+
+        // 运行全部分片的事件循环（分片0在当前线程中运行，直到stop()）。
+        void start()
+        {
+            size_t cpuNum = std::thread::hardware_concurrency();
+            if (cpuNum == 0) cpuNum = 1;
+            for (size_t ii = 1; ii < m_shards.size(); ++ii)
+            {
+                Shard* sp = m_shards[ii].get();
+                sp->m_thread = std::thread([this, sp, cpu = ii % cpuNum]()
+                                           {
+                                               if (m_cpuSteering) pinToCpu(cpu);
+                                               sp->m_loop->run(m_epWaitTimeout); });
+            }
+            if (m_cpuSteering) pinToCpu(0);
+            m_shards[0]->m_loop->run(m_epWaitTimeout);
+        }
+
+        // 停止全部分片的事件循环并等待IO线程退出（可在任意线程中调用）。
+        void stop()
+        {
+            for (auto& shard : m_shards) shard->m_loop->stop();
+            for (auto& shard : m_shards)
+            {
+                if (shard->m_thread.joinable() && shard->m_thread.get_id() != std::this_thread::get_id())
+                    shard->m_thread.join();
+            }
+        }
+
+        // 分片数。
+        inline size_t getShardNum() const { return m_shards.size(); }
+
+        // 分片累计accept的连接数（观察内核分配是否均衡）。
+        inline size_t getAcceptedNum(size_t shard) const
+        {
+            return shard < m_shards.size() ? m_shards[shard]->m_accepted.load(std::memory_order_relaxed) : 0;
+        }
+
+        // 当前连接总数。
+        size_t getConnNum() const
+        {
+            size_t total = 0;
+            for (auto& shard : m_shards)
+            {
+                std::lock_guard<std::mutex> lock(shard->m_connsMutex);
+                total += shard->m_conns.size();
+            }
+            return total;
+        }
+
+        // 是否已开启CPU亲和分流（内核不支持BPF分流时为false）。
+        inline bool isCpuSteering() const { return m_cpuSteering; }
+
+        void setNewConnCb(std::function<void(ConnectionPtr)> func) { m_newConnCb = std::move(func); }
+        void setCloseCb(std::function<void(ConnectionPtr)> func) { m_closeCb = std::move(func); }
+        void setErrorCb(std::function<void(ConnectionPtr)> func) { m_errorCb = std::move(func); }
+        void setOnMessageCb(std::function<void(ConnectionPtr, std::string& message)> func) { m_onMessageCb = std::move(func); }
+        void setSendCompleteCb(std::function<void(ConnectionPtr)> func) { m_sendCompleteCb = std::move(func); }
+        void setTimeoutCb(std::function<void(EventLoop*)> func) { m_timeoutCb = std::move(func); }
+        void setTimerTimeoutCb(std::function<void(int)> func) { m_timerTimeoutCb = std::move(func); }
+    };
+#endif // __linux__
+
+} // namespace ol
+
+#endif // !OL_SHARDEDTCPSERVER_H
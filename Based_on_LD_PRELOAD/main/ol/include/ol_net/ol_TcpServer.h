@@ -18,6 +18,10 @@ namespace ol
 #ifdef __linux__
     class TcpServer
     {
+    public:
+        using ConnPtr = ConnectionPtr; ///< 连接类型（与UringTcpServer::ConnPtr对应，便于业务类按服务器类型写成模板）。
+        using LoopType = EventLoop;    ///< 事件循环类型。
+
     private:
         EventLoopPtr m_mainEventLoop;                   ///< 主事件循环。
         std::vector<EventLoopPtr> m_subEventLoops;      ///< 存放从事件循环的容器。
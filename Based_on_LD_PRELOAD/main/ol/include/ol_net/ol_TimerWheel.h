@@ -0,0 +1,390 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_TimerWheel.h
+ * 功能描述：分层时间轮定时器，用于连接空闲超时和一般的单次/周期定时任务，支持以下特性：
+ *          - 4层、每层64个槽位，每个槽位是一个双向链表；定时器放在"到期时间所在的最粗粒度层"，
+ *            低层转完一圈时把上一层对应槽位的定时器下放（cascade），添加、取消和到期都是O(1)
+ *          - refresh（活动时推迟到期时间）是惰性的：只改到期时间，定时器在原槽位到期时再按新时间重新放置，
+ *            每次收到数据只需一次赋值
+ *          - 每层有64位占用位图：nextTimeoutMs()用ctz在O(层数)内算出下一次必须处理的时间，
+ *            advance()直接跳过空槽；没有定时器时返回-1，可以关闭timerfd，空闲时不产生任何唤醒
+ *          - 与timerfd配合：每次advance()之后调用armTimerFd(fd, nextTimeoutMs())重新设置单次闹钟
+ *          - 非线程安全：由所属事件循环的线程独占使用（跨线程添加请经EventLoop::pushToQueue转发）
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_TIMERWHEEL_H
+#define OL_TIMERWHEEL_H 1
+
+#include "ol_type_traits.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif // __linux__
+
+namespace ol
+{
+
+#ifdef __linux__
+    class TimerWheel : public TypeNonCopyableMovable
+    {
+    public:
+        using TimerId = uint64_t;           ///< 定时器编号（0表示无效）
+        using Callback = std::function<void()>; ///< 到期回调
+
+    private:
+        static constexpr int LEVELS = 4;                                 ///< 层数
+        static constexpr int SLOT_BITS = 6;                              ///< 每层槽位数的位数
+        static constexpr uint64_t SLOTS = 1ull << SLOT_BITS;             ///< 每层槽位数
+        static constexpr uint64_t SLOT_MASK = SLOTS - 1;                 ///< 槽位掩码
+        static constexpr uint64_t MAX_SPAN = 1ull << (SLOT_BITS * LEVELS); ///< 时间轮能直接表示的最大间隔（滴答）
+        static constexpr uint32_t NIL = UINT32_MAX;                      ///< 空链表下标
+
+        // 定时器节点
+        struct Node
+        {
+            uint64_t expire = 0;   ///< 到期时间（滴答，惰性refresh只改这里）
+            uint64_t interval = 0; ///< 周期（滴答，0表示单次）
+            Callback cb;           ///< 回调函数
+            uint32_t prev = NIL;   ///< 槽位链表的前一个节点
+            uint32_t next = NIL;   ///< 槽位链表的后一个节点（空闲时为空闲链表的下一个节点）
+            uint32_t gen = 1;      ///< 代数（节点回收后加1，使旧的TimerId失效）
+            uint16_t slot = 0;     ///< 所在槽位（层 * SLOTS + 槽号）
+            uint8_t state = 0;     ///< 0-空闲，1-在槽位中，2-正在执行回调，3-回调中被取消
+        };
+
+        std::chrono::steady_clock::time_point m_origin; ///< 滴答0对应的时间
+        std::chrono::nanoseconds m_tick;                ///< 每个滴答的时长
+        uint64_t m_now = 0;                             ///< 当前滴答
+        std::vector<Node> m_nodes;                      ///< 节点池
+        uint32_t m_freeHead = NIL;                      ///< 空闲节点链表
+        size_t m_count = 0;                             ///< 活动定时器个数
+        uint32_t m_heads[LEVELS * SLOTS];               ///< 各槽位链表头
+        uint64_t m_bitmap[LEVELS] = {};                 ///< 各层槽位占用位图
+
+        static TimerId makeId(uint32_t index, uint32_t gen) { return (static_cast<uint64_t>(gen) << 32) | index; }
+
+        // 由TimerId找到活动节点的下标，无效时返回NIL
+        uint32_t lookup(TimerId id) const
+        {
+            uint32_t index = static_cast<uint32_t>(id);
+            if (index >= m_nodes.size()) return NIL;
+            const Node& n = m_nodes[index];
+            if (n.gen != static_cast<uint32_t>(id >> 32) || n.state == 0 || n.state == 3) return NIL;
+            return index;
+        }
+
+        /**
+         * @brief 把节点按到期时间放进对应的层和槽位
+         * @param index 节点下标
+         * @param cascading 是否为下放：下放发生在处理第0层当前槽位之前，正好本滴答到期的可以放进当前槽位；
+         *                  其它情况（添加、回调中重新放置）至少放到下一个滴答，避免在fireSlot中反复处理
+         */
+        void link(uint32_t index, bool cascading = false)
+        {
+            Node& n = m_nodes[index];
+            uint64_t expire = (n.expire > m_now || (cascading && n.expire == m_now)) ? n.expire : m_now + 1;
+            if (expire - m_now >= MAX_SPAN) expire = m_now + MAX_SPAN - 1; // 超出范围先放在最高层，下放时再重新计算
+
+            uint64_t delta = expire - m_now;
+            int level = 0;
+            while (level < LEVELS - 1 && delta >= (1ull << (SLOT_BITS * (level + 1)))) ++level;
+            uint16_t slot = static_cast<uint16_t>(level * SLOTS + ((expire >> (SLOT_BITS * level)) & SLOT_MASK));
+
+            n.slot = slot;
+            n.state = 1;
+            n.prev = NIL;
+            n.next = m_heads[slot];
+            if (n.next != NIL) m_nodes[n.next].prev = index;
+            m_heads[slot] = index;
+            m_bitmap[level] |= 1ull << (slot & SLOT_MASK);
+        }
+
+        // 把节点从所在槽位摘下
+        void unlink(uint32_t index)
+        {
+            Node& n = m_nodes[index];
+            if (n.prev != NIL)
+                m_nodes[n.prev].next = n.next;
+            else
+                m_heads[n.slot] = n.next;
+            if (n.next != NIL) m_nodes[n.next].prev = n.prev;
+            if (m_heads[n.slot] == NIL) m_bitmap[n.slot / SLOTS] &= ~(1ull << (n.slot & SLOT_MASK));
+        }
+
+        // 回收节点
+        void release(uint32_t index)
+        {
+            Node& n = m_nodes[index];
+            n.cb = nullptr;
+            n.state = 0;
+            ++n.gen;
+            if (n.gen == 0) n.gen = 1;
+            n.next = m_freeHead;
+            m_freeHead = index;
+            --m_count;
+        }
+
+        // 摘下整个槽位，返回链表头
+        uint32_t detachSlot(uint16_t slot)
+        {
+            uint32_t head = m_heads[slot];
+            m_heads[slot] = NIL;
+            m_bitmap[slot / SLOTS] &= ~(1ull << (slot & SLOT_MASK));
+            return head;
+        }
+
+        // 把第level层当前槽位的定时器下放到更低的层
+        void cascade(int level)
+        {
+            uint16_t slot = static_cast<uint16_t>(level * SLOTS + ((m_now >> (SLOT_BITS * level)) & SLOT_MASK));
+            for (uint32_t index = detachSlot(slot); index != NIL;)
+            {
+                uint32_t next = m_nodes[index].next;
+                link(index, true);
+                index = next;
+            }
+        }
+
+        // 处理第0层当前槽位：到期的执行回调，惰性推迟过的重新放置
+        size_t fireSlot()
+        {
+            // 每次从槽位头部取一个节点（而不是整个摘下），回调中取消同一槽位的其它定时器也是安全的；
+            // 重新放置的节点到期时间都大于m_now，不会回到这个槽位
+            size_t fired = 0;
+            const uint16_t slot = static_cast<uint16_t>(m_now & SLOT_MASK);
+            uint32_t index;
+            while ((index = m_heads[slot]) != NIL)
+            {
+                unlink(index);
+                if (m_nodes[index].expire > m_now)
+                {
+                    link(index);
+                    continue;
+                }
+
+                // 回调可能添加/取消定时器（m_nodes可能扩容），所以回调前后都通过下标访问
+                m_nodes[index].state = 2;
+                Callback cb = std::move(m_nodes[index].cb);
+                cb();
+                ++fired;
+
+                Node& n = m_nodes[index];
+                if (n.state == 2 && n.interval > 0)
+                {
+                    n.cb = std::move(cb);
+                    n.expire += n.interval;
+                    if (n.expire <= m_now) n.expire = m_now + n.interval; // 落后太多时不补发
+                    link(index);
+                }
+                else if (n.state == 2 && n.expire > m_now)
+                {
+                    // 回调中refresh了自己：按新时间继续
+                    n.cb = std::move(cb);
+                    link(index);
+                }
+                else
+                {
+                    release(index);
+                }
+            }
+            return fired;
+        }
+
+        // 从当前滴答之后，下一个必须处理（到期或下放）的滴答
+        uint64_t nextEventTick() const
+        {
+            uint64_t best = UINT64_MAX;
+            for (int level = 0; level < LEVELS; ++level)
+            {
+                if (m_bitmap[level] == 0) continue;
+                int shift = SLOT_BITS * level;
+                uint64_t cur = m_now >> shift;
+                uint64_t rot = (cur + 1) & SLOT_MASK;
+                uint64_t bits = (m_bitmap[level] >> rot) | (rot ? (m_bitmap[level] << (SLOTS - rot)) : 0);
+                uint64_t tick = (cur + 1 + static_cast<uint64_t>(__builtin_ctzll(bits))) << shift;
+                if (tick < best) best = tick;
+            }
+            return best;
+        }
+
+        uint64_t toTicks(std::chrono::nanoseconds d) const
+        {
+            if (d.count() <= 0) return 0;
+            return static_cast<uint64_t>((d.count() + m_tick.count() - 1) / m_tick.count()); // 向上取整，不提前到期
+        }
+
+        uint64_t tickOf(std::chrono::steady_clock::time_point tp) const
+        {
+            return tp <= m_origin ? 0 : static_cast<uint64_t>((tp - m_origin) / m_tick);
+        }
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param tick 时间轮精度（每个滴答的时长，默认10毫秒）
+         * @note 4层 * 64槽位可以直接表示64^4个滴答（10毫秒精度约46小时），更长的定时器到最高层后分段下放
+         */
+        explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(10))
+            : m_origin(std::chrono::steady_clock::now()), m_tick(tick.count() > 0 ? tick : std::chrono::milliseconds(1))
+        {
+            for (auto& head : m_heads) head = NIL;
+        }
+
+        /**
+         * @brief 添加定时器
+         * @param delay 多久之后到期
+         * @param cb 到期回调（在advance()中调用，回调中可以添加、取消、refresh任何定时器）
+         * @param interval 周期（默认0表示单次定时器）
+         * @return 定时器编号
+         */
+        TimerId addTimer(std::chrono::milliseconds delay, Callback cb, std::chrono::milliseconds interval = std::chrono::milliseconds(0))
+        {
+            uint32_t index;
+            if (m_freeHead != NIL)
+            {
+                index = m_freeHead;
+                m_freeHead = m_nodes[index].next;
+            }
+            else
+            {
+                index = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
+            }
+
+            Node& n = m_nodes[index];
+            n.expire = m_now + toTicks(delay);
+            uint64_t iv = toTicks(interval);
+            n.interval = (interval.count() > 0 && iv == 0) ? 1 : iv;
+            n.cb = std::move(cb);
+            ++m_count;
+            link(index);
+            return makeId(index, n.gen);
+        }
+
+        /**
+         * @brief 取消定时器
+         * @param id 定时器编号
+         * @return true-成功，false-定时器不存在（已到期或已取消）
+         * @note 在定时器自己的回调中取消也可以（周期定时器不再继续）
+         */
+        bool cancel(TimerId id)
+        {
+            uint32_t index = lookup(id);
+            if (index == NIL) return false;
+
+            Node& n = m_nodes[index];
+            if (n.state == 2)
+            {
+                n.state = 3; // 正在执行回调，由fireSlot回收
+                return true;
+            }
+            unlink(index);
+            release(index);
+            return true;
+        }
+
+        /**
+         * @brief 推迟或提前定时器的到期时间（连接有活动时调用）
+         * @param id 定时器编号
+         * @param delay 从现在起多久之后到期
+         * @return true-成功，false-定时器不存在
+         * @note 推迟（最常见的情况）只改到期时间，定时器在原槽位到期时再重新放置；提前才需要移动槽位
+         */
+        bool refresh(TimerId id, std::chrono::milliseconds delay)
+        {
+            uint32_t index = lookup(id);
+            if (index == NIL) return false;
+
+            Node& n = m_nodes[index];
+            uint64_t expire = m_now + toTicks(delay);
+            if (n.state == 1 && expire < n.expire)
+            {
+                unlink(index);
+                n.expire = expire;
+                link(index);
+            }
+            else
+            {
+                n.expire = expire;
+            }
+            return true;
+        }
+
+        /**
+         * @brief 推进时间轮到指定时间，执行所有到期的定时器
+         * @param now 当前时间（默认取steady_clock::now()）
+         * @return 执行的回调个数
+         * @note 只访问有定时器的槽位和需要下放的槽位，空槽直接跳过
+         */
+        size_t advance(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now())
+        {
+            uint64_t target = tickOf(now);
+            size_t fired = 0;
+            while (m_now < target)
+            {
+                uint64_t next = (m_count > 0) ? nextEventTick() : UINT64_MAX;
+                if (next > target)
+                {
+                    m_now = target;
+                    break;
+                }
+
+                m_now = next;
+                for (int level = LEVELS - 1; level > 0; --level)
+                {
+                    if ((m_now & ((1ull << (SLOT_BITS * level)) - 1)) == 0) cascade(level);
+                }
+                fired += fireSlot();
+            }
+            return fired;
+        }
+
+        /**
+         * @brief 距离下一次必须调用advance()的时间
+         * @return 毫秒数（向上取整，至少为1）；没有定时器时返回-1
+         * @note 返回的时间可能是一次下放而不是到期，到时调用advance()即可
+         */
+        int64_t nextTimeoutMs() const
+        {
+            if (m_count == 0) return -1;
+            uint64_t next = nextEventTick();
+            auto at = m_origin + m_tick * static_cast<int64_t>(next);
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(at - std::chrono::steady_clock::now()).count();
+            return ns <= 0 ? 1 : (ns + 999999) / 1000000;
+        }
+
+        // 活动定时器个数
+        inline size_t size() const { return m_count; }
+
+        inline bool empty() const { return m_count == 0; }
+
+        /**
+         * @brief 把timerfd设置为单次闹钟
+         * @param fd timerfd_create()创建的fd
+         * @param delayMs 多少毫秒后响（小于0表示关闭闹钟）
+         * @return true-成功，false-失败
+         */
+        static bool armTimerFd(int fd, int64_t delayMs)
+        {
+            struct itimerspec ts = {};
+            if (delayMs >= 0)
+            {
+                if (delayMs == 0) delayMs = 1;
+                ts.it_value.tv_sec = delayMs / 1000;
+                ts.it_value.tv_nsec = (delayMs % 1000) * 1000000;
+            }
+            return timerfd_settime(fd, 0, &ts, nullptr) == 0;
+        }
+    };
+#endif // __linux__
+
+} // namespace ol
+
+#endif // !OL_TIMERWHEEL_H
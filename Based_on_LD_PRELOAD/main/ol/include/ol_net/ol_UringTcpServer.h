@@ -0,0 +1,754 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_UringTcpServer.h
+ * 功能描述：基于io_uring的TCP服务器，回调接口与TcpServer一致，支持以下特性：
+ *          - 每个IO线程一个io_uring环和一个SO_REUSEPORT监听socket，连接在哪个线程accept就在哪个线程处理
+ *          - 多发accept：一次提交持续接收新连接，不需要每个连接一次accept系统调用
+ *          - 多发recv + 提供缓冲区环：内核收包时自行挑选缓冲区，不需要每次可读事件一次read系统调用
+ *          - 发送：同一轮事件中产生的报文合并后用IOSQE_IO_LINK串成有序的发送链，不需要每次send一次系统调用
+ *          - 批量提交：一轮事件循环中的全部SQE与等待合并为一次io_uring_enter
+ *          - 报文格式与Connection一致（四字节报头，主机字节序），报文回调在IO线程中直接执行
+ *          - 空闲超时：每个连接一个时间轮定时器，收到报文时惰性推迟，到期即删除，不再定期遍历全部连接
+ *          - 需要Linux 6.0及以上内核，isSupported()在运行时探测，不支持时使用TcpServer
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_URINGTCPSERVER_H
+#define OL_URINGTCPSERVER_H 1
+
+#include "ol_taskqueue.h"
+#include "ol_net/ol_ChainBuffer.h"
+#include "ol_net/ol_InetAddr.h"
+#include "ol_net/ol_IoUring.h"
+#include "ol_net/ol_SocketFd.h"
+#include "ol_net/ol_TimerWheel.h"
+#include "ol_net/ol_net_fwd_decls.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <time.h>
+#include <unordered_map>
+#include <vector>
+
+#ifdef OL_HAS_IO_URING
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#endif // OL_HAS_IO_URING
+
+namespace ol
+{
+
+#ifdef OL_HAS_IO_URING
+    class UringEventLoop;
+
+    // io_uring连接
+    // ===========================================================================
+    /**
+     * @brief io_uring服务器上的一个TCP连接，接口与Connection一致
+     * @note 全部I/O由所属UringEventLoop完成，本类只保存连接状态；send()可在任意线程中调用
+     */
+    class UringConnection : public std::enable_shared_from_this<UringConnection>
+    {
+        friend class UringEventLoop;
+
+    public:
+        using Ptr = std::shared_ptr<UringConnection>;
+
+    private:
+        UringEventLoop* m_loop;              ///< 所属事件循环。
+        int m_fd;                            ///< 与客户端通讯的fd（所有请求结束后才关闭，fd不会在请求进行中被复用）。
+        ChainBuffer m_inputBuf;              ///< 接收缓冲区（四字节报头拆包）。
+        std::vector<std::string> m_pending;  ///< 待发送的数据块（同一轮事件中的报文合并到块中）。
+        std::vector<std::string> m_sending;  ///< 发送链中的数据块（全部完成前不修改，内核直接读取）。
+        size_t m_sendInflight = 0;           ///< 发送链中未完成的send个数。
+        bool m_recvArmed = false;            ///< 多发recv是否仍在进行。
+        bool m_dirty = false;                ///< 是否已在事件循环的待发送列表中。
+        bool m_closed = false;               ///< 是否已关闭（事件循环线程访问）。
+        std::atomic_bool m_disconnected;     ///< 客户端连接是否已断开（任意线程访问）。
+        time_t m_lastATime;                  ///< 最后一次收到报文的时间。
+        TimerWheel::TimerId m_idleTimer = 0; ///< 空闲超时定时器（0表示未设置）。
+        mutable std::once_flag m_addrOnce;   ///< 对端地址只在第一次查询时获取。
+        mutable std::string m_ip;            ///< 对端ip。
+        mutable uint16_t m_port = 0;         ///< 对端端口。
+
+        static constexpr size_t SEND_CHUNK = 65536; ///< 小报文合并成块的上限。
+
+        // 取对端地址（多发accept不返回每个连接的地址，第一次查询时调用getpeername）。
+        void loadAddr() const
+        {
+            std::call_once(m_addrOnce, [this]()
+                           {
+                               sockaddr_storage ss;
+                               socklen_t len = sizeof(ss);
+                               if (getpeername(m_fd, reinterpret_cast<sockaddr*>(&ss), &len) != 0) return;
+                               char buf[INET6_ADDRSTRLEN] = {0};
+                               if (ss.ss_family == AF_INET)
+                               {
+                                   auto* in = reinterpret_cast<sockaddr_in*>(&ss);
+                                   inet_ntop(AF_INET, &in->sin_addr, buf, sizeof(buf));
+                                   m_port = ntohs(in->sin_port);
+                               }
+                               else if (ss.ss_family == AF_INET6)
+                               {
+                                   auto* in6 = reinterpret_cast<sockaddr_in6*>(&ss);
+                                   inet_ntop(AF_INET6, &in6->sin6_addr, buf, sizeof(buf));
+                                   m_port = ntohs(in6->sin6_port);
+                               }
+                               m_ip = buf; });
+        }
+
+        // 在事件循环线程中把报文加上报头放入待发送块。
+        void appendInLoop(const char* data, size_t size);
+
+    public:
+        UringConnection(UringEventLoop* loop, int fd, time_t now)
+            : m_loop(loop), m_fd(fd), m_inputBuf(1), m_disconnected(false), m_lastATime(now)
+        {
+        }
+
+        int getFd() const { return m_fd; }
+
+        // 所属事件循环（OrderedOffload用它把回复按事件循环分组送回）。
+        UringEventLoop* getLoop() const { return m_loop; }
+
+        const char* getIp() const
+        {
+            loadAddr();
+            return m_ip.c_str();
+        }
+
+        uint16_t getPort() const
+        {
+            loadAddr();
+            return m_port;
+        }
+
+        // 连接是否已断开。
+        bool isDisconnected() const { return m_disconnected.load(std::memory_order_acquire); }
+
+        // 发送数据（加四字节报头），不管在任何线程中，都是调用此函数发送数据。
+        void send(const char* data, size_t size);
+
+        // 判断TCP连接是否超时（空闲太久）。
+        bool timeout(time_t now, int val) const { return now - m_lastATime >= val; }
+    };
+
+    // io_uring事件循环
+    // ===========================================================================
+    class UringEventLoop
+    {
+        friend class UringConnection;
+
+    private:
+        // user_data的低8位是操作类型，高位是fd
+        enum : uint64_t
+        {
+            OP_ACCEPT = 1,
+            OP_RECV = 2,
+            OP_SEND = 3,
+            OP_WAKE = 4,
+            OP_CANCEL = 5,
+        };
+
+        static inline uint64_t makeData(int fd, uint64_t op) { return (static_cast<uint64_t>(static_cast<uint32_t>(fd)) << 8) | op; }
+
+        int m_listenFd;                  ///< 监听socket（由UringTcpServer持有）。
+        unsigned m_ringEntries;          ///< SQ大小。
+        unsigned m_bufNum;               ///< 提供缓冲区个数。
+        size_t m_bufSize;                ///< 每个提供缓冲区的大小。
+        int m_timeout;                   ///< 连接空闲超时时间（秒，小于等于0表示不超时）。
+        std::unique_ptr<IoUring> m_ring; ///< io_uring环（在run()中创建，只在事件循环线程中提交）。
+        std::unique_ptr<IoUringBufRing> m_bufRing; ///< 提供缓冲区环。
+        std::atomic_bool m_stop;         ///< 如果设置为true，表示停止事件循环。
+        std::atomic<pid_t> m_threadId;   ///< 事件循环所在线程的id（run()之前为0）。
+        size_t m_inflight = 0;           ///< 尚未结束的请求数（多发请求在最后一个CQE时结束）。
+        time_t m_now;                    ///< 本轮事件循环的时间（秒）。
+        TimerWheel m_wheel;              ///< 空闲超时时间轮（精度1秒，只在事件循环线程中访问）。
+
+        TaskQueue m_taskQueue;                         ///< 事件循环线程被eventfd唤醒后执行的任务队列（无锁，合并唤醒）。
+        int m_wakeUpFd;                                ///< 用于唤醒事件循环线程的eventfd。
+        uint64_t m_wakeUpBuf = 0;                      ///< eventfd读缓冲区（读请求进行中由内核写入）。
+
+        mutable std::mutex m_connsMutex;                      ///< 保护m_conns的互斥锁（只在增删和跨线程查询时加锁）。
+        std::unordered_map<int, UringConnectionPtr> m_conns;  ///< 运行在该事件循环上的连接（关闭后等请求结束才删除）。
+        std::vector<UringConnectionPtr> m_dirtyConns;         ///< 本轮有数据待发送的连接。
+
+        std::atomic<size_t> m_syscalls{0}; ///< 累计io_uring_enter次数。
+        std::atomic<size_t> m_messages{0}; ///< 累计收到的报文数。
+
+        std::function<void(UringConnectionPtr)> m_newConnCb;                         ///< 新连接的回调函数。
+        std::function<void(UringConnectionPtr)> m_closeCb;                           ///< 连接关闭的回调函数。
+        std::function<void(UringConnectionPtr)> m_errorCb;                           ///< 连接错误的回调函数。
+        std::function<void(UringConnectionPtr, std::string& message)> m_onMessageCb; ///< 处理报文的回调函数。
+        std::function<void(UringConnectionPtr)> m_sendCompleteCb;                    ///< 发送完成的回调函数。
+        std::function<void(UringEventLoop*)> m_timeoutCb;                            ///< 等待超时（一段时间没有事件）的回调函数。
+        std::function<void(int)> m_timerTimeoutCb;                                   ///< 空闲连接被删除的回调函数。
+
+        friend class UringTcpServer;
+
+        void armAccept()
+        {
+            IoUring::prepAcceptMultishot(m_ring->getSqe(), m_listenFd, makeData(0, OP_ACCEPT));
+            ++m_inflight;
+        }
+
+        void armWakeUp()
+        {
+            IoUring::prepRead(m_ring->getSqe(), m_wakeUpFd, &m_wakeUpBuf, sizeof(m_wakeUpBuf), makeData(0, OP_WAKE));
+            ++m_inflight;
+        }
+
+        void armRecv(UringConnection* conn)
+        {
+            IoUring::prepRecvMultishot(m_ring->getSqe(), conn->m_fd, m_bufRing->getBgid(), makeData(conn->m_fd, OP_RECV));
+            conn->m_recvArmed = true;
+            ++m_inflight;
+        }
+
+        UringConnectionPtr findConn(int fd)
+        {
+            auto it = m_conns.find(fd);
+            return it == m_conns.end() ? nullptr : it->second;
+        }
+
+        // 处理新连接。
+        void onAccept(int fd)
+        {
+            if (m_stop)
+            {
+                ::close(fd);
+                return;
+            }
+            UringConnectionPtr conn(new UringConnection(this, fd, m_now));
+            {
+                std::lock_guard<std::mutex> lock(m_connsMutex);
+                m_conns[fd] = conn;
+            }
+            if (m_timeout > 0)
+                conn->m_idleTimer = m_wheel.addTimer(std::chrono::seconds(m_timeout), [this, fd]()
+                                                     { onIdle(fd); });
+            armRecv(conn.get());
+            if (m_newConnCb) m_newConnCb(conn);
+        }
+
+        // 处理收到的数据：拆出完整报文逐个回调。
+        void onData(const UringConnectionPtr& conn, const char* data, size_t size)
+        {
+            conn->m_inputBuf.append(data, size);
+            std::string_view frame;
+            bool active = false;
+            while (!conn->m_closed && conn->m_inputBuf.pickMessage(frame))
+            {
+                active = true;
+                m_messages.fetch_add(1, std::memory_order_relaxed);
+                std::string message(frame.data(), frame.size());
+                if (m_onMessageCb) m_onMessageCb(conn, message);
+            }
+            if (active)
+            {
+                conn->m_lastATime = m_now;
+                if (conn->m_idleTimer) m_wheel.refresh(conn->m_idleTimer, std::chrono::seconds(m_timeout)); // 只改到期时间
+            }
+        }
+
+        // 空闲超时定时器到期：删除连接。
+        void onIdle(int fd)
+        {
+            UringConnectionPtr conn = findConn(fd);
+            if (!conn || conn->m_closed) return;
+            conn->m_idleTimer = 0; // 定时器到期后由时间轮回收
+            closeConn(conn, nullptr);
+            if (m_timerTimeoutCb) m_timerTimeoutCb(fd);
+        }
+
+        /**
+         * @brief 关闭连接：回调上层并取消连接上的请求
+         * @note fd在全部请求结束后才关闭（finalize），期间同一fd不会被新连接复用，CQE总能对应到正确的连接
+         */
+        void closeConn(const UringConnectionPtr& conn, const std::function<void(UringConnectionPtr)>& cb)
+        {
+            if (conn->m_closed) return;
+            conn->m_closed = true;
+            conn->m_disconnected.store(true, std::memory_order_release);
+            if (conn->m_idleTimer)
+            {
+                m_wheel.cancel(conn->m_idleTimer);
+                conn->m_idleTimer = 0;
+            }
+            if (cb) cb(conn);
+            if (conn->m_recvArmed || conn->m_sendInflight > 0)
+            {
+                IoUring::prepCancelFd(m_ring->getSqe(), conn->m_fd, makeData(conn->m_fd, OP_CANCEL));
+                ++m_inflight;
+            }
+            finalize(conn);
+        }
+
+        // 已关闭且没有进行中的请求时关闭fd并删除连接。
+        void finalize(const UringConnectionPtr& conn)
+        {
+            if (!conn->m_closed || conn->m_recvArmed || conn->m_sendInflight > 0) return;
+            ::close(conn->m_fd);
+            std::lock_guard<std::mutex> lock(m_connsMutex);
+            m_conns.erase(conn->m_fd);
+        }
+
+        void handleRecv(const io_uring_cqe& cqe, int fd)
+        {
+            UringConnectionPtr conn = findConn(fd);
+            const bool more = cqe.flags & IORING_CQE_F_MORE;
+            if (cqe.flags & IORING_CQE_F_BUFFER)
+            {
+                uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                if (conn && !conn->m_closed && cqe.res > 0)
+                    onData(conn, m_bufRing->getBuf(bid), static_cast<size_t>(cqe.res));
+                m_bufRing->add(bid);
+            }
+            if (!more) --m_inflight;
+            if (!conn) return;
+            if (!more) conn->m_recvArmed = false;
+
+            if (!conn->m_closed)
+            {
+                if (cqe.res == 0)
+                    closeConn(conn, m_closeCb);
+                else if (cqe.res < 0 && cqe.res != -ENOBUFS)
+                    closeConn(conn, m_errorCb);
+                else if (!more)
+                    armRecv(conn.get()); // 缓冲区耗尽（本轮结束时已归还）或内核结束了多发，重新提交
+            }
+            finalize(conn);
+        }
+
+        void handleSend(const io_uring_cqe& cqe, int fd)
+        {
+            --m_inflight;
+            UringConnectionPtr conn = findConn(fd);
+            if (!conn) return;
+            --conn->m_sendInflight;
+            if (cqe.res < 0 && !conn->m_closed) closeConn(conn, m_errorCb); // 链中后续的send以-ECANCELED结束
+
+            if (conn->m_sendInflight > 0) return;
+            conn->m_sending.clear();
+            if (conn->m_closed)
+                finalize(conn);
+            else if (!conn->m_pending.empty())
+                markDirty(conn);
+            else if (m_sendCompleteCb)
+                m_sendCompleteCb(conn);
+        }
+
+        void handleCqe(const io_uring_cqe& cqe)
+        {
+            const uint64_t op = cqe.user_data & 0xff;
+            const int fd = static_cast<int>(cqe.user_data >> 8);
+            switch (op)
+            {
+            case OP_ACCEPT:
+                if (!(cqe.flags & IORING_CQE_F_MORE))
+                {
+                    --m_inflight;
+                    if (!m_stop && cqe.res != -ECANCELED) armAccept();
+                }
+                if (cqe.res >= 0) onAccept(cqe.res);
+                break;
+            case OP_RECV:
+                handleRecv(cqe, fd);
+                break;
+            case OP_SEND:
+                handleSend(cqe, fd);
+                break;
+            case OP_WAKE:
+                --m_inflight;
+                handleWakeUp();
+                if (!m_stop) armWakeUp();
+                break;
+            default: // OP_CANCEL
+                --m_inflight;
+                break;
+            }
+        }
+
+        void markDirty(const UringConnectionPtr& conn)
+        {
+            if (conn->m_dirty) return;
+            conn->m_dirty = true;
+            m_dirtyConns.push_back(conn);
+        }
+
+        // 为每个有待发送数据的连接提交一条发送链（一个连接同时只有一条链，保证顺序）。
+        void flushSends()
+        {
+            for (auto& conn : m_dirtyConns)
+            {
+                conn->m_dirty = false;
+                if (conn->m_closed || conn->m_sendInflight > 0 || conn->m_pending.empty()) continue;
+
+                conn->m_sending.swap(conn->m_pending);
+                const size_t n = conn->m_sending.size();
+                for (size_t ii = 0; ii < n; ++ii)
+                {
+                    const std::string& chunk = conn->m_sending[ii];
+                    IoUring::prepSend(m_ring->getSqe(), conn->m_fd, chunk.data(), chunk.size(),
+                                      makeData(conn->m_fd, OP_SEND), ii + 1 < n);
+                }
+                conn->m_sendInflight = n;
+                m_inflight += n;
+            }
+            m_dirtyConns.clear();
+        }
+
+        // 事件循环线程被eventfd唤醒后一次执行队列中的全部任务。
+        void handleWakeUp()
+        {
+            m_taskQueue.drain();
+        }
+
+        // 事件循环退出：取消全部请求并等待结束（发送中的数据块必须在内核不再访问后才能释放）。
+        void shutdown()
+        {
+            std::vector<UringConnectionPtr> conns;
+            for (auto& it : m_conns) conns.push_back(it.second);
+            for (auto& conn : conns) closeConn(conn, nullptr);
+            IoUring::prepCancelFd(m_ring->getSqe(), m_listenFd, makeData(0, OP_CANCEL));
+            IoUring::prepCancelFd(m_ring->getSqe(), m_wakeUpFd, makeData(0, OP_CANCEL));
+            m_inflight += 2;
+
+            for (int round = 0; m_inflight > 0 && round < 100; ++round)
+            {
+                m_ring->submitAndWait(10);
+                m_ring->forEachCqe([this](const io_uring_cqe& cqe)
+                                   { handleCqe(cqe); });
+                m_bufRing->commit();
+            }
+
+            std::lock_guard<std::mutex> lock(m_connsMutex);
+            for (auto& it : m_conns) ::close(it.first);
+            m_conns.clear();
+        }
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param listenFd 监听socket
+         * @param ringEntries SQ大小
+         * @param bufNum 提供缓冲区个数（全部连接共享，用完时recv暂停，归还后自动继续）
+         * @param bufSize 每个提供缓冲区的大小
+         * @param timeout 连接空闲超时时间（秒，小于等于0表示不超时）
+         */
+        UringEventLoop(int listenFd, unsigned ringEntries, unsigned bufNum, size_t bufSize, int timeout)
+            : m_listenFd(listenFd), m_ringEntries(ringEntries), m_bufNum(bufNum), m_bufSize(bufSize),
+              m_timeout(timeout), m_stop(false), m_threadId(0), m_now(time(nullptr)), m_wheel(std::chrono::seconds(1))
+        {
+            m_wakeUpFd = eventfd(0, EFD_CLOEXEC);
+        }
+
+        ~UringEventLoop()
+        {
+            ::close(m_wakeUpFd);
+        }
+
+        /**
+         * @brief 运行事件循环（在当前线程中创建io_uring，直到stop()）
+         * @param timeout 等待超时时间（毫秒），这段时间没有任何事件时回调m_timeoutCb
+         * @throw std::runtime_error 创建io_uring或注册缓冲区失败时抛出
+         */
+        void run(int timeout = 10000)
+        {
+            using Clock = std::chrono::steady_clock;
+            m_threadId = static_cast<pid_t>(syscall(SYS_gettid));
+            m_ring.reset(new IoUring(m_ringEntries));
+            m_bufRing.reset(new IoUringBufRing(*m_ring, 0, m_bufNum, m_bufSize));
+            armAccept();
+            armWakeUp();
+
+            auto idleDeadline = Clock::now() + std::chrono::milliseconds(timeout);
+            while (!m_stop)
+            {
+                flushSends();
+
+                auto now = Clock::now();
+                long long waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(idleDeadline - now).count();
+                int64_t wheelMs = m_wheel.nextTimeoutMs(); // 没有连接时为-1，不因空闲超时唤醒
+                if (wheelMs >= 0 && wheelMs < waitMs) waitMs = wheelMs;
+                if (waitMs < 0) waitMs = 0;
+                m_ring->submitAndWait(static_cast<int>(waitMs));
+
+                m_now = time(nullptr);
+                unsigned n = m_ring->forEachCqe([this](const io_uring_cqe& cqe)
+                                                { handleCqe(cqe); });
+                m_bufRing->commit();
+                m_syscalls.store(m_ring->getEnterCalls(), std::memory_order_relaxed);
+
+                now = Clock::now();
+                if (n > 0)
+                    idleDeadline = now + std::chrono::milliseconds(timeout);
+                else if (now >= idleDeadline)
+                {
+                    if (m_timeoutCb) m_timeoutCb(this);
+                    idleDeadline = now + std::chrono::milliseconds(timeout);
+                }
+                m_wheel.advance(now); // 只处理到期的槽位，空闲连接在回调中删除
+            }
+
+            shutdown();
+            m_bufRing.reset();
+            m_ring.reset();
+        }
+
+        // 停止事件循环（可在任意线程中调用）。
+        void stop()
+        {
+            m_stop = true;
+            wakeUp();
+        }
+
+        /**
+         * @brief 把任务添加到队列中，由事件循环线程执行（任意线程）
+         * @param func 可调用对象，签名为void()
+         * @note 只有使队列由空变非空的那次入队写eventfd，事件循环取走这批任务之前的其它入队不做系统调用
+         */
+        template <typename F>
+        void pushToQueue(F&& func)
+        {
+            if (m_taskQueue.push(std::forward<F>(func))) wakeUp();
+        }
+
+        // 用eventfd唤醒事件循环线程。
+        void wakeUp()
+        {
+            uint64_t val = 1;
+            ssize_t ret = ::write(m_wakeUpFd, &val, sizeof(val));
+            (void)ret;
+        }
+
+        // 判断当前线程是否为事件循环线程。
+        inline bool isInLoopThread() const
+        {
+            return m_threadId.load(std::memory_order_relaxed) == syscall(SYS_gettid);
+        }
+
+        // 当前连接数。
+        size_t getConnNum() const
+        {
+            std::lock_guard<std::mutex> lock(m_connsMutex);
+            return m_conns.size();
+        }
+
+        // 累计io_uring_enter系统调用次数。
+        inline size_t getSyscallNum() const { return m_syscalls.load(std::memory_order_relaxed); }
+
+        // 累计收到的报文数。
+        inline size_t getMessageNum() const { return m_messages.load(std::memory_order_relaxed); }
+    };
+
+    // UringConnection中需要UringEventLoop定义的成员函数
+    // ---------------------------------------------------------------------------
+    inline void UringConnection::appendInLoop(const char* data, size_t size)
+    {
+        if (m_closed) return;
+        if (m_pending.empty() || m_pending.back().size() + size + 4 > SEND_CHUNK)
+        {
+            m_pending.emplace_back();
+            m_pending.back().reserve(size + 4 > SEND_CHUNK ? size + 4 : SEND_CHUNK);
+        }
+        uint32_t len = static_cast<uint32_t>(size);
+        m_pending.back().append(reinterpret_cast<const char*>(&len), 4);
+        m_pending.back().append(data, size);
+        m_loop->markDirty(shared_from_this());
+    }
+
+    inline void UringConnection::send(const char* data, size_t size)
+    {
+        if (isDisconnected()) return;
+        if (m_loop->isInLoopThread())
+            appendInLoop(data, size);
+        else
+        {
+            UringConnectionPtr self = shared_from_this();
+            std::string message(data, size);
+            m_loop->pushToQueue([self, message = std::move(message)]()
+                                { self->appendInLoop(message.data(), message.size()); });
+        }
+    }
+
+    // io_uring TCP服务器
+    // ===========================================================================
+    /**
+     * @brief 基于io_uring的TCP服务器，回调接口与TcpServer一致（连接类型为UringConnectionPtr）
+     * @note 在构造时选择后端：把业务类写成以服务器类型为参数的模板（使用Server::ConnPtr和Server::LoopType），
+     *       然后 UringTcpServer::isSupported() ? 使用UringTcpServer : 使用TcpServer
+     */
+    class UringTcpServer
+    {
+    public:
+        using ConnPtr = UringConnectionPtr;
+        using LoopType = UringEventLoop;
+
+    private:
+        std::vector<SocketFdPtr> m_listenFds;                   ///< 每个IO线程的监听socket（SO_REUSEPORT）。
+        std::vector<std::unique_ptr<UringEventLoop>> m_loops;   ///< 每个IO线程的事件循环。
+        std::vector<std::thread> m_threads;                     ///< IO线程（事件循环0在调用start()的线程中运行）。
+        int m_epWaitTimeout;                                    ///< 等待超时时间（毫秒）。
+        std::vector<int> m_cpus;                                ///< IO线程绑定的CPU列表（为空表示不绑定）。
+
+        std::function<void(UringConnectionPtr)> m_newConnCb;                         ///< 回调上层业务类的handleNewConn()。
+        std::function<void(UringConnectionPtr)> m_closeCb;                           ///< 回调上层业务类的handleClose()。
+        std::function<void(UringConnectionPtr)> m_errorCb;                           ///< 回调上层业务类的handleError()。
+        std::function<void(UringConnectionPtr, std::string& message)> m_onMessageCb; ///< 回调上层业务类的handleMessage()。
+        std::function<void(UringConnectionPtr)> m_sendCompleteCb;                    ///< 回调上层业务类的handleSendComplete()。
+        std::function<void(UringEventLoop*)> m_timeoutCb;                            ///< 回调上层业务类的handleTimeOut()。
+        std::function<void(int)> m_timerTimeoutCb;                                   ///< 回调上层业务类的handleTimerTimeOut()。
+
+    public:
+        /**
+         * @brief 构造函数：创建监听socket和事件循环（io_uring在各IO线程启动时创建）
+         * @param ip 监听的IP地址
+         * @param port 监听的端口
+         * @param threadNum IO线程数，0表示CPU核数
+         * @param epWaitTimeout 等待超时时间（毫秒）
+         * @param timerTimetvl 空闲连接检查的间隔（秒，只为与TcpServer的参数一致而保留：空闲连接由时间轮按各自的到期时间删除）
+         * @param timerTimeout 连接空闲超时时间（秒，小于等于0表示不超时）
+         * @param bufNum 每个IO线程的提供缓冲区个数
+         * @param bufSize 每个提供缓冲区的大小
+         * @note 地址无效、绑定或监听失败时与Acceptor一致（SocketFd中输出错误并退出）
+         */
+        UringTcpServer(const std::string& ip, const uint16_t port, size_t threadNum = 0, int epWaitTimeout = 10000,
+                       int timerTimetvl = 30, int timerTimeout = 80, unsigned bufNum = 1024, size_t bufSize = 4096)
+            : m_epWaitTimeout(epWaitTimeout)
+        {
+            (void)timerTimetvl;
+            if (threadNum == 0) threadNum = std::thread::hardware_concurrency();
+            if (threadNum == 0) threadNum = 1;
+
+            InetAddr servAddr(ip, port);
+            for (size_t ii = 0; ii < threadNum; ++ii)
+            {
+                SocketFdPtr listenFd(new SocketFd(createFdNonblocking()));
+                listenFd->setKeepalive(true);
+                listenFd->setReuseaddr(true);
+                listenFd->setReuseport(true);
+                listenFd->setTcpnodelay(true); // accept的连接继承TCP_NODELAY和keepalive
+                listenFd->bind(servAddr);
+                listenFd->listen(1024);
+
+                std::unique_ptr<UringEventLoop> loop(new UringEventLoop(listenFd->getFd(), 256, bufNum, bufSize, timerTimeout));
+                loop->m_newConnCb = [this](UringConnectionPtr c)
+                { if (m_newConnCb) m_newConnCb(c); };
+                loop->m_closeCb = [this](UringConnectionPtr c)
+                { if (m_closeCb) m_closeCb(c); };
+                loop->m_errorCb = [this](UringConnectionPtr c)
+                { if (m_errorCb) m_errorCb(c); };
+                loop->m_onMessageCb = [this](UringConnectionPtr c, std::string& message)
+                { if (m_onMessageCb) m_onMessageCb(c, message); };
+                loop->m_sendCompleteCb = [this](UringConnectionPtr c)
+                { if (m_sendCompleteCb) m_sendCompleteCb(c); };
+                loop->m_timeoutCb = [this](UringEventLoop* l)
+                { if (m_timeoutCb) m_timeoutCb(l); };
+                loop->m_timerTimeoutCb = [this](int fd)
+                { if (m_timerTimeoutCb) m_timerTimeoutCb(fd); };
+
+                m_listenFds.emplace_back(std::move(listenFd));
+                m_loops.emplace_back(std::move(loop));
+            }
+        }
+
+        ~UringTcpServer()
+        {
+            stop();
+        }
+
+        // 运行全部事件循环（事件循环0在当前线程中运行，直到stop()）。
+        void start()
+        {
+            for (size_t ii = 1; ii < m_loops.size(); ++ii)
+            {
+                UringEventLoop* loop = m_loops[ii].get();
+                int cpu = m_cpus.empty() ? -1 : m_cpus[ii % m_cpus.size()];
+                m_threads.emplace_back([this, loop, cpu]()
+                                       {
+                                           if (cpu >= 0) pinToCpu(static_cast<size_t>(cpu));
+                                           loop->run(m_epWaitTimeout); });
+            }
+            if (!m_cpus.empty()) pinToCpu(static_cast<size_t>(m_cpus[0]));
+            m_loops[0]->run(m_epWaitTimeout);
+        }
+
+        /**
+         * @brief 设置IO线程的CPU亲和（在start()之前调用）
+         * @param cpus CPU列表，IO线程i绑定到cpus[i % cpus.size()]（线程0即调用start()的线程）
+         */
+        void setCpuAffinity(std::vector<int> cpus) { m_cpus = std::move(cpus); }
+
+        // 停止全部事件循环并等待IO线程退出（可在任意线程中调用）。
+        void stop()
+        {
+            for (auto& loop : m_loops) loop->stop();
+            for (auto& thread : m_threads)
+            {
+                if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) thread.join();
+            }
+        }
+
+        // 把当前线程绑定到CPU。
+        static void pinToCpu(size_t cpu)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu % CPU_SETSIZE, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+
+        // 运行时探测内核是否支持（不支持时使用TcpServer）。
+        static bool isSupported() { return IoUring::isSupported(); }
+
+        // IO线程数。
+        inline size_t getThreadNum() const { return m_loops.size(); }
+
+        // 当前连接总数。
+        size_t getConnNum() const
+        {
+            size_t total = 0;
+            for (auto& loop : m_loops) total += loop->getConnNum();
+            return total;
+        }
+
+        // 累计io_uring_enter系统调用次数（全部IO线程）。
+        size_t getSyscallNum() const
+        {
+            size_t total = 0;
+            for (auto& loop : m_loops) total += loop->getSyscallNum();
+            return total;
+        }
+
+        // 累计收到的报文数（全部IO线程）。
+        size_t getMessageNum() const
+        {
+            size_t total = 0;
+            for (auto& loop : m_loops) total += loop->getMessageNum();
+            return total;
+        }
+
+        void setNewConnCb(std::function<void(UringConnectionPtr)> func) { m_newConnCb = std::move(func); }
+        void setCloseCb(std::function<void(UringConnectionPtr)> func) { m_closeCb = std::move(func); }
+        void setErrorCb(std::function<void(UringConnectionPtr)> func) { m_errorCb = std::move(func); }
+        void setOnMessageCb(std::function<void(UringConnectionPtr, std::string& message)> func) { m_onMessageCb = std::move(func); }
+        void setSendCompleteCb(std::function<void(UringConnectionPtr)> func) { m_sendCompleteCb = std::move(func); }
+        void setTimeoutCb(std::function<void(UringEventLoop*)> func) { m_timeoutCb = std::move(func); }
+        void setTimerTimeoutCb(std::function<void(int)> func) { m_timerTimeoutCb = std::move(func); }
+    };
+#endif // OL_HAS_IO_URING
+
+} // namespace ol
+
+#endif // !OL_URINGTCPSERVER_H
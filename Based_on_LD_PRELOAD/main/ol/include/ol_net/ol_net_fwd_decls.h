@@ -17,6 +17,7 @@ namespace ol
 
 #ifdef __linux__
     class Buffer;
+    class ChainBuffer;
 
     class InetAddr;
 
@@ -34,10 +35,27 @@ namespace ol
     class Connection;
     using ConnectionPtr = std::shared_ptr<Connection>;
 
+    class TimerWheel;
+
     class EventLoop;
     using EventLoopPtr = std::unique_ptr<EventLoop>;
 
     class TcpServer;
+
+    class ShardedTcpServer;
+
+    class IoUring;
+    class IoUringBufRing;
+
+    class UringConnection;
+    using UringConnectionPtr = std::shared_ptr<UringConnection>;
+
+    class UringEventLoop;
+
+    class UringTcpServer;
+
+    template <class ConnPtr>
+    class OrderedOffload;
 #endif // __linux__
 
 } // namespace ol
@@ -13,6 +13,7 @@
 #ifdef __linux__
 #include "ol_net/ol_net_fwd_decls.h"
 #include "ol_net/ol_Buffer.h"
+#include "ol_net/ol_ChainBuffer.h"
 #include "ol_net/ol_InetAddr.h"
 #include "ol_net/ol_Channel.h"
 #include "ol_net/ol_SocketFd.h"
@@ -20,8 +21,13 @@
 #include "ol_net/ol_Connection.h"
 #include "ol_net/ol_EpollChnl.h"
 #include "ol_net/ol_EpollFd.h"
+#include "ol_net/ol_TimerWheel.h"
 #include "ol_net/ol_EventLoop.h"
 #include "ol_net/ol_TcpServer.h"
+#include "ol_net/ol_ShardedTcpServer.h"
+#include "ol_net/ol_IoUring.h"
+#include "ol_net/ol_UringTcpServer.h"
+#include "ol_net/ol_OrderedOffload.h"
 #endif // __linux__
 
 #endif // !OL_NET_PUBLIC_H
\ No newline at end of file
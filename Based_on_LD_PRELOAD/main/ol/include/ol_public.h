@@ -13,22 +13,29 @@
 // OL库头文件
 #include "ol_chrono.h"
 #include "ol_fstream.h"
+#include "ol_mplog.h"
 #include "ol_ftp.h"
 #include "ol_ipc.h"
 #include "ol_signal.h"
 #include "ol_string.h"
 #include "ol_tcp.h"
 #include "ol_cqueue.h"
+#include "ol_lfqueue.h"
+#include "ol_taskqueue.h"
 #include "ol_BITree.h"
 #include "ol_graph.h"
 #include "ol_TrieMap.h"
 #include "ol_TrieSet.h"
+#include "ol_CompactTrieMap.h"
+#include "ol_CompactTrieSet.h"
+#include "ol_DomainSet.h"
 #include "ol_UnionFind.h"
 #include "ol_type_traits.h"
 #include "ol_mutex.h"
 #include "ol_math.h"
 #include "ol_hash.h"
 #include "ol_ThreadPool.h"
+#include "ol_TaskPool.h"
 #include "ol_TimeStamp.h"
 #include "ol_sort.h"
 #include "ol_net/ol_net_public.h"
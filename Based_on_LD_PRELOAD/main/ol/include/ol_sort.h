@@ -5,6 +5,9 @@
  *          - 容器特性萃取：适配STL容器（vector、deque等）和原生数组，统一迭代器操作接口
  *          - 多种排序算法：插入排序、快速排序、希尔排序、冒泡排序、选择排序、堆排序、归并排序等
  *          - 自定义比较器：支持传入符合严格弱序（Strict Weak Ordering）的比较函数/对象
+ *          - 字节基数排序（radix_sort/radix_sort_by_key）：定宽整数键及按整数键排序的记录，稳定、按字节分配
+ *          - 并行排序（parallel_sort/parallel_radix_sort）：在ol::TaskPool上分块排序后归并，
+ *            或按最高字节分桶（MSD）后各桶并行做LSD基数排序
  *          - 提供容器打印功能（调试用），支持所有可范围遍历的容器类型
  * 作者：ol
  * 适用标准：C++11及以上（需支持迭代器特性、类型萃取、函数对象等特性）
@@ -565,6 +568,82 @@ namespace ol
     }
     // ===========================================================================
 
+    // 用户接口 - 字节基数排序（定宽整数键）
+    // ===========================================================================
+    /**
+     * @brief 字节基数排序（迭代器版本，LSD策略，适用于定宽整数）
+     * @tparam RandomIt 随机访问迭代器类型（元素为整数，包括有符号数和__int128）
+     * @param first 起始迭代器
+     * @param last 结束迭代器
+     * @note
+     * 算法特性：
+     * - 非比较型排序，按字节（基数256）从低位到高位分配，不做除法
+     * - 稳定性：稳定排序（相等元素保持原始相对顺序）
+     * - 时间复杂度：O(w*n)，w为键的字节数；所有元素在某个字节上相同时跳过该轮
+     * - 空间复杂度：O(n)
+     * - 适用场景：大量定宽整数键（地址、端口、打包的复合键），例如编译策略前的排序去重；
+     *   与radix_sort_lsd（按十进制等任意基数逐位处理）相比，每轮只有移位和查表
+     */
+    template <typename RandomIt>
+    typename std::enable_if<base::radix_key_traits<typename std::iterator_traits<RandomIt>::value_type>::value, void>::type
+    radix_sort(RandomIt first, RandomIt last)
+    {
+        using traits = base::radix_key_traits<typename std::iterator_traits<RandomIt>::value_type>;
+        base::radix_sort_by_key_base(first, last, [](const typename std::iterator_traits<RandomIt>::value_type& v)
+                                     { return traits::to_unsigned(v); });
+    }
+
+    /**
+     * @brief 字节基数排序（容器版本，LSD策略，适用于定宽整数）
+     * @tparam Container 容器类型（需支持随机访问迭代器，元素为整数）
+     * @param container 待排序的容器
+     * @note 算法特性同迭代器版本
+     */
+    template <typename Container>
+    typename std::enable_if<base::radix_key_traits<typename container_traits<Container>::value_type>::value, void>::type
+    radix_sort(Container& container)
+    {
+        using traits = container_traits<Container>;
+        radix_sort(traits::begin(container), traits::end(container));
+    }
+
+    /**
+     * @brief 按键的字节基数排序（迭代器版本，适用于键值对、结构体等记录）
+     * @tparam RandomIt 随机访问迭代器类型（元素需可默认构造、可移动）
+     * @tparam KeyFn 取键函数类型，签名为Key(const T&)，Key为整数类型
+     * @param first 起始迭代器
+     * @param last 结束迭代器
+     * @param key 取键函数（每轮会重复调用，应为简单的成员访问或位运算）
+     * @note
+     * - 稳定性：稳定排序，可用于多关键字排序（先按次要键排序，再按主要键排序）
+     * - 复合键可打包成一个整数，例如IPv4地址、前缀长度、端口打包为
+     *   (uint64_t(ip) << 24) | (uint64_t(prefix) << 16) | port，一次排序后用std::unique去重
+     */
+    template <typename RandomIt, typename KeyFn>
+    void radix_sort_by_key(RandomIt first, RandomIt last, const KeyFn& key)
+    {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+        using K = typename std::decay<decltype(key(std::declval<const T&>()))>::type;
+        static_assert(base::radix_key_traits<K>::value, "radix_sort_by_key requires an integral key");
+        base::radix_sort_by_key_base(first, last, [&key](const T& v)
+                                     { return base::radix_key_traits<K>::to_unsigned(key(v)); });
+    }
+
+    /**
+     * @brief 按键的字节基数排序（容器版本）
+     * @tparam Container 容器类型（需支持随机访问迭代器）
+     * @tparam KeyFn 取键函数类型，签名为Key(const T&)，Key为整数类型
+     * @param container 待排序的容器
+     * @param key 取键函数
+     */
+    template <typename Container, typename KeyFn>
+    void radix_sort_by_key(Container& container, const KeyFn& key)
+    {
+        using traits = container_traits<Container>;
+        radix_sort_by_key(traits::begin(container), traits::end(container), key);
+    }
+    // ===========================================================================
+
     // 用户接口 - 快速排序
     // ===========================================================================
     /**
@@ -747,6 +826,157 @@ namespace ol
     }
     // ===========================================================================
 
+    // 用户接口 - 并行排序
+    // ===========================================================================
+    /**
+     * @brief 并行排序（使用调用者的线程池）
+     * @tparam IsDynamic 线程池模式
+     * @tparam RandomIt 随机访问迭代器类型
+     * @tparam Compare 比较函数类型，需满足严格弱序，默认使用std::less
+     * @param pool 线程池（排序期间向其提交任务并等待完成，不能在该线程池的工作线程中调用）
+     * @param first 起始迭代器
+     * @param last 结束迭代器
+     * @param comp 比较函数对象
+     * @note
+     * 算法特性：
+     * - 按线程数分块，各块并行std::sort，再逐轮两两并行归并
+     * - 稳定性：不稳定排序
+     * - 时间复杂度：O((n/p)·log(n/p) + n·log p)，p为分块数
+     * - 空间复杂度：O(n)
+     * - 元素数较少（< 32768）时直接在当前线程排序
+     */
+    template <bool IsDynamic, typename RandomIt, typename Compare = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+    void parallel_sort(TaskPool<IsDynamic>& pool, RandomIt first, RandomIt last, const Compare& comp = Compare())
+    {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+        const size_t n = static_cast<size_t>(std::distance(first, last));
+        const size_t chunks = std::max<size_t>(1, pool.getWorkerNum());
+        if constexpr (base::is_contiguous_iter<RandomIt>::value)
+        {
+            if (n > 0) base::parallel_sort_base(&*first, n, comp, pool, chunks);
+        }
+        else
+        {
+            std::vector<T> tmp(std::make_move_iterator(first), std::make_move_iterator(last));
+            base::parallel_sort_base(tmp.data(), n, comp, pool, chunks);
+            std::move(tmp.begin(), tmp.end(), first);
+        }
+    }
+
+    /**
+     * @brief 并行排序（迭代器版本，临时创建线程池）
+     * @tparam RandomIt 随机访问迭代器类型
+     * @tparam Compare 比较函数类型，需满足严格弱序，默认使用std::less
+     * @param first 起始迭代器
+     * @param last 结束迭代器
+     * @param comp 比较函数对象
+     * @param threadNum 线程数，0表示CPU核数
+     * @note 元素数较少或只有一个线程时不创建线程池；需要反复排序时应复用线程池（见上一个重载）
+     */
+    template <typename RandomIt, typename Compare = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+    void parallel_sort(RandomIt first, RandomIt last, const Compare& comp = Compare(), size_t threadNum = 0)
+    {
+        if (threadNum == 0) threadNum = std::max<unsigned>(1, std::thread::hardware_concurrency());
+        if (threadNum == 1 || static_cast<size_t>(std::distance(first, last)) < base::PARALLEL_SORT_MIN)
+        {
+            std::sort(first, last, comp);
+            return;
+        }
+        TaskPool<false> pool(threadNum);
+        parallel_sort(pool, first, last, comp);
+    }
+
+    /**
+     * @brief 并行排序（容器版本，临时创建线程池）
+     * @tparam Container 容器类型（需支持随机访问迭代器）
+     * @tparam Compare 比较函数类型，需满足严格弱序，默认使用std::less
+     * @param container 待排序的容器
+     * @param comp 比较函数对象
+     * @param threadNum 线程数，0表示CPU核数
+     */
+    template <typename Container, typename Compare = std::less<typename container_traits<Container>::value_type>>
+    void parallel_sort(Container& container, const Compare& comp = Compare(), size_t threadNum = 0)
+    {
+        using traits = container_traits<Container>;
+        parallel_sort(traits::begin(container), traits::end(container), comp, threadNum);
+    }
+
+    /**
+     * @brief 并行按键基数排序（使用调用者的线程池）
+     * @tparam IsDynamic 线程池模式
+     * @tparam RandomIt 随机访问迭代器类型
+     * @tparam KeyFn 取键函数类型，签名为Key(const T&)，Key为整数类型
+     * @param pool 线程池（不能在该线程池的工作线程中调用）
+     * @param first 起始迭代器
+     * @param last 结束迭代器
+     * @param key 取键函数
+     * @note
+     * 算法特性：
+     * - 第一步按键的最高字节（MSD）并行分配到256个桶，各块写入位置预先算好，不加锁
+     * - 第二步各桶并行做LSD字节基数排序（桶内数据连续，缓存友好）
+     * - 稳定性：稳定排序
+     * - 键的最高字节分布越均匀，第二步的负载越均衡
+     */
+    template <bool IsDynamic, typename RandomIt, typename KeyFn>
+    void parallel_radix_sort_by_key(TaskPool<IsDynamic>& pool, RandomIt first, RandomIt last, const KeyFn& key)
+    {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+        using K = typename std::decay<decltype(key(std::declval<const T&>()))>::type;
+        static_assert(base::radix_key_traits<K>::value, "parallel_radix_sort_by_key requires an integral key");
+        auto ukey = [&key](const T& v)
+        { return base::radix_key_traits<K>::to_unsigned(key(v)); };
+
+        const size_t n = static_cast<size_t>(std::distance(first, last));
+        const size_t chunks = std::max<size_t>(1, pool.getWorkerNum());
+        if constexpr (base::is_contiguous_iter<RandomIt>::value)
+        {
+            if (n > 0) base::parallel_radix_sort_base(&*first, n, ukey, pool, chunks);
+        }
+        else
+        {
+            std::vector<T> tmp(std::make_move_iterator(first), std::make_move_iterator(last));
+            base::parallel_radix_sort_base(tmp.data(), n, ukey, pool, chunks);
+            std::move(tmp.begin(), tmp.end(), first);
+        }
+    }
+
+    /**
+     * @brief 并行字节基数排序（使用调用者的线程池，元素为整数）
+     * @param pool 线程池
+     * @param first 起始迭代器
+     * @param last 结束迭代器
+     */
+    template <bool IsDynamic, typename RandomIt>
+    typename std::enable_if<base::radix_key_traits<typename std::iterator_traits<RandomIt>::value_type>::value, void>::type
+    parallel_radix_sort(TaskPool<IsDynamic>& pool, RandomIt first, RandomIt last)
+    {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+        parallel_radix_sort_by_key(pool, first, last, [](const T& v)
+                                   { return v; });
+    }
+
+    /**
+     * @brief 并行字节基数排序（容器版本，临时创建线程池，元素为整数）
+     * @tparam Container 容器类型（需支持随机访问迭代器，元素为整数）
+     * @param container 待排序的容器
+     * @param threadNum 线程数，0表示CPU核数
+     */
+    template <typename Container>
+    typename std::enable_if<base::radix_key_traits<typename container_traits<Container>::value_type>::value, void>::type
+    parallel_radix_sort(Container& container, size_t threadNum = 0)
+    {
+        using traits = container_traits<Container>;
+        if (threadNum == 0) threadNum = std::max<unsigned>(1, std::thread::hardware_concurrency());
+        if (threadNum == 1 || static_cast<size_t>(std::distance(traits::begin(container), traits::end(container))) < base::PARALLEL_SORT_MIN)
+        {
+            radix_sort(container);
+            return;
+        }
+        TaskPool<false> pool(threadNum);
+        parallel_radix_sort(pool, traits::begin(container), traits::end(container));
+    }
+    // ===========================================================================
+
     // 打印容器（调试用）
     // ===========================================================================
     /**
@@ -8,6 +8,7 @@
  *          - XML格式字符串解析函数，支持多种数据类型提取
  *          - 格式化输出函数（sformat），兼容C风格格式符并支持std::string
  *          - KMP算法实现的高效子串查找
+ *          - std::string_view版本（零拷贝）：首尾修整、字段拆分类（ccmdview）、XML字段提取
  * 作者：ol
  * 适用标准：C++11及以上（需支持变参模板、类型萃取等特性）
  */
@@ -16,8 +17,13 @@
 #ifndef OL_STRING_H
 #define OL_STRING_H 1
 
+#include <cctype>
+#include <charconv>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -106,6 +112,82 @@ namespace ol
     bool matchstr(const std::string& str, const std::string& rules);
     // ===========================================================================
 
+    // string_view版本（零拷贝，返回原字符串的子视图，不修改原字符串）
+    // ===========================================================================
+    /**
+     * @brief 删除字符串视图左边指定字符
+     * @param str 字符串视图
+     * @param c 要删除的字符（默认空格' '）
+     * @return 去掉左边字符后的子视图
+     */
+    inline std::string_view deleteLchr(std::string_view str, const char c = ' ')
+    {
+        size_t pos = str.find_first_not_of(c);
+        return pos == std::string_view::npos ? std::string_view() : str.substr(pos);
+    }
+
+    /**
+     * @brief 删除字符串视图右边指定字符
+     * @param str 字符串视图
+     * @param c 要删除的字符（默认空格' '）
+     * @return 去掉右边字符后的子视图
+     */
+    inline std::string_view deleteRchr(std::string_view str, const char c = ' ')
+    {
+        size_t pos = str.find_last_not_of(c);
+        return pos == std::string_view::npos ? std::string_view() : str.substr(0, pos + 1);
+    }
+
+    /**
+     * @brief 删除字符串视图左右两边指定字符
+     * @param str 字符串视图
+     * @param c 要删除的字符（默认空格' '）
+     * @return 去掉左右两边字符后的子视图
+     */
+    inline std::string_view deleteLRchr(std::string_view str, const char c = ' ')
+    {
+        return deleteRchr(deleteLchr(str, c), c);
+    }
+
+    /**
+     * @brief 删除字符串视图左右两边的空白字符（空格、制表符、回车、换行等）
+     * @param str 字符串视图
+     * @return 去掉首尾空白后的子视图
+     * @note 跨行的XML元素内容通常带换行和缩进，用本函数修整
+     */
+    inline std::string_view deleteLRspace(std::string_view str)
+    {
+        size_t begin = 0, end = str.size();
+        while (begin < end && std::isspace(static_cast<unsigned char>(str[begin]))) ++begin;
+        while (end > begin && std::isspace(static_cast<unsigned char>(str[end - 1]))) --end;
+        return str.substr(begin, end - begin);
+    }
+
+    namespace base
+    {
+        /**
+         * @brief 字符串视图转换为数值（忽略首尾空白，允许前导'+'，整个视图都必须是数值）
+         * @tparam T 整数或浮点类型
+         * @param str 字符串视图
+         * @param value 存储结果的变量引用（失败时不修改）
+         * @return true-成功，false-失败
+         */
+        template <typename T>
+        bool sv_to_num(std::string_view str, T& value)
+        {
+            str = deleteLRspace(str);
+            if (!str.empty() && str.front() == '+') str.remove_prefix(1);
+            if (str.empty()) return false;
+
+            T v{};
+            std::from_chars_result r = std::from_chars(str.data(), str.data() + str.size(), v);
+            if (r.ec != std::errc() || r.ptr != str.data() + str.size()) return false;
+            value = v;
+            return true;
+        }
+    } // namespace base
+    // ===========================================================================
+
     // ===========================================================================
     // ccmdstr类，命令行字符串拆分类，用于解析带分隔符的结构化字符串。
     // 字符串的格式为：字段内容1+分隔符+字段内容2+分隔符+字段内容3+分隔符+...+字段内容n。
@@ -191,6 +273,118 @@ namespace ol
     std::ostream& operator<<(std::ostream& out, const ccmdstr& cmdstr);
     // ===========================================================================
 
+    // ===========================================================================
+    // ccmdview类，ccmdstr的零拷贝版本：拆分结果是原字符串的子视图，不为每个字段分配内存。
+    // 注意：原字符串必须在使用拆分结果期间保持有效且不被修改。
+    class ccmdview
+    {
+    private:
+        std::vector<std::string_view> m_cmdstr; // 拆分后的字段视图（重复拆分时复用容量）
+
+    public:
+        // 默认构造函数
+        ccmdview()
+        {
+        }
+
+        /**
+         * @brief 带参构造函数，直接拆分字符串
+         * @param buffer 待拆分的字符串
+         * @param sepstr 分隔符（支持多字符）
+         * @param bdelspace 是否删除字段前后空格（默认false）
+         */
+        ccmdview(std::string_view buffer, std::string_view sepstr, const bool bdelspace = false)
+        {
+            split(buffer, sepstr, bdelspace);
+        }
+
+        /**
+         * @brief 访问拆分后的字段
+         * @param i 字段索引（从0开始）
+         * @return 字段视图
+         */
+        std::string_view operator[](size_t i) const
+        {
+            return m_cmdstr[i];
+        }
+
+        /**
+         * @brief 拆分字符串（语义与ccmdstr::split相同，空字段会被保留）
+         * @param buffer 待拆分的字符串
+         * @param sepstr 分隔符（支持多字符，为空时整个字符串作为一个字段）
+         * @param bdelspace 是否删除字段前后空格（默认false）
+         */
+        void split(std::string_view buffer, std::string_view sepstr, const bool bdelspace = false)
+        {
+            m_cmdstr.clear();
+            if (sepstr.empty())
+            {
+                m_cmdstr.push_back(bdelspace ? deleteLRchr(buffer) : buffer);
+                return;
+            }
+
+            size_t start = 0;
+            while (true)
+            {
+                size_t pos = buffer.find(sepstr, start);
+                std::string_view field = buffer.substr(start, pos == std::string_view::npos ? std::string_view::npos : pos - start);
+                m_cmdstr.push_back(bdelspace ? deleteLRchr(field) : field);
+                if (pos == std::string_view::npos) break;
+                start = pos + sepstr.size();
+            }
+        }
+
+        /**
+         * @brief 获取拆分后的字段数量
+         * @return 字段总数
+         */
+        size_t size() const
+        {
+            return m_cmdstr.size();
+        }
+
+        /**
+         * @brief 获取指定索引的字段内容并转换为目标类型
+         * @param i 字段索引（从0开始）
+         * @param value 存储结果的变量引用
+         * @param len 仅std::string版本有效，指定截取长度（默认0表示不截取）
+         * @return true-成功（索引有效且转换成功），false-失败（索引越界或转换失败）
+         */
+        bool getvalue(const size_t i, std::string_view& value) const // 字段视图（零拷贝）
+        {
+            if (i >= m_cmdstr.size()) return false;
+            value = m_cmdstr[i];
+            return true;
+        }
+
+        bool getvalue(const size_t i, std::string& value, const size_t len = 0) const // std::string版本
+        {
+            if (i >= m_cmdstr.size()) return false;
+            std::string_view field = m_cmdstr[i];
+            if (len > 0 && field.size() > len) field = field.substr(0, len);
+            value.assign(field.data(), field.size());
+            return true;
+        }
+
+        bool getvalue(const size_t i, bool& value) const // 转换为bool（"true"/"1"为true，忽略大小写）
+        {
+            if (i >= m_cmdstr.size()) return false;
+            std::string_view field = deleteLRspace(m_cmdstr[i]);
+            bool istrue = field.size() == 4;
+            for (size_t ii = 0; istrue && ii < 4; ++ii)
+                istrue = std::tolower(static_cast<unsigned char>(field[ii])) == "true"[ii];
+            value = field == "1" || istrue;
+            return true;
+        }
+
+        template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>>
+        bool getvalue(const size_t i, T& value) const // 转换为整数或浮点数
+        {
+            return i < m_cmdstr.size() && base::sv_to_num(m_cmdstr[i], value);
+        }
+    };
+    // ===========================================================================
+
     // ===========================================================================
     /**
      * @brief 解析XML格式字符串，提取指定标签的内容并转换为目标类型
@@ -211,6 +405,38 @@ namespace ol
     bool getByXml(const std::string& xmlbuffer, const std::string& fieldname, unsigned long& value);                     // 转换为unsigned long
     bool getByXml(const std::string& xmlbuffer, const std::string& fieldname, double& value);                            // 转换为double
     bool getByXml(const std::string& xmlbuffer, const std::string& fieldname, float& value);                             // 转换为float
+
+    /**
+     * @brief 零拷贝版本：提取指定标签的内容视图（不分配内存，结果指向xmlbuffer内部）
+     * @param xmlbuffer 待解析的XML格式字符串
+     * @param fieldname 字段标签名
+     * @param value 存储结果的视图（xmlbuffer必须在使用期间保持有效）
+     * @return true-成功，false-标签不存在
+     * @note 整个文件的解析用ol_XmlScanner.h中的XmlScanner（一次遍历，支持注释与跨行元素）
+     */
+    inline bool getByXml(std::string_view xmlbuffer, std::string_view fieldname, std::string_view& value)
+    {
+        // 在栈上拼出"<fieldname>"和"</fieldname>"（标签名过长时视为不存在）
+        char open[128], close[130];
+        if (fieldname.empty() || fieldname.size() + 3 > sizeof(open)) return false;
+        open[0] = '<';
+        std::memcpy(open + 1, fieldname.data(), fieldname.size());
+        open[fieldname.size() + 1] = '>';
+        close[0] = '<';
+        close[1] = '/';
+        std::memcpy(close + 2, fieldname.data(), fieldname.size());
+        close[fieldname.size() + 2] = '>';
+
+        std::string_view openTag(open, fieldname.size() + 2), closeTag(close, fieldname.size() + 3);
+        size_t start = xmlbuffer.find(openTag);
+        if (start == std::string_view::npos) return false;
+        start += openTag.size();
+        size_t end = xmlbuffer.find(closeTag, start);
+        if (end == std::string_view::npos) return false;
+
+        value = xmlbuffer.substr(start, end - start);
+        return true;
+    }
     // ===========================================================================
 
     // ===========================================================================
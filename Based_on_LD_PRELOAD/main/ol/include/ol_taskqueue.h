@@ -0,0 +1,164 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_taskqueue.h
+ * 功能描述：事件循环的跨线程任务队列（多生产者单消费者，无锁），支持以下特性：
+ *          - 侵入式链表：任务直接构造在节点中（不超过48字节的可调用对象不分配内存），入队一次CAS
+ *          - 合并唤醒：只有使队列由空变非空的那次入队返回true，由它唤醒消费者（写eventfd等），
+ *            消费者取走整批任务之前的其它入队都不再唤醒，一批任务只需一次系统调用
+ *          - 批量执行：drain()一次exchange取走全部任务，按入队顺序执行
+ *          - 节点池：执行完的节点整批归还全局节点池，生产者从线程本地缓存取用，稳定状态下不做内存分配
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_TASKQUEUE_H
+#define OL_TASKQUEUE_H 1
+
+#include "ol_base/ol_taskqueue_base.h"
+#include "ol_type_traits.h"
+
+namespace ol
+{
+
+    // ===========================================================================
+    /**
+     * @brief 多生产者单消费者无锁任务队列
+     * @note 用法（以eventfd为例）：
+     *       生产者：if (queue.push(task)) write(eventfd, 1);
+     *       消费者（eventfd可读后）：read(eventfd); queue.drain();
+     *       消费者在drain()取走任务之后才允许下一次"由空变非空"，因此不会漏掉唤醒
+     */
+    class TaskQueue : public TypeNonCopyableMovable
+    {
+    private:
+        alignas(64) std::atomic<base::TaskNode*> m_head{nullptr}; ///< 入队的节点（后入先出的栈，drain时反转）
+
+    public:
+        TaskQueue() = default;
+
+        // 析构：未执行的任务只析构不执行。
+        ~TaskQueue()
+        {
+            base::TaskNode* node = m_head.exchange(nullptr, std::memory_order_acquire);
+            if (!node) return;
+            base::TaskNode* last = node;
+            for (base::TaskNode* p = node; p; p = p->m_next)
+            {
+                p->m_op(p, false);
+                last = p;
+            }
+            base::TaskNodePool::instance().release(node, last);
+        }
+
+        /**
+         * @brief 入队一个任务（任意线程）
+         * @param f 可调用对象，签名为void()
+         * @return true-队列由空变非空，调用方负责唤醒消费者；false-消费者已被唤醒（或将会取到该任务）
+         */
+        template <typename F>
+        bool push(F&& f)
+        {
+            base::TaskNodePool& pool = base::TaskNodePool::instance();
+            base::TaskNode* node = pool.acquire();
+            try
+            {
+                node->set(std::forward<F>(f));
+            }
+            catch (...)
+            {
+                pool.releaseLocal(node);
+                throw;
+            }
+
+            base::TaskNode* head = m_head.load(std::memory_order_relaxed);
+            do
+            {
+                node->m_next = head;
+            } while (!m_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+            return head == nullptr;
+        }
+
+        /**
+         * @brief 取走当前全部任务并按入队顺序执行（只能在消费者线程中调用）
+         * @return 执行的任务数
+         * @note 执行过程中新入队的任务留到下一批（其入队会重新返回true触发唤醒）；
+         *       任务抛出异常时，本批剩余的任务仍留在队列中，下次drain()继续执行
+         */
+        size_t drain()
+        {
+            base::TaskNode* node = m_head.exchange(nullptr, std::memory_order_acquire);
+            if (!node) return 0;
+
+            // 反转为入队顺序
+            base::TaskNode* ordered = nullptr;
+            while (node)
+            {
+                base::TaskNode* next = node->m_next;
+                node->m_next = ordered;
+                ordered = node;
+                node = next;
+            }
+
+            size_t count = 0;
+            base::TaskNode* first = ordered;
+            base::TaskNode* last = ordered;
+            try
+            {
+                for (base::TaskNode* p = ordered; p; last = p, p = p->m_next)
+                {
+                    ordered = p;
+                    ++count;
+                    p->m_op(p, true);
+                }
+            }
+            catch (...)
+            {
+                requeue(ordered->m_next);
+                ordered->m_next = nullptr;
+                base::TaskNodePool::instance().release(first, ordered);
+                throw;
+            }
+            base::TaskNodePool::instance().release(first, last);
+            return count;
+        }
+
+        // 队列是否为空（只是瞬时状态）。
+        bool empty() const { return m_head.load(std::memory_order_acquire) == nullptr; }
+
+    private:
+        // 把未执行的任务（按入队顺序串好）放回队列，保持它们先于之后入队的任务执行。
+        void requeue(base::TaskNode* ordered)
+        {
+            if (!ordered) return;
+
+            // 栈底的任务在drain()反转后最先执行：未执行的任务反转后接在当前栈的下面
+            base::TaskNode* bottom = ordered;
+            base::TaskNode* top = nullptr;
+            while (ordered)
+            {
+                base::TaskNode* next = ordered->m_next;
+                ordered->m_next = top;
+                top = ordered;
+                ordered = next;
+            }
+            if (base::TaskNode* cur = m_head.exchange(nullptr, std::memory_order_acquire))
+            {
+                base::TaskNode* curLast = cur;
+                while (curLast->m_next) curLast = curLast->m_next;
+                curLast->m_next = top;
+                top = cur;
+            }
+
+            base::TaskNode* head = m_head.load(std::memory_order_relaxed);
+            do
+            {
+                bottom->m_next = head;
+            } while (!m_head.compare_exchange_weak(head, top, std::memory_order_release, std::memory_order_relaxed));
+        }
+    };
+    // ===========================================================================
+
+} // namespace ol
+
+#endif // !OL_TASKQUEUE_H
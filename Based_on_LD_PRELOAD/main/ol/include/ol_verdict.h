@@ -0,0 +1,746 @@
+/****************************************************************************************/
+/*
+ * 程序名：ol_verdict.h
+ * 功能描述：本机判定服务的通信与共享内存缓存，用于被注入进程向判定守护进程查询连接是否放行，支持以下特性：
+ *          - 查询走SOCK_SEQPACKET的Unix域套接字：一个报文是一批定长查询，应答按序号对应，保留报文边界，不需要分帧
+ *          - 服务端（cvserver）用epoll管理全部连接，每次唤醒用recvmmsg取出一个连接上积压的多个报文，
+ *            逐条判定后用一次sendmmsg批量应答（流水线：客户端不必等上一批应答就能发下一批）
+ *          - 进程身份（pid、uid、可执行文件）由服务端在accept时通过SO_PEERCRED和/proc/<pid>/exe取得，客户端无法伪造
+ *          - 判定结果写入System V共享内存中的开放寻址哈希表（cvcache），键为(可执行文件哈希, uid, 地址, 端口)，
+ *            每项带序号锁（单写者多读者）、过期时间和策略版本号；客户端先查缓存，只有未命中才付出一次IPC往返
+ *          - 策略重新加载时服务端递增版本号，全部旧缓存项立即失效
+ *          - 客户端连接（cvconn）按线程各自持有，查询有截止时间（poll等待），超时、服务未运行或连接断开都返回失败，
+ *            由调用者按配置放行或拦截；连接失败后1秒内不再重试，服务不可用时不会每次都付出系统调用
+ *          - 仅支持Linux平台（依赖System V共享内存、SO_PEERCRED、recvmmsg/sendmmsg）
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef OL_VERDICT_H
+#define OL_VERDICT_H 1
+
+#include "ol_hash.h"
+#include "ol_type_traits.h"
+#include <atomic>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace ol
+{
+
+#ifdef __linux__
+    // ===========================================================================
+    // 判定服务相关宏定义
+#define SHMKEYVC 0x5098        // 判定缓存共享内存的key。
+#define VCACHECAP 65536        // 缓存项数量，必须是2的幂（每项64字节，共4MB）。
+#define VCACHEPROBE 8          // 线性探测的最大步数。
+#define VCACHEMAGIC 0x4F4C5643 // 共享内存已初始化的标志（"OLVC"）。
+#define VBATCHMAX 64           // 一个报文中最多的查询数。
+#define VRECVBATCH 16          // 服务端每次recvmmsg最多取出的报文数。
+
+    // 判定结果（与st_hookevent::m_verdict一致）
+    enum : uint8_t
+    {
+        VERDICT_ALLOW = 0,    // 放行
+        VERDICT_BLOCK = 1,    // 拦截
+        VERDICT_WHITELIST = 2 // 白名单放行
+    };
+
+    // 一条查询（24字节）；进程身份由服务端从连接上取得
+    struct st_vquery
+    {
+        uint32_t m_seq;     // 序号（应答原样带回）
+        uint16_t m_family;  // 目标地址族（AF_INET/AF_INET6）
+        uint16_t m_port;    // 目标端口（主机字节序）
+        uint8_t m_addr[16]; // 目标IP（网络字节序，IPv4只用前4字节，其余为0）
+    };
+    static_assert(sizeof(st_vquery) == 24, "st_vquery must be 24 bytes");
+
+    // 一条应答（16字节）
+    struct st_vanswer
+    {
+        uint32_t m_seq;    // 查询的序号
+        int32_t m_ruleId;  // 命中的规则编号（-1表示未命中）
+        uint8_t m_verdict; // 判定结果（VERDICT_*）
+        uint8_t m_pad[3];  // 填充
+        uint32_t m_ttl;    // 结果的有效期（秒，0表示不缓存）
+    };
+    static_assert(sizeof(st_vanswer) == 16, "st_vanswer must be 16 bytes");
+
+    // 缓存键（32字节）
+    struct st_vkey
+    {
+        uint64_t m_exeHash; // 可执行文件路径的哈希（vexehash）
+        uint32_t m_uid;     // 进程的uid
+        uint16_t m_family;  // 目标地址族
+        uint16_t m_port;    // 目标端口
+        uint8_t m_addr[16]; // 目标IP（IPv4只用前4字节，其余为0）
+
+        bool operator==(const st_vkey& o) const { return memcmp(this, &o, sizeof(st_vkey)) == 0; }
+    };
+    static_assert(sizeof(st_vkey) == 32, "st_vkey must be 32 bytes");
+
+    // 共享内存中的一个缓存项（64字节，一个缓存行）
+    struct alignas(64) st_ventry
+    {
+        std::atomic<uint32_t> m_seq; // 序号锁（奇数表示正在写）
+        uint32_t m_gen;              // 写入时的策略版本号
+        uint32_t m_expire;           // 过期时间（CLOCK_MONOTONIC，秒），0表示空项
+        int32_t m_ruleId;            // 命中的规则编号
+        uint8_t m_verdict;           // 判定结果
+        uint8_t m_pad[11];           // 填充
+        st_vkey m_key;               // 键
+    };
+    static_assert(sizeof(st_ventry) == 64, "st_ventry must be 64 bytes");
+
+    // 判定缓存共享内存的整体布局
+    struct st_vcache
+    {
+        std::atomic<uint32_t> m_magic;    // 初始化标志（VCACHEMAGIC）
+        std::atomic<int32_t> m_ownerPid;  // 判定守护进程的pid（0表示未运行）
+        std::atomic<uint32_t> m_gen;      // 策略版本号（重新加载策略时递增）
+        char m_sockPath[108];             // 判定服务的套接字路径（sockaddr_un::sun_path的长度）
+        st_ventry m_entry[VCACHECAP];     // 缓存项
+    };
+
+    // 当前时间（CLOCK_MONOTONIC，秒），各进程一致
+    inline uint32_t vnow()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<uint32_t>(ts.tv_sec);
+    }
+
+    // 当前时间（CLOCK_MONOTONIC，毫秒）
+    inline int64_t vnowms()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+    }
+
+    // 可执行文件路径的哈希（客户端与服务端必须一致，固定种子）
+    inline uint64_t vexehash(const char* exe, size_t len)
+    {
+        return hash_bytes(exe, len);
+    }
+
+    // 判定服务是否在监听（建立一次连接后立即关闭，不经过被劫持的connect）
+    inline bool vreachable(const char* sockpath)
+    {
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (fd < 0) return false;
+        struct sockaddr_un sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        strncpy(sa.sun_path, sockpath, sizeof(sa.sun_path) - 1);
+        bool ok = syscall(SYS_connect, fd, reinterpret_cast<struct sockaddr*>(&sa), sizeof(sa)) == 0;
+        ::close(fd);
+        return ok;
+    }
+
+    // 缓存键的起始槽位
+    inline size_t vslot(const st_vkey& key)
+    {
+        return static_cast<size_t>(hash_bytes(&key, sizeof(key))) & (VCACHECAP - 1);
+    }
+
+    /**
+     * @brief 判定缓存（被注入进程使用，只读挂接）
+     * @note 判定守护进程未运行时attach()返回false；守护进程退出后probe()一律未命中。
+     */
+    class cvcache : public TypeNonCopyableMovable
+    {
+    private:
+        const st_vcache* m_shm = nullptr; // 指向共享内存的指针（只读）
+
+    public:
+        cvcache() = default;
+
+        /**
+         * @brief 只读挂接判定守护进程创建的缓存
+         * @param shmkey 共享内存的key（默认SHMKEYVC）
+         * @return true-成功，false-守护进程未运行
+         */
+        bool attach(key_t shmkey = SHMKEYVC)
+        {
+            if (m_shm != nullptr) return true;
+
+            int shmid = shmget(shmkey, 0, 0);
+            if (shmid == -1) return false;
+
+            void* addr = shmat(shmid, nullptr, SHM_RDONLY);
+            if (addr == (void*)-1) return false;
+
+            m_shm = static_cast<const st_vcache*>(addr);
+            if (m_shm->m_magic.load(std::memory_order_acquire) != VCACHEMAGIC)
+            {
+                detach();
+                return false;
+            }
+            return true;
+        }
+
+        // 判断是否已挂接
+        bool isattached() const { return m_shm != nullptr; }
+
+        // 判断守护进程是否在运行
+        bool isrunning() const
+        {
+            return m_shm != nullptr && m_shm->m_ownerPid.load(std::memory_order_acquire) != 0;
+        }
+
+        // 判断当前进程是否就是判定守护进程（守护进程自身的连接不能再向自己查询）
+        bool isowner() const
+        {
+            return m_shm != nullptr && m_shm->m_ownerPid.load(std::memory_order_relaxed) == static_cast<int32_t>(getpid());
+        }
+
+        // 守护进程发布的套接字路径（未挂接时为空串）
+        const char* sockpath() const { return m_shm != nullptr ? m_shm->m_sockPath : ""; }
+
+        /**
+         * @brief 查缓存（热路径，不做系统调用）
+         * @param key 键
+         * @param ans 输出：命中时的判定结果（m_seq和m_ttl不填）
+         * @return true-命中，false-未命中（含守护进程已退出、缓存项过期或策略已重新加载）
+         */
+        bool probe(const st_vkey& key, st_vanswer& ans) const
+        {
+            if (m_shm == nullptr || m_shm->m_ownerPid.load(std::memory_order_relaxed) == 0) return false;
+
+            uint32_t gen = m_shm->m_gen.load(std::memory_order_acquire);
+            uint32_t now = vnow();
+            size_t slot = vslot(key);
+            for (size_t ii = 0; ii < VCACHEPROBE; ++ii)
+            {
+                const st_ventry& e = m_shm->m_entry[(slot + ii) & (VCACHECAP - 1)];
+
+                // 序号锁：读前读后序号相同且为偶数，读到的才是完整的一项
+                uint32_t s1 = e.m_seq.load(std::memory_order_acquire);
+                if (s1 & 1) continue;
+                st_vkey k;
+                memcpy(&k, &e.m_key, sizeof(k));
+                uint32_t egen = e.m_gen, expire = e.m_expire;
+                int32_t ruleId = e.m_ruleId;
+                uint8_t verdict = e.m_verdict;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (e.m_seq.load(std::memory_order_relaxed) != s1) continue;
+
+                if (expire == 0) return false; // 空项：键不在表中
+                if (!(k == key)) continue;
+                if (egen != gen || expire <= now) return false;
+
+                ans.m_ruleId = ruleId;
+                ans.m_verdict = verdict;
+                return true;
+            }
+            return false;
+        }
+
+        // 分离共享内存
+        void detach()
+        {
+            if (m_shm != nullptr) shmdt(m_shm);
+            m_shm = nullptr;
+        }
+
+        ~cvcache()
+        {
+            detach();
+        }
+    };
+
+    /**
+     * @brief 到判定服务的一个连接（客户端，每个线程各自持有一个，不加锁）
+     * @note 1）连接用syscall(SYS_connect)建立，不经过被劫持的connect；
+     *       2）fork出的子进程或uid改变后第一次查询时自动重连（服务端按连接记录进程身份）；
+     *       3）超时的查询的迟到应答按序号丢弃，不会被当作下一次查询的结果。
+     */
+    class cvconn : public TypeNonCopyableMovable
+    {
+    private:
+        int m_fd = -1;           // 套接字
+        int32_t m_pid = 0;       // 建立连接时的进程ID
+        uint32_t m_uid = 0;      // 建立连接时的uid
+        uint32_t m_seq = 0;      // 下一批查询的起始序号
+        int64_t m_retryAt = 0;   // 连接失败后，下一次允许重连的时间（毫秒）
+
+        // 建立连接（失败后1秒内不再重试）
+        bool open(const char* sockpath)
+        {
+            int64_t now = vnowms();
+            if (now < m_retryAt) return false;
+
+            m_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+            if (m_fd >= 0)
+            {
+                struct sockaddr_un sa;
+                memset(&sa, 0, sizeof(sa));
+                sa.sun_family = AF_UNIX;
+                strncpy(sa.sun_path, sockpath, sizeof(sa.sun_path) - 1);
+                if (syscall(SYS_connect, m_fd, reinterpret_cast<struct sockaddr*>(&sa), sizeof(sa)) == 0)
+                {
+                    m_pid = static_cast<int32_t>(getpid());
+                    m_uid = static_cast<uint32_t>(getuid());
+                    return true;
+                }
+                ::close(m_fd);
+                m_fd = -1;
+            }
+            m_retryAt = now + 1000;
+            return false;
+        }
+
+    public:
+        cvconn() = default;
+
+        /**
+         * @brief 发送一批查询并等待应答
+         * @param sockpath 判定服务的套接字路径
+         * @param qs 查询数组（m_seq由本函数填写）
+         * @param as 输出：应答数组（与qs一一对应）
+         * @param n 查询数（不超过VBATCHMAX）
+         * @param deadlineMs 最长等待时间（毫秒，含建立连接）
+         * @return 收到应答的数量（小于n时，未收到应答的as[i].m_seq为0）；服务不可用返回-1
+         */
+        int query(const char* sockpath, st_vquery* qs, st_vanswer* as, size_t n, int deadlineMs)
+        {
+            if (n == 0 || n > VBATCHMAX) return -1;
+            int64_t deadline = vnowms() + deadlineMs;
+
+            if (m_fd >= 0 && (m_pid != static_cast<int32_t>(getpid()) || m_uid != static_cast<uint32_t>(getuid()))) close();
+            if (m_fd < 0 && !open(sockpath)) return -1;
+
+            uint32_t base = m_seq + 1;
+            if (base == 0 || base + n < base) base = 1; // 序号回绕时跳过0
+            for (size_t ii = 0; ii < n; ++ii)
+            {
+                qs[ii].m_seq = base + static_cast<uint32_t>(ii);
+                as[ii].m_seq = 0;
+            }
+            m_seq = base + static_cast<uint32_t>(n) - 1;
+
+            if (send(m_fd, qs, n * sizeof(st_vquery), MSG_NOSIGNAL | MSG_DONTWAIT) != static_cast<ssize_t>(n * sizeof(st_vquery)))
+            {
+                if (errno != EAGAIN) close(); // 服务端积压时不断开，本次按不可用处理
+                return -1;
+            }
+
+            size_t got = 0;
+            st_vanswer buf[VBATCHMAX];
+            while (got < n)
+            {
+                int wait = static_cast<int>(deadline - vnowms());
+                if (wait < 0) break;
+
+                struct pollfd pfd = {m_fd, POLLIN, 0};
+                int ret = poll(&pfd, 1, wait);
+                if (ret < 0 && errno == EINTR) continue;
+                if (ret <= 0) break;
+
+                ssize_t len = recv(m_fd, buf, sizeof(buf), MSG_DONTWAIT);
+                if (len < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+                if (len <= 0)
+                {
+                    close(); // 服务端关闭了连接
+                    break;
+                }
+
+                for (size_t jj = 0; jj < static_cast<size_t>(len) / sizeof(st_vanswer); ++jj)
+                {
+                    uint32_t idx = buf[jj].m_seq - base;
+                    if (idx >= n || as[idx].m_seq != 0) continue; // 之前超时的查询的迟到应答
+                    as[idx] = buf[jj];
+                    ++got;
+                }
+            }
+            return static_cast<int>(got);
+        }
+
+        // 关闭连接
+        void close()
+        {
+            if (m_fd >= 0) ::close(m_fd);
+            m_fd = -1;
+        }
+
+        ~cvconn()
+        {
+            close();
+        }
+    };
+
+    // 服务端记录的一个客户端连接
+    struct st_vpeer
+    {
+        int m_fd;           // 套接字
+        int32_t m_pid;      // 连接建立时的进程ID
+        uint32_t m_uid;     // 进程的uid
+        uint64_t m_exeHash; // 可执行文件路径的哈希
+        std::string m_exe;  // 可执行文件路径
+    };
+
+    /**
+     * @brief 判定服务端（判定守护进程使用）
+     * @note 负责创建缓存共享内存和监听套接字、批量收发查询、把应答写入缓存；判定逻辑由poll()的回调提供。
+     *       只有一个线程调用poll()（缓存单写者）。
+     */
+    class cvserver : public TypeNonCopyableMovable
+    {
+    private:
+        int m_shmid = -1;                             // 共享内存ID
+        st_vcache* m_shm = nullptr;                   // 指向共享内存的指针
+        int m_listenfd = -1;                          // 监听套接字
+        int m_epfd = -1;                              // epoll
+        std::string m_sockPath;                       // 套接字路径
+        std::unordered_map<int, st_vpeer> m_peers;    // 客户端连接
+        uint64_t m_queries = 0;                       // 累计查询数
+        uint64_t m_batches = 0;                       // 累计sendmmsg次数
+
+        // 接受全部待处理的连接
+        void acceptall()
+        {
+            while (true)
+            {
+                int fd = accept4(m_listenfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) return;
+
+                struct ucred cred;
+                socklen_t clen = sizeof(cred);
+                char exe[PATH_MAX] = {0};
+                ssize_t len = -1;
+                if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &clen) == 0)
+                {
+                    char proc[64];
+                    snprintf(proc, sizeof(proc), "/proc/%d/exe", cred.pid);
+                    len = readlink(proc, exe, sizeof(exe) - 1);
+                }
+                if (len <= 0) // 取不到身份的连接不服务
+                {
+                    ::close(fd);
+                    continue;
+                }
+
+                st_vpeer& peer = m_peers[fd];
+                peer.m_fd = fd;
+                peer.m_pid = cred.pid;
+                peer.m_uid = cred.uid;
+                peer.m_exe.assign(exe, static_cast<size_t>(len));
+                peer.m_exeHash = vexehash(exe, static_cast<size_t>(len));
+
+                struct epoll_event ev;
+                ev.events = EPOLLIN | EPOLLRDHUP;
+                ev.data.fd = fd;
+                epoll_ctl(m_epfd, EPOLL_CTL_ADD, fd, &ev);
+            }
+        }
+
+        // 关闭一个客户端连接
+        void closepeer(int fd)
+        {
+            epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, nullptr);
+            ::close(fd);
+            m_peers.erase(fd);
+        }
+
+        // 写入一个缓存项（单写者：序号锁加1为奇数，写完再加1）
+        void publish(const st_vkey& key, const st_vanswer& ans, uint32_t gen, uint32_t now)
+        {
+            // 探测窗口内：同键的项 > 已失效的项（过期或策略版本不同）> 空项 > 最早过期的项。
+            // 缓存项只在守护进程启动时清空，键不会出现在空项之后，遇到空项即可停止查找。
+            size_t slot = vslot(key);
+            st_ventry* victim = nullptr;
+            bool victimStale = false;
+            for (size_t ii = 0; ii < VCACHEPROBE; ++ii)
+            {
+                st_ventry& e = m_shm->m_entry[(slot + ii) & (VCACHECAP - 1)];
+                if (e.m_expire == 0)
+                {
+                    if (victim == nullptr) victim = &e;
+                    break;
+                }
+                if (e.m_key == key)
+                {
+                    victim = &e;
+                    break;
+                }
+                bool stale = e.m_gen != gen || e.m_expire <= now;
+                if (stale && !victimStale)
+                {
+                    victim = &e;
+                    victimStale = true;
+                }
+                else if (!victimStale && (victim == nullptr || e.m_expire < victim->m_expire))
+                    victim = &e;
+            }
+
+            uint32_t seq = victim->m_seq.load(std::memory_order_relaxed);
+            victim->m_seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            memcpy(&victim->m_key, &key, sizeof(key));
+            victim->m_gen = gen;
+            victim->m_ruleId = ans.m_ruleId;
+            victim->m_verdict = ans.m_verdict;
+            victim->m_expire = now + ans.m_ttl;
+            victim->m_seq.store(seq + 2, std::memory_order_release);
+        }
+
+    public:
+        cvserver() = default;
+
+        /**
+         * @brief 创建（或接管）缓存共享内存，监听套接字
+         * @param sockpath 套接字路径（已存在时先删除）
+         * @param shmkey 共享内存的key（默认SHMKEYVC）
+         * @return true-成功，false-失败（上一个守护进程仍存活时也返回false）
+         */
+        bool create(const std::string& sockpath, key_t shmkey = SHMKEYVC)
+        {
+            if (sockpath.empty() || sockpath.size() >= sizeof(m_shm->m_sockPath)) return false;
+
+            // 缓存对所有用户只读（被注入进程只读挂接），只有守护进程能写
+            m_shmid = shmget(shmkey, sizeof(st_vcache), 0644 | IPC_CREAT);
+            if (m_shmid == -1) return false;
+
+            void* addr = shmat(m_shmid, nullptr, 0);
+            if (addr == (void*)-1)
+            {
+                m_shmid = -1;
+                return false;
+            }
+            m_shm = static_cast<st_vcache*>(addr);
+
+            int32_t owner = m_shm->m_ownerPid.load(std::memory_order_acquire);
+            if (owner != 0 && owner != static_cast<int32_t>(getpid()) && (kill(owner, 0) == 0 || errno != ESRCH))
+            {
+                shmdt(m_shm);
+                m_shm = nullptr;
+                return false;
+            }
+
+            // 上一个守护进程留下的缓存项不可信（策略可能已改变），全部清空
+            memset(static_cast<void*>(m_shm->m_entry), 0, sizeof(m_shm->m_entry));
+            m_shm->m_gen.store(1, std::memory_order_relaxed);
+            strncpy(m_shm->m_sockPath, sockpath.c_str(), sizeof(m_shm->m_sockPath) - 1);
+            m_shm->m_magic.store(VCACHEMAGIC, std::memory_order_release);
+
+            // 监听套接字（所有用户的进程都能连接）
+            m_sockPath = sockpath;
+            unlink(sockpath.c_str());
+            m_listenfd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            struct sockaddr_un sa;
+            memset(&sa, 0, sizeof(sa));
+            sa.sun_family = AF_UNIX;
+            strncpy(sa.sun_path, sockpath.c_str(), sizeof(sa.sun_path) - 1);
+            if (m_listenfd < 0 || bind(m_listenfd, reinterpret_cast<struct sockaddr*>(&sa), sizeof(sa)) != 0 ||
+                chmod(sockpath.c_str(), 0666) != 0 || listen(m_listenfd, 1024) != 0)
+            {
+                close();
+                return false;
+            }
+
+            m_epfd = epoll_create1(EPOLL_CLOEXEC);
+            struct epoll_event ev;
+            ev.events = EPOLLIN;
+            ev.data.fd = m_listenfd;
+            if (m_epfd < 0 || epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_listenfd, &ev) != 0)
+            {
+                close();
+                return false;
+            }
+
+            m_shm->m_ownerPid.store(static_cast<int32_t>(getpid()), std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 等待并处理查询（每个可读连接取出积压的报文，逐条判定后批量应答，结果写入缓存）
+         * @tparam Func 判定函数类型，签名为void(const st_vpeer&, const st_vquery&, st_vanswer&)，
+         *         需填写m_verdict、m_ruleId和m_ttl（m_ttl为0时不写缓存）
+         * @param func 判定函数
+         * @param timeoutMs epoll等待时间（毫秒）
+         * @return 本轮处理的查询数
+         */
+        template <typename Func>
+        size_t poll(Func&& func, int timeoutMs)
+        {
+            if (m_epfd < 0) return 0;
+
+            struct epoll_event evs[64];
+            int nev = epoll_wait(m_epfd, evs, 64, timeoutMs);
+            if (nev <= 0) return 0;
+
+            // 每个报文最多VBATCHMAX条查询，收发缓冲区放在栈上
+            st_vquery qbuf[VRECVBATCH][VBATCHMAX];
+            st_vanswer abuf[VRECVBATCH][VBATCHMAX];
+            struct iovec qiov[VRECVBATCH], aiov[VRECVBATCH];
+            struct mmsghdr qmsg[VRECVBATCH], amsg[VRECVBATCH];
+
+            uint32_t gen = m_shm->m_gen.load(std::memory_order_relaxed);
+            uint32_t now = vnow();
+            size_t total = 0;
+            for (int ii = 0; ii < nev; ++ii)
+            {
+                int fd = evs[ii].data.fd;
+                if (fd == m_listenfd)
+                {
+                    acceptall();
+                    continue;
+                }
+
+                auto it = m_peers.find(fd);
+                if (it == m_peers.end()) continue;
+                const st_vpeer& peer = it->second;
+
+                if (evs[ii].events & EPOLLIN)
+                {
+                    memset(qmsg, 0, sizeof(qmsg));
+                    for (size_t jj = 0; jj < VRECVBATCH; ++jj)
+                    {
+                        qiov[jj].iov_base = qbuf[jj];
+                        qiov[jj].iov_len = sizeof(qbuf[jj]);
+                        qmsg[jj].msg_hdr.msg_iov = &qiov[jj];
+                        qmsg[jj].msg_hdr.msg_iovlen = 1;
+                    }
+                    int nmsg = recvmmsg(fd, qmsg, VRECVBATCH, MSG_DONTWAIT, nullptr);
+
+                    // 长度为0的报文表示对端已关闭（客户端不发送空报文），其后的都不是查询
+                    bool eof = nmsg == 0;
+                    for (int jj = 0; jj < nmsg; ++jj)
+                    {
+                        if (qmsg[jj].msg_len == 0)
+                        {
+                            nmsg = jj;
+                            eof = true;
+                            break;
+                        }
+                    }
+
+                    // 逐条判定，应答与查询报文一一对应
+                    memset(amsg, 0, sizeof(amsg));
+                    for (int jj = 0; jj < nmsg; ++jj)
+                    {
+                        size_t nq = qmsg[jj].msg_len / sizeof(st_vquery);
+                        for (size_t kk = 0; kk < nq; ++kk)
+                        {
+                            const st_vquery& q = qbuf[jj][kk];
+                            st_vanswer& a = abuf[jj][kk];
+                            memset(&a, 0, sizeof(a));
+                            a.m_seq = q.m_seq;
+                            a.m_ruleId = -1;
+                            func(peer, q, a);
+
+                            if (a.m_ttl > 0)
+                            {
+                                st_vkey key;
+                                memset(&key, 0, sizeof(key));
+                                key.m_exeHash = peer.m_exeHash;
+                                key.m_uid = peer.m_uid;
+                                key.m_family = q.m_family;
+                                key.m_port = q.m_port;
+                                memcpy(key.m_addr, q.m_addr, sizeof(key.m_addr));
+                                publish(key, a, gen, now);
+                            }
+                        }
+                        aiov[jj].iov_base = abuf[jj];
+                        aiov[jj].iov_len = nq * sizeof(st_vanswer);
+                        amsg[jj].msg_hdr.msg_iov = &aiov[jj];
+                        amsg[jj].msg_hdr.msg_iovlen = 1;
+                        total += nq;
+                    }
+
+                    // 一次sendmmsg批量应答（客户端已超时断开时发送失败，直接丢弃）
+                    if (nmsg > 0)
+                    {
+                        sendmmsg(fd, amsg, static_cast<unsigned>(nmsg), MSG_DONTWAIT | MSG_NOSIGNAL);
+                        ++m_batches;
+                    }
+                    if (eof || (nmsg < 0 && errno != EAGAIN && errno != EINTR))
+                    {
+                        closepeer(fd);
+                        continue;
+                    }
+                }
+
+                // 对端关闭：积压的查询已在上面处理完
+                if (evs[ii].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) closepeer(fd);
+            }
+            m_queries += total;
+            return total;
+        }
+
+        /**
+         * @brief 使全部缓存项失效（重新加载策略后调用）
+         */
+        void invalidate()
+        {
+            if (m_shm == nullptr) return;
+            uint32_t gen = m_shm->m_gen.load(std::memory_order_relaxed) + 1;
+            if (gen == 0) gen = 1;
+            m_shm->m_gen.store(gen, std::memory_order_release);
+        }
+
+        // 当前连接数
+        size_t peernum() const { return m_peers.size(); }
+
+        // 累计查询数
+        uint64_t queries() const { return m_queries; }
+
+        // 累计应答批次数（平均每批查询数 = queries() / batches()）
+        uint64_t batches() const { return m_batches; }
+
+        // 关闭全部连接和监听套接字，分离共享内存（不删除，被注入进程可能仍在挂接）
+        void close()
+        {
+            for (auto& kv : m_peers) ::close(kv.first);
+            m_peers.clear();
+            if (m_epfd >= 0) ::close(m_epfd);
+            m_epfd = -1;
+            if (m_listenfd >= 0)
+            {
+                ::close(m_listenfd);
+                unlink(m_sockPath.c_str());
+            }
+            m_listenfd = -1;
+            if (m_shm != nullptr)
+            {
+                if (m_shm->m_ownerPid.load(std::memory_order_relaxed) == static_cast<int32_t>(getpid()))
+                    m_shm->m_ownerPid.store(0, std::memory_order_release);
+                shmdt(m_shm);
+            }
+            m_shm = nullptr;
+            m_shmid = -1;
+        }
+
+        ~cvserver()
+        {
+            close();
+        }
+    };
+    // ===========================================================================
+#endif // __linux__
+
+} // namespace ol
+
+#endif // !OL_VERDICT_H
@@ -0,0 +1,505 @@
+#include "ol_public.h"
+#include "ol_XmlScanner.h"     // 引入OL流式XML扫描器
+#include "policy/policy_set.h" // 引入策略引擎libpolicy
+#include "url_breaker_spec.h"  // 特化版本的策略表结构和哈希函数（与被注入进程共用）
+#include <algorithm>
+#include <map>
+#include <string>
+#include <time.h>
+#include <utility>
+#include <vector>
+
+using namespace ol;
+using namespace std;
+
+// ===================== 全局配置 =====================
+const int MAX_BLACKLIST = 100;      // 与被注入进程一致
+const uint32_t MAX_DISPLACE = 1u << 20; // 每个桶尝试的位移种子上限，超过时扩大哈希表重试
+
+// 读取配置得到的全部内容（规则编号为entries的下标，与通用版本的g_Blacklist一致）
+struct st_genpolicy
+{
+    policy::PolicySet m_policy;
+    vector<spec::st_specentry> m_entries; // m_url指向m_urls中的字符串
+    vector<string> m_urls;
+};
+
+/**
+ * @brief 读取配置文件（与被注入进程的解析规则、条目顺序和规则编号一致）
+ * @param path 配置文件
+ * @param gp 输出：策略
+ * @return 打开失败返回false
+ */
+static bool load_policy(const string& path, st_genpolicy& gp)
+{
+    cmmapfile mfile;
+    if (!mfile.open(path)) return false;
+
+    int blacklist_count = 0;
+    int rule_ordinal = 0, feed_ordinal = 0;
+    int pending_start = -1;
+    vector<pair<string, int>> feeds;
+    XmlScanner scanner(mfile.view());
+    XmlToken tok;
+    while (scanner.next(tok))
+    {
+        string_view load = deleteLRspace(tok.m_value);
+
+        if (tok.m_tag == "StartInterceptTime")
+        {
+            int parsed_time = 0;
+            if (!policy::Schedule::parseTime(load.data(), load.size(), parsed_time)) continue;
+            if (pending_start >= 0) gp.m_policy.schedule().addRange(pending_start, policy::Schedule::MINUTES_PER_DAY);
+            pending_start = parsed_time;
+        }
+        else if (tok.m_tag == "EndInterceptTime")
+        {
+            int parsed_time = 0;
+            if (!policy::Schedule::parseTime(load.data(), load.size(), parsed_time)) continue;
+            gp.m_policy.schedule().addRange(pending_start >= 0 ? pending_start : 0, parsed_time);
+            pending_start = -1;
+        }
+        else if (tok.m_tag == "WhitelistProc")
+        {
+            if (!load.empty()) gp.m_policy.addWhitelist(string(load));
+        }
+        else if (tok.m_tag == "BlacklistEntry")
+        {
+            int rule_id = rule_ordinal++;
+            if (load.empty() || blacklist_count >= MAX_BLACKLIST) continue;
+
+            int index = static_cast<int>(gp.m_urls.size());
+            policy::NetRule rule;
+            policy::TargetKind kind = gp.m_policy.addTarget(load.data(), load.size(), index, policy::PROTO_TCP | policy::PROTO_UDP, &rule);
+            if (kind == policy::TARGET_INVALID)
+            {
+                printf("⚠️ 无效的黑名单条目：%.*s，跳过该条目\n", (int)load.size(), load.data());
+                continue;
+            }
+            if (kind == policy::TARGET_NET)
+                gp.m_urls.push_back(rule.m_family == policy::FAMILY_ANY ? "*" : policy::formatAddr(rule));
+            else
+                gp.m_urls.push_back(gp.m_policy.domains().back().m_host);
+            gp.m_entries.push_back({nullptr, kind == policy::TARGET_DOMAIN, rule_id});
+            blacklist_count++;
+        }
+        else if (tok.m_tag == "BlacklistFeed")
+        {
+            int rule_id = -2 - feed_ordinal++;
+            if (!load.empty()) feeds.emplace_back(string(load), rule_id);
+        }
+    }
+
+    if (!scanner.ok())
+        printf("⚠️ 配置文件格式错误（第%zu行：%s），其后的配置被忽略\n", scanner.errorLine(), scanner.error());
+
+    // 列表文件在扫描完配置后加载（与被注入进程一致）
+    for (const auto& feed : feeds)
+    {
+        string error;
+        policy::FeedStats st;
+        int index = static_cast<int>(gp.m_urls.size());
+        if (!gp.m_policy.addFeed(feed.first, index, policy::PROTO_TCP | policy::PROTO_UDP, st, error))
+            printf("⚠️ 读取黑名单列表失败：%s（%s）\n", feed.first.c_str(), error.c_str());
+        if (st.m_nets == 0) continue;
+        gp.m_urls.push_back(feed.first);
+        gp.m_entries.push_back({nullptr, false, feed.second});
+        printf("✅ 加载黑名单列表：%s（%s）\n", feed.first.c_str(), st.toString().c_str());
+    }
+
+    if (pending_start >= 0) gp.m_policy.schedule().addRange(pending_start, policy::Schedule::MINUTES_PER_DAY);
+    if (gp.m_policy.schedule().empty()) gp.m_policy.schedule().setAllDay();
+    gp.m_policy.compile();
+
+    for (size_t ii = 0; ii < gp.m_entries.size(); ++ii) gp.m_entries[ii].m_url = gp.m_urls[ii].c_str();
+    return true;
+}
+
+// 转义为C++字符串字面量
+static string quote(const string& s)
+{
+    string out = "\"";
+    for (unsigned char c : s)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += static_cast<char>(c);
+        }
+        else if (c < 0x20 || c == 0x7f)
+            out += sformat("\\%03o", c);
+        else
+            out += static_cast<char>(c);
+    }
+    return out + "\"";
+}
+
+// 大端字节序的地址 → 主机字节序整数
+static uint32_t load_be32(const uint8_t* p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+static uint64_t load_be64(const uint8_t* p)
+{
+    return (static_cast<uint64_t>(load_be32(p)) << 32) | load_be32(p + 4);
+}
+
+/**
+ * @brief 完美哈希表
+ * @note 两级结构：spec_hash(key, 0)选桶，桶内所有键用同一个位移种子d映射到spec_hash(key, d)对应的槽位；
+ *       按桶的大小从大到小依次为每个桶寻找使其全部键落入空槽且互不冲突的d（平均每桶2个键、装载率不超过0.8）。
+ */
+struct st_perfecthash
+{
+    uint32_t m_buckets = 1;       // 桶数（2的幂）
+    uint32_t m_size = 1;          // 槽位数（2的幂）
+    vector<uint32_t> m_disp;      // 每个桶的位移种子（从1开始）
+    vector<int64_t> m_slot;       // 每个槽位中的键的下标（-1表示空槽）
+
+    bool build(const vector<uint32_t>& keys)
+    {
+        size_t n = keys.size();
+        m_buckets = 1;
+        while (m_buckets * 2 <= n / 2) m_buckets *= 2;
+        m_size = 1;
+        while (m_size < n + n / 4) m_size *= 2;
+
+        for (int attempt = 0; attempt < 4; ++attempt, m_size *= 2)
+        {
+            vector<vector<uint32_t>> buckets(m_buckets);
+            for (size_t ii = 0; ii < n; ++ii) buckets[spec::spec_hash(keys[ii], 0) & (m_buckets - 1)].push_back(static_cast<uint32_t>(ii));
+
+            vector<uint32_t> order(m_buckets);
+            for (uint32_t ii = 0; ii < m_buckets; ++ii) order[ii] = ii;
+            stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+            m_disp.assign(m_buckets, 1);
+            m_slot.assign(m_size, -1);
+            bool ok = true;
+            vector<uint32_t> slots;
+            for (uint32_t b : order)
+            {
+                const vector<uint32_t>& bucket = buckets[b];
+                if (bucket.empty()) break;
+
+                uint32_t d = 1;
+                for (; d < MAX_DISPLACE; ++d)
+                {
+                    slots.clear();
+                    bool fit = true;
+                    for (uint32_t k : bucket)
+                    {
+                        uint32_t s = spec::spec_hash(keys[k], d) & (m_size - 1);
+                        if (m_slot[s] >= 0 || find(slots.begin(), slots.end(), s) != slots.end())
+                        {
+                            fit = false;
+                            break;
+                        }
+                        slots.push_back(s);
+                    }
+                    if (fit) break;
+                }
+                if (d == MAX_DISPLACE)
+                {
+                    ok = false;
+                    break;
+                }
+                m_disp[b] = d;
+                for (size_t ii = 0; ii < bucket.size(); ++ii) m_slot[slots[ii]] = bucket[ii];
+            }
+            if (ok) return true;
+        }
+        return false;
+    }
+};
+
+// 地址范围（排序合并用）
+template <typename T>
+struct st_range
+{
+    T m_lo, m_hi;
+    int m_ruleId;
+};
+
+typedef pair<uint64_t, uint64_t> u128pair; // IPv6地址（高64位、低64位）
+
+// 下一个/上一个地址（调用者保证不越界）
+static uint32_t next_addr(uint32_t v) { return v + 1; }
+static uint32_t prev_addr(uint32_t v) { return v - 1; }
+static u128pair next_addr(const u128pair& v) { return v.second == ~0ULL ? u128pair(v.first + 1, 0) : u128pair(v.first, v.second + 1); }
+static u128pair prev_addr(const u128pair& v) { return v.second == 0 ? u128pair(v.first - 1, ~0ULL) : u128pair(v.first, v.second - 1); }
+
+/**
+ * @brief 同一端口位图的地址范围拆成互不重叠、按起点排序的段（与RangeTable::build的优先级一致）
+ * @param ranges 网段对应的地址范围（网段之间只有包含或不相交两种关系）
+ * @note 每段取覆盖它的网段中编号最小的，只有编号相同的相邻段才合并；
+ *       不能把重叠的范围整体合并后取最小编号，否则只被列表覆盖的地址会记到配置条目上（或相反）
+ */
+template <typename T>
+static void merge_ranges(vector<st_range<T>>& ranges)
+{
+    sort(ranges.begin(), ranges.end(), [](const st_range<T>& a, const st_range<T>& b)
+         { return a.m_lo != b.m_lo ? a.m_lo < b.m_lo : a.m_hi > b.m_hi; });
+
+    vector<st_range<T>> out;
+    vector<st_range<T>> stack; // 当前嵌套的外层范围（m_ruleId为从最外层到该层的最小编号）
+    T cursor{};                // 下一个未输出的地址
+    bool done = false;         // 已输出到地址空间末尾
+    auto emit = [&](const T& lo, const T& hi, int id)
+    {
+        if (!out.empty() && out.back().m_ruleId == id && next_addr(out.back().m_hi) == lo)
+            out.back().m_hi = hi;
+        else
+            out.push_back({lo, hi, id});
+    };
+    // 输出栈顶范围的剩余部分并出栈（到达地址空间末尾时不再推进cursor）
+    auto popTop = [&]()
+    {
+        const st_range<T> top = stack.back();
+        stack.pop_back();
+        if (done || cursor > top.m_hi) return;
+        emit(cursor, top.m_hi, top.m_ruleId);
+        T next = next_addr(top.m_hi);
+        if (next < top.m_hi)
+            done = true; // 回绕：外层的范围也到此为止
+        else
+            cursor = next;
+    };
+
+    for (const st_range<T>& r : ranges)
+    {
+        while (!stack.empty() && stack.back().m_hi < r.m_lo) popTop();
+        if (!stack.empty() && cursor < r.m_lo) emit(cursor, prev_addr(r.m_lo), stack.back().m_ruleId);
+        int id = stack.empty() ? r.m_ruleId : min(r.m_ruleId, stack.back().m_ruleId);
+        stack.push_back({r.m_lo, r.m_hi, id});
+        cursor = r.m_lo;
+    }
+    while (!stack.empty()) popTop();
+    ranges.swap(out);
+}
+
+/**
+ * @brief 生成策略头文件
+ * @param gp 策略
+ * @param source 配置文件路径（写入注释和kSource）
+ * @param out 输出文件
+ * @return 写入失败返回false
+ */
+static bool generate(const st_genpolicy& gp, const string& source, const string& out)
+{
+    const policy::PolicySet& ps = gp.m_policy;
+
+    // 端口范围 → 端口位图编号（所有端口为0）
+    map<pair<uint16_t, uint16_t>, uint32_t> portSets;
+    auto portSet = [&](uint16_t lo, uint16_t hi) -> uint32_t
+    {
+        if (lo == 0 && hi == 65535) return 0;
+        auto it = portSets.find(make_pair(lo, hi));
+        if (it != portSets.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(portSets.size()) + 1;
+        portSets[make_pair(lo, hi)] = id;
+        return id;
+    };
+
+    // 单个IPv4地址 → 完美哈希；其余按端口位图分组为地址范围
+    size_t netRanges = 0;
+    map<uint32_t, vector<spec::st_specport>> exact;
+    map<uint32_t, vector<st_range<uint32_t>>> ranges4;
+    map<uint32_t, vector<st_range<u128pair>>> ranges6;
+    for (const policy::NetRule& r : ps.rules())
+    {
+        uint32_t set = portSet(r.m_portLo, r.m_portHi);
+        if (r.m_family == policy::FAMILY_V4)
+        {
+            uint32_t lo = load_be32(r.m_addr);
+            if (r.m_prefixLen == 32)
+            {
+                exact[lo].push_back({set, r.m_ruleId});
+                continue;
+            }
+            ++netRanges;
+            uint32_t hostmask = r.m_prefixLen == 0 ? 0xFFFFFFFFu : (0xFFFFFFFFu >> r.m_prefixLen);
+            ranges4[set].push_back({lo, lo | hostmask, r.m_ruleId});
+        }
+        else
+        {
+            u128pair lo(load_be64(r.m_addr), load_be64(r.m_addr + 8)), hi = lo;
+            int len = r.m_prefixLen;
+            if (len < 64)
+            {
+                hi.first |= len == 0 ? ~0ULL : (~0ULL >> len);
+                hi.second = ~0ULL;
+            }
+            else if (len < 128)
+                hi.second |= ~0ULL >> (len - 64);
+            ranges6[set].push_back({lo, hi, r.m_ruleId});
+            ++netRanges;
+        }
+    }
+
+    vector<uint32_t> keys;
+    for (const auto& kv : exact) keys.push_back(kv.first);
+    st_perfecthash ph;
+    if (!ph.build(keys))
+    {
+        printf("❌ 构建完美哈希表失败（%zu个地址）\n", keys.size());
+        return false;
+    }
+
+    FILE* fp = fopen(out.c_str(), "w");
+    if (fp == nullptr) return false;
+
+    time_t now = time(NULL);
+    char tbuf[32];
+    strftime(tbuf, sizeof(tbuf), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+    fprintf(fp, "// 由policy_codegen根据%s生成（%s），请勿手工修改；策略改变后执行make specialized重新生成\n", source.c_str(), tbuf);
+    fprintf(fp, "// 黑名单%zu条（编译后：单个IPv4地址%zu个、网段%zu个），域名%zu条，白名单进程%zu个，拦截时间段：%s\n\n",
+            gp.m_entries.size(), keys.size(), netRanges, ps.domains().size(), ps.whitelist().size(), ps.schedule().toString().c_str());
+    fprintf(fp, "#ifndef URL_BREAKER_POLICY_H\n#define URL_BREAKER_POLICY_H 1\n\n#include \"url_breaker_spec.h\"\n\nnamespace spec\n{\n\n");
+    fprintf(fp, "    constexpr const char* kSource = %s;\n", quote(source).c_str());
+    fprintf(fp, "    constexpr const char* kSchedText = %s;\n\n", quote(ps.schedule().toString()).c_str());
+
+    // 拦截时间段（每分钟一位）
+    uint64_t sched[(policy::Schedule::MINUTES_PER_DAY + 63) / 64] = {};
+    for (int mm = 0; mm < policy::Schedule::MINUTES_PER_DAY; ++mm)
+        if (ps.schedule().contains(mm)) sched[mm >> 6] |= 1ULL << (mm & 63);
+    fprintf(fp, "    constexpr std::array<uint64_t, %zu> kSchedule = {{", sizeof(sched) / sizeof(sched[0]));
+    for (size_t ii = 0; ii < sizeof(sched) / sizeof(sched[0]); ++ii) fprintf(fp, "%s0x%016llxULL", ii == 0 ? "\n        " : (ii % 4 ? ", " : ",\n        "), (unsigned long long)sched[ii]);
+    fprintf(fp, "}};\n\n");
+
+    // 黑名单条目、域名、白名单
+    fprintf(fp, "    constexpr std::array<st_specentry, %zu> kEntries = {{", gp.m_entries.size());
+    for (const auto& e : gp.m_entries) fprintf(fp, "\n        {%s, %s, %d},", quote(e.m_url).c_str(), e.m_isDomain ? "true" : "false", e.m_ruleId);
+    fprintf(fp, "}};\n\n");
+
+    fprintf(fp, "    constexpr std::array<st_specdomain, %zu> kDomains = {{", ps.domains().size());
+    for (const auto& d : ps.domains()) fprintf(fp, "\n        {%s, %u, %u, %d},", quote(d.m_host).c_str(), d.m_portLo, d.m_portHi, d.m_ruleId);
+    fprintf(fp, "}};\n\n");
+
+    fprintf(fp, "    // 规整后排序（与PolicySet::whitelist()一致）\n");
+    fprintf(fp, "    constexpr std::array<const char*, %zu> kWhitelist = {{", ps.whitelist().size());
+    for (const auto& w : ps.whitelist()) fprintf(fp, "\n        %s,", quote(w).c_str());
+    fprintf(fp, "}};\n\n");
+
+    // 端口位图
+    vector<pair<uint16_t, uint16_t>> setRanges(portSets.size());
+    for (const auto& kv : portSets) setRanges[kv.second - 1] = kv.first;
+    fprintf(fp, "    constexpr std::array<st_specportset, %zu> kPortSets = {{", setRanges.size());
+    for (size_t ii = 0; ii < setRanges.size(); ++ii)
+    {
+        uint64_t bits[1024] = {};
+        for (uint32_t p = setRanges[ii].first; p <= setRanges[ii].second; ++p) bits[p >> 6] |= 1ULL << (p & 63);
+        fprintf(fp, "\n        // %zu：端口%u-%u\n        {{", ii + 1, setRanges[ii].first, setRanges[ii].second);
+        for (int jj = 0; jj < 1024; ++jj)
+        {
+            if (bits[jj] == 0)
+                fprintf(fp, "%s0", jj == 0 ? "" : ",");
+            else
+                fprintf(fp, "%s0x%llxULL", jj == 0 ? "" : ",", (unsigned long long)bits[jj]);
+        }
+        fprintf(fp, "}},");
+    }
+    fprintf(fp, "}};\n\n");
+
+    // 单个IPv4地址的完美哈希表
+    vector<spec::st_specport> ports;
+    fprintf(fp, "    constexpr uint32_t kV4Buckets = %u; // 桶数（2的幂）\n", ph.m_buckets);
+    fprintf(fp, "    constexpr uint32_t kV4Size = %u;    // 槽位数（2的幂）\n", ph.m_size);
+    fprintf(fp, "    constexpr std::array<uint32_t, %u> kV4Disp = {{", ph.m_buckets);
+    for (uint32_t ii = 0; ii < ph.m_buckets; ++ii) fprintf(fp, "%s%u", ii == 0 ? "\n        " : (ii % 16 ? ", " : ",\n        "), ph.m_disp[ii]);
+    fprintf(fp, "}};\n");
+    fprintf(fp, "    constexpr std::array<st_specslot, %u> kV4Table = {{", ph.m_size);
+    for (uint32_t ii = 0; ii < ph.m_size; ++ii)
+    {
+        const char* sep = ii % 4 ? " " : "\n        ";
+        if (ph.m_slot[ii] < 0)
+        {
+            fprintf(fp, "%s{0, 0, 0},", sep);
+            continue;
+        }
+        uint32_t key = keys[ph.m_slot[ii]];
+        const vector<spec::st_specport>& list = exact[key];
+        fprintf(fp, "%s{0x%08xu, %zu, %zu},", sep, key, ports.size(), list.size());
+        ports.insert(ports.end(), list.begin(), list.end());
+    }
+    fprintf(fp, "}};\n");
+    fprintf(fp, "    constexpr std::array<st_specport, %zu> kV4Ports = {{", ports.size());
+    for (size_t ii = 0; ii < ports.size(); ++ii) fprintf(fp, "%s{%u, %d},", ii % 8 ? " " : "\n        ", ports[ii].m_set, ports[ii].m_ruleId);
+    fprintf(fp, "}};\n\n");
+
+    // 网段（按端口位图分组）
+    vector<spec::st_specgroup> groups;
+    size_t total = 0;
+    for (auto& kv : ranges4)
+    {
+        merge_ranges(kv.second);
+        groups.push_back({kv.first, static_cast<uint32_t>(total), static_cast<uint32_t>(kv.second.size())});
+        total += kv.second.size();
+    }
+    fprintf(fp, "    constexpr std::array<st_specgroup, %zu> kV4Groups = {{", groups.size());
+    for (const auto& g : groups) fprintf(fp, "\n        {%u, %u, %u},", g.m_set, g.m_first, g.m_count);
+    fprintf(fp, "}};\n");
+    fprintf(fp, "    constexpr std::array<st_specrange4, %zu> kV4Ranges = {{", total);
+    size_t col = 0;
+    for (const auto& kv : ranges4)
+        for (const auto& r : kv.second) fprintf(fp, "%s{0x%08xu, 0x%08xu, %d},", col++ % 4 ? " " : "\n        ", r.m_lo, r.m_hi, r.m_ruleId);
+    fprintf(fp, "}};\n\n");
+
+    groups.clear();
+    total = 0;
+    for (auto& kv : ranges6)
+    {
+        merge_ranges(kv.second);
+        groups.push_back({kv.first, static_cast<uint32_t>(total), static_cast<uint32_t>(kv.second.size())});
+        total += kv.second.size();
+    }
+    fprintf(fp, "    constexpr std::array<st_specgroup, %zu> kV6Groups = {{", groups.size());
+    for (const auto& g : groups) fprintf(fp, "\n        {%u, %u, %u},", g.m_set, g.m_first, g.m_count);
+    fprintf(fp, "}};\n");
+    fprintf(fp, "    constexpr std::array<st_specrange6, %zu> kV6Ranges = {{", total);
+    for (const auto& kv : ranges6)
+        for (const auto& r : kv.second)
+            fprintf(fp, "\n        {0x%016llxULL, 0x%016llxULL, 0x%016llxULL, 0x%016llxULL, %d},",
+                    (unsigned long long)r.m_lo.first, (unsigned long long)r.m_lo.second,
+                    (unsigned long long)r.m_hi.first, (unsigned long long)r.m_hi.second, r.m_ruleId);
+    fprintf(fp, "}};\n\n");
+
+    fprintf(fp, "} // namespace spec\n\n#endif // !URL_BREAKER_POLICY_H\n");
+    bool ok = !ferror(fp);
+    fclose(fp);
+
+    printf("✅ 生成完成：%s\n", out.c_str());
+    printf("单个IPv4地址：%zu个（完美哈希表%u个桶、%u个槽位），端口位图：%zu个\n", keys.size(), ph.m_buckets, ph.m_size, setRanges.size());
+    printf("网段：IPv4 %zu组、IPv6 %zu组；域名：%zu条；白名单进程：%zu个；拦截时间段：%s\n",
+           ranges4.size(), ranges6.size(), ps.domains().size(), ps.whitelist().size(), ps.schedule().toString().c_str());
+    return ok;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        printf("用法：%s <配置文件> <输出头文件>\n", argv[0]);
+        printf("示例：%s /home/mysql/Projects/URL_Breaker/main/config.xml spec_build/url_breaker_policy.h\n", argv[0]);
+        printf("说明：把配置中的黑名单、列表文件、白名单和拦截时间段生成为编译期常量表，\n");
+        printf("      以-DURL_BREAKER_SPECIALIZED编译URL_Breaker.cpp得到该策略专用的url_breaker.so（make specialized）。\n");
+        printf("      专用版本不再读取配置文件，策略改变后需重新生成；不支持判定服务（VerdictService）。\n");
+        return -1;
+    }
+
+    st_genpolicy gp;
+    if (!load_policy(argv[1], gp))
+    {
+        printf("❌ 打开配置文件失败：%s\n", argv[1]);
+        return -1;
+    }
+
+    if (!generate(gp, argv[1], argv[2]))
+    {
+        printf("❌ 写入头文件失败：%s\n", argv[2]);
+        return -1;
+    }
+    return 0;
+}
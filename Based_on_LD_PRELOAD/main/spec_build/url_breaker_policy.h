@@ -0,0 +1,58 @@
+// 由policy_codegen根据config.xml生成（2026-10-17 14:15:17），请勿手工修改；策略改变后执行make specialized重新生成
+// 黑名单3条（编译后：单个IPv4地址2个、网段0个），域名1条，白名单进程3个，拦截时间段：00:00-24:00
+
+#ifndef URL_BREAKER_POLICY_H
+#define URL_BREAKER_POLICY_H 1
+
+#include "url_breaker_spec.h"
+
+namespace spec
+{
+
+    constexpr const char* kSource = "config.xml";
+    constexpr const char* kSchedText = "00:00-24:00";
+
+    constexpr std::array<uint64_t, 23> kSchedule = {{
+        0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL,
+        0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL,
+        0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL,
+        0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL,
+        0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL,
+        0xffffffffffffffffULL, 0xffffffffffffffffULL, 0x00000000ffffffffULL}};
+
+    constexpr std::array<st_specentry, 3> kEntries = {{
+        {"1.1.1.1", false, 0},
+        {"www.baidu.com", true, 1},
+        {"2.2.2.2", false, 2},}};
+
+    constexpr std::array<st_specdomain, 1> kDomains = {{
+        {"www.baidu.com", 80, 80, 1},}};
+
+    // 规整后排序（与PolicySet::whitelist()一致）
+    constexpr std::array<const char*, 3> kWhitelist = {{
+        "/bin/bash",
+        "/bin/curl",
+        "/home/mysql/Projects/URL_Breaker/test/test_conn_brea_whi",}};
+
+    constexpr std::array<st_specportset, 1> kPortSets = {{
+        // 1：端口80-80
+        {{0,0x10000ULL,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}},}};
+
+    constexpr uint32_t kV4Buckets = 1; // 桶数（2的幂）
+    constexpr uint32_t kV4Size = 2;    // 槽位数（2的幂）
+    constexpr std::array<uint32_t, 1> kV4Disp = {{
+        3}};
+    constexpr std::array<st_specslot, 2> kV4Table = {{
+        {0x02020202u, 0, 1}, {0x01010101u, 1, 1},}};
+    constexpr std::array<st_specport, 2> kV4Ports = {{
+        {0, 2}, {1, 0},}};
+
+    constexpr std::array<st_specgroup, 0> kV4Groups = {{}};
+    constexpr std::array<st_specrange4, 0> kV4Ranges = {{}};
+
+    constexpr std::array<st_specgroup, 0> kV6Groups = {{}};
+    constexpr std::array<st_specrange6, 0> kV6Ranges = {{}};
+
+} // namespace spec
+
+#endif // !URL_BREAKER_POLICY_H
@@ -0,0 +1,167 @@
+#include "ol_public.h"
+#include "ol_evring.h" // 引入OL跨进程事件环
+#include "ol_mplog.h"  // 引入OL多进程共享日志类
+#include "ol_XmlScanner.h" // 引入OL流式XML扫描器
+#include <arpa/inet.h>
+#include <atomic>
+#include <netinet/in.h>
+#include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace ol;
+using namespace std;
+
+// ===================== 全局配置 =====================
+// 与URL_Breaker.cpp保持一致
+const string g_configPath = "/home/mysql/Projects/URL_Breaker/main/config.xml";
+const string g_logPath = "/home/mysql/Projects/URL_Breaker/main/url_breaker.log";
+
+vector<string> g_Rules;          // 规则编号 → 配置中的原始条目（如www.xxx.com:443）
+vector<string> g_Feeds;          // 列表编号 → 配置中的黑名单列表文件（规则编号-2-n对应第n个列表）
+cmplogfile g_log;                // 与被注入进程共用的日志文件
+cevcollector g_collector;        // 事件环采集者
+atomic_bool g_bExit(false);      // 退出标志
+
+// 被劫持函数的名称（下标与st_hookevent::m_op一致）
+static const char* const g_opNames[] = {"connect", "connectat"};
+
+/**
+ * @brief 读取配置文件，按出现顺序给BlacklistEntry、BlacklistFeed标签编号（与被注入进程的rule_id一致）
+ */
+static void load_rules()
+{
+    g_Rules.clear();
+    g_Feeds.clear();
+
+    // 与被注入进程使用同一个扫描器，注释和跨行元素的处理方式一致，编号才能对上
+    cmmapfile mfile;
+    if (!mfile.open(g_configPath)) return;
+
+    XmlScanner scanner(mfile.view());
+    XmlToken tok;
+    while (scanner.next(tok))
+    {
+        if (tok.m_tag == "BlacklistEntry")
+            g_Rules.emplace_back(deleteLRspace(tok.m_value));
+        else if (tok.m_tag == "BlacklistFeed")
+            g_Feeds.emplace_back(deleteLRspace(tok.m_value));
+    }
+}
+
+/**
+ * @brief 格式化并记录一条事件
+ * @param slot 事件所属的槽位（提供进程信息）
+ * @param ev 事件
+ */
+static void write_event(const st_evslot& slot, const st_hookevent& ev)
+{
+    // 事件时间转本地时间（精确到毫秒）
+    time_t sec = static_cast<time_t>(ev.m_ts / 1000000000ULL);
+    struct tm tmv;
+    localtime_r(&sec, &tmv);
+    char tbuf[64];
+    snprintf(tbuf, sizeof(tbuf), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+             tmv.tm_year + 1900, tmv.tm_mon + 1, tmv.tm_mday, tmv.tm_hour, tmv.tm_min, tmv.tm_sec,
+             static_cast<int>(ev.m_ts % 1000000000ULL / 1000000));
+
+    const char* op = ev.m_op < 2 ? g_opNames[ev.m_op] : "unknown";
+    int pid = slot.m_pid.load(std::memory_order_relaxed);
+
+    string record;
+    if (ev.m_verdict == 2)
+    {
+        record = sformat("%s ℹ️ 放行白名单进程[%s](pid=%d,tid=%d)访问\n", tbuf, slot.m_exe, pid, ev.m_tid);
+    }
+    else
+    {
+        char ip[INET6_ADDRSTRLEN] = {0};
+        inet_ntop(ev.m_family, ev.m_addr, ip, sizeof(ip));
+        string addr = (ev.m_family == AF_INET6) ? sformat("[%s]:%u", ip, ev.m_port) : sformat("%s:%u", ip, ev.m_port);
+
+        if (ev.m_verdict == 1)
+        {
+            string rule = "无";
+            if (ev.m_ruleId >= 0 && static_cast<size_t>(ev.m_ruleId) < g_Rules.size())
+                rule = g_Rules[ev.m_ruleId];
+            else if (ev.m_ruleId <= -2 && static_cast<size_t>(-2 - ev.m_ruleId) < g_Feeds.size())
+                rule = "列表" + g_Feeds[-2 - ev.m_ruleId];
+            record = sformat("%s ✅ 拦截非白名单进程[%s](pid=%d,tid=%d)%s访问黑名单地址[%s]（命中规则：%s）\n",
+                             tbuf, slot.m_exe, pid, ev.m_tid, op, addr.c_str(), rule.c_str());
+        }
+        else
+        {
+            record = sformat("%s ℹ️ 放行进程[%s](pid=%d,tid=%d)%s访问地址[%s]\n",
+                             tbuf, slot.m_exe, pid, ev.m_tid, op, addr.c_str());
+        }
+    }
+
+    g_log.writeraw(record.data(), record.size());
+}
+
+// 信号处理：设置退出标志，主循环退出前会把环中剩余事件取完
+static void sig_handler(int sig)
+{
+    g_bExit = true;
+}
+
+int main(int argc, char* argv[])
+{
+    signal(SIGINT, sig_handler);
+    signal(SIGTERM, sig_handler);
+    signal(SIGHUP, SIG_IGN);
+
+    if (!g_log.open(g_logPath, true))
+    {
+        printf("❌ 打开日志文件失败：%s\n", g_logPath.c_str());
+        return -1;
+    }
+
+    if (!g_collector.create())
+    {
+        printf("❌ 创建事件环失败（可能已有采集进程在运行）\n");
+        return -1;
+    }
+
+    load_rules();
+    g_log.write("========== 事件采集进程启动（pid=%d，规则数：%zu，列表数：%zu） ==========\n", getpid(), g_Rules.size(), g_Feeds.size());
+
+    // 自适应轮询：有事件时持续取；空闲时先自旋，再让出CPU，最后逐步加长休眠（最长10毫秒）。
+    unsigned idle = 0;
+    time_t lastReclaim = time(NULL);
+    while (!g_bExit)
+    {
+        // 每秒回收一次已退出进程的槽位（放在取事件之前，事件不断时也照常回收）。
+        time_t now = time(NULL);
+        if (now != lastReclaim)
+        {
+            g_collector.reclaim();
+            lastReclaim = now;
+        }
+
+        if (g_collector.drain(write_event) > 0)
+        {
+            idle = 0;
+            continue;
+        }
+
+        ++idle;
+        if (idle < 64)
+            ;
+        else if (idle < 128)
+            sched_yield();
+        else
+            usleep(idle < 1024 ? 100 : 10000);
+    }
+
+    // 退出前取完剩余事件。
+    while (g_collector.drain(write_event) > 0)
+        ;
+
+    g_log.write("========== 事件采集进程退出 ==========\n");
+    g_collector.close();
+    return 0;
+}
@@ -0,0 +1,109 @@
+/****************************************************************************************/
+/*
+ * 程序名：url_breaker_spec.h
+ * 功能描述：策略特化版本的编译期策略表结构，由policy_codegen生成的url_breaker_policy.h和
+ *          以-DURL_BREAKER_SPECIALIZED编译的URL_Breaker.cpp共用，支持以下特性：
+ *          - 单个IPv4地址的条目编为完美哈希表（两级：桶 → 位移种子 → 槽位），一次查找最多访问两个数组元素
+ *          - 端口范围编为65536位的位图，同一端口范围的条目共用一个位图
+ *          - 网段条目按端口位图分组，组内为按起点排序、互不重叠的地址范围（二分查找）
+ *          - 拦截时间段编为每分钟一位的常量位图
+ *          - 哈希函数为constexpr，生成器与被注入进程使用同一份实现，保证槽位一致
+ * 作者：ol
+ * 适用标准：C++17及以上
+ */
+/****************************************************************************************/
+
+#ifndef URL_BREAKER_SPEC_H
+#define URL_BREAKER_SPEC_H 1
+
+#include <array>
+#include <stdint.h>
+
+namespace spec
+{
+
+    // 黑名单条目（下标即规则编号，与通用版本的g_Blacklist一致）
+    struct st_specentry
+    {
+        const char* m_url; // 原始URL（IP、网段、域名或列表文件路径）
+        bool m_isDomain;   // 是否是域名
+        int m_ruleId;      // 配置中的规则编号（BlacklistEntry为0..，第n个BlacklistFeed为-2-n）
+    };
+
+    // 域名条目（连接时解析后比较地址）
+    struct st_specdomain
+    {
+        const char* m_host; // 域名
+        uint16_t m_portLo;  // 端口范围起点（包含）
+        uint16_t m_portHi;  // 端口范围终点（包含）
+        int m_ruleId;       // 规则编号（kEntries的下标）
+
+        constexpr bool matchPort(uint16_t port) const { return port >= m_portLo && port <= m_portHi; }
+    };
+
+    // 端口位图（每个端口一位）
+    struct st_specportset
+    {
+        uint64_t m_bits[1024];
+
+        constexpr bool contains(uint16_t port) const { return (m_bits[port >> 6] >> (port & 63)) & 1; }
+    };
+
+    // 完美哈希表的一个槽位（m_count为0表示空槽）
+    struct st_specslot
+    {
+        uint32_t m_key;   // IPv4地址（主机字节序）
+        uint32_t m_first; // 该地址的第一条端口规则在kV4Ports中的下标
+        uint32_t m_count; // 端口规则数
+    };
+
+    // 一条端口规则
+    struct st_specport
+    {
+        uint32_t m_set;   // 端口位图编号（0表示所有端口，k表示kPortSets[k-1]）
+        int32_t m_ruleId; // 规则编号
+    };
+
+    // 网段分组（同一端口位图的地址范围）
+    struct st_specgroup
+    {
+        uint32_t m_set;   // 端口位图编号（同st_specport）
+        uint32_t m_first; // 第一个地址范围的下标
+        uint32_t m_count; // 地址范围数
+    };
+
+    // IPv4地址范围（主机字节序，两端包含）
+    struct st_specrange4
+    {
+        uint32_t m_lo;
+        uint32_t m_hi;
+        int32_t m_ruleId;
+    };
+
+    // IPv6地址范围（高64位、低64位，主机字节序，两端包含）
+    struct st_specrange6
+    {
+        uint64_t m_loHi, m_loLo;
+        uint64_t m_hiHi, m_hiLo;
+        int32_t m_ruleId;
+    };
+
+    /**
+     * @brief 完美哈希表使用的哈希函数（32位整数混合）
+     * @param key IPv4地址（主机字节序）
+     * @param seed 种子（0用于选桶，桶的位移种子从1开始）
+     */
+    constexpr uint32_t spec_hash(uint32_t key, uint32_t seed)
+    {
+        uint32_t h = key ^ (seed * 0x9E3779B9u);
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+} // namespace spec
+
+#endif // !URL_BREAKER_SPEC_H
@@ -0,0 +1,370 @@
+#include "ol_public.h"
+#include "ol_mplog.h"      // 引入OL多进程共享日志类
+#include "ol_verdict.h"    // 引入OL判定服务通信与共享内存缓存
+#include "ol_XmlScanner.h" // 引入OL流式XML扫描器
+#include "policy/policy_set.h" // 引入策略引擎libpolicy
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <pwd.h>
+#include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace ol;
+using namespace std;
+
+// ===================== 全局配置 =====================
+// 与URL_Breaker.cpp保持一致
+const string g_configPath = "/home/mysql/Projects/URL_Breaker/main/config.xml";
+const string g_logPath = "/home/mysql/Projects/URL_Breaker/main/url_breaker.log";
+const string g_defaultSock = "/tmp/url_breaker_verdict.sock";
+const int MAX_BLACKLIST = 100;        // 与被注入进程一致
+const unsigned DEFAULT_CACHE_TTL = 60; // 缓存结果的默认有效期（秒）
+const int DOMAIN_REFRESH = 60;         // 域名重新解析的间隔（秒）
+
+// 判定所需的全部策略（SIGHUP时整体重建）
+struct st_verdictpolicy
+{
+    policy::PolicySet m_policy;  // 拦截策略（查找结果是m_ruleIds的下标）
+    vector<int> m_ruleIds;       // 下标 → 配置中的规则编号（BlacklistEntry为0..，第n个BlacklistFeed为-2-n）
+    vector<uint32_t> m_users;    // 白名单用户（uid，排序）
+    string m_sockPath = g_defaultSock; // 监听的套接字路径
+    unsigned m_cacheTtl = DEFAULT_CACHE_TTL; // 缓存结果的有效期（秒）
+    unsigned m_version = 0;      // 策略版本（每次加载递增）
+};
+
+// 域名规则解析出的地址查找表（规则编号是解析时那一版策略的下标）
+struct st_domaintable
+{
+    unsigned m_version;          // 对应的策略版本
+    policy::RangeTable m_table;  // 查找表
+};
+
+unique_ptr<st_verdictpolicy> g_policy;       // 当前策略（只由主线程读写）
+shared_ptr<const st_domaintable> g_domainTable; // 域名地址表（解析线程发布，主线程读取）
+vector<policy::DomainRule> g_domainRules;    // 待解析的域名规则（由g_domainMutex保护）
+unsigned g_domainVersion = 0;                // 待解析的域名规则对应的策略版本（由g_domainMutex保护）
+mutex g_domainMutex;
+condition_variable g_domainCond;
+bool g_domainChanged = false;                // 域名规则已更新，解析线程应立即重新解析
+cmplogfile g_log;                            // 与被注入进程共用的日志文件
+cvserver g_server;                           // 判定服务端
+atomic_bool g_bExit(false);                  // 退出标志
+atomic_bool g_bReload(false);                // 重新加载标志
+
+/**
+ * @brief 读取配置文件，构建判定策略（与被注入进程的解析规则和规则编号一致）
+ * @param vp 输出：判定策略
+ */
+static void load_policy(st_verdictpolicy& vp)
+{
+    cmmapfile mfile;
+    if (!mfile.open(g_configPath))
+    {
+        vp.m_policy.schedule().setAllDay();
+        g_log.write("❌ [判定服务]配置文件不存在，使用默认配置（拦截时间段：%s）\n", vp.m_policy.schedule().toString().c_str());
+        return;
+    }
+
+    int blacklist_count = 0;
+    int rule_ordinal = 0, feed_ordinal = 0;
+    int pending_start = -1;
+    XmlScanner scanner(mfile.view());
+    XmlToken tok;
+    while (scanner.next(tok))
+    {
+        string_view load = deleteLRspace(tok.m_value);
+
+        // 拦截时间段：每对Start/End组成一个时间段（与被注入进程相同）
+        if (tok.m_tag == "StartInterceptTime")
+        {
+            int parsed_time = 0;
+            if (!policy::Schedule::parseTime(load.data(), load.size(), parsed_time)) continue;
+            if (pending_start >= 0) vp.m_policy.schedule().addRange(pending_start, policy::Schedule::MINUTES_PER_DAY);
+            pending_start = parsed_time;
+        }
+        else if (tok.m_tag == "EndInterceptTime")
+        {
+            int parsed_time = 0;
+            if (!policy::Schedule::parseTime(load.data(), load.size(), parsed_time)) continue;
+            vp.m_policy.schedule().addRange(pending_start >= 0 ? pending_start : 0, parsed_time);
+            pending_start = -1;
+        }
+        else if (tok.m_tag == "WhitelistProc")
+        {
+            if (!load.empty()) vp.m_policy.addWhitelist(string(load));
+        }
+
+        // 白名单用户（用户名或uid）：该用户的所有进程都放行，只有判定服务支持
+        else if (tok.m_tag == "WhitelistUser")
+        {
+            string user(load);
+            if (user.empty()) continue;
+            if (all_of(user.begin(), user.end(), ::isdigit))
+            {
+                vp.m_users.push_back(static_cast<uint32_t>(strtoul(user.c_str(), nullptr, 10)));
+                continue;
+            }
+            struct passwd pwd, *result = nullptr;
+            char buf[1024];
+            if (getpwnam_r(user.c_str(), &pwd, buf, sizeof(buf), &result) == 0 && result != nullptr)
+                vp.m_users.push_back(static_cast<uint32_t>(pwd.pw_uid));
+            else
+                g_log.write("❌ [判定服务]白名单用户不存在：%s，忽略该用户\n", user.c_str());
+        }
+        else if (tok.m_tag == "BlacklistEntry")
+        {
+            int rule_id = rule_ordinal++;
+            if (load.empty() || blacklist_count >= MAX_BLACKLIST) continue;
+            int index = static_cast<int>(vp.m_ruleIds.size());
+            if (vp.m_policy.addTarget(load.data(), load.size(), index, policy::PROTO_TCP | policy::PROTO_UDP) == policy::TARGET_INVALID) continue;
+            vp.m_ruleIds.push_back(rule_id);
+            blacklist_count++;
+        }
+        else if (tok.m_tag == "BlacklistFeed")
+        {
+            int rule_id = -2 - feed_ordinal++;
+            if (load.empty()) continue;
+
+            string path(load), error;
+            if (path.size() > 5 && path.compare(path.size() - 5, 5, ".dset") == 0) continue; // 域名集合由被注入进程自己mmap，解析域名时拦截
+
+            policy::FeedStats st;
+            int index = static_cast<int>(vp.m_ruleIds.size());
+            if (!vp.m_policy.addFeed(path, index, policy::PROTO_TCP | policy::PROTO_UDP, st, error))
+                g_log.write("❌ [判定服务]读取黑名单列表失败：%s（%s）\n", path.c_str(), error.c_str());
+            if (st.m_nets == 0) continue;
+            vp.m_ruleIds.push_back(rule_id);
+            g_log.write("✅ [判定服务]加载黑名单列表：%s（%s）\n", path.c_str(), st.toString().c_str());
+        }
+        else if (tok.m_tag == "VerdictService")
+        {
+            if (!load.empty()) vp.m_sockPath.assign(load);
+        }
+        else if (tok.m_tag == "VerdictCacheTtl")
+        {
+            int ttl = atoi(string(load).c_str());
+            if (ttl >= 0) vp.m_cacheTtl = static_cast<unsigned>(ttl);
+        }
+    }
+
+    if (!scanner.ok())
+        g_log.write("❌ [判定服务]配置文件格式错误（第%zu行：%s），其后的配置被忽略\n", scanner.errorLine(), scanner.error());
+
+    if (pending_start >= 0) vp.m_policy.schedule().addRange(pending_start, policy::Schedule::MINUTES_PER_DAY);
+    if (vp.m_policy.schedule().empty()) vp.m_policy.schedule().setAllDay();
+    vp.m_policy.compile();
+    sort(vp.m_users.begin(), vp.m_users.end());
+    vp.m_users.erase(unique(vp.m_users.begin(), vp.m_users.end()), vp.m_users.end());
+}
+
+/**
+ * @brief 解析全部域名规则，生成地址查找表（每个解析出的IP一条规则，端口范围沿用域名规则）
+ * @param rules 域名规则
+ * @param version 域名规则对应的策略版本
+ * @return 查找表
+ */
+static shared_ptr<const st_domaintable> resolve_domains(const vector<policy::DomainRule>& rules, unsigned version)
+{
+    vector<policy::NetRule> nets;
+    for (const auto& rule : rules)
+    {
+        struct addrinfo hints, *res = nullptr;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(rule.m_host.c_str(), nullptr, &hints, &res) != 0) continue;
+
+        for (struct addrinfo* p = res; p != nullptr; p = p->ai_next)
+        {
+            policy::NetRule net;
+            if (p->ai_family == AF_INET)
+            {
+                net.m_family = policy::FAMILY_V4;
+                net.m_prefixLen = 32;
+                memcpy(net.m_addr, &reinterpret_cast<struct sockaddr_in*>(p->ai_addr)->sin_addr, 4);
+            }
+            else if (p->ai_family == AF_INET6)
+            {
+                net.m_family = policy::FAMILY_V6;
+                net.m_prefixLen = 128;
+                memcpy(net.m_addr, &reinterpret_cast<struct sockaddr_in6*>(p->ai_addr)->sin6_addr, 16);
+            }
+            else
+                continue;
+            net.m_portLo = rule.m_portLo;
+            net.m_portHi = rule.m_portHi;
+            net.m_proto = rule.m_proto;
+            net.m_ruleId = rule.m_ruleId;
+            nets.push_back(net);
+        }
+        freeaddrinfo(res);
+    }
+
+    auto table = make_shared<st_domaintable>();
+    table->m_version = version;
+    table->m_table.build(nets);
+    return table;
+}
+
+// 域名解析线程：每DOMAIN_REFRESH秒（或域名规则更新后立即）重新解析，主线程不因DNS阻塞
+static void resolver_thread()
+{
+    while (!g_bExit)
+    {
+        vector<policy::DomainRule> rules;
+        unsigned version;
+        {
+            unique_lock<mutex> lock(g_domainMutex);
+            rules = g_domainRules;
+            version = g_domainVersion;
+            g_domainChanged = false;
+        }
+
+        atomic_store(&g_domainTable, resolve_domains(rules, version));
+
+        unique_lock<mutex> lock(g_domainMutex);
+        g_domainCond.wait_for(lock, chrono::seconds(DOMAIN_REFRESH), [] { return g_domainChanged || g_bExit.load(); });
+    }
+}
+
+/**
+ * @brief 判定一条查询（cvserver::poll的回调）
+ * @param peer 发起查询的进程
+ * @param q 查询
+ * @param a 输出：应答
+ */
+static void judge(const st_vpeer& peer, const st_vquery& q, st_vanswer& a)
+{
+    const st_verdictpolicy& vp = *g_policy;
+    time_t now = time(NULL);
+
+    // 时间段切换前到期，切换后旧结果不再命中
+    long change = vp.m_policy.schedule().secondsUntilChange(now);
+    a.m_ttl = (change > 0 && static_cast<unsigned long>(change) < vp.m_cacheTtl) ? static_cast<uint32_t>(change) : vp.m_cacheTtl;
+
+    // 1. 白名单进程、白名单用户
+    if (vp.m_policy.isWhitelisted(peer.m_exe) || binary_search(vp.m_users.begin(), vp.m_users.end(), peer.m_uid))
+    {
+        a.m_verdict = VERDICT_WHITELIST;
+        return;
+    }
+
+    // 2. 不在拦截时间段
+    a.m_verdict = VERDICT_ALLOW;
+    if (!vp.m_policy.active(now)) return;
+
+    // 3. IP/网段黑名单（IPv4映射的IPv6地址按IPv4查找）
+    static const uint8_t v4mapped[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+    uint8_t family = q.m_family == AF_INET6 ? policy::FAMILY_V6 : policy::FAMILY_V4;
+    const uint8_t* addr = q.m_addr;
+    if (family == policy::FAMILY_V6 && memcmp(addr, v4mapped, sizeof(v4mapped)) == 0)
+    {
+        family = policy::FAMILY_V4;
+        addr += 12;
+    }
+    int idx = vp.m_policy.matchNet(family, addr, q.m_port, policy::PROTO_TCP | policy::PROTO_UDP);
+
+    // 4. 域名黑名单（解析线程发布的地址表；旧版本策略的表规则编号不同，不使用）
+    if (idx < 0)
+    {
+        shared_ptr<const st_domaintable> table = atomic_load(&g_domainTable);
+        if (table && table->m_version == vp.m_version)
+            idx = table->m_table.match(family, addr, q.m_port, policy::PROTO_TCP | policy::PROTO_UDP);
+    }
+
+    if (idx >= 0)
+    {
+        a.m_verdict = VERDICT_BLOCK;
+        a.m_ruleId = vp.m_ruleIds[idx];
+    }
+}
+
+// 加载（或重新加载）策略，更新域名规则并使缓存失效
+static void reload()
+{
+    unique_ptr<st_verdictpolicy> vp(new st_verdictpolicy);
+    load_policy(*vp);
+    vp->m_version = g_policy ? g_policy->m_version + 1 : 1;
+
+    // 交给解析线程立即重新解析（新表发布前域名条目不命中）
+    {
+        lock_guard<mutex> lock(g_domainMutex);
+        g_domainRules = vp->m_policy.domains();
+        g_domainVersion = vp->m_version;
+        g_domainChanged = true;
+    }
+    g_domainCond.notify_one();
+
+    g_log.write("✅ [判定服务]策略已加载：黑名单%zu条（IP/网段%zu条、域名%zu条），白名单进程%zu个、用户%zu个，拦截时间段：%s，缓存有效期%u秒\n",
+                vp->m_ruleIds.size(), vp->m_policy.netInputs(), vp->m_policy.domains().size(),
+                vp->m_policy.whitelist().size(), vp->m_users.size(), vp->m_policy.schedule().toString().c_str(), vp->m_cacheTtl);
+
+    if (g_policy && g_policy->m_sockPath != vp->m_sockPath)
+        g_log.write("⚠️ [判定服务]套接字路径的修改需重启判定服务才生效\n");
+    if (g_policy) vp->m_sockPath = g_policy->m_sockPath;
+
+    g_policy = move(vp);
+    g_server.invalidate();
+}
+
+// 信号处理：SIGINT/SIGTERM退出，SIGHUP重新加载配置
+static void sig_handler(int sig)
+{
+    if (sig == SIGHUP)
+        g_bReload = true;
+    else
+        g_bExit = true;
+}
+
+int main(int argc, char* argv[])
+{
+    signal(SIGINT, sig_handler);
+    signal(SIGTERM, sig_handler);
+    signal(SIGHUP, sig_handler);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (!g_log.open(g_logPath, true))
+    {
+        printf("❌ 打开日志文件失败：%s\n", g_logPath.c_str());
+        return -1;
+    }
+
+    reload();
+    if (!g_server.create(g_policy->m_sockPath))
+    {
+        printf("❌ 创建判定服务失败：%s（可能已有判定进程在运行）\n", g_policy->m_sockPath.c_str());
+        return -1;
+    }
+    g_log.write("========== 判定服务启动（pid=%d，套接字：%s） ==========\n", getpid(), g_policy->m_sockPath.c_str());
+
+    thread resolver(resolver_thread);
+
+    while (!g_bExit)
+    {
+        if (g_bReload.exchange(false)) reload();
+        g_server.poll(judge, 1000);
+    }
+
+    {
+        lock_guard<mutex> lock(g_domainMutex);
+        g_domainChanged = true;
+    }
+    g_domainCond.notify_one();
+    resolver.join();
+
+    g_log.write("========== 判定服务退出（累计查询%llu条，应答批次%llu次） ==========\n",
+                static_cast<unsigned long long>(g_server.queries()), static_cast<unsigned long long>(g_server.batches()));
+    g_server.close();
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include "ol_net/ol_ChainBuffer.h"
+#include <fcntl.h>
+#include <random>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <vector>
+
+// ChainBuffer的三种分隔符模式在小块（帧、报头、"\r\n\r\n"都会跨块）下逐字节喂入时拆包正确，
+// 以及recvFd/sendFd/sendOrAppend经socketpair收发大量数据后内容不变
+
+const size_t BLOCK_SIZE = 16;      // 块很小，让几乎每个帧都跨块
+const size_t STREAM_SIZE = 4 << 20; // socketpair收发的字节数
+
+/**
+ * @brief 生成长度为len的随机字符串
+ */
+static std::string make_data(std::mt19937& rng, size_t len)
+{
+    std::string s(len, '\0');
+    for (auto& c : s) c = static_cast<char>(rng());
+    return s;
+}
+
+/**
+ * @brief 四字节报头模式：一次追加全部帧，以及逐字节追加，拆出的帧与原帧一致
+ * @return 成功返回true
+ */
+static bool check_header_frames(std::mt19937& rng)
+{
+    std::vector<std::string> frames;
+    for (int ii = 0; ii < 200; ++ii) frames.push_back(make_data(rng, rng() % 100)); // 含长度为0的帧
+
+    std::string stream; // 报头为四字节长度（主机字节序）
+    for (const auto& f : frames)
+    {
+        uint32_t len = static_cast<uint32_t>(f.size());
+        stream.append(reinterpret_cast<const char*>(&len), 4);
+        stream += f;
+    }
+
+    // appendWithSep写出的帧可以原样拆回
+    ol::ChainBuffer sep(1, BLOCK_SIZE);
+    for (const auto& f : frames) sep.appendWithSep(f.data(), f.size());
+    std::string_view frame;
+    for (size_t ii = 0; ii < frames.size(); ++ii)
+    {
+        if (!sep.pickMessage(frame) || frame != frames[ii])
+        {
+            printf("❌ appendWithSep写入的第%zu个帧拆包错误\n", ii);
+            return false;
+        }
+    }
+
+    for (int byByte = 0; byByte < 2; ++byByte)
+    {
+        ol::ChainBuffer buf(1, BLOCK_SIZE);
+        size_t next = 0, pos = 0;
+        while (pos < stream.size())
+        {
+            size_t n = byByte ? 1 : stream.size();
+            buf.append(stream.data() + pos, n);
+            pos += n;
+            while (buf.pickMessage(frame))
+            {
+                if (next >= frames.size() || frame != frames[next])
+                {
+                    printf("❌ 第%zu个帧内容错误（逐字节=%d）\n", next, byByte);
+                    return false;
+                }
+                ++next;
+            }
+        }
+        if (next != frames.size() || !buf.empty())
+        {
+            printf("❌ 只拆出%zu个帧，应为%zu（逐字节=%d）\n", next, frames.size(), byByte);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief http模式：报文头在任意位置被截断，"\r\n\r\n"跨块，拆出的报文头与原文一致
+ * @return 成功返回true
+ */
+static bool check_http_frames()
+{
+    std::vector<std::string> heads;
+    for (int ii = 0; ii < 50; ++ii)
+        heads.push_back("GET /" + std::string(ii, 'a') + " HTTP/1.1\r\nHost: h" + std::to_string(ii) + "\r\n\r\n");
+    std::string stream;
+    for (const auto& h : heads) stream += h;
+
+    for (size_t chunk = 1; chunk <= 7; ++chunk)
+    {
+        ol::ChainBuffer buf(2, BLOCK_SIZE);
+        size_t next = 0;
+        std::string_view frame;
+        for (size_t pos = 0; pos < stream.size(); pos += chunk)
+        {
+            buf.append(stream.data() + pos, std::min(chunk, stream.size() - pos));
+            while (buf.pickMessage(frame))
+            {
+                if (next >= heads.size() || frame != heads[next])
+                {
+                    printf("❌ 每次追加%zu字节时第%zu个报文头错误\n", chunk, next);
+                    return false;
+                }
+                ++next;
+            }
+        }
+        if (next != heads.size())
+        {
+            printf("❌ 每次追加%zu字节时只拆出%zu个报文头\n", chunk, next);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 无分隔符模式取出全部数据；size()不含尚未消费的帧；consume和clear
+ * @return 成功返回true
+ */
+static bool check_raw_and_consume(std::mt19937& rng)
+{
+    std::string data = make_data(rng, 1000);
+    ol::ChainBuffer buf(0, BLOCK_SIZE);
+    buf.append(data);
+    buf.consume(10);
+    if (buf.size() != 990)
+    {
+        printf("❌ consume后大小%zu，应为990\n", buf.size());
+        return false;
+    }
+    std::string_view frame;
+    if (!buf.pickMessage(frame) || frame != std::string_view(data).substr(10) || buf.size() != 0)
+    {
+        printf("❌ 无分隔符模式取出的数据错误\n");
+        return false;
+    }
+    buf.append("xyz", 3);
+    if (!buf.pickMessage(frame) || frame != "xyz" || buf.pickMessage(frame))
+    {
+        printf("❌ 上一个帧没有在下一次拆包时消费\n");
+        return false;
+    }
+    buf.append(data);
+    buf.clear();
+    if (!buf.empty() || buf.pickMessage(frame))
+    {
+        printf("❌ clear后缓冲区不为空\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 经非阻塞socketpair收发：一端sendOrAppend+sendFd，另一端recvFd，收到的字节流与发送的一致
+ * @return 成功返回true
+ */
+static bool check_socket(std::mt19937& rng)
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return false;
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+    std::string data = make_data(rng, STREAM_SIZE);
+    ol::ChainBuffer out(0, 4096), in(0, 4096);
+    std::string received;
+    size_t offered = 0;
+    bool ok = true;
+    while (ok && received.size() < data.size())
+    {
+        if (offered < data.size())
+        {
+            size_t n = std::min<size_t>(1 + rng() % 100000, data.size() - offered);
+            ok = out.sendOrAppend(fds[0], data.data() + offered, n) >= 0;
+            offered += n;
+        }
+        if (ok && !out.empty()) ok = out.sendFd(fds[0]) >= 0;
+
+        ssize_t n = in.recvFd(fds[1]);
+        if (n < 0) ok = false;
+        std::string_view frame;
+        if (in.pickMessage(frame)) received.append(frame.data(), frame.size());
+    }
+    close(fds[0]);
+    close(fds[1]);
+    if (!ok || received != data)
+    {
+        printf("❌ socket收发的数据不一致（收到%zu字节）\n", received.size());
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    std::mt19937 rng(20261017);
+
+    printf("🔍 四字节报头模式拆包\n");
+    if (!check_header_frames(rng)) return -1;
+
+    printf("🔍 http模式拆包\n");
+    if (!check_http_frames()) return -1;
+
+    printf("🔍 无分隔符模式、consume和clear\n");
+    if (!check_raw_and_consume(rng)) return -1;
+
+    printf("🔍 socketpair收发\n");
+    if (!check_socket(rng)) return -1;
+
+    printf("✅ ChainBuffer测试通过\n");
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "ol_CompactTrieMap.h"
+#include "ol_CompactTrieSet.h"
+#include <map>
+#include <random>
+#include <stdio.h>
+
+// CompactTrieMap在随机插入、覆盖、删除（会拆分和合并压缩边）之后，以及freeze()成为双数组Trie之后，
+// 每个查询接口的结果都与std::map一致；字母表含0x80以上的字节，核对按无符号字节排序
+
+const int OPS = 20000;      // 随机修改次数
+const int QUERIES = 1000;   // 每轮随机查询次数
+const char ALPHABET[] = {'a', 'b', 'c', '.', '\x7f', '\x80', '\xff'};
+
+/**
+ * @brief 生成长度为0~maxLen的随机键（字母表很小，键之间大量共享前缀）
+ */
+static std::string make_key(std::mt19937& rng, size_t maxLen)
+{
+    std::string key(rng() % (maxLen + 1), '\0');
+    for (auto& c : key) c = ALPHABET[rng() % sizeof(ALPHABET)];
+    return key;
+}
+
+/**
+ * @brief 朴素实现：'.'匹配单个任意字符
+ */
+static bool match_pattern(const std::string& key, const std::string& pattern)
+{
+    if (key.size() != pattern.size()) return false;
+    for (size_t ii = 0; ii < key.size(); ++ii)
+        if (pattern[ii] != '.' && pattern[ii] != key[ii]) return false;
+    return true;
+}
+
+/**
+ * @brief 用随机查询核对trie与std::map的结果
+ * @return 成功返回true
+ */
+static bool check_queries(const ol::CompactTrieMap<int>& trie, const std::map<std::string, int>& expect,
+                          std::mt19937& rng, const char* stage)
+{
+    if (trie.size() != expect.size())
+    {
+        printf("❌ %s：大小%zu，应为%zu\n", stage, trie.size(), expect.size());
+        return false;
+    }
+    for (const auto& kv : expect)
+    {
+        auto v = trie.get(kv.first);
+        if (!v || *v != kv.second)
+        {
+            printf("❌ %s：键\"%s\"的值错误\n", stage, kv.first.c_str());
+            return false;
+        }
+    }
+
+    for (int q = 0; q < QUERIES; ++q)
+    {
+        std::string s = make_key(rng, 7);
+
+        std::string shortest, longest;
+        bool anyPrefix = false;
+        for (size_t len = 0; len <= s.size(); ++len)
+        {
+            if (expect.count(s.substr(0, len)) == 0) continue;
+            if (!anyPrefix) shortest = s.substr(0, len);
+            longest = s.substr(0, len);
+            anyPrefix = true;
+        }
+
+        std::list<std::string> byPrefix, byPattern;
+        for (auto it = expect.lower_bound(s); it != expect.end() && it->first.compare(0, s.size(), s) == 0; ++it)
+            byPrefix.push_back(it->first);
+        for (const auto& kv : expect)
+            if (match_pattern(kv.first, s)) byPattern.push_back(kv.first);
+        std::list<std::string> gotPattern = trie.keysByPattern(s);
+        gotPattern.sort();
+
+        if (trie.has(s) != (expect.count(s) > 0) || trie.shortestPrefix(s) != shortest || trie.longestPrefix(s) != longest ||
+            trie.hasPrefix(s) != !byPrefix.empty() || trie.keysByPrefix(s) != byPrefix || gotPattern != byPattern ||
+            trie.hasPattern(s) != !byPattern.empty())
+        {
+            printf("❌ %s：查询\"%s\"的结果与std::map不一致\n", stage, s.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    std::mt19937 rng(20261017);
+    ol::CompactTrieMap<int> trie;
+    std::map<std::string, int> expect;
+
+    printf("🔍 随机插入、覆盖、删除\n");
+    for (int op = 0; op < OPS; ++op)
+    {
+        std::string key = make_key(rng, 8);
+        if (rng() % 3 == 0)
+        {
+            trie.remove(key);
+            expect.erase(key);
+        }
+        else
+        {
+            trie.put(key, op);
+            expect[key] = op;
+        }
+        if (op % 5000 == 4999 && !check_queries(trie, expect, rng, "修改阶段")) return -1;
+    }
+
+    printf("🔍 freeze后的双数组Trie\n");
+    trie.freeze();
+    trie.freeze(); // 重复调用无副作用
+    if (!trie.frozen() || !check_queries(trie, expect, rng, "冻结后")) return -1;
+    bool thrown = false;
+    try
+    {
+        trie.put("abc", 1);
+    }
+    catch (const std::logic_error&)
+    {
+        thrown = true;
+    }
+    if (!thrown)
+    {
+        printf("❌ 冻结后put没有抛出异常\n");
+        return -1;
+    }
+
+    printf("🔍 CompactTrieSet与空树\n");
+    ol::CompactTrieSet set;
+    for (const auto& kv : expect) set.put(kv.first);
+    set.freeze();
+    for (const auto& kv : expect)
+    {
+        if (!set.has(kv.first))
+        {
+            printf("❌ 集合中缺少\"%s\"\n", kv.first.c_str());
+            return -1;
+        }
+    }
+    ol::CompactTrieMap<int> empty;
+    empty.freeze();
+    if (empty.size() != 0 || empty.has("") || empty.hasPrefix("a") || !empty.keysByPrefix("").empty())
+    {
+        printf("❌ 空树冻结后的查询结果错误\n");
+        return -1;
+    }
+
+    printf("✅ CompactTrieMap测试通过（%zu个键）\n", expect.size());
+    return 0;
+}
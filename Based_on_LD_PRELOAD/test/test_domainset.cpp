@@ -0,0 +1,115 @@
+#include "ol_DomainSet.h"
+#include <stdio.h>
+#include <random>
+#include <set>
+
+// DomainSet构建后加载（load）或mmap（open）时会校验rank/select索引；
+// 边数扫过多个512比特块的边界，确认每个大小的集合都能加载且查询结果与std::set一致
+
+const int MAX_KEYS = 600; // 约4500条边，覆盖8个左右的块边界
+
+/**
+ * @brief 生成一个随机主机名（1~3个标签加顶级域名）
+ */
+static std::string make_host(std::mt19937& rng)
+{
+    static const char* tlds[] = {"com", "net", "org", "cn"};
+    std::string host;
+    int labels = 1 + static_cast<int>(rng() % 3);
+    for (int ii = 0; ii < labels; ++ii)
+    {
+        int len = 1 + static_cast<int>(rng() % 6);
+        for (int jj = 0; jj < len; ++jj) host += static_cast<char>('a' + rng() % 26);
+        host += '.';
+    }
+    host += tlds[rng() % 4];
+    return host;
+}
+
+/**
+ * @brief 构建并加载集合，逐个核对成员
+ * @return 成功返回边数，失败返回-1
+ */
+static long check_set(const std::vector<std::string>& hosts, std::mt19937& rng)
+{
+    ol::DomainSetBuilder builder;
+    std::set<std::string> expect;
+    for (const auto& h : hosts)
+    {
+        builder.add(h);
+        expect.insert(h);
+    }
+    std::string data = builder.build();
+    long edges = static_cast<long>(reinterpret_cast<const ol::base::st_dsethead*>(data.data())->m_edges);
+
+    ol::DomainSet set;
+    if (!set.load(data))
+    {
+        printf("❌ %zu个主机名（%ld条边）的集合加载失败\n", hosts.size(), edges);
+        return -1;
+    }
+    if (set.size() != expect.size())
+    {
+        printf("❌ 集合大小%zu，应为%zu\n", set.size(), expect.size());
+        return -1;
+    }
+    for (const auto& h : hosts)
+    {
+        if (!set.has(h) || !set.hasSuffix("www." + h))
+        {
+            printf("❌ %s未命中\n", h.c_str());
+            return -1;
+        }
+    }
+    for (int ii = 0; ii < 50; ++ii)
+    {
+        std::string h = make_host(rng);
+        if (set.has(h) != (expect.count(h) > 0))
+        {
+            printf("❌ %s的查询结果错误\n", h.c_str());
+            return -1;
+        }
+    }
+    return edges;
+}
+
+int main()
+{
+    printf("🔍 边数跨越512比特块边界的集合均能加载\n");
+    std::mt19937 rng(20261017);
+    std::vector<std::string> hosts;
+    std::set<long> nearBoundary; // 边数落在块边界前64比特内（最后一个字恰好填满一个块）的块号
+    for (int n = 1; n <= MAX_KEYS; ++n)
+    {
+        hosts.push_back(make_host(rng));
+        long edges = check_set(hosts, rng);
+        if (edges < 0) return -1;
+        if (edges % 512 > 448) nearBoundary.insert(edges / 512);
+    }
+    if (nearBoundary.size() < 4)
+    {
+        printf("❌ 只覆盖了%zu个块边界\n", nearBoundary.size());
+        return -1;
+    }
+
+    printf("🔍 500个两级主机名（边数正好落在块边界前）\n");
+    std::vector<std::string> two;
+    for (int ii = 0; ii < 500; ++ii) two.push_back("h" + std::to_string(ii) + ".com");
+    if (check_set(two, rng) < 0) return -1; // 505条边，末字填满第一个块
+
+    printf("🔍 写入文件后mmap打开\n");
+    ol::DomainSetBuilder builder;
+    for (const auto& h : two) builder.add(h);
+    const char* filename = "/tmp/test_domainset.dset";
+    ol::DomainSet set;
+    if (!builder.save(filename) || !set.open(filename) || !set.hasSuffix("a.h499.com") || set.has("h500.com"))
+    {
+        printf("❌ 文件读写失败\n");
+        return -1;
+    }
+    set.close();
+    remove(filename);
+
+    printf("✅ DomainSet测试通过（覆盖%zu个块边界）\n", nearBoundary.size());
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include "ol_hash.h"
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 高速哈希：hash_bytes各长度分支（0~3、4~16、17~48、超过48字节的三路并行）中每个输入比特都影响结果且雪崩充分，
+// 不依赖地址对齐；种子对所有快速路径都生效（含IPv6地址一半恰好等于常数的情况）；
+// 地址键在哈希表低位上分布均匀；哈希函数对象与各函数的结果一致
+
+const int MAX_LEN = 130;
+
+/**
+ * @brief 两个64位值不同的比特数
+ */
+static int bit_diff(uint64_t a, uint64_t b)
+{
+    return __builtin_popcountll(a ^ b);
+}
+
+/**
+ * @brief 逐比特翻转各长度的随机输入：结果都变化，平均翻转的输出比特数接近32
+ * @return 成功返回true
+ */
+static bool check_bytes_avalanche(std::mt19937_64& rng)
+{
+    long flips = 0, changed = 0;
+    std::vector<uint8_t> buf(MAX_LEN);
+    for (size_t len = 1; len <= MAX_LEN; ++len)
+    {
+        for (auto& b : buf) b = static_cast<uint8_t>(rng());
+        uint64_t h = ol::hash_bytes(buf.data(), len);
+        for (size_t bit = 0; bit < len * 8; ++bit)
+        {
+            buf[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+            uint64_t h2 = ol::hash_bytes(buf.data(), len);
+            buf[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+            if (h2 == h)
+            {
+                printf("❌ 长度%zu的输入翻转第%zu比特后哈希不变\n", len, bit);
+                return false;
+            }
+            changed += bit_diff(h, h2);
+            ++flips;
+        }
+    }
+    double avg = static_cast<double>(changed) / flips;
+    if (avg < 31.0 || avg > 33.0)
+    {
+        printf("❌ 平均翻转%.2f个输出比特，应接近32\n", avg);
+        return false;
+    }
+
+    // 内容相同、长度不同（全0）的输入互不相同；未对齐的地址结果不变
+    std::unordered_set<uint64_t> zeros;
+    std::vector<uint8_t> zero(MAX_LEN + 8, 0);
+    for (size_t len = 0; len <= MAX_LEN; ++len) zeros.insert(ol::hash_bytes(zero.data(), len));
+    if (zeros.size() != MAX_LEN + 1)
+    {
+        printf("❌ 不同长度的全0输入发生冲突\n");
+        return false;
+    }
+    for (size_t len = 0; len <= MAX_LEN; ++len)
+    {
+        for (auto& b : buf) b = static_cast<uint8_t>(rng());
+        for (size_t off = 1; off < 8; ++off)
+        {
+            memcpy(zero.data() + off, buf.data(), len);
+            if (ol::hash_bytes(zero.data() + off, len) != ol::hash_bytes(buf.data(), len))
+            {
+                printf("❌ 长度%zu的输入偏移%zu字节后哈希变化\n", len, off);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 种子对每个函数都生效；IPv6地址后8字节恰好等于HASH_SECRET1（或前8字节等于HASH_SECRET0）时
+ *        结果仍随种子和另一半地址变化
+ * @return 成功返回true
+ */
+static bool check_seeds(std::mt19937_64& rng)
+{
+    uint8_t addr[16];
+    uint64_t halves[2][2] = {{rng(), ol::base::HASH_SECRET1}, {ol::base::HASH_SECRET0, rng()}};
+    for (auto& half : halves)
+    {
+        memcpy(addr, &half[0], 8);
+        memcpy(addr + 8, &half[1], 8);
+        std::unordered_set<uint64_t> bySeed, byPort;
+        for (uint64_t seed = 1; seed <= 256; ++seed)
+        {
+            bySeed.insert(ol::hash_addr16(addr, seed));
+            byPort.insert(ol::hash_addr18(addr, static_cast<uint16_t>(seed), 12345));
+        }
+        std::unordered_set<uint64_t> byAddr;
+        for (int ii = 0; ii < 256; ++ii)
+        {
+            addr[ii % 2 ? 0 : 15] = static_cast<uint8_t>(ii); // 只改动另一半
+            byAddr.insert(ol::hash_addr16(addr, 777));
+        }
+        if (bySeed.size() != 256 || byPort.size() != 256 || byAddr.size() < 250)
+        {
+            printf("❌ IPv6地址哈希对种子、端口或地址不敏感（%zu/%zu/%zu）\n", bySeed.size(), byPort.size(), byAddr.size());
+            return false;
+        }
+    }
+
+    const char* text = "www.example.com";
+    for (uint64_t seed = 1; seed < 64; ++seed)
+    {
+        if (ol::hash_bytes(text, strlen(text), seed) == ol::hash_bytes(text, strlen(text), seed - 1) ||
+            ol::hash_u64(42, seed) == ol::hash_u64(42, seed - 1) ||
+            ol::hash_addr4(0x0A000001, 80, seed) == ol::hash_addr4(0x0A000001, 80, seed - 1))
+        {
+            printf("❌ 种子%lu不影响哈希结果\n", seed);
+            return false;
+        }
+    }
+    if (ol::hash_random_seed() != ol::hash_random_seed())
+    {
+        printf("❌ 进程随机种子不稳定\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 连续的IPv4地址+端口放进1024个桶（取哈希低位），最满的桶不超过平均值的1.5倍
+ * @return 成功返回true
+ */
+static bool check_distribution()
+{
+    const int BUCKETS = 1024, KEYS = 1 << 20;
+    std::vector<int> buckets(BUCKETS, 0);
+    for (int ii = 0; ii < KEYS; ++ii)
+        ++buckets[ol::hash_addr4(0xC0A80000 + static_cast<uint32_t>(ii >> 4), static_cast<uint16_t>(8000 + (ii & 15))) & (BUCKETS - 1)];
+    int maxFill = *std::max_element(buckets.begin(), buckets.end());
+    if (maxFill > KEYS / BUCKETS * 3 / 2)
+    {
+        printf("❌ 最满的桶有%d个键，平均%d个\n", maxFill, KEYS / BUCKETS);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 哈希函数对象与对应函数一致，可以用作unordered_map的哈希参数；hash_val对参数顺序敏感
+ * @return 成功返回true
+ */
+static bool check_functors()
+{
+    std::string s = "ads.example.org";
+    if (ol::Hash<std::string>()(s) != ol::hash_string(s) || ol::Hash<std::string_view>()(s) != ol::hash_string(s) ||
+        ol::SeededHash<std::string>(9)(s) != ol::hash_string(s, 9) || ol::Hash<uint32_t>()(7) != ol::hash_u64(7))
+    {
+        printf("❌ 哈希函数对象与哈希函数的结果不一致\n");
+        return false;
+    }
+
+    std::unordered_map<std::string, int, ol::SeededHash<std::string>> map;
+    for (int ii = 0; ii < 10000; ++ii) map["h" + std::to_string(ii) + ".com"] = ii;
+    for (int ii = 0; ii < 10000; ++ii)
+    {
+        auto it = map.find("h" + std::to_string(ii) + ".com");
+        if (it == map.end() || it->second != ii)
+        {
+            printf("❌ unordered_map查找失败\n");
+            return false;
+        }
+    }
+
+    if (ol::hash_val(1, 2) == ol::hash_val(2, 1) || ol::hash_val(1, 2) != ol::hash_val(1, 2))
+    {
+        printf("❌ hash_val的结果错误\n");
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    std::mt19937_64 rng(20261017);
+
+    printf("🔍 hash_bytes各长度的雪崩与对齐\n");
+    if (!check_bytes_avalanche(rng)) return -1;
+
+    printf("🔍 种子与IPv6地址哈希\n");
+    if (!check_seeds(rng)) return -1;
+
+    printf("🔍 地址键的桶分布\n");
+    if (!check_distribution()) return -1;
+
+    printf("🔍 哈希函数对象\n");
+    if (!check_functors()) return -1;
+
+    printf("✅ 哈希测试通过\n");
+    return 0;
+}
@@ -0,0 +1,267 @@
+#include "ol_lfqueue.h"
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// spsc/mpsc/mpmc三种无锁队列：单线程下的满/空边界和批量操作，
+// 多线程下每个元素恰好出队一次且同一生产者的元素保持先后顺序，
+// 阻塞版本的超时与唤醒，以及放在共享内存中跨进程使用
+
+const int PRODUCERS = 4;
+const int CONSUMERS = 4;
+const int ITEMS = 200000; // 每个生产者入队的元素个数
+
+/**
+ * @brief 单线程检查满/空边界、FIFO顺序和push_n/pop_n
+ * @return 成功返回true
+ */
+template <typename Queue>
+static bool check_single(Queue& q, const char* name)
+{
+    const int cap = static_cast<int>(Queue::capacity());
+    int v;
+    if (!q.empty() || q.pop(v))
+    {
+        printf("❌ %s新建的队列不为空\n", name);
+        return false;
+    }
+    for (int ii = 0; ii < cap; ++ii)
+    {
+        if (!q.push(ii))
+        {
+            printf("❌ %s第%d个元素入队失败\n", name, ii);
+            return false;
+        }
+    }
+    if (q.push(cap) || q.size() != static_cast<size_t>(cap))
+    {
+        printf("❌ %s队列满时仍可入队\n", name);
+        return false;
+    }
+    for (int ii = 0; ii < cap; ++ii)
+    {
+        if (!q.pop(v) || v != ii)
+        {
+            printf("❌ %s第%d个出队元素错误\n", name, ii);
+            return false;
+        }
+    }
+
+    // 批量入队只能放下剩余空位，批量出队保持顺序，下标绕过数组末尾
+    std::vector<int> in(cap + 10), out(cap + 10);
+    for (int ii = 0; ii < cap + 10; ++ii) in[ii] = 1000 + ii;
+    q.push(1);
+    if (q.push_n(in.begin(), in.size()) != static_cast<size_t>(cap - 1))
+    {
+        printf("❌ %s批量入队个数错误\n", name);
+        return false;
+    }
+    if (!q.pop(v) || v != 1 || q.pop_n(out.begin(), out.size()) != static_cast<size_t>(cap - 1))
+    {
+        printf("❌ %s批量出队个数错误\n", name);
+        return false;
+    }
+    for (int ii = 0; ii < cap - 1; ++ii)
+    {
+        if (out[ii] != 1000 + ii)
+        {
+            printf("❌ %s批量出队顺序错误\n", name);
+            return false;
+        }
+    }
+    return q.empty();
+}
+
+/**
+ * @brief 元素不可平凡复制时，出队后移出、队列析构时析构剩余元素
+ * @return 成功返回true
+ */
+static bool check_nontrivial()
+{
+    auto probe = std::make_shared<int>(0);
+    {
+        auto q = std::make_unique<ol::mpmc_queue<std::shared_ptr<int>, 8>>();
+        for (int ii = 0; ii < 5; ++ii) q->push(probe);
+        std::shared_ptr<int> out;
+        q->pop(out);
+        if (probe.use_count() != 6)
+        {
+            printf("❌ 出队后引用计数%ld，应为6\n", probe.use_count());
+            return false;
+        }
+    }
+    if (probe.use_count() != 1)
+    {
+        printf("❌ 队列析构后引用计数%ld，应为1\n", probe.use_count());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 多个生产者（元素为生产者编号<<32|序号）、多个消费者并发收发，
+ *        核对每个元素恰好出队一次，且同一消费者看到的同一生产者的元素是递增的
+ * @return 成功返回true
+ */
+template <typename Queue>
+static bool check_concurrent(Queue& q, int producers, int consumers, const char* name)
+{
+    std::vector<std::vector<uint64_t>> got(consumers);
+    std::atomic_int finished{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&q, &finished, p]()
+                             {
+            for (uint64_t ii = 0; ii < ITEMS; ++ii)
+                while (!q.push((static_cast<uint64_t>(p) << 32) | ii)) std::this_thread::yield();
+            finished.fetch_add(1); });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&q, &finished, &got, producers, c]()
+                             {
+            uint64_t buf[16];
+            while (true)
+            {
+                size_t n = q.pop_n(buf, 16);
+                if (n == 0)
+                {
+                    if (finished.load() == producers && q.empty()) break;
+                    std::this_thread::yield();
+                    continue;
+                }
+                got[c].insert(got[c].end(), buf, buf + n);
+            } });
+    }
+    for (auto& t : threads) t.join();
+
+    std::vector<uint32_t> seen(static_cast<size_t>(producers) * ITEMS, 0);
+    for (int c = 0; c < consumers; ++c)
+    {
+        std::vector<int64_t> last(producers, -1);
+        for (uint64_t v : got[c])
+        {
+            int p = static_cast<int>(v >> 32);
+            int64_t seq = static_cast<int64_t>(v & 0xFFFFFFFF);
+            if (p >= producers || seq >= ITEMS || seq <= last[p])
+            {
+                printf("❌ %s消费者%d收到乱序或越界的元素%d:%ld\n", name, c, p, seq);
+                return false;
+            }
+            last[p] = seq;
+            ++seen[static_cast<size_t>(p) * ITEMS + seq];
+        }
+    }
+    for (size_t ii = 0; ii < seen.size(); ++ii)
+    {
+        if (seen[ii] != 1)
+        {
+            printf("❌ %s元素%zu出队%u次\n", name, ii, seen[ii]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 阻塞版本：空队列pop_wait超时返回false；另一个线程入队后等待者被唤醒
+ * @return 成功返回true
+ */
+static bool check_blocking()
+{
+    auto q = std::make_unique<ol::mpmc_queue<int, 4, true>>();
+    int v;
+    auto start = std::chrono::steady_clock::now();
+    if (q->pop_wait(v, std::chrono::milliseconds(50)))
+    {
+        printf("❌ 空队列pop_wait没有超时\n");
+        return false;
+    }
+    if (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(40))
+    {
+        printf("❌ pop_wait提前返回\n");
+        return false;
+    }
+
+    std::thread producer([&q]()
+                         {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for (int ii = 0; ii < 100; ++ii) q->push_wait(ii); });
+    for (int ii = 0; ii < 100; ++ii)
+    {
+        if (!q->pop_wait(v, std::chrono::milliseconds(2000)) || v != ii)
+        {
+            printf("❌ 阻塞出队第%d个元素错误\n", ii);
+            producer.join();
+            return false;
+        }
+    }
+    producer.join();
+    return true;
+}
+
+/**
+ * @brief 队列放在MAP_SHARED内存中，子进程入队、父进程阻塞出队
+ * @return 成功返回true
+ */
+static bool check_process_shared()
+{
+    using Queue = ol::spsc_queue<uint64_t, 64, true>;
+    void* addr = mmap(nullptr, sizeof(Queue), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) return false;
+    Queue* q = new (addr) Queue(true);
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        for (uint64_t ii = 0; ii < ITEMS; ++ii) q->push_wait(ii);
+        _exit(0);
+    }
+
+    bool ok = true;
+    uint64_t v;
+    for (uint64_t ii = 0; ii < ITEMS && ok; ++ii)
+        ok = q->pop_wait(v, std::chrono::milliseconds(2000)) && v == ii;
+    waitpid(pid, nullptr, 0);
+    q->~Queue();
+    munmap(addr, sizeof(Queue));
+    if (!ok) printf("❌ 跨进程队列收到的元素错误\n");
+    return ok;
+}
+
+int main()
+{
+    printf("🔍 满/空边界、FIFO顺序和批量操作\n");
+    {
+        auto spsc = std::make_unique<ol::spsc_queue<int, 16>>();
+        auto mpsc = std::make_unique<ol::mpsc_queue<int, 16>>();
+        auto mpmc = std::make_unique<ol::mpmc_queue<int, 16>>();
+        if (!check_single(*spsc, "spsc") || !check_single(*mpsc, "mpsc") || !check_single(*mpmc, "mpmc")) return -1;
+    }
+    if (!check_nontrivial()) return -1;
+
+    printf("🔍 多线程并发收发\n");
+    {
+        auto spsc = std::make_unique<ol::spsc_queue<uint64_t, 1024>>();
+        auto mpsc = std::make_unique<ol::mpsc_queue<uint64_t, 1024>>();
+        auto mpmc = std::make_unique<ol::mpmc_queue<uint64_t, 1024>>();
+        if (!check_concurrent(*spsc, 1, 1, "spsc") || !check_concurrent(*mpsc, PRODUCERS, 1, "mpsc") ||
+            !check_concurrent(*mpmc, PRODUCERS, CONSUMERS, "mpmc"))
+            return -1;
+    }
+
+    printf("🔍 阻塞等待与超时\n");
+    if (!check_blocking()) return -1;
+
+    printf("🔍 共享内存中跨进程使用\n");
+    if (!check_process_shared()) return -1;
+
+    printf("✅ 无锁队列测试通过\n");
+    return 0;
+}
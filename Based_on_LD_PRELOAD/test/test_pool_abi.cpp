@@ -0,0 +1,68 @@
+#include "ol_TaskPool.h"
+#include "ol_ThreadPool.h"
+#include "ol_net/ol_TcpServer.h"
+#include <stdio.h>
+
+// TcpServer内嵌ThreadPool<false>，其成员函数编译在libol.a中；
+// 头文件中ThreadPool的布局一旦与libol.a不一致（如给它加车道、工作窃取等成员），
+// 先运行线程池任务再构造TcpServer就会崩溃
+
+const int TASK_NUM = 1000;
+
+/**
+ * @brief 向线程池提交TASK_NUM个任务并等待全部完成
+ * @return 全部完成返回true
+ */
+template <typename Pool>
+static bool run_tasks(Pool& pool)
+{
+    std::atomic_int done{0};
+    for (int ii = 0; ii < TASK_NUM; ++ii)
+    {
+        if (!pool.addTask([&done]()
+                          { done.fetch_add(1, std::memory_order_relaxed); }))
+            return false;
+    }
+    for (int ii = 0; ii < 5000 && done.load() < TASK_NUM; ++ii)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return done.load() == TASK_NUM;
+}
+
+/**
+ * @brief 构造并销毁一个TcpServer（端口0由系统分配）
+ */
+static void make_server()
+{
+    ol::TcpServer* server = new ol::TcpServer("127.0.0.1", 0, 2);
+    delete server;
+}
+
+int main()
+{
+    printf("🔍 ThreadPool<false>任务后构造TcpServer\n");
+    {
+        ol::ThreadPool<false> pool(2);
+        if (!run_tasks(pool))
+        {
+            printf("❌ ThreadPool任务未全部完成\n");
+            return -1;
+        }
+    }
+    make_server();
+
+    printf("🔍 TaskPool（工作窃取、优先级车道）与TcpServer同时使用\n");
+    {
+        ol::TaskPool<false> stealing(2, 0, true);
+        ol::TaskPool<false> laned(2);
+        laned.setLanes({{1, 1}, {1, 0}});
+        if (!run_tasks(stealing) || !run_tasks(laned))
+        {
+            printf("❌ TaskPool任务未全部完成\n");
+            return -1;
+        }
+        make_server();
+    }
+
+    printf("✅ 线程池布局与libol.a一致（符合预期）\n");
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include "ol_sort.h"
+#include <deque>
+#include <limits>
+#include <random>
+#include <stdio.h>
+
+// 字节基数排序与并行排序：各宽度的有符号/无符号整数（含极值、__int128）与std::sort结果一致，
+// 按键排序是稳定的（与std::stable_sort一致），非连续容器走复制路径，
+// 并行版本在固定线程池、动态线程池和临时线程池上，以及最高字节全部相同（只有一个桶）时结果正确
+
+const size_t SMALL = 1000;
+const size_t LARGE = 1 << 19; // 超过并行阈值，会真正分块
+
+// 按键排序的记录：键重复很多，seq记录原始顺序，用于检查稳定性
+struct Record
+{
+    int32_t key;
+    uint32_t seq;
+
+    bool operator==(const Record& other) const { return key == other.key && seq == other.seq; }
+};
+
+/**
+ * @brief 生成n个随机整数，混入类型的最小值、最大值、0和-1
+ */
+template <typename T>
+static std::vector<T> make_ints(std::mt19937_64& rng, size_t n)
+{
+    std::vector<T> v(n);
+    for (auto& x : v) x = static_cast<T>(rng());
+    if (n >= 4)
+    {
+        v[0] = std::numeric_limits<T>::min();
+        v[1] = std::numeric_limits<T>::max();
+        v[2] = 0;
+        v[3] = static_cast<T>(-1);
+    }
+    return v;
+}
+
+/**
+ * @brief 生成n条记录，键取自[-range/2, range/2)
+ */
+static std::vector<Record> make_records(std::mt19937_64& rng, size_t n, int32_t range)
+{
+    std::vector<Record> v(n);
+    for (size_t ii = 0; ii < n; ++ii) v[ii] = {static_cast<int32_t>(rng() % range) - range / 2, static_cast<uint32_t>(ii)};
+    return v;
+}
+
+/**
+ * @brief radix_sort的结果与std::sort一致（各种长度，包括0和1）
+ * @return 成功返回true
+ */
+template <typename T>
+static bool check_radix(std::mt19937_64& rng, const char* name)
+{
+    for (size_t n : {size_t(0), size_t(1), size_t(2), size_t(17), SMALL, LARGE / 8})
+    {
+        std::vector<T> v = make_ints<T>(rng, n), expect = v;
+        std::sort(expect.begin(), expect.end());
+        ol::radix_sort(v);
+        if (v != expect)
+        {
+            printf("❌ %s的%zu个元素基数排序结果错误\n", name, n);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 单线程各整数类型、非连续容器、只有低字节不同的输入，以及按键排序的稳定性
+ * @return 成功返回true
+ */
+static bool check_serial(std::mt19937_64& rng)
+{
+    if (!check_radix<int8_t>(rng, "int8") || !check_radix<uint16_t>(rng, "uint16") || !check_radix<int32_t>(rng, "int32") ||
+        !check_radix<uint32_t>(rng, "uint32") || !check_radix<int64_t>(rng, "int64") || !check_radix<uint64_t>(rng, "uint64"))
+        return false;
+#ifdef __SIZEOF_INT128__
+    {
+        std::vector<__int128> v(SMALL);
+        for (auto& x : v) x = static_cast<__int128>((static_cast<unsigned __int128>(rng()) << 64) | rng());
+        std::vector<__int128> expect = v;
+        std::sort(expect.begin(), expect.end());
+        ol::radix_sort(v);
+        if (v != expect)
+        {
+            printf("❌ __int128基数排序结果错误\n");
+            return false;
+        }
+    }
+#endif
+
+    std::deque<int64_t> dq;
+    for (size_t ii = 0; ii < SMALL; ++ii) dq.push_back(static_cast<int64_t>(rng()));
+    std::vector<int64_t> dqExpect(dq.begin(), dq.end());
+    std::sort(dqExpect.begin(), dqExpect.end());
+    ol::radix_sort(dq);
+    if (!std::equal(dq.begin(), dq.end(), dqExpect.begin()))
+    {
+        printf("❌ deque基数排序结果错误\n");
+        return false;
+    }
+
+    // 高位字节全部相同（各轮跳过），只有最低字节不同
+    std::vector<uint64_t> same(SMALL);
+    for (auto& x : same) x = 0x1122334455667700ULL | (rng() & 0xFF);
+    std::vector<uint64_t> sameExpect = same;
+    std::sort(sameExpect.begin(), sameExpect.end());
+    ol::radix_sort(same);
+    if (same != sameExpect)
+    {
+        printf("❌ 高位相同的输入基数排序结果错误\n");
+        return false;
+    }
+
+    std::vector<Record> rec = make_records(rng, SMALL * 10, 50), recExpect = rec;
+    std::stable_sort(recExpect.begin(), recExpect.end(), [](const Record& a, const Record& b)
+                     { return a.key < b.key; });
+    ol::radix_sort_by_key(rec, [](const Record& r)
+                          { return r.key; });
+    if (rec != recExpect)
+    {
+        printf("❌ 按键基数排序不稳定或结果错误\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 在给定线程池上并行排序：比较排序（含自定义比较器、deque）和稳定的按键基数排序
+ * @return 成功返回true
+ */
+template <bool IsDynamic>
+static bool check_parallel(ol::TaskPool<IsDynamic>& pool, std::mt19937_64& rng, const char* name)
+{
+    std::vector<uint64_t> v = make_ints<uint64_t>(rng, LARGE), expect = v;
+    std::sort(expect.begin(), expect.end(), std::greater<uint64_t>());
+    ol::parallel_sort(pool, v.begin(), v.end(), std::greater<uint64_t>());
+    if (v != expect)
+    {
+        printf("❌ %s：并行比较排序结果错误\n", name);
+        return false;
+    }
+
+    std::deque<int32_t> dq;
+    for (size_t ii = 0; ii < LARGE / 4; ++ii) dq.push_back(static_cast<int32_t>(rng()));
+    std::vector<int32_t> dqExpect(dq.begin(), dq.end());
+    std::sort(dqExpect.begin(), dqExpect.end());
+    ol::parallel_sort(pool, dq.begin(), dq.end());
+    if (!std::equal(dq.begin(), dq.end(), dqExpect.begin()))
+    {
+        printf("❌ %s：deque并行排序结果错误\n", name);
+        return false;
+    }
+
+    // 键的范围分别覆盖全部最高字节和只落在一个最高字节桶中
+    for (int32_t range : {std::numeric_limits<int32_t>::max(), 200})
+    {
+        std::vector<Record> rec = make_records(rng, LARGE, range), recExpect = rec;
+        std::stable_sort(recExpect.begin(), recExpect.end(), [](const Record& a, const Record& b)
+                         { return a.key < b.key; });
+        ol::parallel_radix_sort_by_key(pool, rec.begin(), rec.end(), [](const Record& r)
+                                       { return r.key; });
+        if (rec != recExpect)
+        {
+            printf("❌ %s：键范围%d的并行按键基数排序不稳定或结果错误\n", name, range);
+            return false;
+        }
+    }
+
+    std::vector<int64_t> ints = make_ints<int64_t>(rng, LARGE), intsExpect = ints;
+    std::sort(intsExpect.begin(), intsExpect.end());
+    ol::parallel_radix_sort(pool, ints.begin(), ints.end());
+    if (ints != intsExpect)
+    {
+        printf("❌ %s：并行基数排序结果错误\n", name);
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    std::mt19937_64 rng(20261017);
+
+    printf("🔍 单线程字节基数排序\n");
+    if (!check_serial(rng)) return -1;
+
+    printf("🔍 固定线程池（含工作窃取）上的并行排序\n");
+    {
+        ol::TaskPool<false> pool(4);
+        ol::TaskPool<false> stealing(4, 0, true);
+        if (!check_parallel(pool, rng, "固定线程池") || !check_parallel(stealing, rng, "工作窃取线程池")) return -1;
+    }
+
+    printf("🔍 动态线程池上的并行排序\n");
+    {
+        ol::TaskPool<true> pool(1, 4);
+        if (!check_parallel(pool, rng, "动态线程池")) return -1;
+    }
+
+    printf("🔍 临时线程池的容器版本\n");
+    std::vector<std::string> words(LARGE / 8);
+    for (auto& w : words) w = std::to_string(rng());
+    std::vector<std::string> wordsExpect = words;
+    std::sort(wordsExpect.begin(), wordsExpect.end());
+    ol::parallel_sort(words, std::less<std::string>(), 4);
+    std::vector<uint32_t> ints = make_ints<uint32_t>(rng, LARGE), intsExpect = ints;
+    std::sort(intsExpect.begin(), intsExpect.end());
+    ol::parallel_radix_sort(ints, 4);
+    if (words != wordsExpect || ints != intsExpect)
+    {
+        printf("❌ 临时线程池并行排序结果错误\n");
+        return -1;
+    }
+
+    printf("✅ 排序测试通过\n");
+    return 0;
+}
@@ -0,0 +1,604 @@
+#include "ol_TaskPool.h"
+#include "ol_ThreadPool.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// TaskPool的调度功能（test_pool_abi只检查与libol.a的布局兼容）：
+// 工作窃取模式下工作线程内派生的任务被其它线程窃取执行，外部线程并发提交不丢任务，
+// 队列满策略，以及停止时丢弃的排队任务被析构（与ThreadPool一样，stop()只等待正在执行的任务）；
+// 小对象内联的只可移动任务不做堆分配，批量提交与任务组（含异常传递和部分接受）；
+// 动态模式在积压时立即扩容、空闲超时后缩容、停止不被空闲等待拖住，以及运行统计；
+// 优先级车道的严格优先与加权轮转顺序、保留线程、各车道的队列满策略与配置校验
+
+using ms = std::chrono::milliseconds;
+
+const int TREE_DEPTH = 14;        // 递归派生的任务树深度（共2^15-1个任务）
+const int SUBMITTERS = 4;         // 并发提交任务的外部线程数
+const int SUBMIT_TASKS = 50000;   // 每个外部线程提交的任务数
+const int BATCH_TASKS = 10000;    // 批量提交的任务数
+
+// 统计本线程的堆分配次数（检查任务的内联存储）
+static thread_local long t_allocs = 0;
+
+void* operator new(size_t size)
+{
+    ++t_allocs;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+/**
+ * @brief 等待计数达到目标值
+ * @return 在timeout内达到返回true
+ */
+static bool wait_count(const std::atomic_long& count, long target, ms timeout = ms(10000))
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (count.load() < target)
+    {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(ms(1));
+    }
+    return true;
+}
+
+/**
+ * @brief 记录执行任务的线程
+ */
+struct ThreadSet
+{
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+
+    void add()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ids.insert(std::this_thread::get_id());
+    }
+};
+
+/**
+ * @brief 在工作线程内递归派生两个子任务（进入本地队列），直到depth为0
+ */
+template <typename Pool>
+static void spawn_tree(Pool& pool, int depth, std::atomic_long& done, ThreadSet& threads)
+{
+    if (depth > 0)
+    {
+        for (int ii = 0; ii < 2; ++ii)
+            pool.addTask([&pool, depth, &done, &threads]()
+                         { spawn_tree(pool, depth - 1, done, threads); });
+    }
+    // 叶子任务做一点工作，让其它线程有机会窃取
+    volatile uint64_t x = 0;
+    for (int ii = 0; ii < 2000; ++ii) x = x + ii;
+    threads.add();
+    done.fetch_add(1);
+}
+
+/**
+ * @brief 工作窃取：从一个根任务派生的整棵任务树全部执行，且由多个线程分担
+ * @return 成功返回true
+ */
+template <typename Pool>
+static bool check_spawn(Pool& pool, const char* name)
+{
+    std::atomic_long done{0};
+    ThreadSet threads;
+    const long total = (1L << (TREE_DEPTH + 1)) - 1;
+    pool.addTask([&pool, &done, &threads]()
+                 { spawn_tree(pool, TREE_DEPTH, done, threads); });
+    if (!wait_count(done, total))
+    {
+        printf("❌ %s：任务树只执行了%ld/%ld个任务\n", name, done.load(), total);
+        return false;
+    }
+    if (threads.ids.size() < 2)
+    {
+        printf("❌ %s：工作线程内派生的任务没有被其它线程窃取\n", name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 工作窃取：多个外部线程并发提交（进入全局队列），每个任务恰好执行一次；submitTask取得返回值
+ * @return 成功返回true
+ */
+static bool check_submitters()
+{
+    ol::TaskPool<false> pool(4, 0, true);
+    std::vector<std::atomic_int> hits(static_cast<size_t>(SUBMITTERS) * SUBMIT_TASKS);
+    std::atomic_long done{0};
+    std::vector<std::thread> submitters;
+    for (int s = 0; s < SUBMITTERS; ++s)
+    {
+        submitters.emplace_back([&, s]()
+                                {
+            for (int ii = 0; ii < SUBMIT_TASKS; ++ii)
+            {
+                size_t slot = static_cast<size_t>(s) * SUBMIT_TASKS + ii;
+                pool.addTask([&hits, &done, slot]()
+                             {
+                    hits[slot].fetch_add(1);
+                    done.fetch_add(1); });
+            } });
+    }
+    for (auto& t : submitters) t.join();
+    if (!wait_count(done, static_cast<long>(hits.size())))
+    {
+        printf("❌ 外部线程提交的任务只执行了%ld个\n", done.load());
+        return false;
+    }
+    for (size_t ii = 0; ii < hits.size(); ++ii)
+    {
+        if (hits[ii].load() != 1)
+        {
+            printf("❌ 任务%zu执行了%d次\n", ii, hits[ii].load());
+            return false;
+        }
+    }
+
+    auto result = pool.submitTask([](int a, int b)
+                                  { return a * b; },
+                                  6, 7);
+    if (!result.first || result.second.get() != 42)
+    {
+        printf("❌ 工作窃取模式下submitTask的返回值错误\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 工作窃取：全局队列满时拒绝策略返回false，超时策略等待后返回false；
+ *        stop()后排队的任务（执行或丢弃）都被析构
+ * @return 成功返回true
+ */
+static bool check_full_and_stop()
+{
+    std::atomic_bool release{false};
+    std::atomic_long done{0};
+    auto probe = std::make_shared<int>(0);
+    {
+        ol::TaskPool<false> pool(1, 4, true);
+        pool.addTask([&release]()
+                     { while (!release.load()) std::this_thread::sleep_for(ms(1)); });
+        std::this_thread::sleep_for(ms(50)); // 唯一的工作线程取走阻塞任务
+
+        int accepted = 0;
+        for (int ii = 0; ii < 8; ++ii)
+            accepted += pool.addTask([&done, probe]()
+                                     { done.fetch_add(1); });
+        if (accepted != 4)
+        {
+            printf("❌ 容量为4的全局队列接受了%d个任务\n", accepted);
+            return false;
+        }
+
+        pool.setTimeoutPolicy(ms(30));
+        auto start = std::chrono::steady_clock::now();
+        if (pool.addTask([]() {}) || std::chrono::steady_clock::now() - start < ms(25))
+        {
+            printf("❌ 超时策略没有等待后拒绝\n");
+            return false;
+        }
+        release = true;
+    } // 析构时stop()等待正在执行的阻塞任务，其余排队任务可能被丢弃
+    if (probe.use_count() != 1 || done.load() > 4)
+    {
+        printf("❌ 停止线程池后仍有%ld个任务未析构\n", probe.use_count() - 1);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief base::Task：不超过40字节的可调用对象内联保存（不分配），更大的分配一次；
+ *        可以保存只可移动的可调用对象，移动后原任务为空，reset时析构可调用对象
+ * @return 成功返回true
+ */
+static bool check_task()
+{
+    static_assert(sizeof(ol::base::Task) == 48, "Task should stay 48 bytes");
+    int hits = 0;
+    char pad32[32] = {};
+    char pad48[48] = {};
+
+    long before = t_allocs;
+    ol::base::Task small([&hits, pad32]()
+                         { hits += 1 + pad32[0]; });
+    if (t_allocs != before)
+    {
+        printf("❌ 40字节以内的任务做了堆分配\n");
+        return false;
+    }
+    ol::base::Task large([&hits, pad48]()
+                         { hits += 1 + pad48[0]; });
+    if (t_allocs != before + 1)
+    {
+        printf("❌ 超过40字节的任务做了%ld次堆分配，应为1次\n", t_allocs - before);
+        return false;
+    }
+
+    auto owned = std::make_unique<int>(5);
+    int* raw = owned.get();
+    ol::base::Task moveOnly([owned = std::move(owned), &hits]()
+                            { hits += *owned; });
+    ol::base::Task moved(std::move(moveOnly));
+    small();
+    large();
+    moved();
+    if (hits != 7 || moveOnly || !moved || *raw != 5)
+    {
+        printf("❌ 任务执行或移动的结果错误\n");
+        return false;
+    }
+
+    auto probe = std::make_shared<int>(0);
+    ol::base::Task holder([probe]() {});
+    holder.reset();
+    if (probe.use_count() != 1 || holder || ol::base::Task(std::function<void()>()))
+    {
+        printf("❌ 任务reset后没有析构可调用对象，或空std::function构造出了非空任务\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief addTasks/submitBatch批量提交与TaskGroup：全部执行后wait返回；任务异常由wait抛出且任务组可复用；
+ *        有界队列在拒绝策略下只接受前若干个任务，任务组计数只加实际接受的数量
+ * @return 成功返回true
+ */
+static bool check_batch_and_group()
+{
+    ol::TaskPool<false> pool(4);
+    std::atomic_long done{0};
+    std::vector<std::function<void()>> tasks;
+    for (int ii = 0; ii < BATCH_TASKS; ++ii)
+        tasks.emplace_back([&done]()
+                           { done.fetch_add(1); });
+    if (pool.addTasks(tasks) != static_cast<size_t>(BATCH_TASKS) || !wait_count(done, BATCH_TASKS))
+    {
+        printf("❌ addTasks批量提交的任务没有全部执行\n");
+        return false;
+    }
+
+    ol::TaskGroup group;
+    std::vector<std::function<void()>> groupTasks;
+    for (int ii = 0; ii < BATCH_TASKS; ++ii)
+        groupTasks.emplace_back([&done]()
+                                { done.fetch_add(1); });
+    groupTasks[BATCH_TASKS / 2] = []()
+    { throw std::runtime_error("batch"); };
+    pool.submitBatch(groupTasks, group);
+    bool thrown = false;
+    try
+    {
+        group.wait();
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    if (!thrown || done.load() != 2L * BATCH_TASKS - 1 || group.pending() != 0)
+    {
+        printf("❌ submitBatch任务组没有等到全部完成或没有抛出任务异常\n");
+        return false;
+    }
+
+    // 任务组可复用：单个提交，不再有异常
+    for (int ii = 0; ii < 100; ++ii)
+        pool.addTask([&done]()
+                     { done.fetch_add(1); },
+                     group);
+    group.wait();
+    if (done.load() != 2L * BATCH_TASKS + 99)
+    {
+        printf("❌ 复用的任务组结果错误\n");
+        return false;
+    }
+
+    // 有界队列：唯一的工作线程被占住，批量提交只接受队列容量内的任务
+    std::atomic_bool release{false};
+    ol::TaskPool<false> bounded(1, 8);
+    bounded.addTask([&release]()
+                    { while (!release.load()) std::this_thread::sleep_for(ms(1)); });
+    std::this_thread::sleep_for(ms(50));
+    std::vector<std::function<void()>> many(20, [&done]()
+                                            { done.fetch_add(1); });
+    ol::TaskGroup partial;
+    size_t accepted = bounded.submitBatch(many, partial);
+    if (accepted != 8 || partial.pending() != 8)
+    {
+        printf("❌ 容量为8的队列批量接受了%zu个任务，任务组计数%zu\n", accepted, partial.pending());
+        release = true;
+        return false;
+    }
+    release = true;
+    if (!partial.waitFor(ms(5000)))
+    {
+        printf("❌ 部分接受的任务组没有完成\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 动态模式：积压任务多于空闲线程时立即扩容到最大线程数，空闲超过keepAlive后缩回下限；
+ *        stop()不等待空闲线程的keepAlive；统计中的任务数、扩缩容次数和线程峰值
+ * @return 成功返回true
+ */
+static bool check_dynamic()
+{
+    static_assert(std::is_base_of<ol::TaskPool<true>, ol::ThreadPool<true>>::value, "ThreadPool<true> should be TaskPool<true>");
+
+    ol::ThreadPool<true> pool(1, 4, 0, ms(100));
+    if (pool.getWorkerNum() != 1) return false;
+
+    std::atomic_bool release{false};
+    std::atomic_long running{0}, done{0};
+    auto start = std::chrono::steady_clock::now();
+    for (int ii = 0; ii < 4; ++ii)
+    {
+        pool.addTask([&]()
+                     {
+            running.fetch_add(1);
+            while (!release.load()) std::this_thread::sleep_for(ms(1));
+            done.fetch_add(1); });
+    }
+    bool grown = wait_count(running, 4, ms(2000));
+    auto growMs = std::chrono::duration_cast<ms>(std::chrono::steady_clock::now() - start).count();
+    release = true;
+    if (!grown || growMs > 200)
+    {
+        printf("❌ 4个阻塞任务%s（%ld毫秒）\n", grown ? "等了太久才全部开始" : "没有全部开始", static_cast<long>(growMs));
+        return false;
+    }
+    if (!wait_count(done, 4)) return false;
+
+    // 空闲超过keepAlive后缩回下限
+    auto deadline = std::chrono::steady_clock::now() + ms(3000);
+    while (pool.getWorkerNum() > 1 && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(ms(10));
+    ol::TaskPoolStats stats = pool.getStats();
+    if (pool.getWorkerNum() != 1 || stats.scaleUps < 3 || stats.scaleDowns < 3 || stats.peakThreads != 4 || stats.completed != 4)
+    {
+        printf("❌ 缩容后线程数%zu，扩容%lu次，缩容%lu次，峰值%zu，完成%lu个任务\n", pool.getWorkerNum(),
+               stats.scaleUps, stats.scaleDowns, stats.peakThreads, stats.completed);
+        return false;
+    }
+    if (stats.utilization() < 0.0 || stats.utilization() > 1.0)
+    {
+        printf("❌ 利用率%.3f超出0~1\n", stats.utilization());
+        return false;
+    }
+
+    // keepAlive很长时，stop()也立即返回
+    ol::TaskPool<true> idle(2, 4, 0, ms(60000));
+    idle.addTask([]() {});
+    std::this_thread::sleep_for(ms(20));
+    start = std::chrono::steady_clock::now();
+    idle.stop();
+    auto stopMs = std::chrono::duration_cast<ms>(std::chrono::steady_clock::now() - start).count();
+    if (stopMs > 100)
+    {
+        printf("❌ stop()用了%ld毫秒\n", static_cast<long>(stopMs));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 占住线程池的全部工作线程，直到release置位
+ */
+template <typename Pool>
+static void block_workers(Pool& pool, size_t workers, std::atomic_bool& release)
+{
+    std::atomic_long started{0};
+    for (size_t ii = 0; ii < workers; ++ii)
+    {
+        pool.addTask([&release, &started]()
+                     {
+            started.fetch_add(1);
+            while (!release.load()) std::this_thread::sleep_for(ms(1)); });
+    }
+    wait_count(started, static_cast<long>(workers));
+}
+
+/**
+ * @brief 单个工作线程被占住时向两条车道各排入任务，放开后按调度策略记录执行顺序（车道号）
+ * @return 执行顺序
+ */
+static std::vector<int> run_lanes(bool strict, unsigned weight0, unsigned weight1, int perLane)
+{
+    ol::TaskPool<false> pool(1);
+    pool.setLanes({{weight0, 0, 0}, {weight1, 0, 0}}, strict);
+    std::atomic_bool release{false};
+    block_workers(pool, 1, release);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::atomic_long done{0};
+    for (int lane = 1; lane >= 0; --lane) // 低优先级车道先入队
+    {
+        for (int ii = 0; ii < perLane; ++ii)
+        {
+            pool.addLaneTask(static_cast<size_t>(lane), [&, lane]()
+                             {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(lane);
+                done.fetch_add(1); });
+        }
+    }
+    release = true;
+    wait_count(done, 2L * perLane);
+    return order;
+}
+
+/**
+ * @brief 严格优先：车道0的任务全部先于车道1执行；加权3:1：前20个任务中车道0约占15个
+ * @return 成功返回true
+ */
+static bool check_lane_order()
+{
+    std::vector<int> strict = run_lanes(true, 1, 1, 10);
+    for (size_t ii = 0; ii < strict.size(); ++ii)
+    {
+        if (strict[ii] != (ii < 10 ? 0 : 1))
+        {
+            printf("❌ 严格优先模式下第%zu个执行的任务来自车道%d\n", ii, strict[ii]);
+            return false;
+        }
+    }
+
+    std::vector<int> weighted = run_lanes(false, 3, 1, 40);
+    long lane0 = std::count(weighted.begin(), weighted.begin() + 20, 0);
+    if (weighted.size() != 80 || lane0 < 14 || lane0 > 16)
+    {
+        printf("❌ 权重3:1时前20个任务中车道0占%ld个\n", lane0);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 保留线程：车道1的长任务最多占用共享线程，车道0的任务仍能立即执行
+ * @return 成功返回true
+ */
+static bool check_reserved()
+{
+    ol::TaskPool<false> pool(3);
+    pool.setLanes({{1, 1, 0}, {1, 0, 0}});
+    std::atomic_bool release{false};
+    std::atomic_long running{0}, peak{0};
+    for (int ii = 0; ii < 10; ++ii)
+    {
+        pool.addLaneTask(1, [&]()
+                         {
+            long now = running.fetch_add(1) + 1;
+            long old = peak.load();
+            while (now > old && !peak.compare_exchange_weak(old, now)) {}
+            while (!release.load()) std::this_thread::sleep_for(ms(1));
+            running.fetch_sub(1); });
+    }
+    std::this_thread::sleep_for(ms(50));
+
+    std::atomic_long urgent{0};
+    pool.addLaneTask(0, [&urgent]()
+                     { urgent.fetch_add(1); });
+    bool served = wait_count(urgent, 1, ms(500));
+    long bulkPeak = peak.load();
+    release = true;
+    if (!served || bulkPeak != 2)
+    {
+        printf("❌ 保留线程无效（车道0的任务%s执行，车道1同时占用%ld个线程）\n", served ? "已" : "未", bulkPeak);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 各车道独立的容量与队列满策略、越界车道号、submitLaneTask，以及非法配置
+ * @return 成功返回true
+ */
+static bool check_lane_policies()
+{
+    ol::TaskPool<false> pool(1);
+    pool.setLanes({{1, 0, 2, ol::TaskPool<false>::QueueFullPolicy::kReject}, {1, 0, 0}});
+    if (pool.getLaneNum() != 2 || pool.getLanePolicy(0) != ol::TaskPool<false>::QueueFullPolicy::kReject)
+        return false;
+
+    std::atomic_bool release{false};
+    block_workers(pool, 1, release);
+    int accepted0 = 0, accepted1 = 0;
+    for (int ii = 0; ii < 5; ++ii)
+    {
+        accepted0 += pool.addLaneTask(0, []() {});
+        accepted1 += pool.addLaneTask(1, []() {});
+    }
+    bool outOfRange = pool.addLaneTask(2, []() {});
+    size_t queued0 = pool.getTaskNum(0), queued1 = pool.getTaskNum(1);
+    auto result = pool.submitLaneTask(1, []()
+                                      { return 7; });
+    release = true;
+    if (accepted0 != 2 || accepted1 != 5 || outOfRange || queued0 != 2 || queued1 != 5 || !result.first || result.second.get() != 7)
+    {
+        printf("❌ 车道容量或策略错误（车道0接受%d个，车道1接受%d个）\n", accepted0, accepted1);
+        return false;
+    }
+
+    bool badWeight = false, badStealing = false;
+    try
+    {
+        pool.setLanes({{0, 0, 0}});
+    }
+    catch (const std::invalid_argument&)
+    {
+        badWeight = true;
+    }
+    ol::TaskPool<false> stealing(2, 0, true);
+    try
+    {
+        stealing.setLanes({{1, 0, 0}, {1, 0, 0}});
+    }
+    catch (const std::logic_error&)
+    {
+        badStealing = true;
+    }
+    if (!badWeight || !badStealing)
+    {
+        printf("❌ 非法的车道配置没有抛出异常\n");
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    printf("🔍 工作窃取：工作线程内派生的任务树\n");
+    {
+        ol::TaskPool<false> fixed(4, 0, true);
+        ol::TaskPool<true> dynamic(1, 4, 0, ms(1000), true);
+        if (!check_spawn(fixed, "固定线程池") || !check_spawn(dynamic, "动态线程池")) return -1;
+    }
+
+    printf("🔍 工作窃取：外部线程并发提交\n");
+    if (!check_submitters()) return -1;
+
+    printf("🔍 工作窃取：队列满策略与停止\n");
+    if (!check_full_and_stop()) return -1;
+
+    printf("🔍 小对象内联的只可移动任务\n");
+    if (!check_task()) return -1;
+
+    printf("🔍 批量提交与任务组\n");
+    if (!check_batch_and_group()) return -1;
+
+    printf("🔍 动态扩缩容与运行统计\n");
+    if (!check_dynamic()) return -1;
+
+    printf("🔍 优先级车道\n");
+    if (!check_lane_order() || !check_reserved() || !check_lane_policies()) return -1;
+
+    printf("✅ TaskPool测试通过\n");
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include "ol_taskqueue.h"
+#include <memory>
+#include <poll.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// TaskQueue：只有由空变非空的入队要求唤醒，drain按入队顺序执行；
+// 超过内联大小的任务、队列析构时未执行的任务、任务抛出异常后剩余任务的顺序，
+// 以及多个生产者经eventfd唤醒单个消费者时不丢任务、不漏唤醒
+
+const int PRODUCERS = 4;
+const int ITEMS = 100000; // 每个生产者入队的任务数
+
+/**
+ * @brief 单线程：push的返回值、执行顺序、大任务、析构时只析构不执行
+ * @return 成功返回true
+ */
+static bool check_basic()
+{
+    std::vector<int> order;
+    ol::TaskQueue queue;
+    if (!queue.empty() || queue.drain() != 0) return false;
+    if (!queue.push([&order]() { order.push_back(0); }))
+    {
+        printf("❌ 空队列的第一次入队没有返回true\n");
+        return false;
+    }
+    char big[200] = {}; // 超过内联大小，可调用对象分配在堆上
+    for (int ii = 1; ii < 10; ++ii)
+    {
+        bool wake = (ii % 2) ? queue.push([&order, ii]() { order.push_back(ii); })
+                             : queue.push([&order, ii, big]() { order.push_back(ii + big[0]); });
+        if (wake)
+        {
+            printf("❌ 非空队列的入队返回了true\n");
+            return false;
+        }
+    }
+    if (queue.drain() != 10 || !queue.empty())
+    {
+        printf("❌ drain执行的任务数错误\n");
+        return false;
+    }
+    for (int ii = 0; ii < 10; ++ii)
+    {
+        if (order[ii] != ii)
+        {
+            printf("❌ 第%d个任务的执行顺序错误\n", ii);
+            return false;
+        }
+    }
+    if (!queue.push([]() {}))
+    {
+        printf("❌ drain之后的入队没有返回true\n");
+        return false;
+    }
+    queue.drain();
+
+    auto probe = std::make_shared<int>(0);
+    {
+        ol::TaskQueue pending;
+        char pad[100] = {};
+        pending.push([probe]() { ++*probe; });
+        pending.push([probe, pad]() { *probe += pad[0] + 1; });
+    }
+    if (*probe != 0 || probe.use_count() != 1)
+    {
+        printf("❌ 析构队列时执行了任务或没有析构任务\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 任务抛出异常：异常传给drain的调用者，本批剩余任务仍排在之后入队的任务前面
+ * @return 成功返回true
+ */
+static bool check_exception()
+{
+    std::vector<int> order;
+    ol::TaskQueue queue;
+    queue.push([&order]() { order.push_back(1); });
+    queue.push([]() { throw std::runtime_error("task"); });
+    queue.push([&order]() { order.push_back(2); });
+    queue.push([&order]() { order.push_back(3); });
+
+    bool thrown = false;
+    try
+    {
+        queue.drain();
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    queue.push([&order]() { order.push_back(4); });
+    queue.drain();
+
+    if (!thrown || order != std::vector<int>{1, 2, 3, 4})
+    {
+        printf("❌ 任务抛出异常后剩余任务的执行顺序错误\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 多生产者并发入队，push返回true时写eventfd，消费者poll到eventfd后drain；
+ *        每个生产者的任务按入队顺序执行且全部执行，消费者不会在还有任务时一直等不到唤醒
+ * @return 成功返回true
+ */
+static bool check_concurrent()
+{
+    int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (efd < 0) return false;
+
+    ol::TaskQueue queue;
+    std::vector<int> next(PRODUCERS, 0);
+    bool ordered = true;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&, p]()
+                               {
+            for (int ii = 0; ii < ITEMS; ++ii)
+            {
+                auto task = [&next, &ordered, p, ii]()
+                {
+                    if (next[p] != ii) ordered = false;
+                    next[p] = ii + 1;
+                };
+                if (queue.push(task))
+                {
+                    uint64_t one = 1;
+                    if (write(efd, &one, sizeof(one)) != sizeof(one)) abort();
+                }
+            } });
+    }
+
+    long total = 0;
+    bool lost = false;
+    while (total < static_cast<long>(PRODUCERS) * ITEMS)
+    {
+        struct pollfd pfd = {efd, POLLIN, 0};
+        if (poll(&pfd, 1, 2000) != 1)
+        {
+            lost = true; // 还有任务没执行却等不到唤醒
+            break;
+        }
+        uint64_t cnt;
+        if (read(efd, &cnt, sizeof(cnt)) != sizeof(cnt)) continue;
+        total += static_cast<long>(queue.drain());
+    }
+    for (auto& t : producers) t.join();
+    close(efd);
+
+    if (lost || !ordered)
+    {
+        printf("❌ 并发入队%s（执行了%ld个任务）\n", lost ? "漏掉了唤醒" : "执行顺序错误", total);
+        return false;
+    }
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        if (next[p] != ITEMS)
+        {
+            printf("❌ 生产者%d只执行了%d个任务\n", p, next[p]);
+            return false;
+        }
+    }
+    return queue.empty();
+}
+
+int main()
+{
+    printf("🔍 唤醒返回值、执行顺序与析构\n");
+    if (!check_basic()) return -1;
+
+    printf("🔍 任务抛出异常\n");
+    if (!check_exception()) return -1;
+
+    printf("🔍 多生产者经eventfd唤醒消费者\n");
+    if (!check_concurrent()) return -1;
+
+    printf("✅ 任务队列测试通过\n");
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include "ol_net/ol_TimerWheel.h"
+#include <poll.h>
+#include <random>
+#include <stdio.h>
+#include <unistd.h>
+
+// 时间轮用虚拟时间推进（advance传入构造时刻之后若干滴答的时间点），不实际等待：
+// 各层（含超过MAX_SPAN、需要分段下放的）定时器都在到期的那次advance中执行且只执行一次，
+// 取消、惰性refresh、周期定时器、回调中增删定时器，以及nextTimeoutMs和timerfd闹钟
+
+using ms = std::chrono::milliseconds;
+
+const int64_t TICK_MS = 10;
+const int TIMERS = 3000;
+
+/**
+ * @brief 虚拟时钟：从时间轮构造之后取的时间点起，按滴答推进
+ */
+struct VirtualClock
+{
+    std::chrono::steady_clock::time_point base = std::chrono::steady_clock::now();
+    int64_t from = 0; ///< 最近一次advance之前的虚拟滴答
+    int64_t tick = 0; ///< 当前虚拟滴答（最近一次advance的目标）
+
+    size_t advanceTo(ol::TimerWheel& wheel, int64_t target)
+    {
+        from = tick;
+        tick = target;
+        return wheel.advance(base + ms(target * TICK_MS));
+    }
+};
+
+/**
+ * @brief 随机延迟的大量定时器（覆盖4层以及超过MAX_SPAN的延迟），随机取消一部分，
+ *        随机步长推进，核对每个定时器在包含其到期滴答的那次advance中执行且只执行一次
+ * @return 成功返回true
+ */
+static bool check_expiry(std::mt19937_64& rng)
+{
+    ol::TimerWheel wheel{ms(TICK_MS)};
+    VirtualClock clock;
+
+    const int64_t maxSpan = int64_t(1) << 24; // 64^4个滴答
+    std::vector<int64_t> expire(TIMERS), fired(TIMERS, -1), firedFrom(TIMERS, -1);
+    std::vector<ol::TimerWheel::TimerId> ids(TIMERS);
+    std::vector<bool> canceled(TIMERS, false);
+    for (int ii = 0; ii < TIMERS; ++ii)
+    {
+        int level = static_cast<int>(rng() % 5); // 0~3层，4表示超过MAX_SPAN
+        int64_t range = level < 4 ? (int64_t(64) << (6 * level)) : maxSpan * 3;
+        expire[ii] = 1 + static_cast<int64_t>(rng() % range);
+        ids[ii] = wheel.addTimer(ms(expire[ii] * TICK_MS), [&fired, &firedFrom, &clock, ii]()
+                                 {
+            fired[ii] = (fired[ii] == -1) ? clock.tick : -2;
+            firedFrom[ii] = clock.from; });
+    }
+    for (int ii = 0; ii < TIMERS; ii += 3)
+    {
+        canceled[ii] = true;
+        if (!wheel.cancel(ids[ii]) || wheel.cancel(ids[ii]))
+        {
+            printf("❌ 取消定时器%d的返回值错误\n", ii);
+            return false;
+        }
+    }
+
+    while (!wheel.empty())
+    {
+        if (clock.tick > maxSpan * 4)
+        {
+            printf("❌ 推进到%ld个滴答后仍剩%zu个定时器\n", clock.tick, wheel.size());
+            return false;
+        }
+        int64_t step = (rng() % 4 == 0) ? 1 : 1 + static_cast<int64_t>(rng() % (clock.tick < 4096 ? 64 : 200000));
+        clock.advanceTo(wheel, clock.tick + step);
+        if (wheel.nextTimeoutMs() == 0)
+        {
+            printf("❌ nextTimeoutMs返回0\n");
+            return false;
+        }
+    }
+
+    for (int ii = 0; ii < TIMERS; ++ii)
+    {
+        if (canceled[ii])
+        {
+            if (fired[ii] != -1)
+            {
+                printf("❌ 已取消的定时器%d仍被执行\n", ii);
+                return false;
+            }
+            continue;
+        }
+        if (fired[ii] < 0)
+        {
+            printf("❌ 定时器%d（%ld个滴答）%s\n", ii, expire[ii], fired[ii] == -1 ? "没有执行" : "执行了多次");
+            return false;
+        }
+        // 到期滴答必须落在执行它的那次advance推进的区间(from, tick]内
+        if (expire[ii] <= firedFrom[ii] || expire[ii] > fired[ii])
+        {
+            printf("❌ 定时器%d（到期%ld）在推进%ld~%ld时执行\n", ii, expire[ii], firedFrom[ii], fired[ii]);
+            return false;
+        }
+    }
+    return wheel.nextTimeoutMs() == -1;
+}
+
+/**
+ * @brief 逐滴答推进，核对定时器恰好在到期滴答执行（不早不晚）；惰性推迟与提前refresh
+ * @return 成功返回true
+ */
+static bool check_exact_and_refresh()
+{
+    ol::TimerWheel wheel{ms(TICK_MS)};
+    VirtualClock clock;
+
+    int64_t firedA = -1, firedB = -1, firedC = -1;
+    auto a = wheel.addTimer(ms(100 * TICK_MS), [&]()
+                            { firedA = clock.tick; });
+    auto b = wheel.addTimer(ms(5000 * TICK_MS), [&]()
+                            { firedB = clock.tick; });
+    wheel.addTimer(ms(70 * TICK_MS), [&]()
+                   { firedC = clock.tick; });
+
+    for (int64_t t = 1; t <= 50; ++t) clock.advanceTo(wheel, t);
+    wheel.refresh(a, ms(300 * TICK_MS)); // 推迟：只改到期时间，原槽位到期时重新放置，应在350执行
+    wheel.refresh(b, ms(20 * TICK_MS));  // 提前：移动到新槽位，应在70执行
+    for (int64_t t = 51; t <= 6000; ++t) clock.advanceTo(wheel, t);
+
+    if (firedA != 350 || firedB != 70 || firedC != 70)
+    {
+        printf("❌ 执行滴答错误：A=%ld（应为350），B=%ld（应为70），C=%ld（应为70）\n", firedA, firedB, firedC);
+        return false;
+    }
+    if (wheel.refresh(a, ms(10)) || wheel.cancel(b))
+    {
+        printf("❌ 已到期的定时器仍可refresh或取消\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 周期定时器按周期重复执行，在自己的回调中取消后不再执行；回调中可以添加和取消其它定时器
+ * @return 成功返回true
+ */
+static bool check_periodic_and_reentrant()
+{
+    ol::TimerWheel wheel{ms(TICK_MS)};
+    VirtualClock clock;
+
+    std::vector<int64_t> ticks;
+    ol::TimerWheel::TimerId periodic = 0;
+    periodic = wheel.addTimer(ms(30 * TICK_MS), [&]()
+                              {
+        ticks.push_back(clock.tick);
+        if (ticks.size() == 5) wheel.cancel(periodic); }, ms(30 * TICK_MS));
+
+    // 同一滴答到期的两个定时器互相取消（槽位内的执行顺序不作约定），只能执行一个；回调中再添加一个新定时器
+    int pairRuns = 0, childRuns = 0;
+    ol::TimerWheel::TimerId pair[2] = {0, 0};
+    for (int ii = 0; ii < 2; ++ii)
+    {
+        pair[ii] = wheel.addTimer(ms(40 * TICK_MS), [&, ii]()
+                                  {
+            ++pairRuns;
+            wheel.cancel(pair[1 - ii]);
+            wheel.addTimer(ms(10 * TICK_MS), [&]() { ++childRuns; }); });
+    }
+
+    for (int64_t t = 1; t <= 400; ++t) clock.advanceTo(wheel, t);
+
+    std::vector<int64_t> expect = {30, 60, 90, 120, 150};
+    if (ticks != expect)
+    {
+        printf("❌ 周期定时器执行了%zu次\n", ticks.size());
+        return false;
+    }
+    if (pairRuns != 1 || childRuns != 1 || !wheel.empty())
+    {
+        printf("❌ 回调中增删定时器的结果错误（互相取消的定时器执行%d次，新定时器执行%d次）\n", pairRuns, childRuns);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief nextTimeoutMs与timerfd：设置单次闹钟后fd在约定时间内可读，关闭闹钟后不可读
+ * @return 成功返回true
+ */
+static bool check_timerfd()
+{
+    ol::TimerWheel wheel{ms(1)};
+    if (wheel.nextTimeoutMs() != -1) return false;
+    wheel.addTimer(ms(20), []() {});
+    int64_t delay = wheel.nextTimeoutMs();
+    if (delay < 1 || delay > 20)
+    {
+        printf("❌ nextTimeoutMs返回%ld，应在1~20之间\n", delay);
+        return false;
+    }
+
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) return false;
+    struct pollfd pfd = {fd, POLLIN, 0};
+    bool ok = ol::TimerWheel::armTimerFd(fd, delay) && poll(&pfd, 1, 2000) == 1 && wheel.advance() == 1;
+    if (ok)
+    {
+        uint64_t expirations;
+        ok = read(fd, &expirations, sizeof(expirations)) == sizeof(expirations) &&
+             ol::TimerWheel::armTimerFd(fd, wheel.nextTimeoutMs()) && poll(&pfd, 1, 50) == 0;
+    }
+    close(fd);
+    if (!ok) printf("❌ timerfd闹钟错误\n");
+    return ok;
+}
+
+int main()
+{
+    std::mt19937_64 rng(20261017);
+
+    printf("🔍 各层及超长定时器到期与取消\n");
+    if (!check_expiry(rng)) return -1;
+
+    printf("🔍 逐滴答到期与refresh\n");
+    if (!check_exact_and_refresh()) return -1;
+
+    printf("🔍 周期定时器与回调中增删定时器\n");
+    if (!check_periodic_and_reentrant()) return -1;
+
+    printf("🔍 nextTimeoutMs与timerfd\n");
+    if (!check_timerfd()) return -1;
+
+    printf("✅ 时间轮测试通过\n");
+    return 0;
+}
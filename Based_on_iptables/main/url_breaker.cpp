@@ -17,20 +17,6 @@ int URLBreaker::safe_stoi(const std::string& s, int default_val)
     return static_cast<int>(val);
 }
 
-// 解析时间字符串
-bool URLBreaker::parseTimeStr(const std::string& time_str, int& hour, int& min)
-{
-    if (time_str.empty()) return false;
-    size_t colon = time_str.find(':');
-    if (colon == std::string::npos || colon == 0 || colon == time_str.size() - 1)
-    {
-        return false;
-    }
-    hour = safe_stoi(time_str.substr(0, colon), -1);
-    min = safe_stoi(time_str.substr(colon + 1), -1);
-    return (hour >= 0 && hour <= 24) && (min >= 0 && min <= 60);
-}
-
 // 执行系统命令
 std::string URLBreaker::execCmd(const std::string& cmd)
 {
@@ -129,23 +115,22 @@ bool URLBreaker::loadConfig(const std::string& xml_path)
         tinyxml2::XMLElement* time_rule_elem = time_rules_elem->FirstChildElement("TimeRule");
         while (time_rule_elem)
         {
-            TimeRule tr;
-            // 开始时间
+            // 开始时间、结束时间（HH:MM，开始晚于结束时跨天）
+            std::string start, end;
             tinyxml2::XMLElement* start_elem = time_rule_elem->FirstChildElement("Start");
             if (start_elem && start_elem->GetText())
             {
-                tr.start = start_elem->GetText();
+                start = start_elem->GetText();
             }
-            // 结束时间
             tinyxml2::XMLElement* end_elem = time_rule_elem->FirstChildElement("End");
             if (end_elem && end_elem->GetText())
             {
-                tr.end = end_elem->GetText();
+                end = end_elem->GetText();
             }
-            // 有效规则才添加
-            if (!tr.start.empty() && !tr.end.empty())
+            // 有效规则才添加（加载时展开为分钟位图，判断时不再解析）
+            if (!start.empty() && !end.empty() && !policy_set.schedule().addRange(start, end))
             {
-                time_rules.push_back(tr);
+                writeLog(start + "-" + end, 0, "时间规则格式错误，已忽略");
             }
             time_rule_elem = time_rule_elem->NextSiblingElement("TimeRule");
         }
@@ -165,112 +150,106 @@ bool URLBreaker::loadConfig(const std::string& xml_path)
                 item_elem = item_elem->NextSiblingElement("Item");
                 continue;
             }
+            // 格式：IP[/前缀长度]:端口，端口可为范围（如 "10.0.0.0/8:8000-8100"），IPv6地址用方括号括起
             std::string item = item_text;
-            size_t colon = item.find(':');
-            if (colon != std::string::npos && colon > 0 && colon < item.size() - 1)
+            policy::NetRule rule;
+            policy::TargetKind kind = policy_set.addTarget(item, static_cast<int>(black_list.size()), policy::PROTO_ALL, &rule);
+            if (kind == policy::TARGET_NET)
             {
                 BlackItem bi;
-                bi.ip = item.substr(0, colon);
-                bi.port = safe_stoi(item.substr(colon + 1), 0);
+                bi.ip = rule.m_family == policy::FAMILY_ANY ? "*" : policy::formatAddr(rule);
+                bi.port = rule.allPorts() ? 0 : rule.m_portLo;
                 black_list.push_back(bi);
             }
+            else if (kind == policy::TARGET_DOMAIN)
+            {
+                writeLog(item, 0, "内核规则不支持域名，已忽略");
+            }
+            else
+            {
+                writeLog(item, 0, "黑名单项格式错误，已忽略");
+            }
             item_elem = item_elem->NextSiblingElement("Item");
         }
+        compileBlackList();
     }
 
     return true;
 }
 
-// 判断当前是否在拦截时段
-bool URLBreaker::isInInterceptTime()
+// 编译黑名单
+void URLBreaker::compileBlackList()
 {
-    time_t now = time(nullptr);
-    tm* tm_now = localtime(&now);
-    if (!tm_now) return false; // 空指针保护
+    policy_set.compile();
+    const policy::CompileReport& report = policy_set.report();
 
-    int curr_hour = tm_now->tm_hour;
-    int curr_min = tm_now->tm_min;
-    int curr_total = curr_hour * 60 + curr_min;
+    // iptables每个(网段, 端口, 协议)生成LOG+DROP两条规则
+    writeLog("全局", 0, "黑名单编译完成：" + report.toString() + "，内核规则" +
+                            std::to_string(report.m_protoRulesIn * 2) + "→" + std::to_string(report.m_protoRulesOut * 2) + "条");
+}
 
-    for (const auto& tr : time_rules)
-    {
-        int start_h, start_m, end_h, end_m;
-        if (!parseTimeStr(tr.start, start_h, start_m)) continue;
-        if (!parseTimeStr(tr.end, end_h, end_m)) continue;
+// 添加一条编译后规则对应的内核规则
+void URLBreaker::addKernelRule(const policy::NetRule& rule)
+{
+    bool v6 = rule.m_family == policy::FAMILY_V6;
+    std::string ipt = v6 ? "sudo ip6tables -A " : "sudo iptables -A ";
+    std::string dst = " -d " + policy::formatAddr(rule);
+    std::string ports = policy::formatPorts(rule, ':');
+    std::string log_prefix = "\"URL_BREAKER: \" ";
 
-        int start_total = start_h * 60 + start_m;
-        int end_total = end_h * 60 + end_m;
+    static const struct
+    {
+        uint8_t proto;
+        const char* v4_name;
+        const char* v6_name;
+    } protos[] = {{policy::PROTO_TCP, "tcp", "tcp"}, {policy::PROTO_UDP, "udp", "udp"}, {policy::PROTO_ICMP, "icmp", "ipv6-icmp"}};
 
-        // 时间段判断（支持跨天，如23:00-02:00）
-        if (start_total <= end_total)
-        {
-            // 正常时段（如09:00-18:00）
-            if (curr_total >= start_total && curr_total <= end_total)
-            {
-                return true;
-            }
-        }
-        else
-        {
-            // 跨天时段（如23:00-02:00）
-            if (curr_total >= start_total || curr_total <= end_total)
-            {
-                return true;
-            }
-        }
+    std::string proto_names;
+    for (const auto& p : protos)
+    {
+        if (!(rule.m_proto & p.proto)) continue;
+        std::string match = " -p " + std::string(v6 ? p.v6_name : p.v4_name) + dst;
+        if (p.proto != policy::PROTO_ICMP && !ports.empty()) match += " --dport " + ports; // ICMP没有端口
+        execCmd(ipt + global_cfg.ipt_chain + match + " -j LOG --log-prefix " + log_prefix + "--log-level info 2>/dev/null");
+        execCmd(ipt + global_cfg.ipt_chain + match + " -j DROP 2>/dev/null");
+
+        if (!proto_names.empty()) proto_names += "/";
+        proto_names += p.proto == policy::PROTO_TCP ? "TCP" : (p.proto == policy::PROTO_UDP ? "UDP" : "ICMP");
     }
-    return false;
+
+    std::string result = "拦截成功（" + proto_names;
+    if (!ports.empty() && rule.m_portLo != rule.m_portHi) result += "，端口" + policy::formatPorts(rule);
+    result += "）";
+    writeLog(policy::formatAddr(rule), rule.m_portLo == rule.m_portHi ? rule.m_portLo : 0, result);
+}
+
+// 判断当前是否在拦截时段
+bool URLBreaker::isInInterceptTime()
+{
+    // 时间段在加载时已展开为分钟位图（支持跨天，如23:00-02:00），没有配置时间段时不拦截
+    return policy_set.active(time(nullptr));
 }
 
 // 加载iptables规则
 bool URLBreaker::loadIptablesRules()
 {
+    // 是否有IPv6规则（有才操作ip6tables）
+    bool has_v6 = false;
+    for (const auto& rule : policy_set.rules())
+        if (rule.m_family == policy::FAMILY_V6) has_v6 = true;
+
     // 创建自定义链
     std::string cmd_create_chain = "sudo iptables -N " + global_cfg.ipt_chain + " 2>/dev/null";
     execCmd(cmd_create_chain);
+    if (has_v6) execCmd("sudo ip6tables -N " + global_cfg.ipt_chain + " 2>/dev/null");
 
     // 清空已有规则
     clearIptablesRules();
 
-    // 遍历黑名单添加规则
-    for (const auto& bi : black_list)
+    // 按编译后的最小规则集添加规则（相邻网段已合并，被覆盖的规则已去掉）
+    for (const auto& rule : policy_set.rules())
     {
-        std::string log_prefix = "\"URL_BREAKER: \" ";
-        std::string cmd_tcp_log, cmd_tcp_drop;
-        std::string cmd_udp_log, cmd_udp_drop;
-        std::string cmd_icmp_log, cmd_icmp_drop;
-
-        if (bi.port == 0)
-        {
-            // 所有端口
-            cmd_tcp_log = "sudo iptables -A " + global_cfg.ipt_chain + " -p tcp -d " + bi.ip + " -j LOG --log-prefix " + log_prefix + "--log-level info 2>/dev/null";
-            cmd_tcp_drop = "sudo iptables -A " + global_cfg.ipt_chain + " -p tcp -d " + bi.ip + " -j DROP 2>/dev/null";
-            cmd_udp_log = "sudo iptables -A " + global_cfg.ipt_chain + " -p udp -d " + bi.ip + " -j LOG --log-prefix " + log_prefix + "--log-level info 2>/dev/null";
-            cmd_udp_drop = "sudo iptables -A " + global_cfg.ipt_chain + " -p udp -d " + bi.ip + " -j DROP 2>/dev/null";
-            cmd_icmp_log = "sudo iptables -A " + global_cfg.ipt_chain + " -p icmp -d " + bi.ip + " -j LOG --log-prefix " + log_prefix + "--log-level info 2>/dev/null";
-            cmd_icmp_drop = "sudo iptables -A " + global_cfg.ipt_chain + " -p icmp -d " + bi.ip + " -j DROP 2>/dev/null";
-        }
-        else
-        {
-            // 指定端口
-            cmd_tcp_log = "sudo iptables -A " + global_cfg.ipt_chain + " -p tcp -d " + bi.ip + " --dport " + std::to_string(bi.port) + " -j LOG --log-prefix " + log_prefix + "--log-level info 2>/dev/null";
-            cmd_tcp_drop = "sudo iptables -A " + global_cfg.ipt_chain + " -p tcp -d " + bi.ip + " --dport " + std::to_string(bi.port) + " -j DROP 2>/dev/null";
-            cmd_udp_log = "sudo iptables -A " + global_cfg.ipt_chain + " -p udp -d " + bi.ip + " --dport " + std::to_string(bi.port) + " -j LOG --log-prefix " + log_prefix + "--log-level info 2>/dev/null";
-            cmd_udp_drop = "sudo iptables -A " + global_cfg.ipt_chain + " -p udp -d " + bi.ip + " --dport " + std::to_string(bi.port) + " -j DROP 2>/dev/null";
-            cmd_icmp_log = "sudo iptables -A " + global_cfg.ipt_chain + " -p icmp -d " + bi.ip + " -j LOG --log-prefix " + log_prefix + "--log-level info 2>/dev/null";
-            cmd_icmp_drop = "sudo iptables -A " + global_cfg.ipt_chain + " -p icmp -d " + bi.ip + " -j DROP 2>/dev/null";
-        }
-
-        // 执行规则
-        execCmd(cmd_tcp_log);
-        execCmd(cmd_tcp_drop);
-        execCmd(cmd_udp_log);
-        execCmd(cmd_udp_drop);
-        execCmd(cmd_icmp_log);
-        execCmd(cmd_icmp_drop);
-
-        // 记录日志
-        writeLog(bi.ip, bi.port, "拦截成功（TCP/UDP/ICMP）");
+        addKernelRule(rule);
     }
 
     // 挂到OUTPUT链
@@ -278,6 +257,11 @@ bool URLBreaker::loadIptablesRules()
     execCmd(cmd_detach_chain);
     std::string cmd_attach_chain = "sudo iptables -I OUTPUT 1 -j " + global_cfg.ipt_chain + " 2>/dev/null";
     execCmd(cmd_attach_chain);
+    if (has_v6)
+    {
+        execCmd("sudo ip6tables -D OUTPUT -j " + global_cfg.ipt_chain + " 2>/dev/null");
+        execCmd("sudo ip6tables -I OUTPUT 1 -j " + global_cfg.ipt_chain + " 2>/dev/null");
+    }
 
     // 持久化规则
     if (global_cfg.persist_rule)
@@ -293,6 +277,7 @@ bool URLBreaker::clearIptablesRules()
 {
     std::string cmd = "sudo iptables -F " + global_cfg.ipt_chain + " 2>/dev/null";
     std::string result = execCmd(cmd);
+    execCmd("sudo ip6tables -F " + global_cfg.ipt_chain + " 2>/dev/null"); // 没有IPv6规则时链不存在，忽略
     if (result.empty())
     {
         for (const auto& bi : black_list)
@@ -358,9 +343,11 @@ void URLBreaker::writeLog_timeRules()
 
     // 拼接日志
     std::ostringstream oss;
-    for (size_t i = 0; i < time_rules.size(); ++i)
+    const policy::Schedule& schedule = policy_set.schedule();
+    for (size_t i = 0; i < schedule.rangeNum(); ++i)
     {
-        oss << "[" + std::string(time_buf) + "] " << "加载时间规则[" << i + 1 << "]:" << time_rules[i].start << "-" << time_rules[i].end << "\n";
+        oss << "[" + std::string(time_buf) + "] " << "加载时间规则[" << i + 1 << "]:" << policy::Schedule::formatTime(schedule.range(i).first)
+            << "-" << policy::Schedule::formatTime(schedule.range(i).second) << "\n";
     }
 
     // 写入日志文件
@@ -403,6 +390,7 @@ bool URLBreaker::parseKernelLogLine(const std::string& line, KernelLogInfo& log_
     log_info.proto = "";
     log_info.dst_ip = "";
     log_info.spt = -1;
+    log_info.dpt = -1;
     log_info.icmp_id = -1;
 
     // 提取PROTO
@@ -429,10 +417,17 @@ bool URLBreaker::parseKernelLogLine(const std::string& line, KernelLogInfo& log_
             if (spt_end == std::string::npos) spt_end = line.size();
             log_info.spt = safe_stoi(line.substr(spt_pos + 4, spt_end - (spt_pos + 4)), -1);
         }
+        size_t dpt_pos = line.find("DPT=");
+        if (dpt_pos != std::string::npos)
+        {
+            size_t dpt_end = line.find(' ', dpt_pos + 4);
+            if (dpt_end == std::string::npos) dpt_end = line.size();
+            log_info.dpt = safe_stoi(line.substr(dpt_pos + 4, dpt_end - (dpt_pos + 4)), -1);
+        }
     }
 
     // 提取ICMP ID（兼容ID=和icmp_id=两种格式）
-    if (log_info.proto == "ICMP")
+    if (log_info.proto == "ICMP" || log_info.proto == "ICMPv6")
     {
         size_t icmp_id_pos = line.find("ID=");
         // 兼容ICMP ID的另类格式
@@ -497,7 +492,7 @@ std::pair<std::string, std::string> URLBreaker::getInitiatorProcess(const Kernel
     }
 
     // ========== ICMP 进程查询 ==========
-    else if (log_info.proto == "ICMP")
+    else if (log_info.proto == "ICMP" || log_info.proto == "ICMPv6")
     {
         // ICMP TYPE=8 是ping请求，TYPE=0是响应
         if (log_info.icmp_id <= 0 || log_info.dst_ip.empty())
@@ -565,15 +560,14 @@ void URLBreaker::processKernelLogLine(const std::string& line)
     KernelLogInfo log_info;
     if (!parseKernelLogLine(line, log_info)) return;
 
-    // 匹配黑名单
-    for (const auto& bi : black_list)
+    // 匹配黑名单（查编译后的查找表，网段与端口范围都能匹配）
+    uint8_t proto = log_info.proto == "TCP" ? policy::PROTO_TCP : (log_info.proto == "UDP" ? policy::PROTO_UDP : policy::PROTO_ICMP);
+    int id = policy_set.matchNet(log_info.dst_ip.data(), log_info.dst_ip.size(), static_cast<uint16_t>(log_info.dpt > 0 ? log_info.dpt : 0), proto);
+    if (id >= 0 && static_cast<size_t>(id) < black_list.size())
     {
-        if (log_info.dst_ip == bi.ip)
-        {
-            std::pair<std::string, std::string> info = getInitiatorProcess(log_info);
-            writeLog(bi.ip, bi.port, "拦截成功 实时拦截事件：" + line, info.first, info.second);
-            break;
-        }
+        const BlackItem& bi = black_list[id];
+        std::pair<std::string, std::string> info = getInitiatorProcess(log_info);
+        writeLog(bi.ip, bi.port, "拦截成功 实时拦截事件：" + line, info.first, info.second);
     }
 }
 
@@ -16,19 +16,13 @@
 #include <sstream>
 #include <set>
 #include <cstdlib>
-
-// 时间段规则结构体
-struct TimeRule
-{
-    std::string start; // 开始时间（如 "09:00"）
-    std::string end;   // 结束时间（如 "18:00"）
-};
+#include "policy/policy_set.h"
 
 // 黑名单项结构体
 struct BlackItem
 {
-    std::string ip; // 目标IP
-    int port;       // 目标端口（0=所有端口）
+    std::string ip; // 目标IP或网段（如 "10.0.0.0/8"）
+    int port;       // 目标端口（0=所有端口，端口范围时为范围起点）
 };
 
 // 全局配置结构体
@@ -46,6 +40,7 @@ struct KernelLogInfo
     std::string proto;  // 协议（TCP/UDP/ICMP）
     std::string dst_ip; // 目标IP
     int spt;            // 源端口（TCP/UDP）
+    int dpt;            // 目标端口（TCP/UDP）
     int icmp_id;        // ICMP ID（对应ping进程PID）
 };
 
@@ -54,8 +49,8 @@ class URLBreaker
 {
 private:
     GlobalConfig global_cfg;
-    std::vector<TimeRule> time_rules;
-    std::vector<BlackItem> black_list;
+    std::vector<BlackItem> black_list; // 黑名单项（下标即policy_set中的规则编号）
+    policy::PolicySet policy_set;      // 策略引擎（与LD_PRELOAD版本共用）：黑名单编译后的最小规则集、查找表和拦截时间段
     // 线程安全相关
     pthread_t monitor_thread;
     std::atomic<bool> is_running;
@@ -65,8 +60,6 @@ private:
 
     // 私有方法：安全转换字符串到int
     int safe_stoi(const std::string& s, int default_val = 0);
-    // 私有方法：解析时间字符串为小时+分钟
-    bool parseTimeStr(const std::string& time_str, int& hour, int& min);
     // 私有方法：获取当前程序进程名
     std::string getProcessName();
     // 私有方法：实时监控内核日志的线程函数
@@ -75,6 +68,10 @@ private:
     void processKernelLogLine(const std::string& line);
     // 私有方法：解析内核日志行
     bool parseKernelLogLine(const std::string& line, KernelLogInfo& log_info);
+    // 私有方法：编译黑名单（生成最小规则集和查找表，记录精简统计）
+    void compileBlackList();
+    // 私有方法：添加一条编译后规则对应的iptables/ip6tables规则
+    void addKernelRule(const policy::NetRule& rule);
     // 私有方法：查询发起进程
     std::pair<std::string, std::string> getInitiatorProcess(const KernelLogInfo& log_info);
 
@@ -0,0 +1,157 @@
+/****************************************************************************************/
+/*
+ * 程序名：feed_loader.h
+ * 功能描述：黑名单列表（feed）加载器，把常见格式的公开列表直接送入策略构建器，支持以下特性：
+ *          - 普通列表：每行一个IP、网段（"10.0.0.0/8"、"2001:db8::/32"）或域名
+ *          - hosts格式："0.0.0.0 ads.example.com [更多域名...]"，取其后的域名（本机名被忽略）
+ *          - AdBlock域名规则："||ads.example.com^"（可带$important），例外规则和带路径的规则计为不支持
+ *          - 注释：'#'之后、行首的'!'、空白后的';'（兼容Spamhaus DROP等列表）
+ *          - 自动识别（FEED_AUTO）按行判断格式，同一文件中混用也能正确加载
+ *          - IP/网段条目按模板（协议、端口、规则编号）加入RangeCompiler，域名条目交给回调
+ *            （例如DomainSetBuilder::add），加载过程只在回调中产生字符串
+ *          - 文件由LineReader读取（mmap + 向量化换行扫描，gzip自动解压）
+ * 作者：ol
+ * 适用标准：C++11及以上（依赖zlib，链接时加-lz）
+ */
+/****************************************************************************************/
+
+#ifndef POLICY_FEED_LOADER_H
+#define POLICY_FEED_LOADER_H 1
+
+#include "policy/range_compiler.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace policy
+{
+
+    // 列表格式
+    enum FeedFormat : uint8_t
+    {
+        FEED_AUTO = 0,   ///< 按行自动识别
+        FEED_PLAIN = 1,  ///< 每行一个IP、网段或域名
+        FEED_HOSTS = 2,  ///< hosts格式
+        FEED_ADBLOCK = 3 ///< AdBlock域名规则
+    };
+
+    // ===========================================================================
+    /**
+     * @brief 加载统计
+     */
+    struct FeedStats
+    {
+        size_t m_lines = 0;       ///< 读取的行数
+        size_t m_skipped = 0;     ///< 空行、注释、hosts中的本机名
+        size_t m_nets = 0;        ///< IP/网段条目数
+        size_t m_domains = 0;     ///< 域名条目数
+        size_t m_invalid = 0;     ///< 无法解析的条目数
+        size_t m_unsupported = 0; ///< 不支持的AdBlock规则数（例外规则、带路径或过滤选项的规则）
+
+        /**
+         * @brief 格式化为一行说明，如"读取100行，IP/网段40条，域名50条，跳过8条，非法1条，不支持1条"
+         */
+        std::string toString() const;
+    };
+
+    // ===========================================================================
+    /**
+     * @brief 黑名单列表加载器
+     * @note 用法：
+     *       RangeCompiler nets;
+     *       DomainSetBuilder domains;
+     *       FeedLoader loader(&nets, [&](const char* p, size_t n) { domains.add(std::string(p, n)); });
+     *       NetRule tmpl; tmpl.m_proto = PROTO_TCP | PROTO_UDP;
+     *       loader.setTemplate(tmpl);
+     *       if (!loader.load("hosts.txt.gz")) 报错：loader.error()
+     *       nets.compile(&report);
+     */
+    class FeedLoader
+    {
+    public:
+        using DomainSink = std::function<void(const char* host, size_t len)>;
+
+    private:
+        RangeCompiler* m_nets; ///< IP/网段条目的去向（nullptr时只计数）
+        DomainSink m_domains;  ///< 域名条目的去向（为空时只计数）
+        NetRule m_template;    ///< IP/网段条目的协议、端口和规则编号
+        FeedStats m_stats;     ///< 累计统计
+        std::string m_error;   ///< 最近一次load()的错误描述
+
+        // 加入一条IP/网段条目（地址部分已在rule中）。
+        void addNet(NetRule& rule);
+
+        // 加入一条域名条目（已校验）。
+        void addDomain(const char* host, size_t len);
+
+        // 解析AdBlock规则（已去掉注释和首尾空白）。
+        void feedAdblock(const char* p, size_t n);
+
+        // 解析hosts格式的一行（首字段已确认是IP地址，rest为其后的内容）。
+        void feedHosts(const char* rest, size_t n);
+
+        // 解析普通列表的一个字段。
+        void feedPlain(const char* p, size_t n);
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param nets IP/网段条目的去向（nullptr时只计数）
+         * @param domains 域名条目的去向（为空时只计数）
+         */
+        explicit FeedLoader(RangeCompiler* nets, DomainSink domains = DomainSink());
+
+        /**
+         * @brief 设置IP/网段条目的模板（协议掩码、端口范围、规则编号），默认所有协议、所有端口、编号-1
+         * @param tmpl 模板（地址部分被忽略）
+         */
+        void setTemplate(const NetRule& tmpl) { m_template = tmpl; }
+
+        /**
+         * @brief 加载列表文件（gzip自动解压）
+         * @param filename 文件名
+         * @param format 格式
+         * @return true-成功，false-打开失败或gzip数据损坏（error()给出原因，已读出的条目仍然有效）
+         */
+        bool load(const std::string& filename, FeedFormat format = FEED_AUTO);
+
+        /**
+         * @brief 加载内存中的列表文本
+         * @param buf 文本
+         * @param len 长度
+         * @param format 格式
+         */
+        void loadBuffer(const char* buf, size_t len, FeedFormat format = FEED_AUTO);
+
+        /**
+         * @brief 解析一行（不含换行符）
+         * @param line 行
+         * @param len 长度
+         * @param format 格式
+         */
+        void feedLine(const char* line, size_t len, FeedFormat format = FEED_AUTO);
+
+        // 累计统计。
+        const FeedStats& stats() const { return m_stats; }
+
+        // 清空统计。
+        void resetStats() { m_stats = FeedStats(); }
+
+        // 最近一次load()的错误描述。
+        const std::string& error() const { return m_error; }
+    };
+    // ===========================================================================
+
+    /**
+     * @brief 校验主机名（字母、数字、'-'、'_'、'.'组成，最后一级不全是数字，总长不超过253）
+     * @param host 主机名（允许末尾的'.'）
+     * @param len 长度
+     * @param requireDot 是否要求至少两级（列表中的单级名称多为本机名，配置文件中的条目则允许单级）
+     * @return 合法返回true
+     */
+    bool isValidHost(const char* host, size_t len, bool requireDot = true);
+
+} // namespace policy
+
+#endif // !POLICY_FEED_LOADER_H
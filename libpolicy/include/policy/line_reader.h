@@ -0,0 +1,112 @@
+/****************************************************************************************/
+/*
+ * 程序名：line_reader.h
+ * 功能描述：面向百万行级黑名单列表的按行读取器，支持以下特性：
+ *          - 普通文件整个mmap，行就是映射内存中的一段（零拷贝，不为每行分配内存）
+ *          - 换行符扫描向量化：每次比较64字节得到一个换行位图，逐位取出行尾
+ *            （AVX2/SSE2按编译选项选择，其它平台退化为memchr），短行密集的列表也不会每行调用一次函数
+ *          - gzip文件（按魔数1f 8b识别）用zlib流式解压到固定缓冲区，跨缓冲区的行搬到缓冲区开头续读
+ *          - 自动去掉行尾的'\r'（兼容Windows换行），最后一行没有换行符也能读到
+ * 作者：ol
+ * 适用标准：C++11及以上（gzip依赖zlib，链接时加-lz）
+ */
+/****************************************************************************************/
+
+#ifndef POLICY_LINE_READER_H
+#define POLICY_LINE_READER_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace policy
+{
+
+    // ===========================================================================
+    /**
+     * @brief 按行读取器（mmap + 向量化换行扫描，gzip流式解压）
+     * @note 用法：
+     *       LineReader reader;
+     *       if (!reader.open(path)) 报错：reader.error()
+     *       const char* line; size_t len;
+     *       while (reader.next(line, len)) { ... }   // line在下一次next()之前有效
+     *       if (!reader.ok()) 报错（例如gzip数据损坏）
+     */
+    class LineReader
+    {
+    private:
+        static const size_t GZ_CHUNK = 1 << 20; ///< gzip每次解压的目标大小
+
+        // 数据来源
+        const char* m_map = nullptr; ///< mmap的文件内容
+        size_t m_mapLen = 0;         ///< mmap的长度
+        void* m_zs = nullptr;        ///< zlib流（z_stream*，gzip文件时非空）
+        bool m_zEnd = false;         ///< gzip数据已全部解压
+        std::vector<char> m_gzBuf;   ///< gzip解压缓冲区
+
+        // 当前扫描的数据段（普通文件为整个映射，gzip为解压缓冲区中的有效数据）
+        const char* m_data = nullptr; ///< 数据段起点
+        size_t m_len = 0;             ///< 数据段长度
+        size_t m_lineStart = 0;       ///< 当前行起点（相对m_data）
+        size_t m_block = 0;           ///< 换行位图对应的64字节块起点（相对m_data）
+        uint64_t m_mask = 0;          ///< 当前块中尚未取出的换行位图
+
+        size_t m_lineNo = 0;           ///< 已读取的行数
+        const char* m_error = nullptr; ///< 错误描述
+
+        // 计算从m_block开始的64字节块的换行位图（不足64字节的部分按实际长度）。
+        uint64_t scanBlock(size_t block) const;
+
+        // gzip：解压下一段数据（未读完的行搬到缓冲区开头）。
+        bool refill();
+
+    public:
+        LineReader() = default;
+        LineReader(const LineReader&) = delete;
+        LineReader& operator=(const LineReader&) = delete;
+
+        /**
+         * @brief 打开文件（gzip按文件头魔数自动识别）
+         * @param filename 文件名
+         * @return true-成功（空文件也算成功），false-失败（error()给出原因）
+         */
+        bool open(const std::string& filename);
+
+        /**
+         * @brief 直接读取内存中的文本（不复制，buf在读取期间必须有效）
+         * @param buf 文本
+         * @param len 长度
+         */
+        void openBuffer(const char* buf, size_t len);
+
+        /**
+         * @brief 读取下一行
+         * @param line 输出：行起点（不含换行符和行尾的'\r'，在下一次next()之前有效）
+         * @param len 输出：行长度
+         * @return true-读到一行，false-已读完或出错（用ok()区分）
+         */
+        bool next(const char*& line, size_t& len);
+
+        // 关闭（解除映射、释放解压流）。
+        void close();
+
+        // 已读取的行数。
+        size_t lineNo() const { return m_lineNo; }
+
+        // 是否没有出错。
+        bool ok() const { return m_error == nullptr; }
+
+        // 错误描述（没有错误时返回nullptr）。
+        const char* error() const { return m_error; }
+
+        // 是否gzip文件。
+        bool isGzip() const { return m_zs != nullptr; }
+
+        ~LineReader() { close(); }
+    };
+    // ===========================================================================
+
+} // namespace policy
+
+#endif // !POLICY_LINE_READER_H
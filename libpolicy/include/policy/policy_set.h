@@ -0,0 +1,185 @@
+/****************************************************************************************/
+/*
+ * 程序名：policy_set.h
+ * 功能描述：拦截策略（两个前端共用的策略引擎），把配置中的各项规整为可直接查询的形式：
+ *          - 黑名单条目"目标:端口"：目标为IP/网段时交给网段编译器，为域名时保存为域名规则
+ *            （端口可为单个端口、范围、*或0，两种目标的端口写法一致）
+ *          - 黑名单列表文件（普通IP列表、hosts、AdBlock格式，gzip自动解压）
+ *          - 进程白名单（/usr/bin/与/bin/视为同一目录），排序后二分查找
+ *          - 拦截时间段（Schedule，支持多段和跨天）
+ *          - compile()之后：网段查找（IPv4映射的IPv6地址按IPv4查找）、白名单查找、时间段判断
+ *          前端只负责读取各自的配置格式（XmlScanner/tinyxml2）和执行拦截（connect劫持/iptables），
+ *          解析、编译与查找的改进对两种拦截方式同时生效。
+ * 作者：ol
+ * 适用标准：C++11及以上（依赖zlib，链接时加-lz）
+ */
+/****************************************************************************************/
+
+#ifndef POLICY_POLICY_SET_H
+#define POLICY_POLICY_SET_H 1
+
+#include "policy/feed_loader.h"
+#include "policy/range_compiler.h"
+#include "policy/schedule.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace policy
+{
+
+    // 黑名单条目的解析结果
+    enum TargetKind : uint8_t
+    {
+        TARGET_INVALID = 0, ///< 格式错误
+        TARGET_NET = 1,     ///< IP/网段
+        TARGET_DOMAIN = 2   ///< 域名
+    };
+
+    // ===========================================================================
+    /**
+     * @brief 域名规则（由前端在连接时解析域名后比较地址）
+     */
+    struct DomainRule
+    {
+        std::string m_host;        ///< 域名
+        uint16_t m_portLo = 0;     ///< 端口范围起点（包含）
+        uint16_t m_portHi = 65535; ///< 端口范围终点（包含）
+        uint8_t m_proto = PROTO_ALL; ///< 协议掩码
+        int m_ruleId = -1;         ///< 规则编号
+
+        // 端口是否在范围内。
+        bool matchPort(uint16_t port) const { return port >= m_portLo && port <= m_portHi; }
+
+        // 是否所有端口。
+        bool allPorts() const { return m_portLo == 0 && m_portHi == 65535; }
+    };
+
+    // ===========================================================================
+    /**
+     * @brief 拦截策略
+     * @note 用法：
+     *       PolicySet ps;
+     *       ps.schedule().addRange("09:00", "18:00");
+     *       ps.addWhitelist("/usr/bin/curl");
+     *       ps.addTarget("10.0.0.0/8:443", 0);      // 返回TARGET_NET
+     *       ps.addTarget("www.xxx.com:80", 1);      // 返回TARGET_DOMAIN
+     *       ps.compile();
+     *       if (ps.active(time(nullptr)) && ps.matchNet(FAMILY_V4, addr, 443, PROTO_TCP) >= 0) 拦截
+     *       compile()之后只读，可被多个线程同时查询。
+     */
+    class PolicySet
+    {
+    private:
+        RangeCompiler m_compiler;          ///< IP/网段条目（编译前）
+        std::vector<NetRule> m_rules;      ///< 编译后的最小规则集
+        RangeTable m_table;                ///< 编译后的查找表
+        CompileReport m_report;            ///< 编译统计
+        std::vector<DomainRule> m_domains; ///< 域名规则
+        std::vector<std::string> m_whitelist; ///< 进程白名单（规整后排序）
+        Schedule m_schedule;               ///< 拦截时间段
+
+    public:
+        /**
+         * @brief 解析并加入一条黑名单条目
+         * @param text "IP[/前缀]:端口"、"[IPv6][/前缀]:端口"、"*:端口"或"域名:端口"（允许空白）
+         * @param len 文本长度
+         * @param ruleId 规则编号（查找结果返回命中条目中最小的编号）
+         * @param proto 协议掩码
+         * @param net 输出：IP/网段条目的规则（可为nullptr）
+         * @return 条目类型；域名条目为domains().back()
+         */
+        TargetKind addTarget(const char* text, size_t len, int ruleId, uint8_t proto = PROTO_ALL, NetRule* net = nullptr);
+        TargetKind addTarget(const std::string& text, int ruleId, uint8_t proto = PROTO_ALL, NetRule* net = nullptr)
+        {
+            return addTarget(text.data(), text.size(), ruleId, proto, net);
+        }
+
+        /**
+         * @brief 加载黑名单列表文件（IP/网段条目拦截所有端口，域名条目只计数）
+         * @param filename 文件名
+         * @param ruleId 列表中所有条目共用的规则编号
+         * @param proto 协议掩码
+         * @param stats 输出：加载统计
+         * @param error 输出：错误描述
+         * @return true-成功，false-打开失败或数据损坏（已读出的条目仍然有效）
+         */
+        bool addFeed(const std::string& filename, int ruleId, uint8_t proto, FeedStats& stats, std::string& error);
+
+        /**
+         * @brief 加入白名单进程
+         * @param exe 可执行文件的绝对路径
+         */
+        void addWhitelist(const std::string& exe);
+
+        // 拦截时间段（加载配置时直接修改）。
+        Schedule& schedule() { return m_schedule; }
+        const Schedule& schedule() const { return m_schedule; }
+
+        /**
+         * @brief 编译：生成最小规则集和查找表，白名单排序去重
+         * @note 可重复调用（新加入的条目与之前的条目一起重新编译）
+         */
+        void compile();
+
+        // 清空全部内容。
+        void clear();
+
+        // 编译统计。
+        const CompileReport& report() const { return m_report; }
+
+        // 编译后的最小规则集（iptables前端据此生成内核规则）。
+        const std::vector<NetRule>& rules() const { return m_rules; }
+
+        // 查找表。
+        const RangeTable& table() const { return m_table; }
+
+        // 域名规则。
+        const std::vector<DomainRule>& domains() const { return m_domains; }
+
+        // 白名单（规整后排序）。
+        const std::vector<std::string>& whitelist() const { return m_whitelist; }
+
+        // 已加入的IP/网段条目数（含列表文件中的条目）。
+        size_t netInputs() const { return m_compiler.size(); }
+
+        /**
+         * @brief 查找IP/网段黑名单
+         * @param family 地址族（FAMILY_V4/FAMILY_V6）
+         * @param addr 网络字节序地址（IPv4映射的IPv6地址按IPv4查找）
+         * @param port 目标端口
+         * @param proto 协议掩码（命中其中任一协议即可）
+         * @return 命中条目中最小的规则编号，未命中返回-1
+         */
+        int matchNet(uint8_t family, const uint8_t* addr, uint16_t port, uint8_t proto = PROTO_ALL) const;
+
+        /**
+         * @brief 查找IP/网段黑名单（文本地址，如内核日志中的"DST=1.2.3.4"）
+         * @return 命中条目中最小的规则编号，未命中或地址格式错误返回-1
+         */
+        int matchNet(const char* ip, size_t len, uint16_t port, uint8_t proto = PROTO_ALL) const;
+
+        /**
+         * @brief 判断进程是否在白名单中
+         * @param exe 可执行文件的绝对路径
+         */
+        bool isWhitelisted(const std::string& exe) const;
+
+        /**
+         * @brief 判断某一时刻是否在拦截时间段内
+         * @param now 时刻
+         */
+        bool active(time_t now) const { return m_schedule.active(now); }
+
+        /**
+         * @brief 规整进程路径（/usr/bin/xxx与/bin/xxx视为同一进程）
+         */
+        static std::string normalizeExe(const std::string& exe);
+    };
+    // ===========================================================================
+
+} // namespace policy
+
+#endif // !POLICY_POLICY_SET_H
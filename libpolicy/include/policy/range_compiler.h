@@ -0,0 +1,249 @@
+/****************************************************************************************/
+/*
+ * 程序名：range_compiler.h
+ * 功能描述：黑名单网段编译器，把导入的IP/网段规则规整为最小的等价规则集，支持以下特性：
+ *          - 统一表示：每条规则规整为(网段前缀, 端口范围, 协议掩码)三元组，IPv4/IPv6共用
+ *          - 合并：同一端口范围与协议下，重叠或相邻的网段合并（两个相邻的/25合并为/24），
+ *            同一网段下重叠或相邻的端口范围合并，端口与网段都相同的不同协议合并为一条
+ *          - 吸收：被端口范围更宽、网段更大的规则完全覆盖的规则直接去掉
+ *          - 输出：最小的CIDR分解结果和精简统计（CompileReport），前端据此生成内核规则或查找表
+ *          - 查找表（RangeTable）：编译结果按(协议, 端口范围)分组，组内网段互不重叠且有序，
+ *            查找时对每个端口范围匹配的组做一次二分查找
+ *          - 不依赖OL库，C++11即可编译（iptables版本与LD_PRELOAD版本共用）
+ * 作者：ol
+ * 适用标准：C++11及以上（需支持unsigned __int128，GCC/Clang均提供）
+ */
+/****************************************************************************************/
+
+#ifndef POLICY_RANGE_COMPILER_H
+#define POLICY_RANGE_COMPILER_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace policy
+{
+
+    typedef unsigned __int128 u128; ///< 128位无符号整数（IPv6地址按数值处理）
+
+    // 协议掩码
+    enum : uint8_t
+    {
+        PROTO_TCP = 1,  ///< TCP
+        PROTO_UDP = 2,  ///< UDP
+        PROTO_ICMP = 4, ///< ICMP（没有端口，端口范围总是视为全部端口）
+        PROTO_ALL = 7   ///< 以上全部
+    };
+
+    // 地址族（0表示IPv4和IPv6都匹配，只用于输入规则）
+    enum : uint8_t
+    {
+        FAMILY_ANY = 0,
+        FAMILY_V4 = 4,
+        FAMILY_V6 = 6
+    };
+
+    // ===========================================================================
+    /**
+     * @brief 一条网段规则：(网段前缀, 端口范围, 协议掩码)
+     */
+    struct NetRule
+    {
+        uint8_t m_family = FAMILY_V4; ///< 地址族（FAMILY_V4/FAMILY_V6，输入时可为FAMILY_ANY）
+        uint8_t m_prefixLen = 32;     ///< 前缀长度
+        uint8_t m_proto = PROTO_ALL;  ///< 协议掩码
+        uint16_t m_portLo = 0;        ///< 端口范围起点（包含）
+        uint16_t m_portHi = 65535;    ///< 端口范围终点（包含）
+        int m_ruleId = -1;            ///< 来源规则编号（合并后取参与合并的最小编号）
+        uint8_t m_addr[16] = {};      ///< 网络号（网络字节序，IPv4只用前4字节）
+
+        // 是否覆盖全部端口
+        bool allPorts() const
+        {
+            return m_portLo == 0 && m_portHi == 65535;
+        }
+    };
+
+    /**
+     * @brief 编译统计
+     */
+    struct CompileReport
+    {
+        size_t m_input = 0;         ///< 输入规则数
+        size_t m_duplicates = 0;    ///< 完全重复的规则数
+        size_t m_subsumed = 0;      ///< 被更宽规则完全覆盖而去掉的规则数
+        size_t m_merged = 0;        ///< 因重叠或相邻被合并的规则数
+        size_t m_output = 0;        ///< 输出规则数
+        size_t m_protoRulesIn = 0;  ///< 输入的(网段, 端口, 单个协议)规则数（iptables每个协议生成一组规则）
+        size_t m_protoRulesOut = 0; ///< 输出的(网段, 端口, 单个协议)规则数
+
+        /**
+         * @brief 生成可读的统计字符串
+         * @return 如"输入12条，重复2条，吸收3条，合并4条，输出3条（按协议展开：36→9）"
+         */
+        std::string toString() const;
+    };
+    // ===========================================================================
+
+    // 解析与格式化
+    // ===========================================================================
+    /**
+     * @brief 解析IPv4点分十进制地址（严格格式：四段、每段0~255、不允许前导0，与inet_pton一致）
+     * @param text 文本（不要求以'\0'结尾）
+     * @param len 文本长度
+     * @param out 输出：网络字节序的4字节地址
+     * @return 解析成功返回true
+     * @note 单趟扫描、按位累积错误标志，除非法字符外不提前分支，百万行列表中比inet_pton快数倍
+     */
+    bool parseIPv4(const char* text, size_t len, uint8_t out[4]);
+
+    /**
+     * @brief 解析IPv6地址（支持"::"缩写和末尾内嵌IPv4，如"::ffff:1.2.3.4"；不支持"%接口"后缀）
+     * @param text 文本（不要求以'\0'结尾）
+     * @param len 文本长度
+     * @param out 输出：网络字节序的16字节地址
+     * @return 解析成功返回true
+     */
+    bool parseIPv6(const char* text, size_t len, uint8_t out[16]);
+
+    /**
+     * @brief 解析地址或网段（"1.2.3.4"、"10.0.0.0/8"、"2001:db8::/32"、"[::1]"、"*"）
+     * @param text 文本
+     * @param len 文本长度
+     * @param rule 输出：地址族、网络号、前缀长度（主机位清零）；"*"输出FAMILY_ANY、前缀0
+     * @return 解析成功返回true
+     */
+    bool parseAddr(const char* text, size_t len, NetRule& rule);
+
+    /**
+     * @brief 解析端口或端口范围（"*"、"0"表示全部端口；"80"；"8000-8100"或"8000:8100"）
+     * @param text 文本
+     * @param len 文本长度
+     * @param lo 输出：范围起点
+     * @param hi 输出：范围终点
+     * @return 解析成功返回true
+     */
+    bool parsePorts(const char* text, size_t len, uint16_t& lo, uint16_t& hi);
+
+    /**
+     * @brief 解析"地址[/前缀]:端口"形式的规则（IPv6地址可写作"[2001:db8::]/32:443"，
+     *        不带方括号时以最后一个冒号分隔端口）
+     * @param text 规则文本
+     * @param len 文本长度
+     * @param rule 输出规则（协议掩码与规则编号不修改）
+     * @return 解析成功返回true
+     */
+    bool parseTarget(const char* text, size_t len, NetRule& rule);
+    bool parseTarget(const std::string& text, NetRule& rule); // std::string版本
+
+    /**
+     * @brief 格式化网段（整个地址时不带前缀长度，如"1.2.3.4"、"10.0.0.0/8"、"2001:db8::/32"）
+     */
+    std::string formatAddr(const NetRule& rule);
+
+    /**
+     * @brief 格式化端口范围
+     * @param rule 规则
+     * @param sep 范围分隔符（iptables用':'）
+     * @return 全部端口返回空串，单个端口返回"80"，范围返回"8000:8100"
+     */
+    std::string formatPorts(const NetRule& rule, char sep = '-');
+    // ===========================================================================
+
+    // ===========================================================================
+    /**
+     * @brief 网段编译器：收集规则，输出最小的等价规则集
+     * @note 输出规则的语义与输入完全等价：任意(地址, 端口, 协议)被输入中某条规则命中，当且仅当被输出中某条规则命中
+     */
+    class RangeCompiler
+    {
+    private:
+        std::vector<NetRule> m_rules; ///< 输入规则（FAMILY_ANY已展开为IPv4和IPv6两条）
+        size_t m_input = 0;           ///< 调用add的次数
+
+    public:
+        /**
+         * @brief 添加一条规则（主机位自动清零；FAMILY_ANY展开为IPv4/0和IPv6/0）
+         * @param rule 规则
+         */
+        void add(const NetRule& rule);
+
+        // 已添加的规则数。
+        size_t size() const { return m_input; }
+
+        // 清空。
+        void clear()
+        {
+            m_rules.clear();
+            m_input = 0;
+        }
+
+        /**
+         * @brief 编译：合并、吸收并分解为最少的CIDR规则
+         * @param report 输出统计（可为nullptr）
+         * @return 最小等价规则集，按(地址族, 网络号, 前缀长度, 端口)排序
+         */
+        std::vector<NetRule> compile(CompileReport* report = nullptr) const;
+    };
+    // ===========================================================================
+
+    // ===========================================================================
+    /**
+     * @brief 网段查找表：按(地址族, 协议, 端口范围)分组，组内网段互不重叠且按起点排序
+     * @note 查找开销为"端口与协议匹配的组数 × log(组内网段数)"，编译后的规则集通常只有少数几个端口组
+     */
+    class RangeTable
+    {
+    private:
+        struct Interval
+        {
+            u128 m_lo; ///< 地址范围起点
+            u128 m_hi; ///< 地址范围终点（包含）
+            int m_id;  ///< 规则编号
+        };
+
+        struct Group
+        {
+            uint8_t m_family;                 ///< 地址族
+            uint8_t m_proto;                  ///< 协议掩码
+            uint16_t m_portLo;                ///< 端口范围起点
+            uint16_t m_portHi;                ///< 端口范围终点
+            std::vector<Interval> m_ranges;   ///< 互不重叠的地址范围（按起点排序）
+        };
+
+        std::vector<Group> m_groups; ///< 全部分组
+        size_t m_size = 0;           ///< 地址范围总数
+
+    public:
+        /**
+         * @brief 由规则构建查找表（建议先用RangeCompiler编译，未编译的规则也能正确查找）
+         * @param rules 规则（FAMILY_ANY的规则需先经RangeCompiler展开）
+         */
+        void build(const std::vector<NetRule>& rules);
+
+        /**
+         * @brief 查找
+         * @param family 地址族（FAMILY_V4/FAMILY_V6，IPv4映射的IPv6地址应先按IPv4查找）
+         * @param addr 地址（网络字节序，4或16字节）
+         * @param port 端口（只命中ICMP时忽略）
+         * @param proto 协议（PROTO_TCP等单个协议；传入多个协议时任一协议命中即可）
+         * @return 命中返回规则编号（同一地址被多条规则命中时返回编号最小的），未命中返回-1
+         */
+        int match(uint8_t family, const uint8_t* addr, uint16_t port, uint8_t proto = PROTO_ALL) const;
+
+        // 地址范围总数。
+        size_t size() const { return m_size; }
+
+        // 分组数。
+        size_t groupNum() const { return m_groups.size(); }
+
+        // 是否为空。
+        bool empty() const { return m_size == 0; }
+    };
+    // ===========================================================================
+
+} // namespace policy
+
+#endif // !POLICY_RANGE_COMPILER_H
@@ -0,0 +1,121 @@
+/****************************************************************************************/
+/*
+ * 程序名：schedule.h
+ * 功能描述：拦截时间段（按天循环），两个前端共用同一套解析与判断逻辑，支持以下特性：
+ *          - 时间格式"HH:MM"（也接受"H:MM"、"HH:M"，允许首尾空白），取值00:00~24:00
+ *          - 多个时间段取并集；开始晚于结束的时间段跨天（如23:00-02:00）
+ *          - 时间段两端都包含（与原有行为一致：09:00-18:00在18:00这一分钟仍然拦截）
+ *          - 加载时展开为一天1440分钟的位图，判断时只做一次位测试，不再重复解析字符串
+ *          - active()使用localtime_r，可在被注入进程的任意线程中调用
+ * 作者：ol
+ * 适用标准：C++11及以上
+ */
+/****************************************************************************************/
+
+#ifndef POLICY_SCHEDULE_H
+#define POLICY_SCHEDULE_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace policy
+{
+
+    // ===========================================================================
+    /**
+     * @brief 按天循环的时间段集合
+     */
+    class Schedule
+    {
+    public:
+        static const int MINUTES_PER_DAY = 1440; ///< 一天的分钟数
+
+    private:
+        uint64_t m_bits[(MINUTES_PER_DAY + 63) / 64] = {};     ///< 每分钟一位：是否在时间段内
+        std::vector<std::pair<uint16_t, uint16_t>> m_ranges;  ///< 加入的时间段（分钟，用于显示）
+
+    public:
+        /**
+         * @brief 解析"HH:MM"
+         * @param text 文本（允许首尾空白）
+         * @param len 文本长度
+         * @param minutes 输出：从0点起的分钟数（24:00为1440）
+         * @return 解析成功返回true（小时0~24，分钟0~59，24点只能是24:00）
+         */
+        static bool parseTime(const char* text, size_t len, int& minutes);
+        static bool parseTime(const std::string& text, int& minutes) { return parseTime(text.data(), text.size(), minutes); }
+
+        // 分钟数格式化为"HH:MM"（1440为"24:00"）。
+        static std::string formatTime(int minutes);
+
+        /**
+         * @brief 加入一个时间段（两端包含，开始晚于结束时跨天）
+         * @param start 开始（分钟，0~1440）
+         * @param end 结束（分钟，0~1440，1440即到当天结束）
+         * @return 参数越界返回false
+         */
+        bool addRange(int start, int end);
+
+        /**
+         * @brief 加入一个时间段
+         * @param start 开始时间文本（"HH:MM"）
+         * @param end 结束时间文本（"HH:MM"）
+         * @return 任一时间格式错误返回false
+         */
+        bool addRange(const std::string& start, const std::string& end);
+
+        // 设为全天。
+        void setAllDay()
+        {
+            clear();
+            addRange(0, MINUTES_PER_DAY);
+        }
+
+        // 清空。
+        void clear();
+
+        // 是否没有任何时间段。
+        bool empty() const { return m_ranges.empty(); }
+
+        // 时间段个数。
+        size_t rangeNum() const { return m_ranges.size(); }
+
+        // 第index个时间段（分钟）。
+        const std::pair<uint16_t, uint16_t>& range(size_t index) const { return m_ranges[index]; }
+
+        /**
+         * @brief 判断一天中的某一分钟是否在时间段内
+         * @param minute 从0点起的分钟数（0~1439）
+         */
+        bool contains(int minute) const
+        {
+            if (minute < 0 || minute >= MINUTES_PER_DAY) return false;
+            return (m_bits[minute >> 6] >> (minute & 63)) & 1;
+        }
+
+        /**
+         * @brief 判断某一时刻（本地时间）是否在时间段内
+         * @param now 时刻
+         */
+        bool active(time_t now) const;
+
+        /**
+         * @brief 计算某一时刻（本地时间）之后多少秒拦截状态发生变化（进入或离开时间段）
+         * @param now 时刻
+         * @return 秒数（至少1）；全天都在或都不在时间段内时返回-1
+         * @note 判定守护进程据此限制缓存结果的有效期，时间段切换后旧结果不再命中
+         */
+        long secondsUntilChange(time_t now) const;
+
+        // 格式化为"09:00-18:00、23:00-02:00"（没有时间段时为"无"）。
+        std::string toString() const;
+    };
+    // ===========================================================================
+
+} // namespace policy
+
+#endif // !POLICY_SCHEDULE_H
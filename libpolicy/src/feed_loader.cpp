@@ -0,0 +1,263 @@
+#include "policy/feed_loader.h"
+#include "policy/line_reader.h"
+#include <cstring>
+#include <utility>
+
+namespace policy
+{
+
+    // ===========================================================================
+    namespace
+    {
+        inline bool isBlank(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        // 去掉首尾空白。
+        inline void trim(const char*& p, size_t& n)
+        {
+            while (n > 0 && isBlank(*p)) ++p, --n;
+            while (n > 0 && isBlank(p[n - 1])) --n;
+        }
+
+        // 取下一个字段（以空白分隔），p/n前移到字段之后。
+        inline bool nextField(const char*& p, size_t& n, const char*& field, size_t& fieldLen)
+        {
+            while (n > 0 && isBlank(*p)) ++p, --n;
+            if (n == 0) return false;
+            field = p;
+            while (n > 0 && !isBlank(*p)) ++p, --n;
+            fieldLen = static_cast<size_t>(p - field);
+            return true;
+        }
+
+        inline bool startsWith(const char* p, size_t n, const char* prefix, size_t prefixLen)
+        {
+            return n >= prefixLen && std::memcmp(p, prefix, prefixLen) == 0;
+        }
+
+        // hosts文件中带'.'的本机名（不带'.'的本机名如localhost、broadcasthost已被isValidHost排除）。
+        inline bool isLocalName(const char* p, size_t n)
+        {
+            return n == 21 && std::memcmp(p, "localhost.localdomain", 21) == 0;
+        }
+    } // namespace
+    // ===========================================================================
+
+    std::string FeedStats::toString() const
+    {
+        return "读取" + std::to_string(m_lines) + "行，IP/网段" + std::to_string(m_nets) + "条，域名" + std::to_string(m_domains) +
+               "条，跳过" + std::to_string(m_skipped) + "条，非法" + std::to_string(m_invalid) + "条，不支持" +
+               std::to_string(m_unsupported) + "条";
+    }
+
+    bool isValidHost(const char* host, size_t len, bool requireDot)
+    {
+        if (len == 0 || len > 253) return false;
+        if (host[len - 1] == '.') --len; // 允许FQDN末尾的点
+        if (len == 0 || host[0] == '.' || host[0] == '-') return false;
+
+        // 按字符类别累积：非法字符、点的个数、空标签、最后一级是否全是数字
+        bool bad = false, lastNumeric = true;
+        unsigned dots = 0;
+        char prev = 0;
+        for (size_t ii = 0; ii < len; ++ii)
+        {
+            unsigned char c = static_cast<unsigned char>(host[ii]);
+            bool digit = static_cast<unsigned>(c - '0') < 10u;
+            bool alpha = static_cast<unsigned>((c | 0x20) - 'a') < 26u;
+            if (c == '.')
+            {
+                bad |= prev == '.';
+                ++dots;
+                lastNumeric = true;
+            }
+            else
+            {
+                bad |= !(digit | alpha | (c == '-') | (c == '_'));
+                lastNumeric &= digit;
+            }
+            prev = static_cast<char>(c);
+        }
+        return !bad && (dots > 0 || !requireDot) && !lastNumeric;
+    }
+
+    FeedLoader::FeedLoader(RangeCompiler* nets, DomainSink domains) : m_nets(nets), m_domains(std::move(domains))
+    {
+    }
+
+    void FeedLoader::addNet(NetRule& rule)
+    {
+        rule.m_proto = m_template.m_proto;
+        rule.m_portLo = m_template.m_portLo;
+        rule.m_portHi = m_template.m_portHi;
+        rule.m_ruleId = m_template.m_ruleId;
+        if (m_nets != nullptr) m_nets->add(rule);
+        ++m_stats.m_nets;
+    }
+
+    void FeedLoader::addDomain(const char* host, size_t len)
+    {
+        if (len > 0 && host[len - 1] == '.') --len;
+        if (m_domains) m_domains(host, len);
+        ++m_stats.m_domains;
+    }
+
+    void FeedLoader::feedAdblock(const char* p, size_t n)
+    {
+        // 只支持"||域名^"（可带$important、$all），其余规则在域名层面无法等价表达
+        if (!startsWith(p, n, "||", 2))
+        {
+            if (p[0] == '[') // "[Adblock Plus 2.0]"等文件头
+                ++m_stats.m_skipped;
+            else
+                ++m_stats.m_unsupported;
+            return;
+        }
+        p += 2;
+        n -= 2;
+
+        const char* dollar = static_cast<const char*>(std::memchr(p, '$', n));
+        if (dollar != nullptr)
+        {
+            const char* opt = dollar + 1;
+            size_t optLen = n - static_cast<size_t>(opt - p);
+            if (!((optLen == 9 && std::memcmp(opt, "important", 9) == 0) || (optLen == 3 && std::memcmp(opt, "all", 3) == 0)))
+            {
+                ++m_stats.m_unsupported;
+                return;
+            }
+            n = static_cast<size_t>(dollar - p);
+        }
+
+        if (n > 0 && p[n - 1] == '|') --n; // "||域名^|"
+        if (n > 0 && p[n - 1] == '^') --n;
+        else
+        {
+            ++m_stats.m_unsupported; // 没有'^'结尾的是子串匹配，可能带路径
+            return;
+        }
+
+        if (isValidHost(p, n))
+            addDomain(p, n);
+        else
+            ++m_stats.m_unsupported; // 通配符、路径等
+    }
+
+    void FeedLoader::feedHosts(const char* rest, size_t n)
+    {
+        const char* field;
+        size_t fieldLen;
+        while (nextField(rest, n, field, fieldLen))
+        {
+            if (isLocalName(field, fieldLen))
+                ++m_stats.m_skipped;
+            else if (isValidHost(field, fieldLen))
+                addDomain(field, fieldLen);
+            else if (std::memchr(field, '.', fieldLen) == nullptr && std::memchr(field, ':', fieldLen) == nullptr)
+                ++m_stats.m_skipped; // broadcasthost、ip6-loopback等单级本机名
+            else
+                ++m_stats.m_invalid;
+        }
+    }
+
+    void FeedLoader::feedPlain(const char* p, size_t n)
+    {
+        NetRule rule;
+        if (parseAddr(p, n, rule))
+        {
+            if (rule.m_family == FAMILY_ANY) // "*"不是列表条目
+                ++m_stats.m_invalid;
+            else
+                addNet(rule);
+        }
+        else if (isValidHost(p, n))
+            addDomain(p, n);
+        else
+            ++m_stats.m_invalid;
+    }
+
+    void FeedLoader::feedLine(const char* line, size_t len, FeedFormat format)
+    {
+        ++m_stats.m_lines;
+
+        // 注释：'#'之后、空白之后的';'
+        const char* hash = static_cast<const char*>(std::memchr(line, '#', len));
+        if (hash != nullptr) len = static_cast<size_t>(hash - line);
+        const char* semi = static_cast<const char*>(std::memchr(line, ';', len));
+        if (semi != nullptr && (semi == line || isBlank(semi[-1]))) len = static_cast<size_t>(semi - line);
+
+        trim(line, len);
+        if (len == 0 || line[0] == '!')
+        {
+            ++m_stats.m_skipped;
+            return;
+        }
+
+        if (format == FEED_ADBLOCK ||
+            (format == FEED_AUTO && (line[0] == '|' || line[0] == '@' || startsWith(line, len, "[Adblock", 8))))
+        {
+            feedAdblock(line, len);
+            return;
+        }
+
+        const char* rest = line;
+        size_t restLen = len;
+        const char* field = line;
+        size_t fieldLen = 0;
+        nextField(rest, restLen, field, fieldLen);
+
+        // hosts格式：首字段是单个IP地址（重定向目标，不是黑名单条目），其后是域名
+        if (format == FEED_HOSTS || (format == FEED_AUTO && restLen > 0))
+        {
+            uint8_t addr[16];
+            if (parseIPv4(field, fieldLen, addr) || parseIPv6(field, fieldLen, addr))
+            {
+                feedHosts(rest, restLen);
+                return;
+            }
+            if (format == FEED_HOSTS)
+            {
+                ++m_stats.m_invalid;
+                return;
+            }
+        }
+
+        // 普通列表：只取首字段（其后的内容视为说明）
+        feedPlain(field, fieldLen);
+    }
+
+    void FeedLoader::loadBuffer(const char* buf, size_t len, FeedFormat format)
+    {
+        LineReader reader;
+        reader.openBuffer(buf, len);
+        const char* line;
+        size_t lineLen;
+        while (reader.next(line, lineLen)) feedLine(line, lineLen, format);
+    }
+
+    bool FeedLoader::load(const std::string& filename, FeedFormat format)
+    {
+        m_error.clear();
+
+        LineReader reader;
+        if (!reader.open(filename))
+        {
+            m_error = reader.error();
+            return false;
+        }
+
+        const char* line;
+        size_t lineLen;
+        while (reader.next(line, lineLen)) feedLine(line, lineLen, format);
+
+        if (!reader.ok())
+        {
+            m_error = std::string(reader.error()) + " at line " + std::to_string(reader.lineNo());
+            return false;
+        }
+        return true;
+    }
+
+} // namespace policy
@@ -0,0 +1,247 @@
+#include "policy/line_reader.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace policy
+{
+
+    uint64_t LineReader::scanBlock(size_t block) const
+    {
+        const char* p = m_data + block;
+        size_t n = m_len - block;
+        if (n >= 64)
+        {
+#if defined(__AVX2__)
+            const __m256i nl = _mm256_set1_epi8('\n');
+            uint32_t lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), nl)));
+            uint32_t hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)), nl)));
+            return static_cast<uint64_t>(lo) | (static_cast<uint64_t>(hi) << 32);
+#elif defined(__SSE2__)
+            const __m128i nl = _mm_set1_epi8('\n');
+            uint64_t m0 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), nl)));
+            uint64_t m1 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), nl)));
+            uint64_t m2 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)), nl)));
+            uint64_t m3 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)), nl)));
+            return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+#else
+            n = 64;
+#endif
+        }
+
+        // 不足64字节的尾部（或没有SIMD时）：用memchr逐个找换行
+        uint64_t mask = 0;
+        const char* cur = p;
+        const char* end = p + n;
+        while (cur < end)
+        {
+            const char* nl = static_cast<const char*>(std::memchr(cur, '\n', static_cast<size_t>(end - cur)));
+            if (nl == nullptr) break;
+            mask |= static_cast<uint64_t>(1) << (nl - p);
+            cur = nl + 1;
+        }
+        return mask;
+    }
+
+    bool LineReader::open(const std::string& filename)
+    {
+        close();
+
+        int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            m_error = "open failed";
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            ::close(fd);
+            m_error = "not a regular file";
+            return false;
+        }
+
+        if (st.st_size > 0)
+        {
+            void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                ::close(fd);
+                m_error = "mmap failed";
+                return false;
+            }
+            madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            m_map = static_cast<const char*>(addr);
+            m_mapLen = static_cast<size_t>(st.st_size);
+        }
+        ::close(fd);
+
+        // gzip：魔数1f 8b
+        if (m_mapLen >= 2 && static_cast<unsigned char>(m_map[0]) == 0x1f && static_cast<unsigned char>(m_map[1]) == 0x8b)
+        {
+            z_stream* zs = new z_stream();
+            if (inflateInit2(zs, 16 + MAX_WBITS) != Z_OK) // 16+：只接受gzip头
+            {
+                delete zs;
+                m_error = "inflateInit failed";
+                return false;
+            }
+            zs->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(m_map));
+            zs->avail_in = static_cast<uInt>(m_mapLen > 0x7fffffffu ? 0x7fffffffu : m_mapLen);
+            m_zs = zs;
+            m_gzBuf.resize(GZ_CHUNK);
+            m_data = m_gzBuf.data();
+            m_len = 0;
+            return refill();
+        }
+
+        m_data = m_map;
+        m_len = m_mapLen;
+        return true;
+    }
+
+    void LineReader::openBuffer(const char* buf, size_t len)
+    {
+        close();
+        m_data = buf;
+        m_len = len;
+    }
+
+    bool LineReader::refill()
+    {
+        z_stream* zs = static_cast<z_stream*>(m_zs);
+
+        // 未读完的行搬到缓冲区开头；整个缓冲区都是同一行时扩大缓冲区
+        size_t keep = m_len - m_lineStart;
+        if (keep > 0 && m_lineStart > 0) std::memmove(m_gzBuf.data(), m_gzBuf.data() + m_lineStart, keep);
+        if (m_gzBuf.size() - keep < GZ_CHUNK / 2) m_gzBuf.resize(m_gzBuf.size() * 2);
+        m_data = m_gzBuf.data();
+        m_len = keep;
+        m_lineStart = 0;
+        m_block = 0; // 保留部分的尾部（不足64字节）还没扫描过，从头重扫（最多一行）
+        m_mask = 0;
+
+        while (!m_zEnd && m_len < m_gzBuf.size())
+        {
+            // 输入超过2GB时分段喂给zlib
+            if (zs->avail_in == 0)
+            {
+                size_t consumed = static_cast<size_t>(reinterpret_cast<const char*>(zs->next_in) - m_map);
+                size_t rest = m_mapLen - consumed;
+                zs->avail_in = static_cast<uInt>(rest > 0x7fffffffu ? 0x7fffffffu : rest);
+            }
+
+            zs->next_out = reinterpret_cast<Bytef*>(m_gzBuf.data() + m_len);
+            zs->avail_out = static_cast<uInt>(m_gzBuf.size() - m_len);
+            int ret = inflate(zs, Z_NO_FLUSH);
+            m_len = m_gzBuf.size() - zs->avail_out;
+
+            if (ret == Z_STREAM_END)
+            {
+                // 多个gzip成员首尾相连（cat a.gz b.gz）时继续解压下一个成员
+                if (zs->avail_in > 0 && inflateReset(zs) == Z_OK) continue;
+                m_zEnd = true;
+            }
+            else if (ret != Z_OK && ret != Z_BUF_ERROR)
+            {
+                m_error = "gzip data corrupted";
+                m_zEnd = true;
+                return false;
+            }
+            else if (ret == Z_BUF_ERROR && zs->avail_in == 0)
+            {
+                m_error = "gzip data truncated";
+                m_zEnd = true;
+                return false;
+            }
+            if (m_len - keep >= GZ_CHUNK / 2) break; // 攒够一段再交给扫描
+        }
+        return true;
+    }
+
+    bool LineReader::next(const char*& line, size_t& len)
+    {
+        while (true)
+        {
+            // 取出当前块中的下一个换行
+            while (m_mask == 0)
+            {
+                if (m_block + 64 <= m_len)
+                {
+                    m_mask = scanBlock(m_block);
+                    if (m_mask == 0) m_block += 64;
+                    continue;
+                }
+
+                // 不足64字节的尾部：gzip先尝试补充数据，补不到再按尾部扫描
+                if (m_zs != nullptr && !m_zEnd)
+                {
+                    if (!refill()) return false;
+                    continue;
+                }
+                if (m_block < m_len)
+                {
+                    m_mask = scanBlock(m_block);
+                    if (m_mask == 0) m_block = m_len;
+                    continue;
+                }
+
+                // 数据结束：最后一行没有换行符
+                if (m_lineStart < m_len)
+                {
+                    line = m_data + m_lineStart;
+                    len = m_len - m_lineStart;
+                    m_lineStart = m_len;
+                    if (len > 0 && line[len - 1] == '\r') --len;
+                    ++m_lineNo;
+                    return true;
+                }
+                return false;
+            }
+
+            size_t nl = m_block + static_cast<size_t>(__builtin_ctzll(m_mask));
+            m_mask &= m_mask - 1;
+            if (m_mask == 0) m_block += 64;
+
+            line = m_data + m_lineStart;
+            len = nl - m_lineStart;
+            m_lineStart = nl + 1;
+            if (len > 0 && line[len - 1] == '\r') --len;
+            ++m_lineNo;
+            return true;
+        }
+    }
+
+    void LineReader::close()
+    {
+        if (m_zs != nullptr)
+        {
+            inflateEnd(static_cast<z_stream*>(m_zs));
+            delete static_cast<z_stream*>(m_zs);
+            m_zs = nullptr;
+        }
+        if (m_map != nullptr) munmap(const_cast<char*>(m_map), m_mapLen);
+        m_map = nullptr;
+        m_mapLen = 0;
+        m_zEnd = false;
+        std::vector<char>().swap(m_gzBuf);
+        m_data = nullptr;
+        m_len = 0;
+        m_lineStart = 0;
+        m_block = 0;
+        m_mask = 0;
+        m_lineNo = 0;
+        m_error = nullptr;
+    }
+
+} // namespace policy
@@ -0,0 +1,122 @@
+#include "policy/policy_set.h"
+#include <algorithm>
+#include <cstring>
+
+namespace policy
+{
+
+    TargetKind PolicySet::addTarget(const char* text, size_t len, int ruleId, uint8_t proto, NetRule* net)
+    {
+        // 条目中不会有空白（含跨行元素的换行和缩进），去掉后再解析；在栈上进行，不分配内存
+        char compact[320]; // 域名最长253字节，加上端口范围
+        size_t compactLen = 0;
+        for (size_t ii = 0; ii < len; ++ii)
+        {
+            char c = text[ii];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+            if (compactLen == sizeof(compact)) return TARGET_INVALID; // 过长
+            compact[compactLen++] = c;
+        }
+        if (compactLen == 0) return TARGET_INVALID;
+
+        NetRule rule;
+        rule.m_proto = proto;
+        rule.m_ruleId = ruleId;
+        if (parseTarget(compact, compactLen, rule))
+        {
+            m_compiler.add(rule);
+            if (net != nullptr) *net = rule;
+            return TARGET_NET;
+        }
+
+        // 域名条目：域名中不会有':'，以第一个':'分隔端口
+        const char* colon = static_cast<const char*>(std::memchr(compact, ':', compactLen));
+        if (colon == nullptr || colon == compact) return TARGET_INVALID;
+        size_t hostLen = static_cast<size_t>(colon - compact);
+
+        // 形如IP但未能按IP/网段解析的（前缀长度或端口非法）由isValidHost排除：最后一级全是数字
+        if (!isValidHost(compact, hostLen, false)) return TARGET_INVALID;
+
+        DomainRule dr;
+        if (!parsePorts(colon + 1, compactLen - hostLen - 1, dr.m_portLo, dr.m_portHi)) return TARGET_INVALID;
+        if (compact[hostLen - 1] == '.') --hostLen;
+        dr.m_host.assign(compact, hostLen);
+        dr.m_proto = proto;
+        dr.m_ruleId = ruleId;
+        m_domains.push_back(dr);
+        return TARGET_DOMAIN;
+    }
+
+    bool PolicySet::addFeed(const std::string& filename, int ruleId, uint8_t proto, FeedStats& stats, std::string& error)
+    {
+        NetRule tmpl;
+        tmpl.m_proto = proto;
+        tmpl.m_ruleId = ruleId;
+        FeedLoader loader(&m_compiler);
+        loader.setTemplate(tmpl);
+        bool ok = loader.load(filename);
+        stats = loader.stats();
+        error = loader.error();
+        return ok;
+    }
+
+    std::string PolicySet::normalizeExe(const std::string& exe)
+    {
+        if (exe.compare(0, 9, "/usr/bin/") == 0) return exe.substr(4);
+        return exe;
+    }
+
+    void PolicySet::addWhitelist(const std::string& exe)
+    {
+        if (!exe.empty()) m_whitelist.push_back(normalizeExe(exe));
+    }
+
+    void PolicySet::compile()
+    {
+        m_rules = m_compiler.compile(&m_report);
+        m_table.build(m_rules);
+
+        std::sort(m_whitelist.begin(), m_whitelist.end());
+        m_whitelist.erase(std::unique(m_whitelist.begin(), m_whitelist.end()), m_whitelist.end());
+    }
+
+    void PolicySet::clear()
+    {
+        m_compiler.clear();
+        m_rules.clear();
+        m_table.build(m_rules);
+        m_report = CompileReport();
+        m_domains.clear();
+        m_whitelist.clear();
+        m_schedule.clear();
+    }
+
+    int PolicySet::matchNet(uint8_t family, const uint8_t* addr, uint16_t port, uint8_t proto) const
+    {
+        if (m_table.empty()) return -1;
+
+        // IPv4映射的IPv6地址（::ffff:a.b.c.d）按IPv4查找
+        static const uint8_t v4mapped[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+        if (family == FAMILY_V6 && std::memcmp(addr, v4mapped, sizeof(v4mapped)) == 0)
+        {
+            family = FAMILY_V4;
+            addr += 12;
+        }
+        return m_table.match(family, addr, port, proto);
+    }
+
+    int PolicySet::matchNet(const char* ip, size_t len, uint16_t port, uint8_t proto) const
+    {
+        uint8_t addr[16];
+        if (parseIPv4(ip, len, addr)) return matchNet(FAMILY_V4, addr, port, proto);
+        if (parseIPv6(ip, len, addr)) return matchNet(FAMILY_V6, addr, port, proto);
+        return -1;
+    }
+
+    bool PolicySet::isWhitelisted(const std::string& exe) const
+    {
+        if (exe.empty() || m_whitelist.empty()) return false;
+        return std::binary_search(m_whitelist.begin(), m_whitelist.end(), normalizeExe(exe));
+    }
+
+} // namespace policy
@@ -0,0 +1,827 @@
+#include "policy/range_compiler.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstring>
+
+namespace policy
+{
+
+    // 内部实现
+    // ===========================================================================
+    namespace
+    {
+        // 地址族的位数
+        inline unsigned familyBits(uint8_t family)
+        {
+            return family == FAMILY_V6 ? 128 : 32;
+        }
+
+        // 地址族的最大地址
+        inline u128 familyMax(uint8_t family)
+        {
+            return family == FAMILY_V6 ? ~static_cast<u128>(0) : static_cast<u128>(0xffffffffu);
+        }
+
+        // 前缀长度对应的主机位掩码（prefixLen >= bits时为0）
+        inline u128 hostMask(unsigned prefixLen, unsigned bits)
+        {
+            if (prefixLen >= bits) return 0;
+            unsigned host = bits - prefixLen;
+            return host >= 128 ? ~static_cast<u128>(0) : ((static_cast<u128>(1) << host) - 1);
+        }
+
+        // 网络字节序地址 → 数值
+        inline u128 addrToValue(uint8_t family, const uint8_t* addr)
+        {
+            u128 v = 0;
+            size_t n = family == FAMILY_V6 ? 16 : 4;
+            for (size_t ii = 0; ii < n; ++ii) v = (v << 8) | addr[ii];
+            return v;
+        }
+
+        // 数值 → 网络字节序地址
+        inline void valueToAddr(uint8_t family, u128 v, uint8_t* addr)
+        {
+            std::memset(addr, 0, 16);
+            size_t n = family == FAMILY_V6 ? 16 : 4;
+            for (size_t ii = n; ii-- > 0;)
+            {
+                addr[ii] = static_cast<uint8_t>(v);
+                v >>= 8;
+            }
+        }
+
+        // 单个协议上的地址范围：编译过程的基本单位
+        struct Item
+        {
+            uint8_t m_family;
+            uint8_t m_proto; // 单个协议位
+            uint16_t m_portLo;
+            uint16_t m_portHi;
+            u128 m_lo;
+            u128 m_hi;
+            int m_id;
+        };
+
+        // (地址族, 协议, 端口范围)拼成一个整数，按它比较与逐个字段比较的顺序相同
+        inline uint64_t groupKey(const Item& it)
+        {
+            return (static_cast<uint64_t>(it.m_family) << 40) | (static_cast<uint64_t>(it.m_proto) << 32) |
+                   (static_cast<uint64_t>(it.m_portLo) << 16) | it.m_portHi;
+        }
+
+        // 按(地址族, 协议, 端口范围, 地址)排序：同组的地址范围连续且有序
+        inline bool lessByGroup(const Item& a, const Item& b)
+        {
+            uint64_t ka = groupKey(a), kb = groupKey(b);
+            if (ka != kb) return ka < kb;
+            if (a.m_lo != b.m_lo) return a.m_lo < b.m_lo;
+            return a.m_hi > b.m_hi; // 起点相同时大范围在前，后面的小范围直接被吸收
+        }
+
+        // 按(地址族, 协议, 地址, 端口)排序：同一地址范围的端口范围连续且有序
+        inline bool lessByAddr(const Item& a, const Item& b)
+        {
+            if (a.m_family != b.m_family) return a.m_family < b.m_family;
+            if (a.m_proto != b.m_proto) return a.m_proto < b.m_proto;
+            if (a.m_lo != b.m_lo) return a.m_lo < b.m_lo;
+            if (a.m_hi != b.m_hi) return a.m_hi < b.m_hi;
+            if (a.m_portLo != b.m_portLo) return a.m_portLo < b.m_portLo;
+            return a.m_portHi > b.m_portHi;
+        }
+
+        inline bool sameGroup(const Item& a, const Item& b)
+        {
+            return groupKey(a) == groupKey(b);
+        }
+
+        // 所有范围的端口范围都相同（此时地址合并后不会再有可合并的端口范围）
+        inline bool samePorts(const std::vector<Item>& items)
+        {
+            for (const Item& it : items)
+                if (it.m_portLo != items[0].m_portLo || it.m_portHi != items[0].m_portHi) return false;
+            return true;
+        }
+
+        // 128位数值的末尾0个数（v不为0）
+        inline unsigned ctz128(u128 v)
+        {
+            uint64_t low = static_cast<uint64_t>(v);
+            return low != 0 ? static_cast<unsigned>(__builtin_ctzll(low)) : 64 + static_cast<unsigned>(__builtin_ctzll(static_cast<uint64_t>(v >> 64)));
+        }
+
+        // 128位数值的最高位下标，即floor(log2(v))（v不为0）
+        inline unsigned log2u128(u128 v)
+        {
+            uint64_t high = static_cast<uint64_t>(v >> 64);
+            return high != 0 ? 127 - static_cast<unsigned>(__builtin_clzll(high)) : 63 - static_cast<unsigned>(__builtin_clzll(static_cast<uint64_t>(v)));
+        }
+
+        /**
+         * @brief 同组内合并重叠或相邻的地址范围
+         * @return 是否有合并
+         */
+        bool mergeAddrRanges(std::vector<Item>& items, CompileReport& rep, bool countDuplicates)
+        {
+            if (items.size() < 2) return false;
+            std::sort(items.begin(), items.end(), lessByGroup);
+
+            size_t out = 0;
+            bool changed = false;
+            for (size_t ii = 1; ii < items.size(); ++ii)
+            {
+                Item& cur = items[out];
+                const Item& next = items[ii];
+                // 相邻：cur.m_hi + 1 == next.m_lo（cur.m_hi为最大地址时不会有下一个范围与它相邻）
+                if (sameGroup(cur, next) && (next.m_lo <= cur.m_hi || next.m_lo - 1 == cur.m_hi))
+                {
+                    if (next.m_lo == cur.m_lo && next.m_hi == cur.m_hi && countDuplicates)
+                        ++rep.m_duplicates;
+                    else if (next.m_hi <= cur.m_hi)
+                        ++rep.m_subsumed;
+                    else
+                    {
+                        ++rep.m_merged;
+                        cur.m_hi = next.m_hi;
+                    }
+                    cur.m_id = std::min(cur.m_id, next.m_id);
+                    changed = true;
+                    continue;
+                }
+                items[++out] = next;
+            }
+            items.resize(out + 1);
+            return changed;
+        }
+
+        /**
+         * @brief 同一地址范围内合并重叠或相邻的端口范围
+         * @return 是否有合并
+         */
+        bool mergePortRanges(std::vector<Item>& items, CompileReport& rep)
+        {
+            if (items.size() < 2) return false;
+            std::sort(items.begin(), items.end(), lessByAddr);
+
+            size_t out = 0;
+            bool changed = false;
+            for (size_t ii = 1; ii < items.size(); ++ii)
+            {
+                Item& cur = items[out];
+                const Item& next = items[ii];
+                if (cur.m_family == next.m_family && cur.m_proto == next.m_proto && cur.m_lo == next.m_lo && cur.m_hi == next.m_hi &&
+                    static_cast<unsigned>(next.m_portLo) <= static_cast<unsigned>(cur.m_portHi) + 1)
+                {
+                    if (next.m_portHi <= cur.m_portHi)
+                        ++rep.m_subsumed;
+                    else
+                    {
+                        ++rep.m_merged;
+                        cur.m_portHi = next.m_portHi;
+                    }
+                    cur.m_id = std::min(cur.m_id, next.m_id);
+                    changed = true;
+                    continue;
+                }
+                items[++out] = next;
+            }
+            items.resize(out + 1);
+            return changed;
+        }
+
+        /**
+         * @brief 去掉被更宽的组（同地址族与协议，端口范围包含本组）中某个地址范围完全覆盖的范围
+         * @note 调用前items已按lessByGroup排序且组内范围互不重叠
+         */
+        void removeSubsumed(std::vector<Item>& items, CompileReport& rep)
+        {
+            struct GroupSpan
+            {
+                size_t m_begin;
+                size_t m_end;
+            };
+            std::vector<GroupSpan> groups;
+            for (size_t ii = 0; ii < items.size();)
+            {
+                size_t jj = ii + 1;
+                while (jj < items.size() && sameGroup(items[ii], items[jj])) ++jj;
+                groups.push_back(GroupSpan{ii, jj});
+                ii = jj;
+            }
+            if (groups.size() < 2) return;
+
+            std::vector<char> dead(items.size(), 0);
+            for (const GroupSpan& g : groups)
+            {
+                const Item& gk = items[g.m_begin];
+                for (const GroupSpan& h : groups)
+                {
+                    if (&h == &g) continue;
+                    const Item& hk = items[h.m_begin];
+                    if (hk.m_family != gk.m_family || hk.m_proto != gk.m_proto) continue;
+                    if (hk.m_portLo > gk.m_portLo || hk.m_portHi < gk.m_portHi) continue;
+
+                    // h的端口范围包含g：g中每个地址范围在h中二分查找起点不大于它的最后一个范围
+                    for (size_t ii = g.m_begin; ii < g.m_end; ++ii)
+                    {
+                        if (dead[ii]) continue;
+                        const Item& it = items[ii];
+                        size_t lo = h.m_begin, hi = h.m_end;
+                        while (lo < hi)
+                        {
+                            size_t mid = lo + (hi - lo) / 2;
+                            if (items[mid].m_lo <= it.m_lo)
+                                lo = mid + 1;
+                            else
+                                hi = mid;
+                        }
+                        if (lo == h.m_begin) continue;
+                        const Item& cover = items[lo - 1];
+                        if (!dead[lo - 1] && cover.m_hi >= it.m_hi)
+                        {
+                            dead[ii] = 1;
+                            ++rep.m_subsumed;
+                        }
+                    }
+                }
+            }
+
+            size_t out = 0;
+            for (size_t ii = 0; ii < items.size(); ++ii)
+                if (!dead[ii]) items[out++] = items[ii];
+            items.resize(out);
+        }
+
+        /**
+         * @brief 把地址范围分解为最少的CIDR网段
+         */
+        void rangeToCidrs(const Item& it, std::vector<NetRule>& out)
+        {
+            unsigned bits = familyBits(it.m_family);
+            u128 lo = it.m_lo;
+            while (true)
+            {
+                // 取以lo为网络号、不超出范围的最短前缀：主机位数同时受lo的末尾0个数和剩余长度限制
+                unsigned host;
+                u128 count = it.m_hi - lo + 1; // 剩余地址数（整个IPv6空间时溢出为0）
+                if (count == 0 || (bits == 32 && count == (static_cast<u128>(1) << 32)))
+                    host = lo == 0 ? bits : ctz128(lo);
+                else
+                {
+                    host = log2u128(count);
+                    if (lo != 0) host = std::min(host, ctz128(lo));
+                }
+                unsigned prefix = bits - host;
+                u128 last = lo | hostMask(prefix, bits);
+
+                NetRule r;
+                r.m_family = it.m_family;
+                r.m_prefixLen = static_cast<uint8_t>(prefix);
+                r.m_proto = it.m_proto;
+                r.m_portLo = it.m_portLo;
+                r.m_portHi = it.m_portHi;
+                r.m_ruleId = it.m_id;
+                valueToAddr(it.m_family, lo, r.m_addr);
+                out.push_back(r);
+
+                if (last >= it.m_hi) break;
+                lo = last + 1;
+            }
+        }
+
+        inline unsigned protoCount(uint8_t proto)
+        {
+            return ((proto & PROTO_TCP) ? 1 : 0) + ((proto & PROTO_UDP) ? 1 : 0) + ((proto & PROTO_ICMP) ? 1 : 0);
+        }
+
+        inline bool lessRule(const NetRule& a, const NetRule& b)
+        {
+            if (a.m_family != b.m_family) return a.m_family < b.m_family;
+            int c = std::memcmp(a.m_addr, b.m_addr, 16);
+            if (c != 0) return c < 0;
+            if (a.m_prefixLen != b.m_prefixLen) return a.m_prefixLen < b.m_prefixLen;
+            if (a.m_portLo != b.m_portLo) return a.m_portLo < b.m_portLo;
+            return a.m_portHi < b.m_portHi;
+        }
+
+        // 解析十进制无符号整数（整个文本都是数字且不超过maxVal）
+        bool parseUint(const char* text, size_t len, unsigned maxVal, unsigned& val)
+        {
+            if (len == 0 || len > 10) return false;
+            unsigned long long v = 0;
+            for (size_t ii = 0; ii < len; ++ii)
+            {
+                if (text[ii] < '0' || text[ii] > '9') return false;
+                v = v * 10 + static_cast<unsigned>(text[ii] - '0');
+            }
+            if (v > maxVal) return false;
+            val = static_cast<unsigned>(v);
+            return true;
+        }
+    } // namespace
+    // ===========================================================================
+
+    std::string CompileReport::toString() const
+    {
+        return "输入" + std::to_string(m_input) + "条，重复" + std::to_string(m_duplicates) + "条，吸收" + std::to_string(m_subsumed) +
+               "条，合并" + std::to_string(m_merged) + "条，输出" + std::to_string(m_output) + "条（按协议展开：" +
+               std::to_string(m_protoRulesIn) + "→" + std::to_string(m_protoRulesOut) + "）";
+    }
+
+    bool parseIPv4(const char* text, size_t len, uint8_t out[4])
+    {
+        if (len < 7 || len > 15) return false;
+
+        uint32_t addr = 0, octet = 0;
+        unsigned digits = 0, dots = 0;
+        bool bad = false;
+        for (size_t ii = 0; ii < len; ++ii)
+        {
+            unsigned d = static_cast<unsigned>(static_cast<unsigned char>(text[ii])) - '0';
+            if (d < 10)
+            {
+                bad |= (digits != 0 && octet == 0); // 前导0
+                octet = octet * 10 + d;
+                ++digits;
+                bad |= digits > 3;
+            }
+            else if (text[ii] == '.')
+            {
+                bad |= (digits == 0) | (octet > 255);
+                addr = (addr << 8) | (octet & 0xff);
+                octet = 0;
+                digits = 0;
+                ++dots;
+            }
+            else
+                return false;
+        }
+        bad |= (digits == 0) | (octet > 255) | (dots != 3);
+        if (bad) return false;
+
+        addr = (addr << 8) | octet;
+        out[0] = static_cast<uint8_t>(addr >> 24);
+        out[1] = static_cast<uint8_t>(addr >> 16);
+        out[2] = static_cast<uint8_t>(addr >> 8);
+        out[3] = static_cast<uint8_t>(addr);
+        return true;
+    }
+
+    bool parseIPv6(const char* text, size_t len, uint8_t out[16])
+    {
+        if (len < 2 || len > 45) return false;
+
+        uint16_t groups[8];
+        int num = 0, gap = -1; // gap："::"所在的组下标
+        size_t pos = 0;
+        if (text[0] == ':')
+        {
+            if (text[1] != ':') return false;
+            gap = 0;
+            pos = 2;
+        }
+
+        while (pos < len)
+        {
+            size_t start = pos;
+            unsigned v = 0, nd = 0;
+            while (pos < len && nd <= 4)
+            {
+                unsigned char c = static_cast<unsigned char>(text[pos]);
+                unsigned h = c - '0';
+                if (h >= 10)
+                {
+                    h = (c | 0x20) - 'a'; // 转小写
+                    if (h >= 6) break;
+                    h += 10;
+                }
+                v = (v << 4) | h;
+                ++pos;
+                ++nd;
+            }
+            if (nd == 0) return false;
+
+            // 末尾内嵌IPv4
+            if (pos < len && text[pos] == '.')
+            {
+                uint8_t v4[4];
+                if (num > 6 || !parseIPv4(text + start, len - start, v4)) return false;
+                groups[num++] = static_cast<uint16_t>((v4[0] << 8) | v4[1]);
+                groups[num++] = static_cast<uint16_t>((v4[2] << 8) | v4[3]);
+                pos = len;
+                break;
+            }
+
+            if (nd > 4 || num == 8) return false;
+            groups[num++] = static_cast<uint16_t>(v);
+            if (pos == len) break;
+            if (text[pos] != ':') return false;
+            if (++pos == len) return false; // 以单个':'结尾
+            if (text[pos] == ':')
+            {
+                if (gap >= 0) return false; // 只能有一个"::"
+                gap = num;
+                ++pos;
+            }
+        }
+
+        if (gap < 0 ? num != 8 : num > 7) return false;
+
+        int zeros = 8 - num;
+        int out16 = 0;
+        for (int ii = 0; ii < num; ++ii)
+        {
+            if (ii == gap)
+                for (int jj = 0; jj < zeros; ++jj, ++out16) out[out16 * 2] = out[out16 * 2 + 1] = 0;
+            out[out16 * 2] = static_cast<uint8_t>(groups[ii] >> 8);
+            out[out16 * 2 + 1] = static_cast<uint8_t>(groups[ii]);
+            ++out16;
+        }
+        for (; out16 < 8; ++out16) out[out16 * 2] = out[out16 * 2 + 1] = 0; // "::"在末尾
+        return true;
+    }
+
+    bool parseAddr(const char* text, size_t len, NetRule& rule)
+    {
+        if (len == 1 && text[0] == '*')
+        {
+            rule.m_family = FAMILY_ANY;
+            rule.m_prefixLen = 0;
+            std::memset(rule.m_addr, 0, sizeof(rule.m_addr));
+            return true;
+        }
+
+        // 拆出前缀长度
+        const char* slash = static_cast<const char*>(std::memchr(text, '/', len));
+        size_t addrLen = slash ? static_cast<size_t>(slash - text) : len;
+        size_t prefixTextLen = slash ? len - addrLen - 1 : 0;
+        const char* addr = text;
+        if (addrLen >= 2 && addr[0] == '[' && addr[addrLen - 1] == ']')
+        {
+            ++addr;
+            addrLen -= 2;
+        }
+
+        uint8_t bytes[16] = {};
+        uint8_t family;
+        if (parseIPv4(addr, addrLen, bytes))
+            family = FAMILY_V4;
+        else if (parseIPv6(addr, addrLen, bytes))
+            family = FAMILY_V6;
+        else
+            return false;
+
+        unsigned bits = familyBits(family);
+        unsigned prefix = bits;
+        if (slash && !parseUint(slash + 1, prefixTextLen, bits, prefix)) return false;
+
+        // 主机位清零
+        u128 v = addrToValue(family, bytes) & ~hostMask(prefix, bits);
+        rule.m_family = family;
+        rule.m_prefixLen = static_cast<uint8_t>(prefix);
+        valueToAddr(family, v, rule.m_addr);
+        return true;
+    }
+
+    bool parsePorts(const char* text, size_t len, uint16_t& lo, uint16_t& hi)
+    {
+        if (len == 1 && text[0] == '*')
+        {
+            lo = 0;
+            hi = 65535;
+            return true;
+        }
+
+        const char* sep = nullptr;
+        for (size_t ii = 0; ii < len; ++ii)
+        {
+            if (text[ii] == '-' || text[ii] == ':')
+            {
+                sep = text + ii;
+                break;
+            }
+        }
+
+        unsigned a = 0, b = 0;
+        if (!sep)
+        {
+            if (!parseUint(text, len, 65535, a)) return false;
+            if (a == 0) // 0表示全部端口
+            {
+                lo = 0;
+                hi = 65535;
+                return true;
+            }
+            b = a;
+        }
+        else
+        {
+            size_t n = static_cast<size_t>(sep - text);
+            if (!parseUint(text, n, 65535, a) || !parseUint(sep + 1, len - n - 1, 65535, b) || a > b) return false;
+        }
+        lo = static_cast<uint16_t>(a);
+        hi = static_cast<uint16_t>(b);
+        return true;
+    }
+
+    bool parseTarget(const char* text, size_t len, NetRule& rule)
+    {
+        size_t pos = len;
+        if (len > 0 && text[0] == '[')
+        {
+            // [v6]/len:port
+            const char* close = static_cast<const char*>(std::memchr(text, ']', len));
+            if (close == nullptr) return false;
+            const char* colon = static_cast<const char*>(std::memchr(close, ':', len - static_cast<size_t>(close - text)));
+            if (colon != nullptr) pos = static_cast<size_t>(colon - text);
+        }
+        else
+        {
+            while (pos > 0 && text[pos - 1] != ':') --pos;
+            pos = pos > 0 ? pos - 1 : len;
+        }
+        if (pos >= len || pos == 0) return false;
+
+        NetRule r = rule;
+        if (!parseAddr(text, pos, r)) return false;
+        if (!parsePorts(text + pos + 1, len - pos - 1, r.m_portLo, r.m_portHi)) return false;
+        rule = r;
+        return true;
+    }
+
+    bool parseTarget(const std::string& text, NetRule& rule)
+    {
+        return parseTarget(text.data(), text.size(), rule);
+    }
+
+    std::string formatAddr(const NetRule& rule)
+    {
+        char buf[INET6_ADDRSTRLEN] = {};
+        inet_ntop(rule.m_family == FAMILY_V6 ? AF_INET6 : AF_INET, rule.m_addr, buf, sizeof(buf));
+        std::string s(buf);
+        if (rule.m_prefixLen != familyBits(rule.m_family)) s += "/" + std::to_string(rule.m_prefixLen);
+        return s;
+    }
+
+    std::string formatPorts(const NetRule& rule, char sep)
+    {
+        if (rule.allPorts()) return std::string();
+        if (rule.m_portLo == rule.m_portHi) return std::to_string(rule.m_portLo);
+        return std::to_string(rule.m_portLo) + sep + std::to_string(rule.m_portHi);
+    }
+
+    void RangeCompiler::add(const NetRule& rule)
+    {
+        ++m_input;
+        NetRule r = rule;
+        if (r.m_portLo > r.m_portHi) std::swap(r.m_portLo, r.m_portHi);
+        if (r.m_family == FAMILY_ANY)
+        {
+            std::memset(r.m_addr, 0, sizeof(r.m_addr));
+            r.m_prefixLen = 0;
+            r.m_family = FAMILY_V4;
+            m_rules.push_back(r);
+            r.m_family = FAMILY_V6;
+            m_rules.push_back(r);
+            return;
+        }
+
+        unsigned bits = familyBits(r.m_family);
+        if (r.m_prefixLen > bits) r.m_prefixLen = static_cast<uint8_t>(bits);
+        u128 v = addrToValue(r.m_family, r.m_addr) & ~hostMask(r.m_prefixLen, bits);
+        valueToAddr(r.m_family, v, r.m_addr);
+        m_rules.push_back(r);
+    }
+
+    std::vector<NetRule> RangeCompiler::compile(CompileReport* report) const
+    {
+        CompileReport rep;
+        rep.m_input = m_input;
+
+        // 所有规则的协议掩码相同时（列表加载、配置文件的常见情况），各协议的编译过程完全相同，
+        // 只按整个掩码编译一遍，统计数按协议数放大。ICMP的端口视为全部，掩码含ICMP时要求端口也都是全部。
+        uint8_t uniform = m_rules.empty() ? 0 : m_rules[0].m_proto;
+        for (const NetRule& r : m_rules)
+        {
+            if (r.m_proto != uniform || ((uniform & PROTO_ICMP) && uniform != PROTO_ICMP && !r.allPorts()))
+            {
+                uniform = 0;
+                break;
+            }
+        }
+
+        // 1、展开为单个协议上的地址范围（ICMP没有端口，端口范围视为全部）
+        std::vector<Item> items;
+        items.reserve(uniform ? m_rules.size() : m_rules.size() * 2);
+        for (const NetRule& r : m_rules)
+        {
+            unsigned bits = familyBits(r.m_family);
+            u128 lo = addrToValue(r.m_family, r.m_addr);
+            u128 hi = lo | hostMask(r.m_prefixLen, bits);
+            rep.m_protoRulesIn += protoCount(r.m_proto);
+            if (uniform)
+            {
+                Item it;
+                it.m_family = r.m_family;
+                it.m_proto = uniform;
+                it.m_portLo = uniform == PROTO_ICMP ? 0 : r.m_portLo;
+                it.m_portHi = uniform == PROTO_ICMP ? 65535 : r.m_portHi;
+                it.m_lo = lo;
+                it.m_hi = hi;
+                it.m_id = r.m_ruleId;
+                items.push_back(it);
+                continue;
+            }
+            for (uint8_t p = PROTO_TCP; p <= PROTO_ICMP; p <<= 1)
+            {
+                if (!(r.m_proto & p)) continue;
+                Item it;
+                it.m_family = r.m_family;
+                it.m_proto = p;
+                it.m_portLo = p == PROTO_ICMP ? 0 : r.m_portLo;
+                it.m_portHi = p == PROTO_ICMP ? 65535 : r.m_portHi;
+                it.m_lo = lo;
+                it.m_hi = hi;
+                it.m_id = r.m_ruleId;
+                items.push_back(it);
+            }
+        }
+
+        // 2、地址合并与端口合并交替进行，直到不再变化（端口合并后可能产生新的相邻地址范围，反之亦然）
+        //    所有端口范围都相同时没有可合并的端口，跳过端口合并及其排序
+        bool first = true;
+        bool byGroup = true;
+        while (true)
+        {
+            mergeAddrRanges(items, rep, first);
+            first = false;
+            if (samePorts(items)) break;
+            bool portChanged = mergePortRanges(items, rep);
+            byGroup = false;
+            if (!portChanged) break; // 端口合并没有改变结果时，地址合并的结果也已稳定
+        }
+        if (!byGroup) std::sort(items.begin(), items.end(), lessByGroup);
+
+        // 3、去掉被更宽规则完全覆盖的范围
+        removeSubsumed(items, rep);
+
+        // 4、分解为CIDR
+        std::vector<NetRule> cidrs;
+        cidrs.reserve(items.size());
+        for (const Item& it : items) rangeToCidrs(it, cidrs);
+
+        if (uniform)
+        {
+            unsigned k = protoCount(uniform);
+            rep.m_duplicates *= k;
+            rep.m_subsumed *= k;
+            rep.m_merged *= k;
+        }
+
+        // 5、网段与端口都相同的不同协议合并为一条（每个地址族只有一个组时分解结果已经有序）
+        if (!std::is_sorted(cidrs.begin(), cidrs.end(), lessRule)) std::sort(cidrs.begin(), cidrs.end(), lessRule);
+        std::vector<NetRule> out;
+        out.reserve(cidrs.size());
+        for (const NetRule& r : cidrs)
+        {
+            if (!out.empty())
+            {
+                NetRule& last = out.back();
+                if (!lessRule(last, r) && !lessRule(r, last))
+                {
+                    last.m_proto |= r.m_proto;
+                    last.m_ruleId = std::min(last.m_ruleId, r.m_ruleId);
+                    continue;
+                }
+            }
+            out.push_back(r);
+        }
+
+        rep.m_output = out.size();
+        for (const NetRule& r : out) rep.m_protoRulesOut += protoCount(r.m_proto);
+        if (report) *report = rep;
+        return out;
+    }
+
+    void RangeTable::build(const std::vector<NetRule>& rules)
+    {
+        m_groups.clear();
+        m_size = 0;
+
+        // 按(地址族, 协议, 端口范围)分组
+        std::vector<NetRule> sorted(rules);
+        std::sort(sorted.begin(), sorted.end(), [](const NetRule& a, const NetRule& b)
+                  {
+                      if (a.m_family != b.m_family) return a.m_family < b.m_family;
+                      if (a.m_proto != b.m_proto) return a.m_proto < b.m_proto;
+                      if (a.m_portLo != b.m_portLo) return a.m_portLo < b.m_portLo;
+                      if (a.m_portHi != b.m_portHi) return a.m_portHi < b.m_portHi;
+                      return std::memcmp(a.m_addr, b.m_addr, 16) < 0; });
+
+        for (const NetRule& r : sorted)
+        {
+            if (r.m_family != FAMILY_V4 && r.m_family != FAMILY_V6) continue;
+            if (m_groups.empty() || m_groups.back().m_family != r.m_family || m_groups.back().m_proto != r.m_proto ||
+                m_groups.back().m_portLo != r.m_portLo || m_groups.back().m_portHi != r.m_portHi)
+            {
+                Group g;
+                g.m_family = r.m_family;
+                g.m_proto = r.m_proto;
+                g.m_portLo = r.m_portLo;
+                g.m_portHi = r.m_portHi;
+                m_groups.push_back(std::move(g));
+            }
+
+            unsigned bits = familyBits(r.m_family);
+            unsigned prefix = r.m_prefixLen > bits ? bits : r.m_prefixLen;
+            u128 lo = addrToValue(r.m_family, r.m_addr) & ~hostMask(prefix, bits);
+            m_groups.back().m_ranges.push_back(Interval{lo, lo | hostMask(prefix, bits), r.m_ruleId});
+        }
+
+        // 组内重叠的范围拆成互不重叠的段（未编译的规则集可能有重叠，CIDR只有包含或不相交两种关系），
+        // 每段取覆盖它的规则中编号最小的
+        for (Group& g : m_groups)
+        {
+            std::vector<Interval>& in = g.m_ranges;
+            std::sort(in.begin(), in.end(), [](const Interval& a, const Interval& b)
+                      { return a.m_lo != b.m_lo ? a.m_lo < b.m_lo : a.m_hi > b.m_hi; });
+
+            std::vector<Interval> out;
+            std::vector<Interval> stack; // 当前嵌套的外层范围
+            u128 maxAddr = familyMax(g.m_family);
+            u128 cursor = 0;               // 下一个未输出的地址
+            bool done = false;             // 已输出到最大地址
+
+            auto emit = [&](u128 lo, u128 hi, int id)
+            {
+                if (!out.empty() && out.back().m_id == id && out.back().m_hi + 1 == lo)
+                    out.back().m_hi = hi;
+                else
+                    out.push_back(Interval{lo, hi, id});
+            };
+
+            // 输出栈顶范围中[cursor, upto]部分
+            auto flushTo = [&](u128 upto)
+            {
+                while (!stack.empty() && !done)
+                {
+                    const Interval& top = stack.back();
+                    if (top.m_hi < cursor)
+                    {
+                        stack.pop_back();
+                        continue;
+                    }
+                    u128 end = top.m_hi < upto ? top.m_hi : upto;
+                    if (end < cursor) break;
+                    int id = top.m_id;
+                    for (const Interval& s : stack) id = std::min(id, s.m_id);
+                    emit(cursor, end, id);
+                    if (end == maxAddr) done = true;
+                    else cursor = end + 1;
+                    if (end == upto) break;
+                }
+            };
+
+            for (const Interval& iv : in)
+            {
+                if (iv.m_lo > 0) flushTo(iv.m_lo - 1);
+                if (done) break;
+                while (!stack.empty() && stack.back().m_hi < iv.m_lo) stack.pop_back();
+                if (stack.empty() || cursor < iv.m_lo) cursor = iv.m_lo;
+                stack.push_back(iv);
+            }
+            flushTo(maxAddr);
+
+            m_size += out.size();
+            in.swap(out);
+        }
+    }
+
+    int RangeTable::match(uint8_t family, const uint8_t* addr, uint16_t port, uint8_t proto) const
+    {
+        u128 v = addrToValue(family, addr);
+        int best = -1;
+        for (const Group& g : m_groups)
+        {
+            if (g.m_family != family) continue;
+            uint8_t hitProto = g.m_proto & proto;
+            if (!hitProto) continue;
+            if (hitProto != PROTO_ICMP && (port < g.m_portLo || port > g.m_portHi)) continue; // ICMP没有端口
+
+            // 最后一个起点不大于v的范围
+            const std::vector<Interval>& r = g.m_ranges;
+            size_t lo = 0, hi = r.size();
+            while (lo < hi)
+            {
+                size_t mid = lo + (hi - lo) / 2;
+                if (r[mid].m_lo <= v)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            if (lo > 0 && r[lo - 1].m_hi >= v && (best < 0 || r[lo - 1].m_id < best)) best = r[lo - 1].m_id;
+        }
+        return best;
+    }
+
+} // namespace policy
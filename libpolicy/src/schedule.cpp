@@ -0,0 +1,109 @@
+#include "policy/schedule.h"
+#include <cstdio>
+
+namespace policy
+{
+
+    bool Schedule::parseTime(const char* text, size_t len, int& minutes)
+    {
+        while (len > 0 && (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n')) ++text, --len;
+        while (len > 0 && (text[len - 1] == ' ' || text[len - 1] == '\t' || text[len - 1] == '\r' || text[len - 1] == '\n')) --len;
+
+        // H:M ~ HH:MM
+        if (len < 3 || len > 5) return false;
+        size_t colon = 0;
+        while (colon < len && text[colon] != ':') ++colon;
+        if (colon < 1 || colon > 2 || len - colon - 1 < 1 || len - colon - 1 > 2) return false;
+
+        int hour = 0, min = 0;
+        for (size_t ii = 0; ii < colon; ++ii)
+        {
+            if (text[ii] < '0' || text[ii] > '9') return false;
+            hour = hour * 10 + (text[ii] - '0');
+        }
+        for (size_t ii = colon + 1; ii < len; ++ii)
+        {
+            if (text[ii] < '0' || text[ii] > '9') return false;
+            min = min * 10 + (text[ii] - '0');
+        }
+        if (hour > 24 || min > 59 || (hour == 24 && min != 0)) return false;
+
+        minutes = hour * 60 + min;
+        return true;
+    }
+
+    std::string Schedule::formatTime(int minutes)
+    {
+        if (minutes < 0) minutes = 0;
+        if (minutes > MINUTES_PER_DAY) minutes = MINUTES_PER_DAY;
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%02d:%02d", minutes / 60, minutes % 60);
+        return buf;
+    }
+
+    bool Schedule::addRange(int start, int end)
+    {
+        if (start < 0 || start > MINUTES_PER_DAY || end < 0 || end > MINUTES_PER_DAY) return false;
+        m_ranges.emplace_back(static_cast<uint16_t>(start), static_cast<uint16_t>(end));
+
+        // 与原有判断一致：开始不晚于结束时取[start, end]，否则取[start, 24:00)∪[00:00, end]；
+        // 当前分钟最大为23:59，所以24:00作为开始时不覆盖任何当天的分钟
+        int last = end < MINUTES_PER_DAY ? end : MINUTES_PER_DAY - 1;
+        int first = start <= end ? start : 0;
+        for (int mm = first; mm <= last; ++mm) m_bits[mm >> 6] |= static_cast<uint64_t>(1) << (mm & 63);
+        if (start > end)
+            for (int mm = start; mm < MINUTES_PER_DAY; ++mm) m_bits[mm >> 6] |= static_cast<uint64_t>(1) << (mm & 63);
+        return true;
+    }
+
+    bool Schedule::addRange(const std::string& start, const std::string& end)
+    {
+        int s = 0, e = 0;
+        if (!parseTime(start, s) || !parseTime(end, e)) return false;
+        return addRange(s, e);
+    }
+
+    void Schedule::clear()
+    {
+        for (uint64_t& w : m_bits) w = 0;
+        m_ranges.clear();
+    }
+
+    bool Schedule::active(time_t now) const
+    {
+        struct tm tmv;
+        if (localtime_r(&now, &tmv) == nullptr) return false;
+        return contains(tmv.tm_hour * 60 + tmv.tm_min);
+    }
+
+    long Schedule::secondsUntilChange(time_t now) const
+    {
+        struct tm tmv;
+        if (localtime_r(&now, &tmv) == nullptr) return -1;
+
+        int minute = tmv.tm_hour * 60 + tmv.tm_min;
+        bool cur = contains(minute);
+        for (int step = 1; step < MINUTES_PER_DAY; ++step)
+        {
+            if (contains((minute + step) % MINUTES_PER_DAY) != cur)
+            {
+                long secs = static_cast<long>(step) * 60 - tmv.tm_sec;
+                return secs > 0 ? secs : 1;
+            }
+        }
+        return -1;
+    }
+
+    std::string Schedule::toString() const
+    {
+        if (m_ranges.empty()) return "无";
+        std::string s;
+        for (size_t ii = 0; ii < m_ranges.size(); ++ii)
+        {
+            if (ii > 0) s += "、";
+            s += formatTime(m_ranges[ii].first) + "-" + formatTime(m_ranges[ii].second);
+        }
+        return s;
+    }
+
+} // namespace policy
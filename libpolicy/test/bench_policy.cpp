@@ -0,0 +1,171 @@
+// libpolicy基准测试
+// 随机生成N条IP/网段规则（其中一部分带端口范围），分别统计：
+//   parse   ：按行解析列表文本（LineReader + FeedLoader）的行/s
+//   compile ：RangeCompiler去重、合并的耗时
+//   match   ：PolicySet::matchNet的每次查找耗时（命中与未命中各一半）
+//   schedule：Schedule::active的每次判断耗时
+// 用于对比策略库优化前后的性能。
+//
+// 用法：bench_policy [--rules=1000000] [--lookups=5000000] [--seed=1]
+
+#include "policy/feed_loader.h"
+#include "policy/policy_set.h"
+#include "policy/range_compiler.h"
+#include "policy/schedule.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace policy;
+
+// ===================== 全局配置 =====================
+struct st_config
+{
+    size_t rules = 1000000;
+    size_t lookups = 5000000;
+    unsigned seed = 1;
+};
+
+static st_config g_cfg;
+
+static double now_sec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool parse_args(int argc, char* argv[])
+{
+    for (int ii = 1; ii < argc; ++ii)
+    {
+        const char* arg = argv[ii];
+        if (strncmp(arg, "--rules=", 8) == 0)
+            g_cfg.rules = strtoul(arg + 8, nullptr, 10);
+        else if (strncmp(arg, "--lookups=", 10) == 0)
+            g_cfg.lookups = strtoul(arg + 10, nullptr, 10);
+        else if (strncmp(arg, "--seed=", 7) == 0)
+            g_cfg.seed = static_cast<unsigned>(strtoul(arg + 7, nullptr, 10));
+        else
+        {
+            printf("用法：%s [--rules=1000000] [--lookups=5000000] [--seed=1]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 生成列表文本：IPv4单个地址、/16~/30网段和少量IPv6网段
+static std::string make_feed(std::mt19937& rng)
+{
+    std::string text;
+    text.reserve(g_cfg.rules * 20);
+    char line[64];
+    for (size_t ii = 0; ii < g_cfg.rules; ++ii)
+    {
+        uint32_t r = rng();
+        int kind = static_cast<int>(rng() % 16);
+        if (kind == 0)
+            snprintf(line, sizeof(line), "2001:db8:%x:%x::/64\n", r >> 16, r & 0xffff);
+        else if (kind < 6)
+            snprintf(line, sizeof(line), "%u.%u.%u.0/%u\n", 1 + (r >> 24) % 223, (r >> 16) & 0xff, (r >> 8) & 0xff, 16 + static_cast<unsigned>(rng() % 15));
+        else
+            snprintf(line, sizeof(line), "%u.%u.%u.%u\n", 1 + (r >> 24) % 223, (r >> 16) & 0xff, (r >> 8) & 0xff, r & 0xff);
+        text += line;
+    }
+    return text;
+}
+
+int main(int argc, char* argv[])
+{
+    if (!parse_args(argc, argv)) return 1;
+
+    std::mt19937 rng(g_cfg.seed);
+    std::string feed = make_feed(rng);
+
+    // ===================== 解析 =====================
+    RangeCompiler rc;
+    FeedLoader loader(&rc);
+    NetRule tmpl;
+    tmpl.m_proto = PROTO_TCP | PROTO_UDP;
+    tmpl.m_ruleId = 0;
+    loader.setTemplate(tmpl);
+
+    double t0 = now_sec();
+    loader.loadBuffer(feed.data(), feed.size());
+    double t1 = now_sec();
+    printf("parse   : %zu行  %.3fs  %.2fM行/s  (%s)\n", loader.stats().m_lines, t1 - t0,
+           loader.stats().m_lines / (t1 - t0) / 1e6, loader.stats().toString().c_str());
+
+    // ===================== 编译 =====================
+    CompileReport report;
+    t0 = now_sec();
+    std::vector<NetRule> rules = rc.compile(&report);
+    t1 = now_sec();
+    printf("compile : %zu条 -> %zu条  %.3fs\n", report.m_input, report.m_output, t1 - t0);
+
+    // 同样的规则经PolicySet（带一部分端口范围）建立查找表
+    PolicySet ps;
+    // 配置中的端口范围通常只有几种（每种端口范围对应查找表中的一个分组）
+    static const char* ports[] = {"80", "443", "8000-8100", "1000-2000"};
+    char text[64];
+    for (size_t ii = 0; ii < rules.size(); ++ii)
+    {
+        NetRule& r = rules[ii];
+        std::string addr = formatAddr(r);
+        if (ii % 4 == 0)
+            snprintf(text, sizeof(text), r.m_family == FAMILY_V6 ? "[%s]:%s" : "%s:%s", addr.c_str(), ports[(ii / 4) % 4]);
+        else
+            snprintf(text, sizeof(text), r.m_family == FAMILY_V6 ? "[%s]:*" : "%s:*", addr.c_str());
+        ps.addTarget(text, strlen(text), static_cast<int>(ii), PROTO_TCP | PROTO_UDP);
+    }
+    t0 = now_sec();
+    ps.compile();
+    t1 = now_sec();
+    printf("build   : %zu条规则 -> %zu个地址范围  %.3fs\n", ps.rules().size(), ps.table().size(), t1 - t0);
+
+    // ===================== 查找 =====================
+    // 一半地址取自规则（命中），一半随机（大多未命中）
+    std::vector<uint8_t> addrs(g_cfg.lookups * 4);
+    for (size_t ii = 0; ii < g_cfg.lookups; ++ii)
+    {
+        uint8_t* a = &addrs[ii * 4];
+        const NetRule& r = ps.rules()[rng() % ps.rules().size()];
+        if (ii % 2 == 0 && r.m_family == FAMILY_V4)
+            memcpy(a, r.m_addr, 4);
+        else
+        {
+            uint32_t v = rng();
+            memcpy(a, &v, 4);
+        }
+    }
+
+    size_t hits = 0;
+    t0 = now_sec();
+    for (size_t ii = 0; ii < g_cfg.lookups; ++ii)
+    {
+        if (ps.matchNet(FAMILY_V4, &addrs[ii * 4], static_cast<uint16_t>(ii % 2 == 0 ? 443 : 1500), PROTO_TCP) >= 0) ++hits;
+    }
+    t1 = now_sec();
+    printf("match   : %zu次  %.1fns/次  命中%zu次\n", g_cfg.lookups, (t1 - t0) * 1e9 / g_cfg.lookups, hits);
+
+    // ===================== 时间段 =====================
+    Schedule sched;
+    sched.addRange("08:00", "12:00");
+    sched.addRange("14:00", "18:00");
+    sched.addRange("22:00", "02:00");
+    time_t base = time(nullptr);
+    size_t active = 0;
+    t0 = now_sec();
+    for (size_t ii = 0; ii < g_cfg.lookups; ++ii)
+    {
+        if (sched.active(base + static_cast<time_t>(ii % 86400))) ++active;
+    }
+    t1 = now_sec();
+    printf("schedule: %zu次  %.1fns/次  生效%zu次\n", g_cfg.lookups, (t1 - t0) * 1e9 / g_cfg.lookups, active);
+
+    return 0;
+}
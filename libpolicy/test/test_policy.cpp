@@ -0,0 +1,381 @@
+// libpolicy单元测试：地址/端口/条目解析、网段编译与查找、时间段、列表加载、策略查找
+// 用法：make test（失败时打印出错的表达式和行号，返回值为失败个数）
+
+#include "policy/feed_loader.h"
+#include "policy/line_reader.h"
+#include "policy/policy_set.h"
+#include "policy/range_compiler.h"
+#include "policy/schedule.h"
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+
+using namespace policy;
+
+static int g_failed = 0;
+static int g_passed = 0;
+
+#define CHECK(expr)                                                        \
+    do                                                                     \
+    {                                                                      \
+        if (expr)                                                          \
+            ++g_passed;                                                    \
+        else                                                               \
+        {                                                                  \
+            ++g_failed;                                                    \
+            printf("❌ %s:%d 检查失败：%s\n", __FILE__, __LINE__, #expr); \
+        }                                                                  \
+    } while (0)
+
+static bool v4(const char* s, uint8_t out[4])
+{
+    return parseIPv4(s, strlen(s), out);
+}
+
+static bool v6(const char* s, uint8_t out[16])
+{
+    return parseIPv6(s, strlen(s), out);
+}
+
+static NetRule target(const char* s, bool* ok = nullptr)
+{
+    NetRule r;
+    bool res = parseTarget(s, strlen(s), r);
+    if (ok) *ok = res;
+    return r;
+}
+
+// ===================== 地址解析 =====================
+static void test_parse_addr()
+{
+    uint8_t a[16];
+    CHECK(v4("1.2.3.4", a) && a[0] == 1 && a[3] == 4);
+    CHECK(v4("255.255.255.255", a) && a[0] == 255);
+    CHECK(v4("0.0.0.0", a));
+    CHECK(!v4("256.1.1.1", a));
+    CHECK(!v4("1.2.3", a));
+    CHECK(!v4("1.2.3.4.5", a));
+    CHECK(!v4("01.2.3.4", a)); // 前导0（与inet_pton一致）
+    CHECK(!v4("1..3.4", a));
+    CHECK(!v4("1.2.3.4 ", a));
+
+    uint8_t b[16];
+    CHECK(v6("::", a));
+    CHECK(v6("::1", a) && a[15] == 1 && a[0] == 0);
+    CHECK(v6("2001:db8::1", a) && a[0] == 0x20 && a[1] == 0x01 && a[2] == 0x0d && a[3] == 0xb8 && a[15] == 1);
+    CHECK(v6("::ffff:1.2.3.4", a) && a[10] == 0xff && a[12] == 1 && a[15] == 4);
+    CHECK(v6("1:2:3:4:5:6:7:8", a) && a[14] == 0 && a[15] == 8);
+    CHECK(v6("fe80::", a) && a[0] == 0xfe && a[1] == 0x80 && a[15] == 0);
+    CHECK(!v6("1:2:3:4:5:6:7:8:9", a));
+    CHECK(!v6("1::2::3", a));
+    CHECK(!v6("12345::", a));
+    CHECK(!v6(":1", a));
+    CHECK(!v6("1:", a));
+
+    // 与inet_pton结果一致
+    const char* samples[] = {"2001:db8:0:0:1:0:0:1", "::ffff:0:0", "1::", "::2:3:4:5:6:7:8", "a:b:c:d:e:f:0:1"};
+    for (const char* s : samples)
+    {
+        CHECK(v6(s, a) && inet_pton(AF_INET6, s, b) == 1 && memcmp(a, b, 16) == 0);
+    }
+
+    NetRule r;
+    CHECK(parseAddr("10.1.2.3/8", 10, r) && r.m_family == FAMILY_V4 && r.m_prefixLen == 8 && r.m_addr[0] == 10 && r.m_addr[1] == 0); // 主机位清零
+    CHECK(parseAddr("[2001:db8::1]/32", 16, r) && r.m_family == FAMILY_V6 && r.m_prefixLen == 32 && r.m_addr[15] == 0);
+    CHECK(parseAddr("*", 1, r) && r.m_family == FAMILY_ANY);
+    CHECK(!parseAddr("10.0.0.0/33", 11, r));
+    CHECK(!parseAddr("www.xxx.com", 11, r));
+}
+
+// ===================== 端口与条目解析 =====================
+static void test_parse_target()
+{
+    uint16_t lo = 0, hi = 0;
+    CHECK(parsePorts("*", 1, lo, hi) && lo == 0 && hi == 65535);
+    CHECK(parsePorts("0", 1, lo, hi) && lo == 0 && hi == 65535);
+    CHECK(parsePorts("80", 2, lo, hi) && lo == 80 && hi == 80);
+    CHECK(parsePorts("8000-8100", 9, lo, hi) && lo == 8000 && hi == 8100);
+    CHECK(parsePorts("8000:8100", 9, lo, hi) && lo == 8000 && hi == 8100);
+    CHECK(!parsePorts("8100-8000", 9, lo, hi));
+    CHECK(!parsePorts("65536", 5, lo, hi));
+
+    bool ok = false;
+    NetRule r = target("1.2.3.4:80", &ok);
+    CHECK(ok && r.m_prefixLen == 32 && r.m_portLo == 80 && r.m_portHi == 80);
+    r = target("[::1]:443", &ok);
+    CHECK(ok && r.m_family == FAMILY_V6 && r.m_portLo == 443);
+    r = target("2001:db8::/32:*", &ok); // 不带方括号时以最后一个冒号分隔端口
+    CHECK(ok && r.m_family == FAMILY_V6 && r.m_prefixLen == 32 && r.allPorts());
+    r = target("*:53", &ok);
+    CHECK(ok && r.m_family == FAMILY_ANY && r.m_portLo == 53);
+    target("1.2.3.4", &ok);
+    CHECK(!ok);
+    target("www.xxx.com:80", &ok);
+    CHECK(!ok);
+
+    CHECK(formatAddr(target("10.0.0.0/8:0")) == "10.0.0.0/8");
+    CHECK(formatAddr(target("1.2.3.4:0")) == "1.2.3.4");
+    CHECK(formatPorts(target("1.2.3.4:8000-8100"), ':') == "8000:8100");
+    CHECK(formatPorts(target("1.2.3.4:*")).empty());
+}
+
+// ===================== 网段编译与查找 =====================
+static void test_compile()
+{
+    RangeCompiler rc;
+    const char* rules[] = {"10.0.0.0/25:80", "10.0.0.128/25:80", "10.0.0.5:80", "10.0.0.5:80", "192.168.0.0/16:*", "192.168.1.0/24:443"};
+    int id = 0;
+    for (const char* s : rules)
+    {
+        NetRule r = target(s);
+        r.m_proto = PROTO_TCP;
+        r.m_ruleId = id++;
+        rc.add(r);
+    }
+
+    CompileReport rep;
+    std::vector<NetRule> out = rc.compile(&rep);
+    CHECK(rep.m_input == 6);
+    CHECK(out.size() == 2); // 10.0.0.0/24:80、192.168.0.0/16:*
+    CHECK(rep.m_duplicates + rep.m_subsumed == 3); // 重复的10.0.0.5和被/16覆盖的192.168.1.0/24
+    CHECK(rep.m_merged == 1);
+    CHECK(out.size() == 2 && formatAddr(out[0]) == "10.0.0.0/24" && out[0].m_portLo == 80 && out[0].m_ruleId == 0);
+    CHECK(out.size() == 2 && formatAddr(out[1]) == "192.168.0.0/16" && out[1].allPorts() && out[1].m_ruleId == 4);
+
+    // 协议掩码相同与不同时的结果一致（相同时走快速路径）
+    RangeCompiler same, mixed;
+    for (int ii = 0; ii < 64; ++ii)
+    {
+        NetRule r;
+        r.m_addr[0] = 10;
+        r.m_addr[3] = static_cast<uint8_t>(ii * 4);
+        r.m_prefixLen = 30;
+        r.m_proto = PROTO_TCP | PROTO_UDP;
+        r.m_ruleId = ii;
+        same.add(r);
+        r.m_proto = PROTO_TCP;
+        mixed.add(r);
+        r.m_proto = PROTO_UDP;
+        mixed.add(r);
+    }
+    CompileReport repSame, repMixed;
+    std::vector<NetRule> a = same.compile(&repSame), b = mixed.compile(&repMixed);
+    CHECK(a.size() == 1 && b.size() == 1 && formatAddr(a[0]) == "10.0.0.0/24" && a[0].m_proto == (PROTO_TCP | PROTO_UDP));
+    CHECK(repSame.m_merged * 2 == repMixed.m_merged + repMixed.m_duplicates || repSame.m_merged == 63 * 2);
+
+    // 查找：命中条目中最小的编号，ICMP忽略端口
+    RangeTable table;
+    std::vector<NetRule> in;
+    NetRule r1 = target("10.0.0.0/8:443");
+    r1.m_proto = PROTO_TCP;
+    r1.m_ruleId = 7;
+    NetRule r2 = target("10.1.0.0/16:*");
+    r2.m_proto = PROTO_ALL;
+    r2.m_ruleId = 3;
+    in.push_back(r1);
+    in.push_back(r2);
+    table.build(in);
+    uint8_t addr[4] = {10, 1, 2, 3};
+    CHECK(table.match(FAMILY_V4, addr, 443, PROTO_TCP) == 3);
+    CHECK(table.match(FAMILY_V4, addr, 80, PROTO_ICMP) == 3);
+    addr[1] = 2;
+    CHECK(table.match(FAMILY_V4, addr, 443, PROTO_TCP) == 7);
+    CHECK(table.match(FAMILY_V4, addr, 443, PROTO_UDP) == -1);
+    CHECK(table.match(FAMILY_V4, addr, 80, PROTO_TCP) == -1);
+}
+
+// ===================== 时间段 =====================
+static void test_schedule()
+{
+    int m = 0;
+    CHECK(Schedule::parseTime("09:30", m) && m == 570);
+    CHECK(Schedule::parseTime(" 9:05 ", m) && m == 545);
+    CHECK(Schedule::parseTime("24:00", m) && m == 1440);
+    CHECK(!Schedule::parseTime("24:01", m));
+    CHECK(!Schedule::parseTime("12:60", m));
+    CHECK(!Schedule::parseTime("1200", m));
+    CHECK(!Schedule::parseTime("ab:cd", m));
+    CHECK(Schedule::formatTime(570) == "09:30" && Schedule::formatTime(1440) == "24:00");
+
+    Schedule s;
+    CHECK(s.empty() && !s.contains(0));
+    CHECK(s.addRange("09:00", "18:00"));
+    CHECK(!s.contains(539) && s.contains(540) && s.contains(1080) && !s.contains(1081)); // 两端包含
+    CHECK(s.addRange("23:00", "02:00"));                                                  // 跨天
+    CHECK(s.contains(1380) && s.contains(1439) && s.contains(0) && s.contains(120) && !s.contains(121));
+    CHECK(!s.addRange("25:00", "26:00"));
+    CHECK(s.rangeNum() == 2 && s.toString() == "09:00-18:00、23:00-02:00");
+
+    s.setAllDay();
+    CHECK(s.contains(0) && s.contains(1439) && s.rangeNum() == 1);
+
+    CHECK(s.secondsUntilChange(time(nullptr)) == -1); // 全天不变
+
+    s.clear();
+    s.addRange(1440, 1440); // 24:00-24:00不覆盖任何分钟（与原有判断一致）
+    CHECK(!s.contains(1439) && !s.contains(0));
+
+    // 距状态变化的秒数（本地时间）
+    s.clear();
+    s.addRange("09:00", "18:00");
+    time_t base = time(nullptr);
+    struct tm tmv;
+    localtime_r(&base, &tmv);
+    tmv.tm_hour = 8, tmv.tm_min = 59, tmv.tm_sec = 30, tmv.tm_isdst = -1;
+    CHECK(s.secondsUntilChange(mktime(&tmv)) == 30);
+    tmv.tm_hour = 9, tmv.tm_min = 0, tmv.tm_sec = 30, tmv.tm_isdst = -1;
+    CHECK(s.secondsUntilChange(mktime(&tmv)) == (1081 - 540) * 60 - 30);
+}
+
+// ===================== 按行读取与列表加载 =====================
+static void test_feed()
+{
+    // 各种行长和结尾（跨64字节块、末行无换行、\r\n）
+    for (int lines = 0; lines < 200; ++lines)
+    {
+        std::string text;
+        std::vector<std::string> expect;
+        for (int ii = 0; ii < lines; ++ii)
+        {
+            std::string line(static_cast<size_t>((ii * 7) % 150), static_cast<char>('a' + ii % 26));
+            expect.push_back(line);
+            text += line;
+            if (ii % 5 == 0) text += '\r';
+            if (ii + 1 < lines || lines % 2 == 0) text += '\n';
+        }
+        LineReader reader;
+        reader.openBuffer(text.data(), text.size());
+        const char* p;
+        size_t n;
+        size_t count = 0;
+        bool same = true;
+        while (reader.next(p, n))
+        {
+            if (count >= expect.size() || std::string(p, n) != expect[count]) same = false;
+            ++count;
+        }
+        // 末行为空且没有换行符时读不到这一行
+        bool countOk = count == expect.size() || (count + 1 == expect.size() && expect.back().empty());
+        if (!same || !countOk)
+        {
+            CHECK(same && countOk);
+            break;
+        }
+    }
+
+    // gzip文件（解压缓冲区1MB，写入超过它的内容验证跨缓冲区的行）
+    char path[] = "/tmp/test_policy_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    if (fd >= 0)
+    {
+        close(fd);
+        gzFile gz = gzopen(path, "wb");
+        std::string all;
+        for (int ii = 0; ii < 200000; ++ii) all += std::to_string(ii % 223 + 1) + "." + std::to_string(ii % 251) + ".0.0/16\n";
+        gzwrite(gz, all.data(), static_cast<unsigned>(all.size()));
+        gzclose(gz);
+
+        LineReader reader;
+        CHECK(reader.open(path) && reader.isGzip());
+        const char* p;
+        size_t n;
+        size_t count = 0, bytes = 0;
+        while (reader.next(p, n))
+        {
+            ++count;
+            bytes += n + 1;
+        }
+        CHECK(reader.ok() && count == 200000 && bytes == all.size());
+        unlink(path);
+    }
+
+    const char* text =
+        "# 注释\n"
+        "1.2.3.4\n"
+        "10.0.0.0/8 ; SBL123\n"
+        "[::1]\n"
+        "example.com\n"
+        "0.0.0.0 ads.example.com tracker.example.net\n"
+        "127.0.0.1 localhost\n"
+        "||adblock.example.com^\n"
+        "||imp.example.com^$important\n"
+        "||thirdp.example.com^$third-party\n"
+        "@@||good.example.com^\n"
+        "! title\n"
+        "bad_line!!\n"
+        "\n";
+    RangeCompiler rc;
+    std::vector<std::string> domains;
+    FeedLoader loader(&rc, [&](const char* p, size_t n) { domains.emplace_back(p, n); });
+    loader.loadBuffer(text, strlen(text));
+    const FeedStats& st = loader.stats();
+    CHECK(st.m_lines == 14);
+    CHECK(st.m_nets == 3 && rc.size() == 3);
+    CHECK(st.m_domains == 5);
+    CHECK(st.m_unsupported == 2);
+    CHECK(st.m_invalid == 1);
+    CHECK(domains.size() == 5 && domains[0] == "example.com" && domains[1] == "ads.example.com" && domains[4] == "imp.example.com");
+
+    CHECK(isValidHost("www.example.com", 15));
+    CHECK(!isValidHost("localhost", 9));
+    CHECK(isValidHost("localhost", 9, false));
+    CHECK(!isValidHost("1.2.3.999", 9, false));
+    CHECK(!isValidHost("a..b", 4));
+}
+
+// ===================== 策略 =====================
+static void test_policy_set()
+{
+    PolicySet ps;
+    NetRule net;
+    CHECK(ps.addTarget(std::string("10.0.0.0/8 : 443"), 0, PROTO_TCP | PROTO_UDP, &net) == TARGET_NET && net.m_portLo == 443);
+    CHECK(ps.addTarget(std::string("www.xxx.com:80"), 1, PROTO_TCP | PROTO_UDP) == TARGET_DOMAIN);
+    CHECK(ps.addTarget(std::string("www.yyy.com.:8000-8100"), 2) == TARGET_DOMAIN);
+    CHECK(ps.addTarget(std::string("1.2.3.999:80"), 3) == TARGET_INVALID);
+    CHECK(ps.addTarget(std::string("www.xxx.com"), 4) == TARGET_INVALID);
+    CHECK(ps.addTarget(std::string("www.xxx.com:70000"), 5) == TARGET_INVALID);
+    CHECK(ps.addTarget(std::string("[2001:db8::]/32:*"), 6) == TARGET_NET);
+    ps.addWhitelist("/usr/bin/curl");
+    ps.addWhitelist("/bin/curl");
+    ps.schedule().setAllDay();
+    ps.compile();
+
+    CHECK(ps.domains().size() == 2 && ps.domains()[0].m_host == "www.xxx.com" && ps.domains()[0].matchPort(80) && !ps.domains()[0].matchPort(81));
+    CHECK(ps.domains().size() == 2 && ps.domains()[1].m_host == "www.yyy.com" && ps.domains()[1].matchPort(8050));
+    CHECK(ps.whitelist().size() == 1);
+    CHECK(ps.isWhitelisted("/bin/curl") && ps.isWhitelisted("/usr/bin/curl") && !ps.isWhitelisted("/usr/bin/wget"));
+    CHECK(ps.rules().size() == 2 && ps.netInputs() == 2);
+
+    uint8_t mapped[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 10, 9, 8, 7};
+    CHECK(ps.matchNet(FAMILY_V6, mapped, 443, PROTO_TCP) == 0);
+    CHECK(ps.matchNet(FAMILY_V6, mapped, 80, PROTO_TCP) == -1);
+    CHECK(ps.matchNet("10.1.1.1", 8, 443, PROTO_UDP) == 0);
+    CHECK(ps.matchNet("2001:db8::5", 11, 22, PROTO_TCP) == 6);
+    CHECK(ps.matchNet("not-an-ip", 9, 22, PROTO_TCP) == -1);
+    CHECK(ps.active(time(nullptr)));
+
+    ps.clear();
+    ps.compile();
+    CHECK(ps.rules().empty() && ps.domains().empty() && ps.matchNet("10.1.1.1", 8, 443) == -1);
+}
+
+int main()
+{
+    test_parse_addr();
+    test_parse_target();
+    test_compile();
+    test_schedule();
+    test_feed();
+    test_policy_set();
+
+    if (g_failed == 0)
+        printf("✅ libpolicy单元测试全部通过（%d项）\n", g_passed);
+    else
+        printf("❌ libpolicy单元测试失败%d项（通过%d项）\n", g_failed, g_passed);
+    return g_failed;
+}